@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/graphics/BufferUtil.h"
+#include "ngfx/graphics/GraphicsContext.h"
+#include <memory>
+#include <vector>
+using namespace ngfx;
+using namespace std;
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("buffer", argc, argv);
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("bench_buffer", false, false));
+    ctx->setSurface(nullptr);
+    for (uint32_t size : { 64u * 1024u, 16u * 1024u * 1024u }) {
+        const string sizeStr = (size < 1024 * 1024) ? to_string(size / 1024) + "KB"
+                                                      : to_string(size / (1024 * 1024)) + "MB";
+        vector<uint8_t> data(size);
+        for (uint32_t j = 0; j < size; j++)
+            data[j] = uint8_t(j * 7);
+        unique_ptr<Buffer> buffer;
+        benchmark.run("create_" + sizeStr, [&]() {
+            buffer.reset(createStorageBuffer(ctx.get(), nullptr, size));
+        }, 1, "buffers", [&]() { buffer.reset(); });
+        benchmark.run("create_upload_" + sizeStr, [&]() {
+            buffer.reset(createStorageBuffer(ctx.get(), data.data(), size));
+        }, size, "bytes", [&]() { buffer.reset(); });
+        buffer.reset(createStorageBuffer(ctx.get(), data.data(), size));
+        benchmark.run("upload_" + sizeStr, [&]() {
+            buffer->upload(data.data(), size);
+        }, size, "bytes");
+        benchmark.run("download_" + sizeStr, [&]() {
+            buffer->download(data.data(), size);
+        }, size, "bytes");
+        benchmark.run("map_" + sizeStr, [&]() {
+            buffer->map();
+            buffer->unmap();
+        }, 1, "maps");
+    }
+    return benchmark.finish();
+}
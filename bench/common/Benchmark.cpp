@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/core/FileUtil.h"
+#include "ngfx/core/FrameStats.h"
+#include <chrono>
+#include <ctime>
+using namespace ngfx;
+using namespace std;
+using json = nlohmann::json;
+
+Benchmark::Benchmark(const string& suiteName, int argc, char** argv) : suiteName(suiteName) {
+    for (int j = 1; j < argc; j++) {
+        string arg = argv[j];
+        auto nextArg = [&]() -> string {
+            if (j + 1 >= argc)
+                NGFX_ERR("missing value for %s", arg.c_str());
+            return argv[++j];
+        };
+        if (arg == "--filter")
+            filter = nextArg();
+        else if (arg == "--warmup")
+            warmup = uint32_t(stoul(nextArg()));
+        else if (arg == "--repetitions")
+            repetitions = uint32_t(stoul(nextArg()));
+        else if (arg == "--quick") {
+            warmup = 1;
+            repetitions = 3;
+        }
+        else if (arg == "--json")
+            jsonFile = nextArg();
+        else
+            NGFX_ERR("unknown option: %s", arg.c_str());
+    }
+    if (repetitions == 0)
+        NGFX_ERR("the number of repetitions must be at least 1");
+}
+
+bool Benchmark::isEnabled(const string& name) const {
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+void Benchmark::run(const string& name, function<void()> fn, double numItems,
+        const string& itemUnit, function<void()> setup) {
+    if (!isEnabled(name))
+        return;
+    for (uint32_t j = 0; j < warmup; j++) {
+        if (setup)
+            setup();
+        fn();
+    }
+    FrameStats stats(repetitions);
+    for (uint32_t j = 0; j < repetitions; j++) {
+        if (setup)
+            setup();
+        auto t0 = chrono::steady_clock::now();
+        fn();
+        auto t1 = chrono::steady_clock::now();
+        stats.add(chrono::duration<double, milli>(t1 - t0).count());
+    }
+    FrameStats::Summary summary = stats.getSummary();
+    json result = {
+        { "name", suiteName + "/" + name },
+        { "repetitions", summary.numSamples },
+        { "min_ms", summary.min }, { "avg_ms", summary.avg }, { "p50_ms", summary.p50 },
+        { "p95_ms", summary.p95 }, { "max_ms", summary.max }
+    };
+    string throughput;
+    //the throughput is computed from the median, which is robust to outliers
+    if (numItems > 0.0 && summary.p50 > 0.0) {
+        double itemsPerSecond = numItems * 1000.0 / summary.p50;
+        result["items_per_second"] = itemsPerSecond;
+        result["item_unit"] = itemUnit;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "  %10.4g %s/s", itemsPerSecond, itemUnit.c_str());
+        throughput = buffer;
+    }
+    NGFX_LOG("%-40s p50 %9.3f ms  min %9.3f ms  p95 %9.3f ms%s", result["name"].get<string>().c_str(),
+        summary.p50, summary.min, summary.p95, throughput.c_str());
+    results.push_back(result);
+}
+
+int Benchmark::finish() {
+    if (jsonFile.empty())
+        return 0;
+    char date[32];
+    time_t t = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+    json report = {
+        { "context", { { "suite", suiteName }, { "date", date },
+            { "warmup", warmup }, { "repetitions", repetitions } } },
+        { "benchmarks", results }
+    };
+    FileUtil::writeFile(jsonFile, report.dump(2));
+    return 0;
+}
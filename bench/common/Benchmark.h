@@ -0,0 +1,64 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <json.hpp>
+#include <string>
+
+namespace ngfx {
+/** \class Benchmark
+ *
+ *  A minimal benchmark harness.  Each case runs a few untimed warm-up iterations,
+ *  then it's timed over a number of repetitions, and the summary statistics are
+ *  printed and optionally written to a JSON file.
+ *
+ *  Command line options:
+ *    --filter <substring>  Only run the cases whose name contains the substring
+ *    --warmup <n>          The number of warm-up iterations (default 3)
+ *    --repetitions <n>     The number of timed repetitions (default 20)
+ *    --quick               One warm-up iteration and 3 repetitions, e.g. for a CI smoke test
+ *    --json <file>         Write the results to a JSON file
+ */
+class Benchmark {
+public:
+    Benchmark(const std::string& suiteName, int argc, char** argv);
+    /** Run a benchmark case
+     *  @param name The case name
+     *  @param fn The timed function
+     *  @param numItems The number of items processed by each call to fn, to report the throughput (optional)
+     *  @param itemUnit The item unit, e.g. "bytes" or "draws"
+     *  @param setup An untimed function called before each call to fn (optional)
+     */
+    void run(const std::string& name, std::function<void()> fn, double numItems = 0.0,
+        const std::string& itemUnit = "", std::function<void()> setup = nullptr);
+    /** Check if the filter selects a case, e.g. to skip an expensive setup */
+    bool isEnabled(const std::string& name) const;
+    /** Write the JSON file
+     *  @return The process exit code */
+    int finish();
+    std::string suiteName, filter, jsonFile;
+    uint32_t warmup = 3, repetitions = 20;
+
+private:
+    nlohmann::json results = nlohmann::json::array();
+};
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/compute/ComputeUtil.h"
+#include "ngfx/computeOps/ColorspaceConversionGPUOp.h"
+#include "ngfx/computeOps/ConvolveGPUOp.h"
+#include "ngfx/computeOps/LensCorrectionGPUOp.h"
+#include "ngfx/computeOps/MatrixMultiplyCPUOp.h"
+#include "ngfx/computeOps/MatrixMultiplyGPUOp.h"
+#include "ngfx/graphics/BufferUtil.h"
+#include "ngfx/graphics/GraphicsContext.h"
+#include "ngfx/graphics/Texture.h"
+#include <memory>
+#include <vector>
+using namespace ngfx;
+using namespace ngfx::ComputeUtil;
+using namespace std;
+using namespace glm;
+
+// The image size is kept small enough for a software rasterizer
+static const int W = 1280, H = 720;
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("compute", argc, argv);
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("bench_compute", false, false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics(Graphics::create(ctx.get()));
+    //includes the submission and synchronization overhead
+    auto applyGPU = [&](ComputeOp* op) {
+        auto commandBuffer = ctx->computeCommandBuffer();
+        commandBuffer->begin();
+        op->apply(commandBuffer, graphics.get());
+        commandBuffer->end();
+        ctx->submit(commandBuffer);
+        ctx->queue->waitIdle();
+    };
+
+    //matrix multiply
+    using MatrixParam = MatrixMultiplyOp::MatrixParam;
+    const uint32_t DIM = 256;
+    const double numOps = 2.0 * DIM * DIM * DIM;
+    vector<float> src0Data(DIM * DIM), src1Data(DIM * DIM), dstData(DIM * DIM);
+    for (uint32_t j = 0; j < DIM * DIM; j++) {
+        src0Data[j] = (rand() % 1024) / 1024.0f;
+        src1Data[j] = (rand() % 1024) / 1024.0f;
+    }
+    MatrixParam src0 = { DIM, DIM, src0Data.data() }, src1 = { DIM, DIM, src1Data.data() };
+    auto matrixMultiplyCPUOp = make_unique<MatrixMultiplyCPUOp>(src0, src1, MatrixParam{ DIM, DIM, dstData.data() });
+    benchmark.run("matrix_multiply_cpu", [&]() { matrixMultiplyCPUOp->apply(); }, numOps, "flops");
+    auto matrixMultiplyGPUOp = make_unique<MatrixMultiplyGPUOp>(ctx.get(), src0, src1,
+        MatrixParam{ DIM, DIM, nullptr }, graphics.get());
+    benchmark.run("matrix_multiply_gpu", [&]() { applyGPU(matrixMultiplyGPUOp.get()); }, numOps, "flops");
+
+    //5x5 box blur
+    vector<u8vec4> srcImage(W * H), dstImage(W * H);
+    for (auto& v : srcImage)
+        v = u8vec4(rand() % 256, rand() % 256, rand() % 256, 255);
+    vector<float> kernelData(25, 1.0f / 25.0f);
+    kernel_t kernel = { kernelData.data(), 5, 5 };
+    const double numPixels = double(W) * H;
+    image_t src = { srcImage.data(), W, H }, dst = { dstImage.data(), W, H };
+    benchmark.run("convolve_5x5_cpu", [&]() { convolve(src, dst, kernel); }, numPixels, "pixels");
+    const uint32_t imageSize = W * H * 4;
+    unique_ptr<Texture> srcTexture(Texture::create(ctx.get(), graphics.get(), srcImage.data(),
+        PIXELFORMAT_RGBA8_UNORM, imageSize, W, H, 1, 1,
+        ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_DST_BIT)));
+    unique_ptr<Texture> dstTexture(Texture::create(ctx.get(), graphics.get(), nullptr,
+        PIXELFORMAT_RGBA8_UNORM, imageSize, W, H, 1, 1,
+        ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT)));
+    auto convolveGPUOp = make_unique<ConvolveGPUOp>(ctx.get(), graphics.get());
+    convolveGPUOp->update(srcTexture.get(), dstTexture.get(), kernel);
+    benchmark.run("convolve_5x5_gpu", [&]() { applyGPU(convolveGPUOp.get()); }, numPixels, "pixels");
+
+    //lens correction
+    lens_t lens = { LENS_MODEL_BROWN_CONRADY, 1000.0f, 1000.0f, (W - 1) * 0.5f, (H - 1) * 0.5f,
+        { -0.28f, 0.07f, 0.0f, 0.0f }, { 0.001f, -0.0005f }, 1.0f };
+    vector<vec2> lut(W * H);
+    benchmark.run("lens_lut_cpu", [&]() { computeLensLUT(lens, W, H, W, H, lut.data()); }, numPixels, "pixels");
+    benchmark.run("remap_bicubic_cpu", [&]() {
+        remap(src, dst, lut.data(), REMAP_FILTER_BICUBIC);
+    }, numPixels, "pixels");
+    auto lensCorrectionGPUOp = make_unique<LensCorrectionGPUOp>(ctx.get(), graphics.get(),
+        srcTexture.get(), dstTexture.get(), lens, REMAP_FILTER_BICUBIC);
+    benchmark.run("remap_bicubic_gpu", [&]() { applyGPU(lensCorrectionGPUOp.get()); }, numPixels, "pixels");
+
+    //NV12 to RGB
+    colorspace_t colorspace = { YUV_LAYOUT_NV12, 8, COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED, TRANSFER_FUNCTION_NONE };
+    uint32_t yuvSize = getYUVImageSize(W, H, colorspace);
+    vector<uint8_t> yuv(yuvSize);
+    for (auto& v : yuv)
+        v = uint8_t(16 + rand() % 220);
+    vector<vec4> rgb(W * H);
+    benchmark.run("yuv_to_rgb_cpu", [&]() {
+        convertYUVToRGB({ yuv.data(), W, H }, { rgb.data(), W, H }, colorspace);
+    }, numPixels, "pixels");
+    unique_ptr<Buffer> bYUV(createStorageBuffer(ctx.get(), yuv.data(), yuvSize));
+    auto yuvToRGBOp = make_unique<ColorspaceConversionGPUOp>(ctx.get(),
+        ColorspaceConversionGPUOp::DIRECTION_YUV_TO_RGB, bYUV.get(), W, H, colorspace);
+    benchmark.run("yuv_to_rgb_gpu", [&]() { applyGPU(yuvToRGBOp.get()); }, numPixels, "pixels");
+    return benchmark.finish();
+}
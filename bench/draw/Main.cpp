@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/drawOps/DrawColorOp.h"
+#include "ngfx/drawOps/DrawTextureOp.h"
+#include "ngfx/graphics/FilterOp.h"
+#include "ngfx/graphics/GraphicsContext.h"
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace ngfx;
+using namespace std;
+using namespace glm;
+
+static const uint32_t NUM_DRAWS = 1000, NUM_RESOURCES = 16;
+static const vector<vec2> quad = { vec2(-1, 1), vec2(-1, -1), vec2(1, 1), vec2(1, -1) };
+
+// Record commands into an offscreen render pass
+class RecordOp : public FilterOp {
+public:
+    using OnDraw = function<void(CommandBuffer*, Graphics*)>;
+    RecordOp(GraphicsContext* ctx, Graphics* graphics, uint32_t w, uint32_t h)
+        : FilterOp(ctx, graphics, w, h) {}
+    void draw(CommandBuffer* commandBuffer, Graphics* graphics) override {
+        onDraw(commandBuffer, graphics);
+    }
+    OnDraw onDraw;
+};
+
+// Bind a different uniform buffer before each draw
+class UniformBindingOp : public DrawColorOp {
+public:
+    UniformBindingOp(GraphicsContext* ctx) : DrawColorOp(ctx, quad, vec4(1.0f)) {
+        for (uint32_t j = 0; j < NUM_RESOURCES; j++) {
+            vec4 color(float(j) / NUM_RESOURCES, 0.0f, 0.0f, 1.0f);
+            ubos.emplace_back(createUniformBuffer(ctx, &color, sizeof(color)));
+        }
+    }
+    void bind(CommandBuffer* commandBuffer, Graphics* graphics, uint32_t numBindings) {
+        graphics->bindGraphicsPipeline(commandBuffer, graphicsPipeline);
+        for (uint32_t j = 0; j < numBindings; j++)
+            graphics->bindUniformBuffer(commandBuffer, ubos[j % NUM_RESOURCES].get(), U_UBO,
+                SHADER_STAGE_FRAGMENT_BIT);
+    }
+    vector<unique_ptr<Buffer>> ubos;
+};
+
+// Bind a different texture before each draw
+class TextureBindingOp : public DrawTextureOp {
+public:
+    TextureBindingOp(GraphicsContext* ctx, const vector<Texture*>& textures)
+        : DrawTextureOp(ctx, textures[0]), textures(textures) {}
+    void bind(CommandBuffer* commandBuffer, Graphics* graphics, uint32_t numBindings) {
+        graphics->bindGraphicsPipeline(commandBuffer, graphicsPipeline);
+        for (uint32_t j = 0; j < numBindings; j++)
+            graphics->bindTexture(commandBuffer, textures[j % textures.size()], U_TEXTURE);
+    }
+    vector<Texture*> textures;
+};
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("draw", argc, argv);
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("bench_draw", false, false));
+    unique_ptr<Surface> surface(new Surface(256, 256, true));
+    ctx->setSurface(surface.get());
+    unique_ptr<Graphics> graphics(Graphics::create(ctx.get()));
+    auto recordOp = make_unique<RecordOp>(ctx.get(), graphics.get(), 256, 256);
+    auto commandBuffer = ctx->drawCommandBuffer();
+    auto record = [&](RecordOp::OnDraw onDraw) {
+        recordOp->onDraw = onDraw;
+        commandBuffer->begin();
+        recordOp->apply(ctx.get(), commandBuffer, graphics.get());
+        commandBuffer->end();
+    };
+    auto submit = [&]() {
+        ctx->queue->submit(commandBuffer);
+        ctx->queue->waitIdle();
+    };
+
+    vector<unique_ptr<DrawColorOp>> colorOps;
+    for (uint32_t j = 0; j < NUM_RESOURCES; j++)
+        colorOps.emplace_back(new DrawColorOp(ctx.get(), quad, vec4(float(j) / NUM_RESOURCES, 0, 0, 1)));
+    //each draw op binds its pipeline and resources
+    auto drawOps = [&](CommandBuffer* commandBuffer, Graphics* graphics) {
+        for (uint32_t j = 0; j < NUM_DRAWS; j++)
+            colorOps[j % NUM_RESOURCES]->draw(commandBuffer, graphics);
+    };
+    benchmark.run("record_draw_ops", [&]() { record(drawOps); }, NUM_DRAWS, "draws");
+    benchmark.run("record_submit_draw_ops", [&]() {
+        record(drawOps);
+        submit();
+    }, NUM_DRAWS, "draws");
+    //the state is bound once, only the draw calls are recorded
+    benchmark.run("record_draws", [&]() {
+        record([&](CommandBuffer* commandBuffer, Graphics* graphics) {
+            colorOps[0]->draw(commandBuffer, graphics);
+            for (uint32_t j = 1; j < NUM_DRAWS; j++)
+                graphics->draw(commandBuffer, 4);
+        });
+    }, NUM_DRAWS, "draws");
+
+    auto uniformBindingOp = make_unique<UniformBindingOp>(ctx.get());
+    benchmark.run("bind_uniform_buffer", [&]() {
+        record([&](CommandBuffer* commandBuffer, Graphics* graphics) {
+            uniformBindingOp->bind(commandBuffer, graphics, NUM_DRAWS);
+        });
+    }, NUM_DRAWS, "bindings");
+
+    vector<uint8_t> textureData(64 * 64 * 4, 255);
+    vector<unique_ptr<Texture>> textures;
+    vector<Texture*> texturePtrs;
+    SamplerDesc samplerDesc = {
+        FILTER_LINEAR, FILTER_LINEAR, FILTER_LINEAR, CLAMP_TO_EDGE, CLAMP_TO_EDGE, CLAMP_TO_EDGE
+    };
+    for (uint32_t j = 0; j < NUM_RESOURCES; j++) {
+        textures.emplace_back(Texture::create(ctx.get(), graphics.get(), textureData.data(),
+            PIXELFORMAT_RGBA8_UNORM, uint32_t(textureData.size()), 64, 64, 1, 1,
+            ImageUsageFlags(IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_DST_BIT),
+            TEXTURE_TYPE_2D, false, 1, &samplerDesc));
+        texturePtrs.push_back(textures.back().get());
+    }
+    auto textureBindingOp = make_unique<TextureBindingOp>(ctx.get(), texturePtrs);
+    benchmark.run("bind_texture", [&]() {
+        record([&](CommandBuffer* commandBuffer, Graphics* graphics) {
+            textureBindingOp->bind(commandBuffer, graphics, NUM_DRAWS);
+        });
+    }, NUM_DRAWS, "bindings");
+    ctx->queue->waitIdle();
+    return benchmark.finish();
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/core/FileUtil.h"
+#include "ngfx/graphics/ImageData.h"
+#include "ngfx/graphics/ImageUtil.h"
+#include "ngfx/graphics/MeshData.h"
+#include "ngfx/graphics/MeshUtil.h"
+#include <filesystem>
+#include <glm/gtc/constants.hpp>
+using namespace ngfx;
+using namespace std;
+using namespace glm;
+namespace fs = std::filesystem;
+
+// A UV sphere with 2 * rings * segments triangles
+static void createSphere(uint32_t rings, uint32_t segments, MeshData& meshData) {
+    for (uint32_t j = 0; j <= rings; j++) {
+        float theta = pi<float>() * j / rings;
+        for (uint32_t k = 0; k <= segments; k++) {
+            float phi = 2.0f * pi<float>() * k / segments;
+            vec3 n(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi));
+            meshData.pos.push_back(n);
+            meshData.normal.push_back(n);
+        }
+    }
+    for (uint32_t j = 0; j < rings; j++) {
+        for (uint32_t k = 0; k < segments; k++) {
+            int i0 = j * (segments + 1) + k, i1 = i0 + segments + 1;
+            meshData.faces.push_back(ivec3(i0, i1, i0 + 1));
+            meshData.faces.push_back(ivec3(i0 + 1, i1, i1 + 1));
+        }
+    }
+    meshData.bounds[0] = vec3(-1.0f);
+    meshData.bounds[1] = vec3(1.0f);
+}
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("media", argc, argv);
+    const fs::path tempDir = fs::path(FileUtil::tempDir()) / "ngfx_bench_media";
+    fs::create_directories(tempDir);
+
+    const string meshFile = (tempDir / "sphere.bin").string();
+    MeshData sphere;
+    createSphere(256, 512, sphere);
+    benchmark.run("mesh_export", [&]() {
+        MeshUtil::exportMesh(meshFile, sphere);
+    }, double(sphere.faces.size()), "triangles");
+    MeshUtil::exportMesh(meshFile, sphere);
+    benchmark.run("mesh_import", [&]() {
+        MeshData meshData;
+        MeshUtil::importMesh(meshFile, meshData);
+    }, double(sphere.faces.size()), "triangles");
+
+    //a smooth gradient with some noise, so the compression ratio is realistic
+    const int w = 1920, h = 1080;
+    ImageData image(w, h);
+    uint8_t* data = (uint8_t*)image.data;
+    for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++) {
+            uint8_t* p = &data[(j * w + k) * 4];
+            int noise = rand() % 16;
+            p[0] = uint8_t(k * 255 / w) ^ noise;
+            p[1] = uint8_t(j * 255 / h) ^ noise;
+            p[2] = uint8_t((j + k) * 255 / (w + h));
+            p[3] = 255;
+        }
+    }
+    const string pngFile = (tempDir / "image.png").string(), jpgFile = (tempDir / "image.jpg").string();
+    const double numPixels = double(w) * h;
+    benchmark.run("png_encode", [&]() { ImageUtil::storePNG(pngFile, image); }, numPixels, "pixels");
+    benchmark.run("jpg_encode", [&]() { ImageUtil::storeJPEG(jpgFile, image); }, numPixels, "pixels");
+    ImageUtil::storePNG(pngFile, image);
+    ImageUtil::storeJPEG(jpgFile, image);
+    benchmark.run("png_decode", [&]() {
+        ImageData imageData;
+        ImageUtil::load(pngFile, imageData);
+    }, numPixels, "pixels");
+    benchmark.run("jpg_decode", [&]() {
+        ImageData imageData;
+        ImageUtil::load(jpgFile, imageData);
+    }, numPixels, "pixels");
+    fs::remove_all(tempDir);
+    return benchmark.finish();
+}
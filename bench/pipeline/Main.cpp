@@ -0,0 +1,97 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/compute/ComputePipeline.h"
+#include "ngfx/graphics/GraphicsContext.h"
+#include "ngfx/graphics/GraphicsPipeline.h"
+#include "ngfx/graphics/ShaderModule.h"
+#include <memory>
+using namespace ngfx;
+using namespace std;
+
+struct Context {
+    Context() {
+        ctx.reset(GraphicsContext::create("bench_pipeline", false, false));
+        surface.reset(new Surface(256, 256, true));
+        ctx->setSurface(surface.get());
+    }
+    unique_ptr<GraphicsContext> ctx;
+    unique_ptr<Surface> surface;
+};
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("pipeline", argc, argv);
+    unique_ptr<Context> context;
+    unique_ptr<VertexShaderModule> vs;
+    unique_ptr<FragmentShaderModule> fs;
+    unique_ptr<ComputeShaderModule> cs;
+    unique_ptr<GraphicsPipeline> graphicsPipeline;
+    unique_ptr<ComputePipeline> computePipeline;
+    auto loadShaders = [&]() {
+        auto device = context->ctx->device;
+        vs = VertexShaderModule::create(device, NGFX_DATA_DIR "/drawTexture.vert");
+        fs = FragmentShaderModule::create(device, NGFX_DATA_DIR "/drawTexture.frag");
+        cs = ComputeShaderModule::create(device, NGFX_DATA_DIR "/convolve.comp");
+    };
+    auto createGraphicsPipeline = [&]() {
+        GraphicsPipeline::State state;
+        state.primitiveTopology = PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        auto ctx = context->ctx.get();
+        graphicsPipeline.reset(GraphicsPipeline::create(ctx, state, vs.get(), fs.get(),
+            ctx->surfaceFormat, ctx->depthStencilFormat));
+    };
+    auto createComputePipeline = [&]() {
+        computePipeline.reset(ComputePipeline::create(context->ctx.get(), cs.get()));
+    };
+    auto destroyAll = [&]() {
+        graphicsPipeline.reset();
+        computePipeline.reset();
+        vs.reset();
+        fs.reset();
+        cs.reset();
+    };
+    //cold: a new context per iteration, so the driver pipeline cache is empty
+    auto newContext = [&]() {
+        destroyAll();
+        context.reset();
+        context = make_unique<Context>();
+    };
+    benchmark.run("graphics_pipeline_cold", [&]() {
+        loadShaders();
+        createGraphicsPipeline();
+    }, 1, "pipelines", newContext);
+    benchmark.run("compute_pipeline_cold", [&]() {
+        loadShaders();
+        createComputePipeline();
+    }, 1, "pipelines", newContext);
+    //warm: the shader modules are loaded and the driver pipeline cache is primed
+    destroyAll();
+    context.reset();
+    context = make_unique<Context>();
+    benchmark.run("shader_module_load", [&]() { loadShaders(); }, 3, "modules");
+    loadShaders();
+    createGraphicsPipeline();
+    createComputePipeline();
+    benchmark.run("graphics_pipeline_warm", [&]() { createGraphicsPipeline(); }, 1, "pipelines");
+    benchmark.run("compute_pipeline_warm", [&]() { createComputePipeline(); }, 1, "pipelines");
+    destroyAll();
+    return benchmark.finish();
+}
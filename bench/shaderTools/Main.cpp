@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/core/FileUtil.h"
+#include "ngfx/graphics/ShaderTools.h"
+#include <filesystem>
+using namespace ngfx;
+using namespace std;
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("shaderTools", argc, argv);
+    const vector<string> files = {
+        NGFX_BENCH_SHADER_DIR "/drawColor.vert", NGFX_BENCH_SHADER_DIR "/drawColor.frag",
+        NGFX_BENCH_SHADER_DIR "/drawTexture.vert", NGFX_BENCH_SHADER_DIR "/drawTexture.frag",
+        NGFX_BENCH_SHADER_DIR "/convolve.comp", NGFX_BENCH_SHADER_DIR "/reduce.comp"
+    };
+    const string outDir = (fs::path(FileUtil::tempDir()) / "ngfx_bench_shaders").string();
+    ShaderTools shaderTools;
+    //the outputs are removed before each iteration, otherwise the compilation is skipped
+    auto clean = [&]() {
+        fs::remove_all(outDir);
+        fs::create_directories(outDir);
+    };
+    vector<string> spvFiles;
+    benchmark.run("compile_glsl", [&]() {
+        spvFiles = shaderTools.compileShaders(files, outDir);
+    }, double(files.size()), "shaders", clean);
+    benchmark.run("compile_glsl_defines", [&]() {
+        spvFiles = shaderTools.compileShaders(files, outDir, ShaderTools::FORMAT_GLSL,
+            { { "USE_BENCH_DEFINE", "1" } });
+    }, double(files.size()), "shaders", clean);
+    benchmark.run("generate_shader_maps", [&]() {
+        shaderTools.generateShaderMaps(files, outDir, ShaderTools::FORMAT_GLSL);
+    }, double(files.size()), "shaders", [&]() {
+        clean();
+        spvFiles = shaderTools.compileShaders(files, outDir);
+    });
+    fs::remove_all(outDir);
+    return benchmark.finish();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "bench/common/Benchmark.h"
+#include "ngfx/graphics/GraphicsContext.h"
+#include "ngfx/graphics/Texture.h"
+#include <memory>
+#include <vector>
+using namespace ngfx;
+using namespace std;
+
+int main(int argc, char** argv) {
+    Benchmark benchmark("texture", argc, argv);
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("bench_texture", false, false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics(Graphics::create(ctx.get()));
+    for (uint32_t dim : { 256u, 2048u }) {
+        const string dimStr = to_string(dim) + "x" + to_string(dim);
+        const uint32_t size = dim * dim * 4;
+        vector<uint8_t> data(size);
+        for (uint32_t j = 0; j < size; j++)
+            data[j] = uint8_t(j * 13);
+        unique_ptr<Texture> texture;
+        auto createTexture = [&](bool genMipmaps) {
+            texture.reset(Texture::create(ctx.get(), graphics.get(), data.data(), PIXELFORMAT_RGBA8_UNORM,
+                size, dim, dim, 1, 1, ImageUsageFlags(IMAGE_USAGE_SAMPLED_BIT |
+                    IMAGE_USAGE_TRANSFER_SRC_BIT | IMAGE_USAGE_TRANSFER_DST_BIT),
+                TEXTURE_TYPE_2D, genMipmaps));
+        };
+        benchmark.run("create_upload_" + dimStr, [&]() { createTexture(false); },
+            size, "bytes", [&]() { texture.reset(); });
+        benchmark.run("create_upload_mipmaps_" + dimStr, [&]() { createTexture(true); },
+            size, "bytes", [&]() { texture.reset(); });
+        createTexture(false);
+        benchmark.run("upload_" + dimStr, [&]() {
+            texture->upload(data.data(), size);
+        }, size, "bytes");
+        benchmark.run("download_" + dimStr, [&]() {
+            texture->download(data.data(), size);
+        }, size, "bytes");
+    }
+    return benchmark.finish();
+}
@@ -0,0 +1,53 @@
+precision highp float;
+#define YUV_LAYOUT_I420 0
+#define YUV_LAYOUT_NV12 1
+#define YUV_LAYOUT_YUV444 2
+#define TRANSFER_FUNCTION_NONE 0
+#define TRANSFER_FUNCTION_PQ 1
+#define TRANSFER_FUNCTION_HLG 2
+// SMPTE ST 2084 (PQ) constants
+#define PQ_M1 0.1593017578125
+#define PQ_M2 78.84375
+#define PQ_C1 0.8359375
+#define PQ_C2 18.8515625
+#define PQ_C3 18.6875
+// ARIB STD-B67 (HLG) constants
+#define HLG_A 0.17883277
+#define HLG_B 0.28466892
+#define HLG_C 0.55991073
+
+// Each thread converts a block of 8x2 pixels, so the YUV samples are
+// loaded and stored as whole 32-bit words
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (std140, set = 0, binding = 0) uniform UBO_CS {
+	// Each row holds the coefficients of the 3 input components and the offset
+	vec4 matrix[3];
+	int w, h, yuv_layout, bit_depth, transfer;
+	// The sample offsets of the U and V planes
+	int u_offset, v_offset;
+};
+
+vec4 transform(int j, vec4 x0, vec4 x1, vec4 x2) {
+	return matrix[j].x * x0 + matrix[j].y * x1 + matrix[j].z * x2 + matrix[j].w;
+}
+
+// Convert a non-linear signal in [0, 1] to linear light
+vec4 transferToLinear(vec4 v) {
+	v = clamp(v, 0.0, 1.0);
+	if (transfer == TRANSFER_FUNCTION_PQ) {
+		vec4 p = pow(v, vec4(1.0 / PQ_M2));
+		return pow(max(p - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * p), vec4(1.0 / PQ_M1));
+	}
+	return mix(v * v / 3.0, (exp((v - HLG_C) / HLG_A) + HLG_B) / 12.0, greaterThan(v, vec4(0.5)));
+}
+
+// Convert linear light in [0, 1] to a non-linear signal
+vec4 transferFromLinear(vec4 v) {
+	v = clamp(v, 0.0, 1.0);
+	if (transfer == TRANSFER_FUNCTION_PQ) {
+		vec4 p = pow(v, vec4(PQ_M1));
+		return pow((PQ_C1 + PQ_C2 * p) / (1.0 + PQ_C3 * p), vec4(PQ_M2));
+	}
+	return mix(sqrt(3.0 * v), HLG_A * log(12.0 * v - HLG_B) + HLG_C, greaterThan(v, vec4(1.0 / 12.0)));
+}
@@ -0,0 +1,75 @@
+precision highp float;
+#define WORKGROUP_SIZE 256
+#define ITEMS_PER_THREAD 4
+#define FLT_MAX 3.402823466e+38
+#define OPERATION_SUM 0
+#define OPERATION_MIN 1
+#define OPERATION_MAX 2
+
+// Each workgroup reduces WORKGROUP_SIZE * ITEMS_PER_THREAD elements of src
+// to a single element of dst
+layout (local_size_x = WORKGROUP_SIZE) in;
+
+layout (std140, set = 0, binding = 0) uniform UBO_CS {
+	int count, operation;
+};
+layout (std430, set = 1, binding = 0) readonly buffer srcBuffer {
+	float data[];
+} src;
+layout (std430, set = 2, binding = 0) buffer dstBuffer {
+	float data[];
+} dst;
+
+shared float partials[WORKGROUP_SIZE];
+
+float identity() {
+	if (operation == OPERATION_MIN) return FLT_MAX;
+	else if (operation == OPERATION_MAX) return -FLT_MAX;
+	return 0.0f;
+}
+
+float reduceOp(float a, float b) {
+	if (operation == OPERATION_MIN) return min(a, b);
+	else if (operation == OPERATION_MAX) return max(a, b);
+	return a + b;
+}
+
+#ifdef USE_SUBGROUPS
+float subgroupReduceOp(float v) {
+	if (operation == OPERATION_MIN) return subgroupMin(v);
+	else if (operation == OPERATION_MAX) return subgroupMax(v);
+	return subgroupAdd(v);
+}
+#endif
+
+void main() {
+	int lid = int(gl_LocalInvocationID.x);
+	int offset = int(gl_WorkGroupID.x) * WORKGROUP_SIZE * ITEMS_PER_THREAD + lid;
+	float v = identity();
+	for (int j = 0; j < ITEMS_PER_THREAD; j++) {
+		int i = offset + j * WORKGROUP_SIZE;
+		if (i < count) v = reduceOp(v, src.data[i]);
+	}
+#ifdef USE_SUBGROUPS
+	// Reduce within each subgroup, then reduce the partial results in the first subgroup
+	v = subgroupReduceOp(v);
+	if (subgroupElect()) partials[gl_SubgroupID] = v;
+	barrier();
+	if (gl_SubgroupID == 0u) {
+		v = identity();
+		for (uint j = gl_SubgroupInvocationID; j < gl_NumSubgroups; j += gl_SubgroupSize)
+			v = reduceOp(v, partials[j]);
+		v = subgroupReduceOp(v);
+		if (subgroupElect()) dst.data[gl_WorkGroupID.x] = v;
+	}
+#else
+	// Shared memory tree reduction
+	partials[lid] = v;
+	barrier();
+	for (int s = WORKGROUP_SIZE / 2; s > 0; s >>= 1) {
+		if (lid < s) partials[lid] = reduceOp(partials[lid], partials[lid + s]);
+		barrier();
+	}
+	if (lid == 0) dst.data[gl_WorkGroupID.x] = partials[0];
+#endif
+}
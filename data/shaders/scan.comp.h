@@ -0,0 +1,77 @@
+precision highp float;
+#define WORKGROUP_SIZE 256
+#define ITEMS_PER_THREAD 4
+
+// Each workgroup computes the prefix sum of a block of WORKGROUP_SIZE * ITEMS_PER_THREAD
+// elements of src, and writes the sum of the block to blockSums
+layout (local_size_x = WORKGROUP_SIZE) in;
+
+layout (std140, set = 0, binding = 0) uniform UBO_CS {
+	int count, exclusive;
+};
+layout (std430, set = 1, binding = 0) readonly buffer srcBuffer {
+	float data[];
+} src;
+layout (std430, set = 2, binding = 0) buffer dstBuffer {
+	float data[];
+} dst;
+layout (std430, set = 3, binding = 0) buffer blockSumsBuffer {
+	float data[];
+} blockSums;
+
+shared float partials[WORKGROUP_SIZE];
+shared float blockSum;
+
+void main() {
+	int lid = int(gl_LocalInvocationID.x);
+	// Each thread scans ITEMS_PER_THREAD consecutive elements
+	int offset = (int(gl_WorkGroupID.x) * WORKGROUP_SIZE + lid) * ITEMS_PER_THREAD;
+	float v[ITEMS_PER_THREAD];
+	float threadSum = 0.0f;
+	for (int j = 0; j < ITEMS_PER_THREAD; j++) {
+		int i = offset + j;
+		v[j] = (i < count) ? src.data[i] : 0.0f;
+		threadSum += v[j];
+	}
+	// Compute the exclusive prefix sum of the thread sums
+	float threadPrefix;
+#ifdef USE_SUBGROUPS
+	float subgroupPrefix = subgroupInclusiveAdd(threadSum);
+	if (gl_SubgroupInvocationID == gl_SubgroupSize - 1u) partials[gl_SubgroupID] = subgroupPrefix;
+	barrier();
+	if (gl_SubgroupID == 0u) {
+		float carry = 0.0f;
+		for (uint j = 0u; j < gl_NumSubgroups; j += gl_SubgroupSize) {
+			uint k = j + gl_SubgroupInvocationID;
+			float p = (k < gl_NumSubgroups) ? partials[k] : 0.0f;
+			float s = subgroupInclusiveAdd(p);
+			if (k < gl_NumSubgroups) partials[k] = carry + s - p;
+			carry += subgroupAdd(p);
+		}
+		if (subgroupElect()) blockSum = carry;
+	}
+	barrier();
+	threadPrefix = partials[gl_SubgroupID] + subgroupPrefix - threadSum;
+#else
+	// Shared memory Hillis-Steele scan
+	partials[lid] = threadSum;
+	barrier();
+	for (int s = 1; s < WORKGROUP_SIZE; s <<= 1) {
+		float p = (lid >= s) ? partials[lid - s] : 0.0f;
+		barrier();
+		partials[lid] += p;
+		barrier();
+	}
+	threadPrefix = partials[lid] - threadSum;
+	if (lid == WORKGROUP_SIZE - 1) blockSum = partials[lid];
+	barrier();
+#endif
+	float prefix = threadPrefix;
+	for (int j = 0; j < ITEMS_PER_THREAD; j++) {
+		int i = offset + j;
+		float next = prefix + v[j];
+		if (i < count) dst.data[i] = (exclusive != 0) ? prefix : next;
+		prefix = next;
+	}
+	if (lid == 0) blockSums.data[gl_WorkGroupID.x] = blockSum;
+}
@@ -21,6 +21,7 @@
 #include "ngfx/compute/ComputeApplication.h"
 #include "ngfx/core/DebugUtil.h"
 #include "ngfx/core/Timer.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/graphics/Graphics.h"
 #include <memory>
 using namespace ngfx;
@@ -43,6 +44,7 @@ void ComputeApplication::init() {
 }
 
 void ComputeApplication::recordCommandBuffer(CommandBuffer *commandBuffer) {
+  NGFX_TRACE_ZONE("record", "recordCommandBuffer");
   commandBuffer->begin();
   onRecordCommandBuffer(commandBuffer);
   commandBuffer->end();
@@ -61,6 +63,7 @@ void ComputeApplication::run() {
 void ComputeApplication::close() {}
 
 void ComputeApplication::doCompute(CommandBuffer *commandBuffer) {
+  NGFX_TRACE_ZONE("compute", "doCompute");
   Timer timer;
   graphicsContext->submit(commandBuffer);
   graphics->waitIdle(commandBuffer);
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/compute/ComputeGraph.h"
+#include "ngfx/core/DebugUtil.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+using namespace ngfx;
+using namespace std;
+
+uint32_t ComputeGraph::addNode(ComputeOp *op, const vector<Resource> &inputs,
+                               const vector<Resource> &outputs) {
+  Node node;
+  node.op = op;
+  node.inputs = inputs;
+  node.outputs = outputs;
+  nodes.emplace_back(std::move(node));
+  dirty = true;
+  return uint32_t(nodes.size() - 1);
+}
+
+void ComputeGraph::clear() {
+  nodes.clear();
+  numBranches = 0;
+  dirty = true;
+}
+
+void ComputeGraph::compile() {
+  struct ResourceState {
+    int32_t lastWriter = -1;
+    vector<uint32_t> readers;
+  };
+  map<const void *, ResourceState> resources;
+  vector<uint32_t> parent(nodes.size());
+  iota(parent.begin(), parent.end(), 0);
+  auto root = [&](uint32_t j) {
+    while (parent[j] != j)
+      j = parent[j] = parent[parent[j]];
+    return j;
+  };
+  for (uint32_t j = 0; j < nodes.size(); j++) {
+    Node &node = nodes[j];
+    node.deps.clear();
+    auto addDep = [&](int32_t k) {
+      if (k < 0 || uint32_t(k) == j)
+        return;
+      if (find(node.deps.begin(), node.deps.end(), uint32_t(k)) == node.deps.end())
+        node.deps.push_back(uint32_t(k));
+    };
+    // Read after write
+    for (const Resource &input : node.inputs) {
+      auto &state = resources[input.handle()];
+      addDep(state.lastWriter);
+      state.readers.push_back(j);
+    }
+    // Write after write and write after read
+    for (const Resource &output : node.outputs) {
+      auto &state = resources[output.handle()];
+      addDep(state.lastWriter);
+      for (uint32_t reader : state.readers)
+        addDep(reader);
+      state.lastWriter = j;
+      state.readers.clear();
+    }
+    node.level = 0;
+    for (uint32_t dep : node.deps) {
+      node.level = std::max(node.level, nodes[dep].level + 1);
+      parent[root(dep)] = root(j);
+    }
+  }
+  // Number the branches in the order of their first node
+  map<uint32_t, uint32_t> branchIndex;
+  for (uint32_t j = 0; j < nodes.size(); j++) {
+    auto it = branchIndex.emplace(root(j), uint32_t(branchIndex.size())).first;
+    nodes[j].branch = it->second;
+  }
+  numBranches = uint32_t(branchIndex.size());
+  dirty = false;
+}
+
+uint32_t ComputeGraph::getNumBranches() {
+  if (dirty)
+    compile();
+  return numBranches;
+}
+
+vector<ComputeGraph::Step> ComputeGraph::getSchedule(int32_t branch) {
+  if (dirty)
+    compile();
+  vector<uint32_t> order;
+  for (uint32_t j = 0; j < nodes.size(); j++) {
+    if (branch < 0 || nodes[j].branch == uint32_t(branch))
+      order.push_back(j);
+  }
+  stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return nodes[a].level < nodes[b].level;
+  });
+  // The accesses to each resource since the last barrier on it
+  map<const void *, ShaderAccessFlags> pendingAccess;
+  vector<Step> schedule(order.size());
+  for (uint32_t j0 = 0, j1 = 0; j0 < order.size(); j0 = j1) {
+    // Gather the accesses of the nodes at the same level, in recording order
+    vector<pair<Resource, ShaderAccessFlags>> levelAccess;
+    auto addAccess = [&](const Resource &r, ShaderAccessFlags access) {
+      auto it = find_if(levelAccess.begin(), levelAccess.end(), [&](auto &a) {
+        return a.first.handle() == r.handle();
+      });
+      if (it == levelAccess.end())
+        levelAccess.emplace_back(r, access);
+      else
+        it->second |= access;
+    };
+    for (j1 = j0; j1 < order.size() &&
+                  nodes[order[j1]].level == nodes[order[j0]].level;
+         j1++) {
+      const Node &node = nodes[order[j1]];
+      for (const Resource &input : node.inputs)
+        addAccess(input, SHADER_ACCESS_READ_BIT);
+      for (const Resource &output : node.outputs)
+        addAccess(output, SHADER_ACCESS_WRITE_BIT);
+      schedule[j1].node = order[j1];
+    }
+    // A read after read doesn't need a barrier
+    for (auto &a : levelAccess) {
+      ShaderAccessFlags &pending = pendingAccess[a.first.handle()];
+      bool hazard = (pending & SHADER_ACCESS_WRITE_BIT) ||
+                    ((a.second & SHADER_ACCESS_WRITE_BIT) &&
+                     (pending & SHADER_ACCESS_READ_BIT));
+      if (!hazard) {
+        pending |= a.second;
+        continue;
+      }
+      ResourceBarrier barrier;
+      barrier.buffer = a.first.buffer;
+      barrier.texture = a.first.texture;
+      barrier.srcAccess = pending;
+      barrier.dstAccess = a.second;
+      schedule[j0].barriers.push_back(barrier);
+      pending = a.second;
+    }
+  }
+  return schedule;
+}
+
+void ComputeGraph::record(CommandBuffer *commandBuffer, Graphics *graphics,
+                          int32_t branch) {
+  for (const Step &step : getSchedule(branch)) {
+    if (!step.barriers.empty())
+      graphics->resourceBarrier(commandBuffer, step.barriers);
+    nodes[step.node].op->apply(commandBuffer, graphics);
+  }
+}
+
+void ComputeGraph::apply(Graphics *graphics) {
+  auto commandBuffer = ctx->computeCommandBuffer();
+  commandBuffer->begin();
+  record(commandBuffer, graphics);
+  commandBuffer->end();
+  ctx->submit(commandBuffer);
+  ctx->queue->waitIdle();
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/graphics/Buffer.h"
+#include "ngfx/graphics/Graphics.h"
+#include "ngfx/graphics/Texture.h"
+#include <vector>
+
+namespace ngfx {
+
+/** \class ComputeGraph
+ *
+ *  This class records a chain of compute operations into a single command buffer.
+ *  Each node declares the buffers and textures it reads and writes, and the graph
+ *  derives the dependencies between nodes (read after write, write after write,
+ *  and write after read) in the order the nodes were added.
+ *  The nodes are scheduled by dependency level: nodes at the same level are
+ *  independent and are recorded back to back.  Between consecutive levels, a
+ *  barrier is inserted only on the resources accessed by the next level which
+ *  have a pending hazard (read after write, write after write or write after
+ *  read), and only if there is at least one such resource.
+ *  Textures are accessed as storage images, in IMAGE_LAYOUT_GENERAL.
+ *  Nodes which don't share any resources form independent branches, which can
+ *  also be recorded separately, e.g. to be submitted on a different queue.
+ */
+
+class ComputeGraph {
+public:
+  /** A resource accessed by a node: a buffer or a texture */
+  struct Resource {
+    Resource(Buffer *buffer) : buffer(buffer) {}
+    Resource(Texture *texture) : texture(texture) {}
+    const void *handle() const {
+      return buffer ? (const void *)buffer : (const void *)texture;
+    }
+    Buffer *buffer = nullptr;
+    Texture *texture = nullptr;
+  };
+  struct Node {
+    ComputeOp *op;
+    std::vector<Resource> inputs, outputs;
+    /** The indices of the nodes this node depends on */
+    std::vector<uint32_t> deps;
+    uint32_t level = 0, branch = 0;
+  };
+  /** A recorded node, preceded by the barriers on the resources it depends on.
+   *  The barriers of a level are all attached to its first node */
+  struct Step {
+    uint32_t node;
+    std::vector<ResourceBarrier> barriers;
+  };
+  ComputeGraph(GraphicsContext *ctx) : ctx(ctx) {}
+  virtual ~ComputeGraph() {}
+  /** Add a node to the graph
+   *  @param op The compute operation.  The graph doesn't take ownership
+   *  @param inputs The resources read by the operation
+   *  @param outputs The resources written by the operation
+   *  @return The node index
+   */
+  uint32_t addNode(ComputeOp *op, const std::vector<Resource> &inputs,
+                   const std::vector<Resource> &outputs);
+  /** Remove all the nodes */
+  void clear();
+  /** Get the recording order and barrier placement
+   *  @param branch The branch index, or -1 for all the branches
+   */
+  std::vector<Step> getSchedule(int32_t branch = -1);
+  /** Record the graph into a command buffer
+   *  @param commandBuffer The command buffer, in the recording state
+   *  @param graphics The graphics object
+   *  @param branch The branch index, or -1 for all the branches
+   */
+  void record(CommandBuffer *commandBuffer, Graphics *graphics,
+              int32_t branch = -1);
+  /** Record the graph into the compute command buffer, submit it and wait
+   *  until it completes */
+  void apply(Graphics *graphics);
+  /** Get the number of independent branches */
+  uint32_t getNumBranches();
+  std::vector<Node> nodes;
+
+protected:
+  void compile();
+  GraphicsContext *ctx;
+  uint32_t numBranches = 0;
+  bool dirty = true;
+};
+} // namespace ngfx
@@ -27,8 +27,16 @@ namespace ngfx {
 class GraphicsContext;
 class ComputePipeline : public Pipeline {
 public:
+  /** Create a compute pipeline
+   *  @param graphicsContext The graphics context
+   *  @param cs The compute shader module
+   *  @param specializationConstants The values of the shader specialization constants,
+   *         where element j sets the constant with constant_id = j (32-bit values).
+   *         Constants that are not specified keep the default value defined in the shader
+   */
   static ComputePipeline *create(GraphicsContext *graphicsContext,
-                                 ComputeShaderModule *cs);
+                                 ComputeShaderModule *cs,
+                                 const std::vector<uint32_t> &specializationConstants = {});
   virtual ~ComputePipeline() {}
   void getBindings(std::vector<uint32_t*> pDescriptorBindings);
   std::vector<uint32_t> descriptorBindings;
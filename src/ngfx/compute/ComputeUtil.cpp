@@ -20,9 +20,123 @@
  */
 
 #include "ngfx/compute/ComputeUtil.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 using namespace ngfx;
+using namespace ngfx::ComputeUtil;
 using namespace glm;
 
+// Number of rows processed by each task
+#define ROWS_PER_TASK 4
+// Number of floats processed per chunk, sized to keep the accumulators in the L1 cache
+#define CHUNK_SIZE 1024
+// Transpose block size, in pixels
+#define TRANSPOSE_BLOCK_SIZE 32
+
+// y[i] += a * x[i]
+static inline void axpy(float* y, const float* x, float a, int n) {
+    int i = 0;
+#if defined(__AVX512F__)
+    __m512 a0 = _mm512_set1_ps(a);
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(&y[i], _mm512_fmadd_ps(a0, _mm512_loadu_ps(&x[i]), _mm512_loadu_ps(&y[i])));
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 a0 = _mm256_set1_ps(a);
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(&y[i], _mm256_fmadd_ps(a0, _mm256_loadu_ps(&x[i]), _mm256_loadu_ps(&y[i])));
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= n; i += 4)
+#if defined(__aarch64__)
+        vst1q_f32(&y[i], vfmaq_n_f32(vld1q_f32(&y[i]), vld1q_f32(&x[i]), a));
+#else
+        vst1q_f32(&y[i], vmlaq_n_f32(vld1q_f32(&y[i]), vld1q_f32(&x[i]), a));
+#endif
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 a0 = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(a0, _mm_loadu_ps(&x[i]))));
+#endif
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+// y[i] += a * float(x[i])
+static inline void axpy(float* y, const uint8_t* x, float a, int n) {
+    int i = 0;
+#if defined(__AVX512F__)
+    __m512 a0 = _mm512_set1_ps(a);
+    for (; i + 16 <= n; i += 16) {
+        __m512 x0 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)&x[i])));
+        _mm512_storeu_ps(&y[i], _mm512_fmadd_ps(a0, x0, _mm512_loadu_ps(&y[i])));
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 a0 = _mm256_set1_ps(a);
+    for (; i + 8 <= n; i += 8) {
+        __m256 x0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&x[i])));
+        _mm256_storeu_ps(&y[i], _mm256_fmadd_ps(a0, x0, _mm256_loadu_ps(&y[i])));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t x0 = vmovl_u8(vld1_u8(&x[i]));
+        float32x4_t x1 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(x0)));
+        float32x4_t x2 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(x0)));
+        vst1q_f32(&y[i], vmlaq_n_f32(vld1q_f32(&y[i]), x1, a));
+        vst1q_f32(&y[i + 4], vmlaq_n_f32(vld1q_f32(&y[i + 4]), x2, a));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 a0 = _mm_set1_ps(a);
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i x0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&x[i]), zero);
+        __m128 x1 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(x0, zero));
+        __m128 x2 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(x0, zero));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(a0, x1)));
+        _mm_storeu_ps(&y[i + 4], _mm_add_ps(_mm_loadu_ps(&y[i + 4]), _mm_mul_ps(a0, x2)));
+    }
+#endif
+    for (; i < n; i++)
+        y[i] += a * float(x[i]);
+}
+
+// Convert to 8 bit, clamping to [0, 255] and truncating like imageStore
+static inline void storeU8(uint8_t* dst, const float* src, int n) {
+    int i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t maxValue = vdupq_n_f32(255.0f);
+    for (; i + 8 <= n; i += 8) {
+        // vcvtq_u32_f32 saturates negative values to 0
+        uint32x4_t v0 = vcvtq_u32_f32(vminq_f32(vld1q_f32(&src[i]), maxValue));
+        uint32x4_t v1 = vcvtq_u32_f32(vminq_f32(vld1q_f32(&src[i + 4]), maxValue));
+        vst1_u8(&dst[i], vmovn_u16(vcombine_u16(vmovn_u32(v0), vmovn_u32(v1))));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 minValue = _mm_setzero_ps(), maxValue = _mm_set1_ps(255.0f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[4];
+        for (int j = 0; j < 4; j++)
+            v[j] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[i + j * 4]), minValue), maxValue));
+        __m128i v0 = _mm_packs_epi32(v[0], v[1]), v1 = _mm_packs_epi32(v[2], v[3]);
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(v0, v1));
+    }
+#endif
+    for (; i < n; i++)
+        dst[i] = uint8_t(std::min(std::max(src[i], 0.0f), 255.0f));
+}
+
+// Copy a row of pixels, replicating the edge pixels: dst[j] = src[clamp(j - offset, 0, srcW - 1)]
+template <typename T>
+static inline void padRow(T* dst, const T* src, int srcW, int offset, int n) {
+    for (int j = 0; j < n; j++)
+        dst[j] = src[clamp(j - offset, 0, srcW - 1)];
+}
+
 vec4 ComputeUtil::imageLoad(image_t src, ivec2 coord) {
     int x = clamp(coord.x, 0, src.w - 1);
     int y = clamp(coord.y, 0, src.h - 1);
@@ -35,7 +149,69 @@ void ComputeUtil::imageStore(image_t dst, ivec2 coord, vec4 v) {
     *dstPtr = u8vec4(v * 255.0f);
 }
 
-void ComputeUtil::convolve(image_t src, image_t dst, kernel_t kernel) {
+void ComputeUtil::convolve(image_t src, image_t dst, kernel_t kernel, ThreadPool* threadPool) {
+    std::vector<float> kernelX, kernelY;
+    bool separable = true;
+    if (kernel.h == 1) {
+        kernelX.assign(kernel.data, kernel.data + kernel.w);
+        kernelY = { 1.0f };
+    }
+    else if (kernel.w == 1) {
+        kernelX = { 1.0f };
+        kernelY.assign(kernel.data, kernel.data + kernel.h);
+    }
+    else separable = separateKernel(kernel, kernelX, kernelY);
+    // The input is in [0, 255] and the output is truncated to 8 bit, so the
+    // kernel is applied without rescaling
+    int kw2 = kernel.w / 2, kh2 = kernel.h / 2, padW = dst.w + kernel.w - 1;
+    uint32_t numTasks = (dst.h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        std::vector<vec4> acc(std::max(src.w, dst.w)), accPadded, dstRow(dst.w);
+        std::vector<u8vec4> srcPadded;
+        if (separable) accPadded.resize(padW);
+        else srcPadded.resize(padW);
+        int j0 = task * ROWS_PER_TASK, j1 = std::min(j0 + ROWS_PER_TASK, dst.h);
+        for (int j = j0; j < j1; j++) {
+            float* dstData = &dstRow[0].x;
+            memset(dstData, 0, dst.w * sizeof(vec4));
+            if (separable) {
+                // Vertical pass
+                float* accData = &acc[0].x;
+                memset(accData, 0, src.w * sizeof(vec4));
+                for (int x0 = 0; x0 < src.w * 4; x0 += CHUNK_SIZE) {
+                    int n = std::min(CHUNK_SIZE, src.w * 4 - x0);
+                    for (int i0 = 0; i0 < kernel.h; i0++) {
+                        int y = clamp(j + i0 - kh2, 0, src.h - 1);
+                        axpy(&accData[x0], (const uint8_t*)&src.data[y * src.w] + x0, kernelY[i0], n);
+                    }
+                }
+                // Horizontal pass
+                padRow(accPadded.data(), acc.data(), src.w, kw2, padW);
+                const float* srcData = &accPadded[0].x;
+                for (int x0 = 0; x0 < dst.w * 4; x0 += CHUNK_SIZE) {
+                    int n = std::min(CHUNK_SIZE, dst.w * 4 - x0);
+                    for (int i1 = 0; i1 < kernel.w; i1++)
+                        axpy(&dstData[x0], &srcData[i1 * 4 + x0], kernelX[i1], n);
+                }
+            }
+            else {
+                for (int i0 = 0; i0 < kernel.h; i0++) {
+                    int y = clamp(j + i0 - kh2, 0, src.h - 1);
+                    padRow(srcPadded.data(), &src.data[y * src.w], src.w, kw2, padW);
+                    const uint8_t* srcData = (const uint8_t*)srcPadded.data();
+                    for (int x0 = 0; x0 < dst.w * 4; x0 += CHUNK_SIZE) {
+                        int n = std::min(CHUNK_SIZE, dst.w * 4 - x0);
+                        for (int i1 = 0; i1 < kernel.w; i1++)
+                            axpy(&dstData[x0], &srcData[i1 * 4 + x0], kernel.data[i0 * kernel.w + i1], n);
+                    }
+                }
+            }
+            storeU8((uint8_t*)&dst.data[j * dst.w], dstData, dst.w * 4);
+        }
+    });
+}
+
+void ComputeUtil::convolveReference(image_t src, image_t dst, kernel_t kernel) {
     int kw2 = kernel.w / 2, kh2 = kernel.h / 2;
     for (int j = 0; j < dst.h; j++) {
         for (int k = 0; k < dst.w; k++) {
@@ -51,7 +227,93 @@ void ComputeUtil::convolve(image_t src, image_t dst, kernel_t kernel) {
     }
 }
 
-void ComputeUtil::transpose(image_t src, image_t dst) {
+bool ComputeUtil::separateKernel(kernel_t kernel, std::vector<float>& kernelX,
+        std::vector<float>& kernelY, float epsilon) {
+    // Use the element with the largest magnitude as the pivot
+    int p0 = 0, p1 = 0;
+    float maxValue = 0.0f;
+    for (int i0 = 0; i0 < kernel.h; i0++) {
+        for (int i1 = 0; i1 < kernel.w; i1++) {
+            float v = fabs(kernel.data[i0 * kernel.w + i1]);
+            if (v > maxValue) {
+                maxValue = v;
+                p0 = i0; p1 = i1;
+            }
+        }
+    }
+    if (maxValue == 0.0f)
+        return false;
+    float pivot = kernel.data[p0 * kernel.w + p1];
+    kernelX.resize(kernel.w);
+    kernelY.resize(kernel.h);
+    for (int i1 = 0; i1 < kernel.w; i1++)
+        kernelX[i1] = kernel.data[p0 * kernel.w + i1];
+    for (int i0 = 0; i0 < kernel.h; i0++)
+        kernelY[i0] = kernel.data[i0 * kernel.w + p1] / pivot;
+    // The kernel is separable if it's equal to the outer product
+    for (int i0 = 0; i0 < kernel.h; i0++) {
+        for (int i1 = 0; i1 < kernel.w; i1++) {
+            float v = kernelY[i0] * kernelX[i1];
+            if (fabs(v - kernel.data[i0 * kernel.w + i1]) > epsilon * maxValue)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Transpose a 4x4 block of pixels
+static inline void transpose4x4(const u8vec4* src, int srcStride, u8vec4* dst, int dstStride) {
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128 r0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&src[0])),
+        r1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&src[srcStride])),
+        r2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&src[2 * srcStride])),
+        r3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&src[3 * srcStride]));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_si128((__m128i*)&dst[0], _mm_castps_si128(r0));
+    _mm_storeu_si128((__m128i*)&dst[dstStride], _mm_castps_si128(r1));
+    _mm_storeu_si128((__m128i*)&dst[2 * dstStride], _mm_castps_si128(r2));
+    _mm_storeu_si128((__m128i*)&dst[3 * dstStride], _mm_castps_si128(r3));
+#elif defined(__ARM_NEON)
+    uint32x4_t r0 = vld1q_u32((const uint32_t*)&src[0]),
+        r1 = vld1q_u32((const uint32_t*)&src[srcStride]),
+        r2 = vld1q_u32((const uint32_t*)&src[2 * srcStride]),
+        r3 = vld1q_u32((const uint32_t*)&src[3 * srcStride]);
+    uint32x4x2_t t0 = vtrnq_u32(r0, r1), t1 = vtrnq_u32(r2, r3);
+    vst1q_u32((uint32_t*)&dst[0], vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0])));
+    vst1q_u32((uint32_t*)&dst[dstStride], vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1])));
+    vst1q_u32((uint32_t*)&dst[2 * dstStride], vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0])));
+    vst1q_u32((uint32_t*)&dst[3 * dstStride], vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1])));
+#else
+    for (int j = 0; j < 4; j++)
+        for (int k = 0; k < 4; k++)
+            dst[j * dstStride + k] = src[k * srcStride + j];
+#endif
+}
+
+void ComputeUtil::transpose(image_t src, image_t dst, ThreadPool* threadPool) {
+    // Each task transposes a row of blocks of dst
+    uint32_t numTasks = (dst.h + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        int j0 = task * TRANSPOSE_BLOCK_SIZE, j1 = std::min(j0 + TRANSPOSE_BLOCK_SIZE, dst.h);
+        for (int k0 = 0; k0 < dst.w; k0 += TRANSPOSE_BLOCK_SIZE) {
+            int k1 = std::min(k0 + TRANSPOSE_BLOCK_SIZE, dst.w);
+            int j = j0;
+            for (; j + 4 <= j1; j += 4) {
+                int k = k0;
+                for (; k + 4 <= k1; k += 4)
+                    transpose4x4(&src.data[k * src.w + j], src.w, &dst.data[j * dst.w + k], dst.w);
+                for (; k < k1; k++)
+                    for (int i = 0; i < 4; i++)
+                        dst.data[(j + i) * dst.w + k] = src.data[k * src.w + j + i];
+            }
+            for (; j < j1; j++)
+                for (int k = k0; k < k1; k++)
+                    dst.data[j * dst.w + k] = src.data[k * src.w + j];
+        }
+    });
+}
+
+void ComputeUtil::transposeReference(image_t src, image_t dst) {
     for (int j = 0; j < dst.h; j++) {
         for (int k = 0; k < dst.w; k++) {
             u8vec4* dstPtr = &dst.data[j * (dst.w) + k];
@@ -60,3 +322,352 @@ void ComputeUtil::transpose(image_t src, image_t dst) {
         }
     }
 }
+
+// y_i = m_i.x * x0 + m_i.y * x1 + m_i.z * x2 + m_i.w, for i in [0, 3)
+static inline void transform3(const vec4* m, const float* x0, const float* x1, const float* x2,
+        float* y0, float* y1, float* y2, int n) {
+    int i = 0;
+    float* y[3] = { y0, y1, y2 };
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        __m256 a0 = _mm256_loadu_ps(&x0[i]), a1 = _mm256_loadu_ps(&x1[i]), a2 = _mm256_loadu_ps(&x2[i]);
+        for (int j = 0; j < 3; j++) {
+            __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[j].x), a0), _mm256_mul_ps(_mm256_set1_ps(m[j].y), a1));
+            v = _mm256_add_ps(_mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(m[j].z), a2)), _mm256_set1_ps(m[j].w));
+            _mm256_storeu_ps(&y[j][i], v);
+        }
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t a0 = vld1q_f32(&x0[i]), a1 = vld1q_f32(&x1[i]), a2 = vld1q_f32(&x2[i]);
+        for (int j = 0; j < 3; j++) {
+            float32x4_t v = vmlaq_n_f32(vmulq_n_f32(a0, m[j].x), a1, m[j].y);
+            v = vaddq_f32(vmlaq_n_f32(v, a2, m[j].z), vdupq_n_f32(m[j].w));
+            vst1q_f32(&y[j][i], v);
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 4 <= n; i += 4) {
+        __m128 a0 = _mm_loadu_ps(&x0[i]), a1 = _mm_loadu_ps(&x1[i]), a2 = _mm_loadu_ps(&x2[i]);
+        for (int j = 0; j < 3; j++) {
+            __m128 v = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[j].x), a0), _mm_mul_ps(_mm_set1_ps(m[j].y), a1));
+            v = _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(m[j].z), a2)), _mm_set1_ps(m[j].w));
+            _mm_storeu_ps(&y[j][i], v);
+        }
+    }
+#endif
+    for (; i < n; i++)
+        for (int j = 0; j < 3; j++)
+            y[j][i] = m[j].x * x0[i] + m[j].y * x1[i] + m[j].z * x2[i] + m[j].w;
+}
+
+// Load n samples: dst[i] = src[offset + i * stride]
+static inline void loadSamples(const void* src, int bitDepth, size_t offset, int stride, float* dst, int n) {
+    if (bitDepth <= 8) {
+        const uint8_t* s = (const uint8_t*)src + offset;
+        for (int i = 0; i < n; i++)
+            dst[i] = float(s[i * stride]);
+    }
+    else {
+        const uint16_t* s = (const uint16_t*)src + offset;
+        for (int i = 0; i < n; i++)
+            dst[i] = float(s[i * stride]);
+    }
+}
+
+// Store n samples, rounding to the nearest integer and clamping: dst[offset + i * stride] = src[i]
+static inline void storeSamples(void* dst, int bitDepth, size_t offset, int stride, const float* src, int n) {
+    float maxValue = float((1 << bitDepth) - 1);
+    if (bitDepth <= 8) {
+        uint8_t* d = (uint8_t*)dst + offset;
+        for (int i = 0; i < n; i++)
+            d[i * stride] = uint8_t(std::min(std::max(floorf(src[i] + 0.5f), 0.0f), maxValue));
+    }
+    else {
+        uint16_t* d = (uint16_t*)dst + offset;
+        for (int i = 0; i < n; i++)
+            d[i * stride] = uint16_t(std::min(std::max(floorf(src[i] + 0.5f), 0.0f), maxValue));
+    }
+}
+
+// SMPTE ST 2084 (PQ) constants
+#define PQ_M1 0.1593017578125f
+#define PQ_M2 78.84375f
+#define PQ_C1 0.8359375f
+#define PQ_C2 18.8515625f
+#define PQ_C3 18.6875f
+// ARIB STD-B67 (HLG) constants
+#define HLG_A 0.17883277f
+#define HLG_B 0.28466892f
+#define HLG_C 0.55991073f
+
+// Convert a non-linear signal in [0, 1] to linear light
+static inline float transferToLinear(float v, TransferFunction transfer) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    if (transfer == TRANSFER_FUNCTION_PQ) {
+        float p = powf(v, 1.0f / PQ_M2);
+        return powf(std::max(p - PQ_C1, 0.0f) / (PQ_C2 - PQ_C3 * p), 1.0f / PQ_M1);
+    }
+    if (v <= 0.5f)
+        return v * v / 3.0f;
+    return (expf((v - HLG_C) / HLG_A) + HLG_B) / 12.0f;
+}
+
+// Convert linear light in [0, 1] to a non-linear signal
+static inline float transferFromLinear(float v, TransferFunction transfer) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    if (transfer == TRANSFER_FUNCTION_PQ) {
+        float p = powf(v, PQ_M1);
+        return powf((PQ_C1 + PQ_C2 * p) / (1.0f + PQ_C3 * p), PQ_M2);
+    }
+    if (v <= 1.0f / 12.0f)
+        return sqrtf(3.0f * v);
+    return HLG_A * logf(12.0f * v - HLG_B) + HLG_C;
+}
+
+static void getColorMatrixCoefficients(ColorMatrix matrix, float& kr, float& kb) {
+    switch (matrix) {
+    case COLOR_MATRIX_BT601: kr = 0.299f; kb = 0.114f; break;
+    case COLOR_MATRIX_BT709: kr = 0.2126f; kb = 0.0722f; break;
+    case COLOR_MATRIX_BT2020: kr = 0.2627f; kb = 0.0593f; break;
+    }
+}
+
+// Get the offset and scale mapping the luma and chroma samples to [0, 1] and [-0.5, 0.5]
+static void getSampleRange(const colorspace_t& colorspace, float& yOffset, float& yScale,
+        float& cOffset, float& cScale) {
+    float s = float(1 << (colorspace.bitDepth - 8));
+    if (colorspace.range == COLOR_RANGE_FULL) {
+        yOffset = 0.0f;
+        yScale = cScale = float((1 << colorspace.bitDepth) - 1);
+    }
+    else {
+        yOffset = 16.0f * s;
+        yScale = 219.0f * s;
+        cScale = 224.0f * s;
+    }
+    cOffset = 128.0f * s;
+}
+
+uint32_t ComputeUtil::getYUVImageSize(int w, int h, const colorspace_t& colorspace) {
+    uint32_t bytesPerSample = (colorspace.bitDepth <= 8) ? 1 : 2;
+    uint32_t numSamples = (colorspace.layout == YUV_LAYOUT_YUV444) ? w * h * 3 : w * h * 3 / 2;
+    return numSamples * bytesPerSample;
+}
+
+void ComputeUtil::getYUVToRGBMatrix(const colorspace_t& colorspace, vec4 matrix[3]) {
+    float kr, kb, yOffset, yScale, cOffset, cScale;
+    getColorMatrixCoefficients(colorspace.matrix, kr, kb);
+    getSampleRange(colorspace, yOffset, yScale, cOffset, cScale);
+    float kg = 1.0f - kr - kb;
+    // R'G'B' as a function of Y, Pb and Pr
+    float m[3][3] = {
+        { 1.0f, 0.0f, 2.0f * (1.0f - kr) },
+        { 1.0f, -2.0f * kb * (1.0f - kb) / kg, -2.0f * kr * (1.0f - kr) / kg },
+        { 1.0f, 2.0f * (1.0f - kb), 0.0f }
+    };
+    for (int j = 0; j < 3; j++) {
+        float cy = m[j][0] / yScale, cu = m[j][1] / cScale, cv = m[j][2] / cScale;
+        matrix[j] = vec4(cy, cu, cv, -(cy * yOffset + cu * cOffset + cv * cOffset));
+    }
+}
+
+void ComputeUtil::getRGBToYUVMatrix(const colorspace_t& colorspace, vec4 matrix[3]) {
+    float kr, kb, yOffset, yScale, cOffset, cScale;
+    getColorMatrixCoefficients(colorspace.matrix, kr, kb);
+    getSampleRange(colorspace, yOffset, yScale, cOffset, cScale);
+    float kg = 1.0f - kr - kb;
+    // Y = kr R' + kg G' + kb B', Pb = (B' - Y) / (2 (1 - kb)), Pr = (R' - Y) / (2 (1 - kr))
+    float pb = 0.5f / (1.0f - kb), pr = 0.5f / (1.0f - kr);
+    matrix[0] = vec4(kr * yScale, kg * yScale, kb * yScale, yOffset);
+    matrix[1] = vec4(-kr * pb * cScale, -kg * pb * cScale, (1.0f - kb) * pb * cScale, cOffset);
+    matrix[2] = vec4((1.0f - kr) * pr * cScale, -kg * pr * cScale, -kb * pr * cScale, cOffset);
+}
+
+// The sample offsets and strides of the chroma planes
+struct ChromaLayout {
+    size_t uOffset, vOffset;
+    int w, h, stride, rowStride;
+};
+
+static ChromaLayout getChromaLayout(int w, int h, YUVLayout layout) {
+    size_t lumaSize = size_t(w) * h;
+    switch (layout) {
+    case YUV_LAYOUT_I420:
+        return { lumaSize, lumaSize + lumaSize / 4, w / 2, h / 2, 1, w / 2 };
+    case YUV_LAYOUT_NV12:
+        return { lumaSize, lumaSize + 1, w / 2, h / 2, 2, w };
+    default:
+        return { lumaSize, 2 * lumaSize, w, h, 1, w };
+    }
+}
+
+void ComputeUtil::convertYUVToRGB(yuv_image_t src, rgb_image_t dst, const colorspace_t& colorspace,
+        ThreadPool* threadPool) {
+    vec4 m[3];
+    getYUVToRGBMatrix(colorspace, m);
+    int w = src.w, h = src.h;
+    ChromaLayout chroma = getChromaLayout(w, h, colorspace.layout);
+    int chromaScale = w / chroma.w;
+    uint32_t numTasks = (h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        std::vector<float> y(w), u(w), v(w), r(w), g(w), b(w);
+        int j0 = task * ROWS_PER_TASK, j1 = std::min(j0 + ROWS_PER_TASK, h);
+        for (int j = j0; j < j1; j++) {
+            loadSamples(src.data, colorspace.bitDepth, size_t(j) * w, 1, y.data(), w);
+            size_t chromaRow = size_t(j * chroma.h / h) * chroma.rowStride;
+            loadSamples(src.data, colorspace.bitDepth, chroma.uOffset + chromaRow, chroma.stride, u.data(), chroma.w);
+            loadSamples(src.data, colorspace.bitDepth, chroma.vOffset + chromaRow, chroma.stride, v.data(), chroma.w);
+            // Replicate the subsampled chroma, in place from the end of the row
+            if (chromaScale > 1) {
+                for (int k = w - 1; k >= 0; k--) {
+                    u[k] = u[k / chromaScale];
+                    v[k] = v[k / chromaScale];
+                }
+            }
+            transform3(m, y.data(), u.data(), v.data(), r.data(), g.data(), b.data(), w);
+            vec4* dstRow = &dst.data[size_t(j) * w];
+            for (int k = 0; k < w; k++) {
+                vec4 c(r[k], g[k], b[k], 1.0f);
+                if (colorspace.transfer != TRANSFER_FUNCTION_NONE) {
+                    c.x = transferToLinear(c.x, colorspace.transfer);
+                    c.y = transferToLinear(c.y, colorspace.transfer);
+                    c.z = transferToLinear(c.z, colorspace.transfer);
+                }
+                dstRow[k] = c;
+            }
+        }
+    });
+}
+
+void ComputeUtil::convertRGBToYUV(rgb_image_t src, yuv_image_t dst, const colorspace_t& colorspace,
+        ThreadPool* threadPool) {
+    vec4 m[3];
+    getRGBToYUVMatrix(colorspace, m);
+    int w = src.w, h = src.h;
+    ChromaLayout chroma = getChromaLayout(w, h, colorspace.layout);
+    bool subsampled = (chroma.w != w);
+    // Each task processes pairs of rows, so the 4:2:0 chroma can be averaged over 2x2 pixels
+    uint32_t numTasks = (h / 2 + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        std::vector<float> r(w), g(w), b(w), y(w), u[2], v[2], cu(chroma.w), cv(chroma.w);
+        for (int i = 0; i < 2; i++) {
+            u[i].resize(w);
+            v[i].resize(w);
+        }
+        int j0 = task * ROWS_PER_TASK * 2, j1 = std::min(j0 + ROWS_PER_TASK * 2, h);
+        for (int j = j0; j < j1; j += 2) {
+            for (int i = 0; i < 2; i++) {
+                const vec4* srcRow = &src.data[size_t(j + i) * w];
+                for (int k = 0; k < w; k++) {
+                    vec4 c = srcRow[k];
+                    if (colorspace.transfer != TRANSFER_FUNCTION_NONE) {
+                        c.x = transferFromLinear(c.x, colorspace.transfer);
+                        c.y = transferFromLinear(c.y, colorspace.transfer);
+                        c.z = transferFromLinear(c.z, colorspace.transfer);
+                    }
+                    r[k] = c.x; g[k] = c.y; b[k] = c.z;
+                }
+                transform3(m, r.data(), g.data(), b.data(), y.data(), u[i].data(), v[i].data(), w);
+                storeSamples(dst.data, colorspace.bitDepth, size_t(j + i) * w, 1, y.data(), w);
+                if (!subsampled) {
+                    size_t chromaRow = size_t(j + i) * chroma.rowStride;
+                    storeSamples(dst.data, colorspace.bitDepth, chroma.uOffset + chromaRow, chroma.stride, u[i].data(), w);
+                    storeSamples(dst.data, colorspace.bitDepth, chroma.vOffset + chromaRow, chroma.stride, v[i].data(), w);
+                }
+            }
+            if (subsampled) {
+                for (int k = 0; k < chroma.w; k++) {
+                    cu[k] = (u[0][2 * k] + u[0][2 * k + 1] + u[1][2 * k] + u[1][2 * k + 1]) * 0.25f;
+                    cv[k] = (v[0][2 * k] + v[0][2 * k + 1] + v[1][2 * k] + v[1][2 * k + 1]) * 0.25f;
+                }
+                size_t chromaRow = size_t(j / 2) * chroma.rowStride;
+                storeSamples(dst.data, colorspace.bitDepth, chroma.uOffset + chromaRow, chroma.stride, cu.data(), chroma.w);
+                storeSamples(dst.data, colorspace.bitDepth, chroma.vOffset + chromaRow, chroma.stride, cv.data(), chroma.w);
+            }
+        }
+    });
+}
+
+// Map a point of the corrected image, in normalized camera coordinates, to the distorted image
+static inline vec2 distort(const lens_t& lens, float x, float y) {
+    if (lens.model == LENS_MODEL_FISHEYE) {
+        float r = sqrtf(x * x + y * y);
+        if (r < 1e-8f)
+            return vec2(x, y);
+        float theta = atanf(r), theta2 = theta * theta;
+        float thetaD = theta * (1.0f + theta2 * (lens.k[0] + theta2 * (lens.k[1] +
+            theta2 * (lens.k[2] + theta2 * lens.k[3]))));
+        float s = thetaD / r;
+        return vec2(x * s, y * s);
+    }
+    float r2 = x * x + y * y;
+    float radial = 1.0f + r2 * (lens.k[0] + r2 * (lens.k[1] + r2 * lens.k[2]));
+    float xy = x * y;
+    return vec2(x * radial + 2.0f * lens.p[0] * xy + lens.p[1] * (r2 + 2.0f * x * x),
+        y * radial + lens.p[0] * (r2 + 2.0f * y * y) + 2.0f * lens.p[1] * xy);
+}
+
+void ComputeUtil::computeLensLUT(const lens_t& lens, int srcW, int srcH, int dstW, int dstH, vec2* lut,
+        ThreadPool* threadPool) {
+    float dstFx = lens.fx * lens.scale, dstFy = lens.fy * lens.scale;
+    float dstCx = lens.cx + (dstW - srcW) * 0.5f, dstCy = lens.cy + (dstH - srcH) * 0.5f;
+    uint32_t numTasks = (dstH + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        int j0 = task * ROWS_PER_TASK, j1 = std::min(j0 + ROWS_PER_TASK, dstH);
+        for (int j = j0; j < j1; j++) {
+            float y = (j - dstCy) / dstFy;
+            for (int k = 0; k < dstW; k++) {
+                vec2 d = distort(lens, (k - dstCx) / dstFx, y);
+                lut[size_t(j) * dstW + k] = vec2(lens.fx * d.x + lens.cx, lens.fy * d.y + lens.cy);
+            }
+        }
+    });
+}
+
+// Catmull-Rom weights of the 4 taps around a sample at fractional offset t
+static inline vec4 cubicWeights(float t) {
+    float t2 = t * t, t3 = t2 * t;
+    return vec4(-0.5f * t3 + t2 - 0.5f * t, 1.5f * t3 - 2.5f * t2 + 1.0f,
+        -1.5f * t3 + 2.0f * t2 + 0.5f * t, 0.5f * t3 - 0.5f * t2);
+}
+
+static inline vec4 remapSample(image_t src, vec2 coord, RemapFilter filter) {
+    if (coord.x < -0.5f || coord.y < -0.5f || coord.x > src.w - 0.5f || coord.y > src.h - 0.5f)
+        return vec4(0.0f);
+    float x0 = floorf(coord.x), y0 = floorf(coord.y);
+    float fx = coord.x - x0, fy = coord.y - y0;
+    int k0 = int(x0), j0 = int(y0);
+    if (filter == REMAP_FILTER_BILINEAR) {
+        vec4 c0 = imageLoad(src, ivec2(k0, j0)) * (1.0f - fx) + imageLoad(src, ivec2(k0 + 1, j0)) * fx;
+        vec4 c1 = imageLoad(src, ivec2(k0, j0 + 1)) * (1.0f - fx) + imageLoad(src, ivec2(k0 + 1, j0 + 1)) * fx;
+        return c0 * (1.0f - fy) + c1 * fy;
+    }
+    vec4 wx = cubicWeights(fx), wy = cubicWeights(fy);
+    vec4 c(0.0f);
+    // Clamp to the range of the 4x4 neighborhood, to remove the ringing of the negative lobes
+    vec4 cMin(FLT_MAX), cMax(-FLT_MAX);
+    for (int i = 0; i < 4; i++) {
+        vec4 row(0.0f);
+        for (int k = 0; k < 4; k++) {
+            vec4 v = imageLoad(src, ivec2(k0 + k - 1, j0 + i - 1));
+            row += v * wx[k];
+            cMin = min(cMin, v);
+            cMax = max(cMax, v);
+        }
+        c += row * wy[i];
+    }
+    return clamp(c, cMin, cMax);
+}
+
+void ComputeUtil::remap(image_t src, image_t dst, const vec2* lut, RemapFilter filter,
+        ThreadPool* threadPool) {
+    uint32_t numTasks = (dst.h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool::parallelFor(threadPool, 0, numTasks, [&](uint32_t task) {
+        int j0 = task * ROWS_PER_TASK, j1 = std::min(j0 + ROWS_PER_TASK, dst.h);
+        for (int j = j0; j < j1; j++) {
+            for (int k = 0; k < dst.w; k++)
+                imageStore(dst, ivec2(k, j), remapSample(src, lut[size_t(j) * dst.w + k], filter));
+        }
+    });
+}
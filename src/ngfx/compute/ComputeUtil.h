@@ -19,7 +19,9 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/core/ThreadPool.h"
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace ngfx {
     namespace ComputeUtil {
@@ -27,7 +29,106 @@ namespace ngfx {
         struct kernel_t { float* data; int w, h; };
         extern glm::vec4 imageLoad(image_t src, glm::ivec2 coord);
         extern void imageStore(image_t dst, glm::ivec2 coord, glm::vec4 v);
-        extern void convolve(image_t src, image_t dst, kernel_t kernel);
-        extern void transpose(image_t src, image_t dst);
+        /** Convolve an image with a 2D kernel, clamping to the edge.
+         *  Separable kernels are applied as a vertical pass followed by a horizontal pass.
+         *  The rows are distributed across the thread pool, or processed serially if threadPool is null
+         */
+        extern void convolve(image_t src, image_t dst, kernel_t kernel,
+            ThreadPool* threadPool = ThreadPool::getDefault());
+        /** Scalar implementation of convolve, used for validation */
+        extern void convolveReference(image_t src, image_t dst, kernel_t kernel);
+        /** Decompose a 2D kernel into a horizontal and a vertical 1D kernel,
+         *  such that kernel(x, y) = kernelX[x] * kernelY[y]
+         *  @return false if the kernel is not separable
+         */
+        extern bool separateKernel(kernel_t kernel, std::vector<float>& kernelX,
+            std::vector<float>& kernelY, float epsilon = 1e-5f);
+        /** Transpose an image.  The image is processed in blocks, distributed across the thread pool */
+        extern void transpose(image_t src, image_t dst,
+            ThreadPool* threadPool = ThreadPool::getDefault());
+        /** Scalar implementation of transpose, used for validation */
+        extern void transposeReference(image_t src, image_t dst);
+
+        /** The YUV layouts.  The planes are stored contiguously, without padding.
+         *  Samples with more than 8 bits are stored in 16-bit little endian words, LSB aligned.
+         *  P010 data can be processed as NV12 with a 16-bit depth and limited range
+         */
+        enum YUVLayout {
+            /** Planar 4:2:0: the Y plane, followed by the U and V planes at half resolution */
+            YUV_LAYOUT_I420,
+            /** Semi-planar 4:2:0: the Y plane, followed by an interleaved UV plane at half resolution */
+            YUV_LAYOUT_NV12,
+            /** Planar 4:4:4: the Y, U and V planes at full resolution */
+            YUV_LAYOUT_YUV444
+        };
+        enum ColorMatrix { COLOR_MATRIX_BT601, COLOR_MATRIX_BT709, COLOR_MATRIX_BT2020 };
+        enum ColorRange { COLOR_RANGE_LIMITED, COLOR_RANGE_FULL };
+        /** The transfer function of the YUV data.  When a transfer function is set, the RGB data is linear,
+         *  normalized to 10000 cd/m2 for PQ and to the nominal peak for HLG (scene light, without OOTF).
+         *  Otherwise the RGB data is the non-linear R'G'B' signal
+         */
+        enum TransferFunction { TRANSFER_FUNCTION_NONE, TRANSFER_FUNCTION_PQ, TRANSFER_FUNCTION_HLG };
+        struct colorspace_t {
+            YUVLayout layout;
+            int bitDepth;
+            ColorMatrix matrix;
+            ColorRange range;
+            TransferFunction transfer;
+        };
+        /** A YUV image.  The width must be a multiple of 8 and the height a multiple of 2 */
+        struct yuv_image_t { void* data; int w, h; };
+        /** An RGBA float image */
+        struct rgb_image_t { glm::vec4* data; int w, h; };
+        /** Get the size of a YUV image in bytes */
+        extern uint32_t getYUVImageSize(int w, int h, const colorspace_t& colorspace);
+        /** Get the matrix converting YUV samples to R'G'B'.
+         *  Each row holds the coefficients of the Y, U and V samples and the offset
+         */
+        extern void getYUVToRGBMatrix(const colorspace_t& colorspace, glm::vec4 matrix[3]);
+        /** Get the matrix converting R'G'B' to YUV samples.
+         *  Each row holds the coefficients of R', G' and B' and the offset
+         */
+        extern void getRGBToYUVMatrix(const colorspace_t& colorspace, glm::vec4 matrix[3]);
+        /** Convert a YUV image to RGBA.  The chroma samples are replicated for 4:2:0 layouts.
+         *  The rows are distributed across the thread pool, or processed serially if threadPool is null
+         */
+        extern void convertYUVToRGB(yuv_image_t src, rgb_image_t dst, const colorspace_t& colorspace,
+            ThreadPool* threadPool = ThreadPool::getDefault());
+        /** Convert an RGBA image to YUV.  The chroma samples are averaged over 2x2 pixels for 4:2:0 layouts.
+         *  The rows are distributed across the thread pool, or processed serially if threadPool is null
+         */
+        extern void convertRGBToYUV(rgb_image_t src, yuv_image_t dst, const colorspace_t& colorspace,
+            ThreadPool* threadPool = ThreadPool::getDefault());
+
+        enum LensModel {
+            /** Brown-Conrady: radial coefficients k1, k2, k3 and tangential coefficients p1, p2 */
+            LENS_MODEL_BROWN_CONRADY,
+            /** Equidistant fisheye: theta_d = theta * (1 + k1 theta^2 + k2 theta^4 + k3 theta^6 + k4 theta^8) */
+            LENS_MODEL_FISHEYE
+        };
+        /** The lens parameters of the source image.  The focal length and principal point are in pixels.
+         *  The corrected image has the same principal point, offset by half the size difference,
+         *  and the focal length multiplied by scale: a scale below 1 keeps more of the field of view
+         */
+        struct lens_t {
+            LensModel model;
+            float fx, fy, cx, cy;
+            float k[4], p[2];
+            float scale = 1.0f;
+        };
+        enum RemapFilter { REMAP_FILTER_BILINEAR, REMAP_FILTER_BICUBIC };
+        /** Compute the LUT correcting the lens distortion.  For each pixel of the corrected image,
+         *  the LUT holds the coordinates of the source sample, in pixels, with the first pixel centered at (0, 0).
+         *  The rows are distributed across the thread pool, or processed serially if threadPool is null
+         */
+        extern void computeLensLUT(const lens_t& lens, int srcW, int srcH, int dstW, int dstH, glm::vec2* lut,
+            ThreadPool* threadPool = ThreadPool::getDefault());
+        /** Remap an image with a LUT of source coordinates, sized as dst.
+         *  Coordinates more than half a pixel outside the source image return transparent black.
+         *  The bicubic filter uses Catmull-Rom weights, and is clamped to the range of the 4x4 neighborhood.
+         *  The rows are distributed across the thread pool, or processed serially if threadPool is null
+         */
+        extern void remap(image_t src, image_t dst, const glm::vec2* lut, RemapFilter filter,
+            ThreadPool* threadPool = ThreadPool::getDefault());
     };
 }; // namespace ngfx
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/ColorspaceConversionGPUOp.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/BufferUtil.h"
+using namespace ngfx;
+using namespace ngfx::ComputeUtil;
+
+ColorspaceConversionGPUOp::ColorspaceConversionGPUOp(
+    GraphicsContext *ctx, Direction direction, Buffer *src, uint32_t w,
+    uint32_t h, const colorspace_t &colorspace)
+    : ComputeOp(ctx), direction(direction), colorspace(colorspace) {
+  if (colorspace.bitDepth < 8 || colorspace.bitDepth > 16)
+    NGFX_ERR("unsupported bit depth: %d", colorspace.bitDepth);
+  update(src, w, h);
+  createPipeline();
+  computePipeline->getBindings({&U_UBO, &SSBO_SRC, &SSBO_DST});
+}
+
+ColorspaceConversionGPUOp::~ColorspaceConversionGPUOp() {}
+
+void ColorspaceConversionGPUOp::apply(CommandBuffer *commandBuffer,
+                                      Graphics *graphics) {
+  graphics->bindComputePipeline(commandBuffer, computePipeline);
+  graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_UBO,
+                              SHADER_STAGE_COMPUTE_BIT);
+  graphics->bindStorageBuffer(commandBuffer, src, SSBO_SRC,
+                              SHADER_STAGE_COMPUTE_BIT, true);
+  graphics->bindStorageBuffer(commandBuffer, bDst.get(), SSBO_DST,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  uint32_t numThreadsX = w / BLOCK_WIDTH, numThreadsY = h / BLOCK_HEIGHT;
+  graphics->dispatch(commandBuffer, (numThreadsX + 7) / 8,
+                     (numThreadsY + 7) / 8, 1, 8, 8, 1);
+}
+
+void ColorspaceConversionGPUOp::update(Buffer *src, uint32_t w, uint32_t h) {
+  if (w % BLOCK_WIDTH != 0 || h % BLOCK_HEIGHT != 0)
+    NGFX_ERR("the image size must be a multiple of %dx%d: %dx%d", BLOCK_WIDTH,
+             BLOCK_HEIGHT, w, h);
+  this->src = src;
+  this->w = w;
+  this->h = h;
+  UboData uboData;
+  if (direction == DIRECTION_YUV_TO_RGB)
+    getYUVToRGBMatrix(colorspace, uboData.matrix);
+  else
+    getRGBToYUVMatrix(colorspace, uboData.matrix);
+  uboData.w = int32_t(w);
+  uboData.h = int32_t(h);
+  uboData.yuv_layout = colorspace.layout;
+  uboData.bit_depth = colorspace.bitDepth;
+  uboData.transfer = colorspace.transfer;
+  int32_t lumaSize = int32_t(w * h);
+  uboData.u_offset = lumaSize;
+  uboData.v_offset = (colorspace.layout == YUV_LAYOUT_I420) ? lumaSize + lumaSize / 4
+                     : (colorspace.layout == YUV_LAYOUT_NV12) ? lumaSize + 1
+                     : 2 * lumaSize;
+  updateBuffer(ctx, bUbo, &uboData, sizeof(uboData),
+               BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  uint32_t dstSize = (direction == DIRECTION_YUV_TO_RGB)
+                         ? w * h * sizeof(glm::vec4)
+                         : getYUVImageSize(w, h, colorspace);
+  updateBuffer(ctx, bDst, nullptr, dstSize, BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+void ColorspaceConversionGPUOp::createPipeline() {
+  const std::string key = (direction == DIRECTION_YUV_TO_RGB)
+                              ? "colorspaceYUVToRGBOp"
+                              : "colorspaceRGBToYUVOp";
+  computePipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
+  if (computePipeline)
+    return;
+  const std::string filename = (direction == DIRECTION_YUV_TO_RGB)
+                                   ? NGFX_DATA_DIR "/yuvToRGB.comp"
+                                   : NGFX_DATA_DIR "/rgbToYUV.comp";
+  computePipeline = ComputePipeline::create(
+      ctx, ComputeShaderModule::create(ctx->device, filename).get());
+  ctx->pipelineCache->add(key, computePipeline);
+}
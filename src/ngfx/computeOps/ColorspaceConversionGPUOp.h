@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/compute/ComputeUtil.h"
+#include "ngfx/graphics/Buffer.h"
+
+namespace ngfx {
+
+/** \class ColorspaceConversionGPUOp
+ *
+ *  This class converts between YUV and RGBA float images on the GPU, in a single pass.
+ *  The YUV layout, bit depth, color matrix, range and transfer function are given by
+ *  the colorspace (see ComputeUtil::colorspace_t).  Each thread converts a block of
+ *  8x2 pixels, loading and storing the YUV samples as whole 32-bit words.
+ *  ComputeUtil::convertYUVToRGB and ComputeUtil::convertRGBToYUV provide the
+ *  matching CPU implementation.
+ */
+
+class ColorspaceConversionGPUOp : public ComputeOp {
+public:
+  enum Direction { DIRECTION_YUV_TO_RGB, DIRECTION_RGB_TO_YUV };
+  /** Create the colorspace conversion operation
+   *  @param ctx The graphics context
+   *  @param direction The conversion direction
+   *  @param src The input storage buffer: a YUV image, or an RGBA float image
+   *  @param w The image width, a multiple of 8
+   *  @param h The image height, a multiple of 2
+   *  @param colorspace The colorspace of the YUV image
+   */
+  ColorspaceConversionGPUOp(GraphicsContext *ctx, Direction direction,
+                            Buffer *src, uint32_t w, uint32_t h,
+                            const ComputeUtil::colorspace_t &colorspace);
+  virtual ~ColorspaceConversionGPUOp();
+  void apply(CommandBuffer *commandBuffer = nullptr,
+             Graphics *graphics = nullptr) override;
+  /** Update the input buffer.  The output buffer is only reallocated when
+   *  the image size changes */
+  void update(Buffer *src, uint32_t w, uint32_t h);
+  /** The number of pixels converted by each thread */
+  static const uint32_t BLOCK_WIDTH = 8, BLOCK_HEIGHT = 2;
+  Direction direction;
+  Buffer *src = nullptr;
+  uint32_t w = 0, h = 0;
+  ComputeUtil::colorspace_t colorspace;
+  /** The result: an RGBA float image, or a YUV image */
+  std::unique_ptr<Buffer> bDst;
+
+protected:
+  struct UboData {
+    glm::vec4 matrix[3];
+    int32_t w, h, yuv_layout, bit_depth, transfer;
+    int32_t u_offset, v_offset;
+  };
+  void createPipeline();
+  std::unique_ptr<Buffer> bUbo;
+  ComputePipeline *computePipeline;
+  uint32_t U_UBO = 0, SSBO_SRC = 1, SSBO_DST = 2;
+};
+} // namespace ngfx
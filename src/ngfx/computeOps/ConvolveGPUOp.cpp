@@ -19,24 +19,52 @@
  * under the License.
  */
 #include "ngfx/computeOps/ConvolveGPUOp.h"
+#include "ngfx/core/DebugUtil.h"
 #include "ngfx/graphics/BufferUtil.h"
 using namespace ngfx;
 using namespace ngfx::ComputeUtil;
 using namespace glm;
 
 ConvolveGPUOp::ConvolveGPUOp(GraphicsContext* ctx, Graphics* graphics)
-    : ComputeOp(ctx) {
-    createPipeline();
-    computePipeline->getBindings({ &U_UBO, &U_SRC_IMAGE, &U_DST_IMAGE });
+    : ComputeOp(ctx), graphics(graphics) {
+    createPipelines();
+    computePipeline->getBindings({ &U_UBO, &SSBO_KERNEL, &U_SRC_IMAGE, &U_DST_IMAGE });
+    computePipeline1D->getBindings({ &U_UBO_1D, &SSBO_KERNEL_1D, &U_SRC_IMAGE_1D, &U_DST_IMAGE_1D });
 }
 ConvolveGPUOp::~ConvolveGPUOp() {}
 void ConvolveGPUOp::apply(CommandBuffer* commandBuffer,
     Graphics* graphics) {
-    graphics->bindComputePipeline(commandBuffer, computePipeline);
-    graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_UBO, SHADER_STAGE_COMPUTE_BIT);
-    graphics->bindTextureAsImage(commandBuffer, srcTexture, U_SRC_IMAGE);
-    graphics->bindTextureAsImage(commandBuffer, dstTexture, U_DST_IMAGE);
-    graphics->dispatch(commandBuffer, dstTexture->w, dstTexture->h, 1, 1, 1, 1);
+    if (!srcTexture || !dstTexture || numPasses == 0)
+        NGFX_ERR("the textures and the kernel must be set before apply");
+    if (numPasses == 1) {
+        applyPass(commandBuffer, graphics, bUbo[0].get(), srcTexture, dstTexture, uboData[0].direction);
+        return;
+    }
+    applyPass(commandBuffer, graphics, bUbo[0].get(), srcTexture, tmpTexture.get(), DIRECTION_HORIZONTAL);
+    graphics->computeBarrier(commandBuffer);
+    applyPass(commandBuffer, graphics, bUbo[1].get(), tmpTexture.get(), dstTexture, DIRECTION_VERTICAL);
+}
+void ConvolveGPUOp::applyPass(CommandBuffer* commandBuffer, Graphics* graphics, Buffer* ubo,
+    Texture* src, Texture* dst, int direction) {
+    if (direction == DIRECTION_NONE) {
+        graphics->bindComputePipeline(commandBuffer, computePipeline);
+        graphics->bindUniformBuffer(commandBuffer, ubo, U_UBO, SHADER_STAGE_COMPUTE_BIT);
+        graphics->bindStorageBuffer(commandBuffer, bKernel.get(), SSBO_KERNEL, SHADER_STAGE_COMPUTE_BIT, true);
+        graphics->bindTextureAsImage(commandBuffer, src, U_SRC_IMAGE);
+        graphics->bindTextureAsImage(commandBuffer, dst, U_DST_IMAGE);
+        graphics->dispatch(commandBuffer, (dst->w + TILE_SIZE - 1) / TILE_SIZE,
+            (dst->h + TILE_SIZE - 1) / TILE_SIZE, 1, TILE_SIZE, TILE_SIZE, 1);
+        return;
+    }
+    graphics->bindComputePipeline(commandBuffer, computePipeline1D);
+    graphics->bindUniformBuffer(commandBuffer, ubo, U_UBO_1D, SHADER_STAGE_COMPUTE_BIT);
+    graphics->bindStorageBuffer(commandBuffer, bKernel.get(), SSBO_KERNEL_1D, SHADER_STAGE_COMPUTE_BIT, true);
+    graphics->bindTextureAsImage(commandBuffer, src, U_SRC_IMAGE_1D);
+    graphics->bindTextureAsImage(commandBuffer, dst, U_DST_IMAGE_1D);
+    uint32_t along = (direction == DIRECTION_HORIZONTAL) ? dst->w : dst->h,
+        across = (direction == DIRECTION_HORIZONTAL) ? dst->h : dst->w;
+    graphics->dispatch(commandBuffer, (along + TILE_ALONG - 1) / TILE_ALONG,
+        (across + TILE_ACROSS - 1) / TILE_ACROSS, 1, TILE_ALONG, TILE_ACROSS, 1);
 }
 void ConvolveGPUOp::update(Texture* srcTexture, Texture* dstTexture, kernel_t kernel) {
     this->srcTexture = srcTexture;
@@ -44,16 +72,58 @@ void ConvolveGPUOp::update(Texture* srcTexture, Texture* dstTexture, kernel_t ke
     setKernel(kernel);
 }
 void ConvolveGPUOp::setKernel(kernel_t kernel) {
-    vec4* kernelData = uboData.kernel_data;
-    uboData.kernel_w = kernel.w;
-    uboData.kernel_h = kernel.h;
-    for (int j = 0; j < (kernel.w * kernel.h); j++)
-        uboData.kernel_data[j] = vec4(kernel.data[j]);
-    bUbo.reset(createUniformBuffer(ctx, &uboData, sizeof(uboData)));
+    std::vector<float> kernelData, kernelX, kernelY;
+    if (kernel.w == 1 || kernel.h == 1) {
+        // A single 1D pass
+        separable = true;
+        numPasses = 1;
+        kernelData.assign(kernel.data, kernel.data + kernel.w * kernel.h);
+        int direction = (kernel.h == 1) ? DIRECTION_HORIZONTAL : DIRECTION_VERTICAL;
+        uboData[0] = { kernel.w * kernel.h, 1, 0, direction };
+    }
+    else if (separateKernel(kernel, kernelX, kernelY)) {
+        // A horizontal pass followed by a vertical pass
+        separable = true;
+        numPasses = 2;
+        kernelData = kernelX;
+        kernelData.insert(kernelData.end(), kernelY.begin(), kernelY.end());
+        uboData[0] = { kernel.w, 1, 0, DIRECTION_HORIZONTAL };
+        uboData[1] = { kernel.h, 1, kernel.w, DIRECTION_VERTICAL };
+    }
+    else {
+        separable = false;
+        numPasses = 1;
+        kernelData.assign(kernel.data, kernel.data + kernel.w * kernel.h);
+        uboData[0] = { kernel.w, kernel.h, 0, DIRECTION_NONE };
+    }
+    // Update the buffers in place, unless the size has changed
+    updateBuffer(ctx, bKernel, kernelData.data(), uint32_t(kernelData.size() * sizeof(float)),
+        BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    for (int j = 0; j < numPasses; j++)
+        updateBuffer(ctx, bUbo[j], &uboData[j], sizeof(uboData[j]), BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    // The intermediate texture is allocated once the destination texture is known
+    if (numPasses == 2 && dstTexture)
+        updateTmpTexture();
+}
+
+void ConvolveGPUOp::updateTmpTexture() {
+    if (tmpTexture && tmpTexture->w == dstTexture->w && tmpTexture->h == dstTexture->h &&
+        tmpTexture->format == dstTexture->format)
+        return;
+    tmpTexture.reset(Texture::create(ctx, graphics, nullptr, dstTexture->format, dstTexture->size,
+        dstTexture->w, dstTexture->h, 1, 1, IMAGE_USAGE_STORAGE_BIT));
 }
 
-void ConvolveGPUOp::createPipeline() {
-    computePipeline = ComputePipeline::create(
-        ctx,
-        ComputeShaderModule::create(ctx->device, NGFX_DATA_DIR "/shaders/convolve.comp").get());
-}
\ No newline at end of file
+void ConvolveGPUOp::createPipelines() {
+    auto createPipeline = [&](const std::string& key, const std::string& filename) {
+        auto pipeline = (ComputePipeline*)ctx->pipelineCache->get(key);
+        if (pipeline)
+            return pipeline;
+        pipeline = ComputePipeline::create(ctx,
+            ComputeShaderModule::create(ctx->device, filename).get());
+        ctx->pipelineCache->add(key, pipeline);
+        return pipeline;
+    };
+    computePipeline = createPipeline("convolveOp", NGFX_DATA_DIR "/convolve.comp");
+    computePipeline1D = createPipeline("convolve1DOp", NGFX_DATA_DIR "/convolve1D.comp");
+}
@@ -23,6 +23,13 @@
 #include "ngfx/compute/ComputeUtil.h"
 
 namespace ngfx {
+    /** \class ConvolveGPUOp
+     *
+     *  Convolve an image with a 2D kernel on the GPU.
+     *  Separable kernels are applied as a horizontal pass followed by a vertical pass,
+     *  via an intermediate texture.  Each workgroup loads a tile of the source image,
+     *  including the halo, into shared memory.
+     */
     class ConvolveGPUOp : public ComputeOp {
     public:
         ConvolveGPUOp(GraphicsContext* ctx, Graphics* graphics);
@@ -30,19 +37,30 @@ namespace ngfx {
         void apply(CommandBuffer* commandBuffer = nullptr,
             Graphics* graphics = nullptr) override;
         void update(Texture* srcTexture, Texture* dstTexture, ComputeUtil::kernel_t kernel);
+        /** Set the kernel.  The kernel data is updated in place when the size is unchanged.
+         *  This can be called before update: the intermediate texture is then allocated by update */
         void setKernel(ComputeUtil::kernel_t kernel);
-        std::unique_ptr<Buffer> bUbo;
+        std::unique_ptr<Buffer> bUbo[2], bKernel;
         Texture* srcTexture = nullptr;
         Texture* dstTexture = nullptr;
+        /** The intermediate texture used by separable kernels */
+        std::unique_ptr<Texture> tmpTexture;
+        bool separable = false;
     protected:
-        void createPipeline();
-        static const int MAX_KERNEL_SIZE = 64;
+        void createPipelines();
+        void updateTmpTexture();
+        void applyPass(CommandBuffer* commandBuffer, Graphics* graphics, Buffer* ubo,
+            Texture* src, Texture* dst, int direction);
+        enum { DIRECTION_NONE = -1, DIRECTION_HORIZONTAL = 0, DIRECTION_VERTICAL = 1 };
+        static const int TILE_SIZE = 16, TILE_ALONG = 64, TILE_ACROSS = 4;
         struct ConvolveUboData {
-            int kernel_w = 0, kernel_h = 0, padding_0 = 0, padding_1 = 0;
-            glm::vec4 kernel_data[MAX_KERNEL_SIZE]{};
+            int kernel_w = 0, kernel_h = 0, kernel_offset = 0, direction = 0;
         };
-        ConvolveUboData uboData;
-        ComputePipeline* computePipeline;
-        uint32_t U_UBO = 0, U_SRC_IMAGE = 1, U_DST_IMAGE = 2;
+        ConvolveUboData uboData[2];
+        int numPasses = 0;
+        Graphics* graphics;
+        ComputePipeline *computePipeline = nullptr, *computePipeline1D = nullptr;
+        uint32_t U_UBO = 0, SSBO_KERNEL = 1, U_SRC_IMAGE = 2, U_DST_IMAGE = 3;
+        uint32_t U_UBO_1D = 0, SSBO_KERNEL_1D = 1, U_SRC_IMAGE_1D = 2, U_DST_IMAGE_1D = 3;
     };
-}
\ No newline at end of file
+}
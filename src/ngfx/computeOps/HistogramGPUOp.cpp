@@ -0,0 +1,83 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/HistogramGPUOp.h"
+#include "ngfx/graphics/BufferUtil.h"
+using namespace ngfx;
+
+HistogramGPUOp::HistogramGPUOp(GraphicsContext *ctx, Texture *srcTexture)
+    : ComputeOp(ctx) {
+  update(srcTexture);
+  createPipelines();
+  histogramPipeline->getBindings({&U_SRC_IMAGE, &SSBO_PARTIALS});
+  mergePipeline->getBindings(
+      {&U_MERGE_UBO, &SSBO_MERGE_PARTIALS, &SSBO_MERGE_DST});
+}
+
+HistogramGPUOp::~HistogramGPUOp() {}
+
+void HistogramGPUOp::apply(CommandBuffer *commandBuffer, Graphics *graphics) {
+  graphics->bindComputePipeline(commandBuffer, histogramPipeline);
+  graphics->bindTextureAsImage(commandBuffer, srcTexture, U_SRC_IMAGE);
+  graphics->bindStorageBuffer(commandBuffer, bPartials.get(), SSBO_PARTIALS,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  graphics->dispatch(commandBuffer, numGroupsX, numGroupsY, 1, 16, 16, 1);
+  graphics->computeBarrier(commandBuffer);
+  graphics->bindComputePipeline(commandBuffer, mergePipeline);
+  graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_MERGE_UBO,
+                              SHADER_STAGE_COMPUTE_BIT);
+  graphics->bindStorageBuffer(commandBuffer, bPartials.get(),
+                              SSBO_MERGE_PARTIALS, SHADER_STAGE_COMPUTE_BIT,
+                              true);
+  graphics->bindStorageBuffer(commandBuffer, bDst.get(), SSBO_MERGE_DST,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  graphics->dispatch(commandBuffer, 1, 1, 1, NUM_BINS, 1, 1);
+}
+
+void HistogramGPUOp::update(Texture *srcTexture) {
+  this->srcTexture = srcTexture;
+  numGroupsX = (srcTexture->w + REGION_SIZE - 1) / REGION_SIZE;
+  numGroupsY = (srcTexture->h + REGION_SIZE - 1) / REGION_SIZE;
+  UboData uboData = {int32_t(numGroupsX * numGroupsY)};
+  updateBuffer(ctx, bUbo, &uboData, sizeof(uboData),
+               BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  updateBuffer(ctx, bPartials, nullptr,
+               numGroupsX * numGroupsY * NUM_BINS * sizeof(uint32_t),
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  updateBuffer(ctx, bDst, nullptr, NUM_BINS * sizeof(uint32_t),
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+void HistogramGPUOp::createPipelines() {
+  auto createPipeline = [&](const std::string &key,
+                            const std::string &filename) {
+    auto pipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
+    if (pipeline)
+      return pipeline;
+    pipeline = ComputePipeline::create(
+        ctx, ComputeShaderModule::create(ctx->device, filename).get());
+    ctx->pipelineCache->add(key, pipeline);
+    return pipeline;
+  };
+  histogramPipeline =
+      createPipeline("histogramOp", NGFX_DATA_DIR "/histogram.comp");
+  mergePipeline = createPipeline("histogramMergeOp",
+                                 NGFX_DATA_DIR "/histogramMerge.comp");
+}
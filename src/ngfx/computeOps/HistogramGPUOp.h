@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/graphics/Buffer.h"
+#include "ngfx/graphics/Texture.h"
+
+namespace ngfx {
+
+/** \class HistogramGPUOp
+ *
+ *  This class computes a 256-bin luminance histogram of a texture on the GPU.
+ *  Each workgroup accumulates the histogram of a 64x64 region in shared memory,
+ *  and a second pass sums the partial histograms.  The result stays on the GPU,
+ *  e.g. for auto-exposure.
+ *  The texture must be created with IMAGE_USAGE_STORAGE_BIT.
+ */
+
+class HistogramGPUOp : public ComputeOp {
+public:
+  HistogramGPUOp(GraphicsContext *ctx, Texture *srcTexture);
+  virtual ~HistogramGPUOp();
+  void apply(CommandBuffer *commandBuffer = nullptr,
+             Graphics *graphics = nullptr) override;
+  /** Update the input texture */
+  void update(Texture *srcTexture);
+  static const uint32_t NUM_BINS = 256;
+  /** The size of the region processed by each workgroup */
+  static const uint32_t REGION_SIZE = 64;
+  Texture *srcTexture = nullptr;
+  /** The result: a storage buffer with NUM_BINS uint32 values */
+  std::unique_ptr<Buffer> bDst;
+
+protected:
+  struct UboData {
+    int32_t num_partials;
+  };
+  void createPipelines();
+  std::unique_ptr<Buffer> bUbo, bPartials;
+  uint32_t numGroupsX = 0, numGroupsY = 0;
+  ComputePipeline *histogramPipeline, *mergePipeline;
+  uint32_t U_SRC_IMAGE = 0, SSBO_PARTIALS = 1;
+  uint32_t U_MERGE_UBO = 0, SSBO_MERGE_PARTIALS = 1, SSBO_MERGE_DST = 2;
+};
+} // namespace ngfx
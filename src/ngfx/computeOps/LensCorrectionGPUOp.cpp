@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/LensCorrectionGPUOp.h"
+#include "ngfx/graphics/BufferUtil.h"
+#include <cstring>
+using namespace ngfx;
+using namespace ngfx::ComputeUtil;
+using namespace glm;
+
+LensCorrectionGPUOp::LensCorrectionGPUOp(GraphicsContext* ctx, Graphics* graphics,
+    Texture* srcTexture, Texture* dstTexture, const lens_t& lens, RemapFilter filter)
+    : ComputeOp(ctx), graphics(graphics) {
+    update(srcTexture, dstTexture, lens, filter);
+    createPipeline();
+    computePipeline->getBindings({ &U_UBO, &U_LUT, &U_SRC_IMAGE, &U_DST_IMAGE });
+}
+LensCorrectionGPUOp::~LensCorrectionGPUOp() {}
+void LensCorrectionGPUOp::apply(CommandBuffer* commandBuffer, Graphics* graphics) {
+    graphics->bindComputePipeline(commandBuffer, computePipeline);
+    graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_UBO, SHADER_STAGE_COMPUTE_BIT);
+    graphics->bindTextureAsImage(commandBuffer, lutTexture.get(), U_LUT);
+    graphics->bindTextureAsImage(commandBuffer, srcTexture, U_SRC_IMAGE);
+    graphics->bindTextureAsImage(commandBuffer, dstTexture, U_DST_IMAGE);
+    graphics->dispatch(commandBuffer, (dstTexture->w + TILE_SIZE - 1) / TILE_SIZE,
+        (dstTexture->h + TILE_SIZE - 1) / TILE_SIZE, 1, TILE_SIZE, TILE_SIZE, 1);
+}
+void LensCorrectionGPUOp::update(Texture* srcTexture, Texture* dstTexture, const lens_t& lens,
+    RemapFilter filter) {
+    // The lens parameters are plain floats, so they can be compared bitwise
+    bool lutChanged = !lutTexture || memcmp(&this->lens, &lens, sizeof(lens)) ||
+        srcTexture->w != lutSrcW || srcTexture->h != lutSrcH ||
+        dstTexture->w != lutTexture->w || dstTexture->h != lutTexture->h;
+    this->srcTexture = srcTexture;
+    this->dstTexture = dstTexture;
+    this->lens = lens;
+    if (lutChanged)
+        updateLUT();
+    uboData.filter = filter;
+    updateBuffer(ctx, bUbo, &uboData, sizeof(uboData), BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+}
+
+void LensCorrectionGPUOp::updateLUT() {
+    uint32_t w = dstTexture->w, h = dstTexture->h, size = w * h * sizeof(vec2);
+    lutSrcW = srcTexture->w;
+    lutSrcH = srcTexture->h;
+    std::vector<vec2> lut(size_t(w) * h);
+    computeLensLUT(lens, int(lutSrcW), int(lutSrcH), int(w), int(h), lut.data());
+    if (lutTexture && lutTexture->w == w && lutTexture->h == h)
+        lutTexture->upload(lut.data(), size);
+    else
+        lutTexture.reset(Texture::create(ctx, graphics, lut.data(), PIXELFORMAT_RG32_SFLOAT, size,
+            w, h, 1, 1, ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_DST_BIT)));
+}
+
+void LensCorrectionGPUOp::createPipeline() {
+    const std::string key = "lensCorrectionOp";
+    computePipeline = (ComputePipeline*)ctx->pipelineCache->get(key);
+    if (computePipeline)
+        return;
+    computePipeline = ComputePipeline::create(ctx,
+        ComputeShaderModule::create(ctx->device, NGFX_DATA_DIR "/lensCorrection.comp").get());
+    ctx->pipelineCache->add(key, computePipeline);
+}
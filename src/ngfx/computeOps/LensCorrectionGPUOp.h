@@ -0,0 +1,66 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/compute/ComputeUtil.h"
+
+namespace ngfx {
+    /** \class LensCorrectionGPUOp
+     *
+     *  Correct the lens distortion of an image on the GPU.
+     *  The remap LUT is computed once per set of lens parameters and stored in a texture,
+     *  so each frame only performs a single gather pass with bilinear or bicubic filtering.
+     *  ComputeUtil::remap is the CPU reference.
+     */
+    class LensCorrectionGPUOp : public ComputeOp {
+    public:
+        LensCorrectionGPUOp(GraphicsContext* ctx, Graphics* graphics, Texture* srcTexture,
+            Texture* dstTexture, const ComputeUtil::lens_t& lens,
+            ComputeUtil::RemapFilter filter = ComputeUtil::REMAP_FILTER_BILINEAR);
+        virtual ~LensCorrectionGPUOp();
+        void apply(CommandBuffer* commandBuffer = nullptr,
+            Graphics* graphics = nullptr) override;
+        /** Update the textures, lens parameters and filter.
+         *  The LUT is only recomputed when the lens parameters or the image sizes change
+         */
+        void update(Texture* srcTexture, Texture* dstTexture, const ComputeUtil::lens_t& lens,
+            ComputeUtil::RemapFilter filter = ComputeUtil::REMAP_FILTER_BILINEAR);
+        std::unique_ptr<Buffer> bUbo;
+        /** The remap LUT: the source coordinates of each destination pixel */
+        std::unique_ptr<Texture> lutTexture;
+        Texture* srcTexture = nullptr;
+        Texture* dstTexture = nullptr;
+        ComputeUtil::lens_t lens;
+    protected:
+        void createPipeline();
+        void updateLUT();
+        static const int TILE_SIZE = 16;
+        struct UboData {
+            int filter = 0, padding[3];
+        };
+        UboData uboData;
+        /** The source size the LUT was computed for */
+        uint32_t lutSrcW = 0, lutSrcH = 0;
+        Graphics* graphics;
+        ComputePipeline* computePipeline = nullptr;
+        uint32_t U_UBO = 0, U_LUT = 1, U_SRC_IMAGE = 2, U_DST_IMAGE = 3;
+    };
+}
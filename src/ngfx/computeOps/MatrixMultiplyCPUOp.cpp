@@ -21,13 +21,121 @@
 #include "ngfx/computeOps/MatrixMultiplyCPUOp.h"
 #include "ngfx/core/DebugUtil.h"
 #include "ngfx/core/Timer.h"
-#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) ||          \
+    defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 using namespace ngfx;
-using namespace glm;
+
+// Micro-kernel tile size (MR x NR), chosen so that the accumulators fit in registers
+#if defined(__AVX512F__)
+#define MR 8
+#define NR 16
+#elif defined(__AVX2__) && defined(__FMA__)
+#define MR 6
+#define NR 16
+#elif defined(__ARM_NEON)
+#define MR 8
+#define NR 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#define MR 4
+#define NR 8
+#else
+#define MR 4
+#define NR 4
+#endif
+// Cache blocking: a KC x NR panel of B stays in L1, a MC x KC block of A in L2,
+// and a KC x NC block of B in L3
+#define KC 256
+#define MC (MR * 16)
+#define NC (NR * 256)
+// Number of columns processed by each task
+#define NB (NR * 16)
+
+// Compute tile = a * b, where a is a packed KC x MR panel and b is a packed KC x NR panel
+static inline void microKernel(uint32_t kc, const float *a, const float *b,
+                               float *tile) {
+#if defined(__AVX512F__)
+  __m512 c[MR];
+  for (int i = 0; i < MR; i++)
+    c[i] = _mm512_setzero_ps();
+  for (uint32_t k = 0; k < kc; k++, a += MR, b += NR) {
+    __m512 b0 = _mm512_loadu_ps(b);
+    for (int i = 0; i < MR; i++)
+      c[i] = _mm512_fmadd_ps(_mm512_set1_ps(a[i]), b0, c[i]);
+  }
+  for (int i = 0; i < MR; i++)
+    _mm512_storeu_ps(&tile[i * NR], c[i]);
+#elif defined(__AVX2__) && defined(__FMA__)
+  __m256 c[MR][2];
+  for (int i = 0; i < MR; i++)
+    c[i][0] = c[i][1] = _mm256_setzero_ps();
+  for (uint32_t k = 0; k < kc; k++, a += MR, b += NR) {
+    __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+    for (int i = 0; i < MR; i++) {
+      __m256 a0 = _mm256_broadcast_ss(&a[i]);
+      c[i][0] = _mm256_fmadd_ps(a0, b0, c[i][0]);
+      c[i][1] = _mm256_fmadd_ps(a0, b1, c[i][1]);
+    }
+  }
+  for (int i = 0; i < MR; i++) {
+    _mm256_storeu_ps(&tile[i * NR], c[i][0]);
+    _mm256_storeu_ps(&tile[i * NR + 8], c[i][1]);
+  }
+#elif defined(__ARM_NEON)
+  float32x4_t c[MR][2];
+  for (int i = 0; i < MR; i++)
+    c[i][0] = c[i][1] = vdupq_n_f32(0.0f);
+  for (uint32_t k = 0; k < kc; k++, a += MR, b += NR) {
+    float32x4_t b0 = vld1q_f32(b), b1 = vld1q_f32(b + 4);
+    for (int i = 0; i < MR; i++) {
+#if defined(__aarch64__)
+      c[i][0] = vfmaq_n_f32(c[i][0], b0, a[i]);
+      c[i][1] = vfmaq_n_f32(c[i][1], b1, a[i]);
+#else
+      c[i][0] = vmlaq_n_f32(c[i][0], b0, a[i]);
+      c[i][1] = vmlaq_n_f32(c[i][1], b1, a[i]);
+#endif
+    }
+  }
+  for (int i = 0; i < MR; i++) {
+    vst1q_f32(&tile[i * NR], c[i][0]);
+    vst1q_f32(&tile[i * NR + 4], c[i][1]);
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  __m128 c[MR][2];
+  for (int i = 0; i < MR; i++)
+    c[i][0] = c[i][1] = _mm_setzero_ps();
+  for (uint32_t k = 0; k < kc; k++, a += MR, b += NR) {
+    __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4);
+    for (int i = 0; i < MR; i++) {
+      __m128 a0 = _mm_set1_ps(a[i]);
+      c[i][0] = _mm_add_ps(c[i][0], _mm_mul_ps(a0, b0));
+      c[i][1] = _mm_add_ps(c[i][1], _mm_mul_ps(a0, b1));
+    }
+  }
+  for (int i = 0; i < MR; i++) {
+    _mm_storeu_ps(&tile[i * NR], c[i][0]);
+    _mm_storeu_ps(&tile[i * NR + 4], c[i][1]);
+  }
+#else
+  float c[MR][NR] = {};
+  for (uint32_t k = 0; k < kc; k++, a += MR, b += NR) {
+    for (int i = 0; i < MR; i++)
+      for (int j = 0; j < NR; j++)
+        c[i][j] += a[i] * b[j];
+  }
+  memcpy(tile, c, sizeof(c));
+#endif
+}
 
 MatrixMultiplyCPUOp::MatrixMultiplyCPUOp(MatrixParam src0, MatrixParam src1,
-                                         MatrixParam dst)
-    : MatrixMultiplyOp(nullptr), dst(dst) {
+                                         MatrixParam dst, ThreadPool *threadPool)
+    : MatrixMultiplyOp(nullptr), dst(dst), threadPool(threadPool) {
   update(src0, src1);
 }
 
@@ -37,45 +145,123 @@ void MatrixMultiplyCPUOp::apply(CommandBuffer *, Graphics *) {
 }
 
 void MatrixMultiplyCPUOp::update(MatrixParam src0, MatrixParam src1) {
+  if (src0.w != src1.h)
+    NGFX_ERR("matrix dimensions mismatch: %dx%d * %dx%d", src0.w, src0.h,
+             src1.w, src1.h);
   this->src0 = src0;
   this->src1 = src1;
-  src1t_data.resize(src1.w * src1.h);
-  src1t = {src1.h, src1.w, src1t_data.data()};
-  transpose(src1, src1t);
 }
 
 void MatrixMultiplyCPUOp::transpose(MatrixParam &src, MatrixParam &dst) {
-  Timer timer;
-  float *dst_data = dst.data;
+  // Transpose in tiles, so that both the source and the destination
+  // are accessed within a small working set
+  const uint32_t TILE_SIZE = 32;
+  for (uint32_t y0 = 0; y0 < dst.h; y0 += TILE_SIZE) {
+    uint32_t y1 = std::min(y0 + TILE_SIZE, dst.h);
+    for (uint32_t x0 = 0; x0 < dst.w; x0 += TILE_SIZE) {
+      uint32_t x1 = std::min(x0 + TILE_SIZE, dst.w);
+      for (uint32_t dst_row = y0; dst_row < y1; dst_row++) {
+        for (uint32_t dst_col = x0; dst_col < x1; dst_col++)
+          dst.data[dst_row * dst.w + dst_col] =
+              src.data[dst_col * src.w + dst_row];
+      }
+    }
+  }
+}
+
+void MatrixMultiplyCPUOp::matrixMultiplyReference(const MatrixParam &src0,
+                                                  const MatrixParam &src1,
+                                                  MatrixParam &dst) {
   for (uint32_t dst_row = 0; dst_row < dst.h; dst_row++) {
     for (uint32_t dst_col = 0; dst_col < dst.w; dst_col++) {
-      float *src_data = &src.data[dst_col * src.w + dst_row];
-      *dst_data++ = *src_data;
+      float c = 0.0f;
+      for (uint32_t j = 0; j < src0.w; j++)
+        c += src0.data[dst_row * src0.w + j] * src1.data[j * src1.w + dst_col];
+      dst.data[dst_row * dst.w + dst_col] = c;
     }
   }
-  timer.update();
-  NGFX_LOG("transpose elapsed: %f", timer.elapsed);
 }
 
-#define VEC4_LOAD(src, j)                                                      \
-  vec4(src.data[j], src.data[j + 1], src.data[j + 2], src.data[j + 3])
+void MatrixMultiplyCPUOp::packB(uint32_t jc, uint32_t nc, uint32_t pc,
+                                uint32_t kc) {
+  // Pack a KC x NC block of src1 into panels of NR columns,
+  // padding the last panel with zeros
+  uint32_t numPanels = (nc + NR - 1) / NR;
+  packedB.resize(size_t(numPanels) * kc * NR);
+  ThreadPool::parallelFor(threadPool, 0, numPanels, [&](uint32_t panel) {
+    uint32_t j0 = jc + panel * NR, nr = std::min(uint32_t(NR), jc + nc - j0);
+    float *dstData = &packedB[size_t(panel) * kc * NR];
+    for (uint32_t k = 0; k < kc; k++, dstData += NR) {
+      const float *srcData = &src1.data[size_t(pc + k) * src1.w + j0];
+      memcpy(dstData, srcData, nr * sizeof(float));
+      std::fill(dstData + nr, dstData + NR, 0.0f);
+    }
+  });
+}
+
+void MatrixMultiplyCPUOp::multiplyBlock(uint32_t ic, uint32_t mc, uint32_t jc,
+                                        uint32_t nc, uint32_t pc, uint32_t kc) {
+  // Pack a MC x KC block of src0 into panels of MR rows,
+  // padding the last panel with zeros
+  static thread_local std::vector<float> packedA;
+  uint32_t numPanels = (mc + MR - 1) / MR;
+  packedA.resize(size_t(numPanels) * kc * MR);
+  for (uint32_t panel = 0; panel < numPanels; panel++) {
+    uint32_t i0 = ic + panel * MR, mr = std::min(uint32_t(MR), ic + mc - i0);
+    float *dstData = &packedA[size_t(panel) * kc * MR];
+    for (uint32_t k = 0; k < kc; k++, dstData += MR) {
+      for (uint32_t i = 0; i < mr; i++)
+        dstData[i] = src0.data[size_t(i0 + i) * src0.w + pc + k];
+      std::fill(dstData + mr, dstData + MR, 0.0f);
+    }
+  }
+  // Multiply each MR x KC panel of src0 by each KC x NR panel of src1
+  float tile[MR * NR];
+  for (uint32_t jr = 0; jr < nc; jr += NR) {
+    uint32_t nr = std::min(uint32_t(NR), nc - jr);
+    // The packed block of src1 starts at a multiple of NC
+    const float *b = &packedB[size_t(((jc + jr) % NC) / NR) * kc * NR];
+    for (uint32_t ir = 0; ir < mc; ir += MR) {
+      uint32_t mr = std::min(uint32_t(MR), mc - ir);
+      microKernel(kc, &packedA[size_t(ir / MR) * kc * MR], b, tile);
+      for (uint32_t i = 0; i < mr; i++) {
+        float *c = &dst.data[size_t(ic + ir + i) * dst.w + jc + jr];
+        const float *t = &tile[i * NR];
+        if (pc == 0) {
+          for (uint32_t j = 0; j < nr; j++)
+            c[j] = t[j];
+        } else {
+          for (uint32_t j = 0; j < nr; j++)
+            c[j] += t[j];
+        }
+      }
+    }
+  }
+}
 
 void MatrixMultiplyCPUOp::matrixMultiply() {
   Timer timer;
-  float *dst_data = dst.data;
-  for (uint32_t dst_row = 0; dst_row < dst.h; dst_row++) {
-    uint32_t src0_offset = dst_row * src0.w;
-    for (uint32_t dst_col = 0; dst_col < dst.w; dst_col++) {
-      uint32_t src1t_offset = dst_col * src1t.h;
-      float c = 0.0f;
-      for (uint32_t j = 0; j < src0.w; j += 4) {
-        vec4 a0 = VEC4_LOAD(src0, src0_offset + j),
-             b0 = VEC4_LOAD(src1t, src1t_offset + j);
-        c += dot(a0, b0);
-      }
-      *dst_data++ = c;
+  uint32_t M = dst.h, N = dst.w, K = src0.w;
+  if (K == 0) {
+    std::fill(dst.data, dst.data + size_t(M) * N, 0.0f);
+    return;
+  }
+  for (uint32_t jc = 0; jc < N; jc += NC) {
+    uint32_t nc = std::min(uint32_t(NC), N - jc);
+    for (uint32_t pc = 0; pc < K; pc += KC) {
+      uint32_t kc = std::min(uint32_t(KC), K - pc);
+      packB(jc, nc, pc, kc);
+      uint32_t numRowBlocks = (M + MC - 1) / MC,
+               numColBlocks = (nc + NB - 1) / NB;
+      ThreadPool::parallelFor(
+          threadPool, 0, numRowBlocks * numColBlocks, [&](uint32_t j) {
+            uint32_t ic = (j / numColBlocks) * MC,
+                     jb = jc + (j % numColBlocks) * NB;
+            multiplyBlock(ic, std::min(uint32_t(MC), M - ic), jb,
+                          std::min(uint32_t(NB), jc + nc - jb), pc, kc);
+          });
     }
   }
   timer.update();
-  NGFX_LOG("CPU matrix multiply elapsed: %f", timer.elapsed);
+  NGFX_LOG_DEBUG("CPU matrix multiply elapsed: %f", timer.elapsed);
 }
@@ -20,20 +20,41 @@
  */
 #pragma once
 #include "ngfx/computeOps/MatrixMultiplyOp.h"
+#include "ngfx/core/ThreadPool.h"
+#include <vector>
 
 namespace ngfx {
+
+/** \class MatrixMultiplyCPUOp
+ *
+ *  This class computes dst = src0 * src1 on the CPU (row-major matrices).
+ *  It uses cache blocking with packed panels, a register-tiled SIMD micro-kernel
+ *  (AVX-512, AVX2, SSE2 or NEON, depending on the target instruction set,
+ *  with a scalar fallback), and splits the work across a thread pool.
+ *  The work is processed serially if threadPool is null.
+ */
+
 class MatrixMultiplyCPUOp : public MatrixMultiplyOp {
 public:
-  MatrixMultiplyCPUOp(MatrixParam src0, MatrixParam src1, MatrixParam dst);
+  MatrixMultiplyCPUOp(MatrixParam src0, MatrixParam src1, MatrixParam dst,
+                      ThreadPool *threadPool = ThreadPool::getDefault());
   virtual ~MatrixMultiplyCPUOp();
   void apply(CommandBuffer *commandBuffer = nullptr,
              Graphics *graphics = nullptr) override;
   void update(MatrixParam src0, MatrixParam src1) override;
   static void transpose(MatrixParam &src, MatrixParam &dst);
+  /** Compute dst = src0 * src1 using a naive triple loop.
+   *  Used as a reference for validation and benchmarking */
+  static void matrixMultiplyReference(const MatrixParam &src0,
+                                      const MatrixParam &src1, MatrixParam &dst);
 
 protected:
   void matrixMultiply();
-  std::vector<float> src1t_data;
-  MatrixParam src0, src1, src1t, dst;
+  void packB(uint32_t jc, uint32_t nc, uint32_t pc, uint32_t kc);
+  void multiplyBlock(uint32_t ic, uint32_t mc, uint32_t jc, uint32_t nc,
+                     uint32_t pc, uint32_t kc);
+  std::vector<float> packedB;
+  MatrixParam src0, src1, dst;
+  ThreadPool *threadPool;
 };
 } // namespace ngfx
@@ -19,16 +19,35 @@
  * under the License.
  */
 #include "ngfx/computeOps/MatrixMultiplyGPUOp.h"
-#include "ngfx/computeOps/MatrixMultiplyCPUOp.h"
 #include "ngfx/core/DebugUtil.h"
 #include "ngfx/core/Timer.h"
 #include "ngfx/graphics/BufferUtil.h"
+#include <map>
 using namespace ngfx;
 
+const MatrixMultiplyGPUOp::TileConfig MatrixMultiplyGPUOp::DEFAULT_TILE_CONFIG = {
+    16, 8, 16, 4, 2};
+
+// The candidate configurations use at most 128 invocations per workgroup,
+// the minimum limit guaranteed by Vulkan
+const std::vector<MatrixMultiplyGPUOp::TileConfig>
+    MatrixMultiplyGPUOp::TILE_CONFIG_CANDIDATES = {
+    {16, 8, 16, 2, 1}, {16, 8, 16, 4, 2}, {16, 8, 16, 8, 4},
+    {8, 8, 8, 4, 4}, {8, 8, 16, 8, 8}};
+
+// The autotuned configuration for each device
+static std::map<Device *, MatrixMultiplyGPUOp::TileConfig> tunedTileConfigs;
+
 MatrixMultiplyGPUOp::MatrixMultiplyGPUOp(GraphicsContext *ctx, MatrixParam src0,
-                                         MatrixParam src1, MatrixParam dst)
+                                         MatrixParam src1, MatrixParam dst,
+                                         Graphics *graphics)
     : MatrixMultiplyOp(ctx), dst(dst) {
   update(src0, src1);
+  auto it = tunedTileConfigs.find(ctx->device);
+  if (it != tunedTileConfigs.end())
+    tileConfig = it->second;
+  else if (graphics)
+    autotune(graphics);
   createPipeline();
 }
 
@@ -44,30 +63,89 @@ void MatrixMultiplyGPUOp::apply(CommandBuffer *commandBuffer,
                               SHADER_STAGE_COMPUTE_BIT, true);
   graphics->bindStorageBuffer(commandBuffer, bDst.get(), SSBO_DST,
                               SHADER_STAGE_COMPUTE_BIT, false);
-  graphics->dispatch(commandBuffer, dst.w, dst.h, 1, 1, 1, 1);
+  uint32_t tileM = tileConfig.wgY * tileConfig.threadM,
+           tileN = tileConfig.wgX * tileConfig.threadN;
+  graphics->dispatch(commandBuffer, (dst.w + tileN - 1) / tileN,
+                     (dst.h + tileM - 1) / tileM, 1, tileConfig.wgX,
+                     tileConfig.wgY, 1);
 }
 
 void MatrixMultiplyGPUOp::update(MatrixParam src0, MatrixParam src1) {
-  std::vector<float> src1t_data(size_t(src1.w * src1.h));
-  MatrixParam src1t = {src1.h, src1.w, src1t_data.data()};
-  MatrixMultiplyCPUOp::transpose(src1, src1t);
-  UboData uboData = {int32_t(src0.w),  int32_t(src0.h), int32_t(src1t.w),
-                     int32_t(src1t.h), int32_t(dst.w),  int32_t(dst.h)};
-  bUbo.reset(createUniformBuffer(ctx, &uboData, sizeof(uboData)));
-  bSrc0.reset(
-      createStorageBuffer(ctx, src0.data, src0.w * src0.h * sizeof(float)));
-  bSrc1.reset(
-      createStorageBuffer(ctx, src1t.data, src1.w * src1.h * sizeof(float)));
-  bDst.reset(createStorageBuffer(ctx, dst.data, dst.w * dst.h * sizeof(float)));
+  if (src0.w != src1.h)
+    NGFX_ERR("matrix dimensions mismatch: %dx%d * %dx%d", src0.w, src0.h,
+             src1.w, src1.h);
+  // The output dimensions follow the input dimensions
+  dst.w = src1.w;
+  dst.h = src0.h;
+  UboData uboData = {int32_t(src0.w), int32_t(src0.h), int32_t(src1.w),
+                     int32_t(src1.h), int32_t(dst.w),  int32_t(dst.h)};
+  uint32_t src0Size = src0.w * src0.h * sizeof(float),
+           src1Size = src1.w * src1.h * sizeof(float),
+           dstSize = dst.w * dst.h * sizeof(float);
+  // Update the buffers in place, unless the size has changed
+  updateBuffer(ctx, bUbo, &uboData, sizeof(uboData),
+               BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  updateBuffer(ctx, bSrc0, src0.data, src0Size,
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  updateBuffer(ctx, bSrc1, src1.data, src1Size,
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  updateBuffer(ctx, bDst, nullptr, dstSize, BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+void MatrixMultiplyGPUOp::setTileConfig(const TileConfig &tileConfig) {
+  this->tileConfig = tileConfig;
+  createPipeline();
+}
+
+void MatrixMultiplyGPUOp::autotune(Graphics *graphics) {
+#ifdef NGFX_GRAPHICS_BACKEND_VULKAN
+  const uint32_t NUM_ITERATIONS = 4;
+  float minElapsed = 0.0f;
+  TileConfig bestTileConfig = DEFAULT_TILE_CONFIG;
+  for (auto &candidate : TILE_CONFIG_CANDIDATES) {
+    setTileConfig(candidate);
+    auto run = [&]() {
+      auto commandBuffer = ctx->computeCommandBuffer();
+      commandBuffer->begin();
+      for (uint32_t j = 0; j < NUM_ITERATIONS; j++)
+        apply(commandBuffer, graphics);
+      commandBuffer->end();
+      ctx->submit(commandBuffer);
+      ctx->queue->waitIdle();
+    };
+    run(); // warm up
+    Timer timer;
+    run();
+    timer.update();
+    if (minElapsed == 0.0f || timer.elapsed < minElapsed) {
+      minElapsed = timer.elapsed;
+      bestTileConfig = candidate;
+    }
+  }
+  tileConfig = bestTileConfig;
+  NGFX_LOG_DEBUG("matrix multiply tile config: workgroup %dx%d, tileK: %d, thread tile: %dx%d",
+                 tileConfig.wgX, tileConfig.wgY, tileConfig.tileK,
+                 tileConfig.threadM, tileConfig.threadN);
+#else
+  // The other backends don't support specialization constants yet
+  tileConfig = DEFAULT_TILE_CONFIG;
+#endif
+  tunedTileConfigs[ctx->device] = tileConfig;
 }
 
 void MatrixMultiplyGPUOp::createPipeline() {
-  const std::string key = "matrixMultiplyOp";
+  const std::string key = "matrixMultiplyOp_" + std::to_string(tileConfig.wgX) +
+                          "_" + std::to_string(tileConfig.wgY) + "_" +
+                          std::to_string(tileConfig.tileK) + "_" +
+                          std::to_string(tileConfig.threadM) + "_" +
+                          std::to_string(tileConfig.threadN);
   computePipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
   if (computePipeline)
     return;
   computePipeline = ComputePipeline::create(
       ctx,
-      ComputeShaderModule::create(ctx->device, NGFX_DATA_DIR "/matrixMultiply.comp").get());
+      ComputeShaderModule::create(ctx->device, NGFX_DATA_DIR "/matrixMultiply.comp").get(),
+      {tileConfig.wgX, tileConfig.wgY, tileConfig.tileK, tileConfig.threadM,
+       tileConfig.threadN});
   ctx->pipelineCache->add(key, computePipeline);
 }
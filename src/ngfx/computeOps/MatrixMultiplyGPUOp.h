@@ -21,22 +21,64 @@
 #pragma once
 #include "ngfx/computeOps/MatrixMultiplyOp.h"
 #include "ngfx/graphics/Graphics.h"
+#include <vector>
 
 namespace ngfx {
+
+/** \class MatrixMultiplyGPUOp
+ *
+ *  This class computes dst = src0 * src1 on the GPU (row-major matrices).
+ *  Each workgroup computes a tile of dst, staging the tiles of src0 and src1
+ *  in shared memory.  The workgroup and tile sizes are passed to the shader
+ *  via specialization constants.
+ *  The buffers are persistent: update() uploads new data in place
+ *  when the matrix dimensions don't change, and reallocates them otherwise.
+ */
+
 class MatrixMultiplyGPUOp : public MatrixMultiplyOp {
 public:
+  /** The tile configuration.
+   *  Each workgroup computes a (wgY * threadM) x (wgX * threadN) tile of dst */
+  struct TileConfig {
+    /** The workgroup size */
+    uint32_t wgX, wgY;
+    /** The tile size along the shared dimension */
+    uint32_t tileK;
+    /** The number of rows and columns computed by each thread */
+    uint32_t threadM, threadN;
+  };
+  /** Create the matrix multiply operation
+   *  @param ctx The graphics context
+   *  @param src0 The first input matrix
+   *  @param src1 The second input matrix
+   *  @param dst The output matrix.  The data pointer is optional,
+   *         the result can be downloaded from bDst
+   *  @param graphics The graphics interface.  If set, the tile configuration is
+   *         autotuned the first time the operation is used on a given device
+   */
   MatrixMultiplyGPUOp(GraphicsContext *ctx, MatrixParam src0, MatrixParam src1,
-                      MatrixParam dst);
+                      MatrixParam dst, Graphics *graphics = nullptr);
   virtual ~MatrixMultiplyGPUOp();
   virtual void apply(CommandBuffer *commandBuffer = nullptr,
                      Graphics *graphics = nullptr);
+  /** Update the input matrices.
+   *  The dimensions of dst are set to src1.w x src0.h */
   virtual void update(MatrixParam src0, MatrixParam src1);
+  /** Set the tile configuration */
+  void setTileConfig(const TileConfig &tileConfig);
+  /** Benchmark the candidate tile configurations and select the fastest one */
+  void autotune(Graphics *graphics);
+  /** The default tile configuration, matching the shader defaults */
+  static const TileConfig DEFAULT_TILE_CONFIG;
+  /** The tile configurations benchmarked by autotune() */
+  static const std::vector<TileConfig> TILE_CONFIG_CANDIDATES;
   std::unique_ptr<Buffer> bUbo;
   std::unique_ptr<Buffer> bSrc0, bSrc1, bDst;
+  TileConfig tileConfig = DEFAULT_TILE_CONFIG;
 
 protected:
   struct UboData {
-    int32_t src0_w, src0_h, src1t_w, src1t_h, dst_w, dst_h;
+    int32_t src0_w, src0_h, src1_w, src1_h, dst_w, dst_h;
   };
   void createPipeline();
   ComputePipeline *computePipeline;
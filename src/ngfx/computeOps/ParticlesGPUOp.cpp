@@ -0,0 +1,142 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/ParticlesGPUOp.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/BufferUtil.h"
+#include "ngfx/graphics/Graphics.h"
+using namespace ngfx;
+
+ParticlesGPUOp::ParticlesGPUOp(GraphicsContext *ctx, uint32_t maxParticles,
+                               const Params &params)
+    : ComputeOp(ctx), maxParticles(maxParticles) {
+  if (maxParticles == 0)
+    NGFX_ERR("maxParticles must be greater than 0");
+  if (maxParticles > MAX_PARTICLES)
+    NGFX_ERR("maxParticles: %d exceeds the maximum: %d", maxParticles,
+             MAX_PARTICLES);
+  uint32_t particlesSize = maxParticles * sizeof(Particle);
+  bParticles.reset(Buffer::create(
+      ctx, nullptr, particlesSize,
+      BufferUsageFlags(BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                       BUFFER_USAGE_VERTEX_BUFFER_BIT)));
+  bParticlesTmp.reset(createStorageBuffer(ctx, nullptr, particlesSize));
+  bAlive.reset(
+      createStorageBuffer(ctx, nullptr, maxParticles * sizeof(float)));
+  DrawIndirectCommand drawArgs = {0, 1, 0, 0};
+  bDrawArgs.reset(createIndirectBuffer(ctx, &drawArgs, sizeof(drawArgs)));
+  State state = {0, 0};
+  bState.reset(createStorageBuffer(ctx, &state, sizeof(state)));
+  // The exclusive scan of the alive flags gives the compacted index of each
+  // live particle.  The flags are stored as floats, which is exact for up to
+  // MAX_PARTICLES particles
+  scanOp.reset(new ScanGPUOp(ctx, bAlive.get(), maxParticles, true));
+  update(params);
+  createPipelines();
+  simulatePipeline->getBindings({&U_SIMULATE_PARAMS, &SSBO_SIMULATE_STATE,
+                                 &SSBO_SIMULATE_SRC, &SSBO_SIMULATE_DST,
+                                 &SSBO_SIMULATE_ALIVE});
+  compactPipeline->getBindings(
+      {&U_COMPACT_PARAMS, &SSBO_COMPACT_STATE, &SSBO_COMPACT_SRC,
+       &SSBO_COMPACT_ALIVE, &SSBO_COMPACT_OFFSETS, &SSBO_COMPACT_DST,
+       &SSBO_COMPACT_DRAW_ARGS});
+}
+
+ParticlesGPUOp::~ParticlesGPUOp() {}
+
+void ParticlesGPUOp::apply(CommandBuffer *commandBuffer, Graphics *graphics) {
+  uint32_t numGroups = (maxParticles + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+  // The compact pass of the previous frame writes the particles, the state and
+  // the draw arguments
+  graphics->computeBarrier(commandBuffer);
+  // Age and integrate the live particles, and flag the particles which are
+  // still alive
+  graphics->bindComputePipeline(commandBuffer, simulatePipeline);
+  graphics->bindUniformBuffer(commandBuffer, bParams.get(), U_SIMULATE_PARAMS,
+                              SHADER_STAGE_COMPUTE_BIT);
+  graphics->bindStorageBuffer(commandBuffer, bState.get(), SSBO_SIMULATE_STATE,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  graphics->bindStorageBuffer(commandBuffer, bParticles.get(),
+                              SSBO_SIMULATE_SRC, SHADER_STAGE_COMPUTE_BIT,
+                              true);
+  graphics->bindStorageBuffer(commandBuffer, bParticlesTmp.get(),
+                              SSBO_SIMULATE_DST, SHADER_STAGE_COMPUTE_BIT,
+                              false);
+  graphics->bindStorageBuffer(commandBuffer, bAlive.get(), SSBO_SIMULATE_ALIVE,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  graphics->dispatch(commandBuffer, numGroups, 1, 1, WORKGROUP_SIZE, 1, 1);
+  graphics->computeBarrier(commandBuffer);
+  scanOp->apply(commandBuffer, graphics);
+  graphics->computeBarrier(commandBuffer);
+  // Scatter the live particles to their compacted index, append the emitted
+  // particles and update the particle count
+  graphics->bindComputePipeline(commandBuffer, compactPipeline);
+  graphics->bindUniformBuffer(commandBuffer, bParams.get(), U_COMPACT_PARAMS,
+                              SHADER_STAGE_COMPUTE_BIT);
+  graphics->bindStorageBuffer(commandBuffer, bState.get(), SSBO_COMPACT_STATE,
+                              SHADER_STAGE_COMPUTE_BIT, false);
+  graphics->bindStorageBuffer(commandBuffer, bParticlesTmp.get(),
+                              SSBO_COMPACT_SRC, SHADER_STAGE_COMPUTE_BIT, true);
+  graphics->bindStorageBuffer(commandBuffer, bAlive.get(), SSBO_COMPACT_ALIVE,
+                              SHADER_STAGE_COMPUTE_BIT, true);
+  graphics->bindStorageBuffer(commandBuffer, scanOp->bDst.get(),
+                              SSBO_COMPACT_OFFSETS, SHADER_STAGE_COMPUTE_BIT,
+                              true);
+  graphics->bindStorageBuffer(commandBuffer, bParticles.get(),
+                              SSBO_COMPACT_DST, SHADER_STAGE_COMPUTE_BIT,
+                              false);
+  graphics->bindStorageBuffer(commandBuffer, bDrawArgs.get(),
+                              SSBO_COMPACT_DRAW_ARGS, SHADER_STAGE_COMPUTE_BIT,
+                              false);
+  graphics->dispatch(commandBuffer, numGroups, 1, 1, WORKGROUP_SIZE, 1, 1);
+  // Make the particles and the draw arguments visible to the draws
+  graphics->computeToDrawBarrier(commandBuffer);
+}
+
+void ParticlesGPUOp::update(const Params &params) {
+  this->params = params;
+  UboData uboData = {params, maxParticles};
+  updateBuffer(ctx, bParams, &uboData, sizeof(uboData),
+               BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+}
+
+void ParticlesGPUOp::reset() {
+  State state = {0, 0};
+  bState->upload(&state, sizeof(state));
+  DrawIndirectCommand drawArgs = {0, 1, 0, 0};
+  bDrawArgs->upload(&drawArgs, sizeof(drawArgs));
+}
+
+void ParticlesGPUOp::createPipelines() {
+  auto createPipeline = [&](const std::string &key,
+                            const std::string &filename) {
+    auto pipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
+    if (pipeline)
+      return pipeline;
+    pipeline = ComputePipeline::create(
+        ctx, ComputeShaderModule::create(ctx->device, filename).get());
+    ctx->pipelineCache->add(key, pipeline);
+    return pipeline;
+  };
+  simulatePipeline = createPipeline("particlesSimulateOp",
+                                    NGFX_DATA_DIR "/particlesSimulate.comp");
+  compactPipeline = createPipeline("particlesCompactOp",
+                                   NGFX_DATA_DIR "/particlesCompact.comp");
+}
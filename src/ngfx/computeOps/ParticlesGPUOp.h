@@ -0,0 +1,122 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/computeOps/ScanGPUOp.h"
+#include "ngfx/graphics/Buffer.h"
+#include <glm/glm.hpp>
+
+namespace ngfx {
+
+/** \class ParticlesGPUOp
+ *
+ *  This class simulates a particle system on the GPU.  The particle state stays
+ *  in storage buffers across frames: each apply() ages and integrates the live
+ *  particles, compacts them with a prefix scan of the alive flags, and appends
+ *  the newly emitted particles.  The compaction preserves the particle order
+ *  and the emission uses a hash of the frame index, so the simulation is
+ *  deterministic.
+ *  The particles can be rendered directly from bParticles, using bDrawArgs
+ *  for an indirect draw with one vertex per particle.  apply() is recorded
+ *  outside a render pass, and ends with a barrier making its results visible
+ *  to the subsequent draws in the same command buffer.
+ */
+
+class ParticlesGPUOp : public ComputeOp {
+public:
+  /** The particle layout in bParticles */
+  struct Particle {
+    /** The position (xyz) and the age in seconds (w) */
+    glm::vec4 position;
+    /** The velocity (xyz) and the lifetime in seconds (w) */
+    glm::vec4 velocity;
+  };
+  /** The simulation parameters */
+  struct Params {
+    glm::vec4 emitterPosition = glm::vec4(0.0f);
+    glm::vec4 gravity = glm::vec4(0.0f, -9.8f, 0.0f, 0.0f);
+    /** The time step in seconds */
+    float dt = 1.0f / 64.0f;
+    /** The initial speed of the emitted particles */
+    float speed = 1.0f;
+    float minLifetime = 0.5f, maxLifetime = 1.0f;
+    /** The number of particles emitted per frame */
+    uint32_t emitCount = 64;
+    /** The seed of the random number generator */
+    uint32_t seed = 0;
+  };
+  /** The simulation state in bState */
+  struct State {
+    /** The number of live particles */
+    uint32_t count;
+    /** The number of simulated frames */
+    uint32_t frame;
+  };
+  /** Create the particle system
+   *  @param ctx The graphics context
+   *  @param maxParticles The capacity of the particle buffers, at most
+   *         MAX_PARTICLES.  Particles emitted when the buffer is full are
+   *         discarded
+   *  @param params The simulation parameters
+   */
+  ParticlesGPUOp(GraphicsContext *ctx, uint32_t maxParticles,
+                 const Params &params = Params());
+  virtual ~ParticlesGPUOp();
+  /** Simulate one frame.  Several frames can be recorded back to back in the
+   *  same command buffer */
+  void apply(CommandBuffer *commandBuffer = nullptr,
+             Graphics *graphics = nullptr) override;
+  /** Update the simulation parameters */
+  void update(const Params &params);
+  /** Remove all the particles and reset the frame counter */
+  void reset();
+  static const uint32_t WORKGROUP_SIZE = 256;
+  /** The maximum capacity: the alive flags are scanned as floats, which
+   *  represent the compacted indices exactly up to 2^24 */
+  static const uint32_t MAX_PARTICLES = 1u << 24;
+  uint32_t maxParticles;
+  Params params;
+  /** The particles: maxParticles Particle structs, of which the first
+   *  State::count are live.  Also usable as a vertex buffer */
+  std::unique_ptr<Buffer> bParticles;
+  /** The simulation state: a State struct */
+  std::unique_ptr<Buffer> bState;
+  /** The indirect draw arguments: a DrawIndirectCommand drawing one vertex
+   *  per live particle */
+  std::unique_ptr<Buffer> bDrawArgs;
+
+protected:
+  struct UboData {
+    Params params;
+    uint32_t max_particles;
+  };
+  void createPipelines();
+  std::unique_ptr<Buffer> bParams, bParticlesTmp, bAlive;
+  std::unique_ptr<ScanGPUOp> scanOp;
+  ComputePipeline *simulatePipeline, *compactPipeline;
+  uint32_t U_SIMULATE_PARAMS = 0, SSBO_SIMULATE_STATE = 1,
+           SSBO_SIMULATE_SRC = 2, SSBO_SIMULATE_DST = 3,
+           SSBO_SIMULATE_ALIVE = 4;
+  uint32_t U_COMPACT_PARAMS = 0, SSBO_COMPACT_STATE = 1, SSBO_COMPACT_SRC = 2,
+           SSBO_COMPACT_ALIVE = 3, SSBO_COMPACT_OFFSETS = 4,
+           SSBO_COMPACT_DST = 5, SSBO_COMPACT_DRAW_ARGS = 6;
+};
+} // namespace ngfx
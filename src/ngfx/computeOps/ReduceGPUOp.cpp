@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/ReduceGPUOp.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/BufferUtil.h"
+using namespace ngfx;
+
+ReduceGPUOp::ReduceGPUOp(GraphicsContext *ctx, Operation operation,
+                         Buffer *src, uint32_t count)
+    : ComputeOp(ctx), operation(operation) {
+  update(src, count);
+  createPipeline();
+  computePipeline->getBindings({&U_UBO, &SSBO_SRC, &SSBO_DST});
+}
+
+ReduceGPUOp::~ReduceGPUOp() {}
+
+void ReduceGPUOp::apply(CommandBuffer *commandBuffer, Graphics *graphics) {
+  graphics->bindComputePipeline(commandBuffer, computePipeline);
+  Buffer *passSrc = src;
+  for (uint32_t j = 0; j < passes.size(); j++) {
+    auto &pass = passes[j];
+    bool lastPass = (j == passes.size() - 1);
+    Buffer *passDst = lastPass ? bDst.get() : pass.bDst.get();
+    graphics->bindUniformBuffer(commandBuffer, pass.bUbo.get(), U_UBO,
+                                SHADER_STAGE_COMPUTE_BIT);
+    graphics->bindStorageBuffer(commandBuffer, passSrc, SSBO_SRC,
+                                SHADER_STAGE_COMPUTE_BIT, true);
+    graphics->bindStorageBuffer(commandBuffer, passDst, SSBO_DST,
+                                SHADER_STAGE_COMPUTE_BIT, false);
+    graphics->dispatch(commandBuffer, pass.numGroups, 1, 1, BLOCK_SIZE / 4, 1,
+                       1);
+    if (!lastPass)
+      graphics->computeBarrier(commandBuffer);
+    passSrc = passDst;
+  }
+}
+
+void ReduceGPUOp::update(Buffer *src, uint32_t count) {
+  if (count == 0)
+    NGFX_ERR("cannot reduce an empty buffer");
+  this->src = src;
+  this->count = count;
+  // Each pass reduces the output of the previous pass, until a single value remains
+  uint32_t numPasses = 0;
+  for (uint32_t n = count; n > 1 || numPasses == 0;
+       n = (n + BLOCK_SIZE - 1) / BLOCK_SIZE)
+    numPasses++;
+  passes.resize(numPasses);
+  uint32_t n = count;
+  for (uint32_t j = 0; j < numPasses; j++) {
+    auto &pass = passes[j];
+    pass.numGroups = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    UboData uboData = {int32_t(n), int32_t(operation)};
+    updateBuffer(ctx, pass.bUbo, &uboData, sizeof(uboData),
+                 BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    if (j != numPasses - 1)
+      updateBuffer(ctx, pass.bDst, nullptr, pass.numGroups * sizeof(float),
+                   BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    n = pass.numGroups;
+  }
+  updateBuffer(ctx, bDst, nullptr, sizeof(float),
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+void ReduceGPUOp::createPipeline() {
+  bool useSubgroups = ctx->device->supportsSubgroupArithmetic();
+  const std::string key = useSubgroups ? "reduceSubgroupOp" : "reduceOp";
+  computePipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
+  if (computePipeline)
+    return;
+  const std::string filename = useSubgroups
+                                   ? NGFX_DATA_DIR "/reduceSubgroup.comp"
+                                   : NGFX_DATA_DIR "/reduce.comp";
+  computePipeline = ComputePipeline::create(
+      ctx, ComputeShaderModule::create(ctx->device, filename).get());
+  ctx->pipelineCache->add(key, computePipeline);
+}
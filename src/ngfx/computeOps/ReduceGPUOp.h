@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/graphics/Buffer.h"
+#include <vector>
+
+namespace ngfx {
+
+/** \class ReduceGPUOp
+ *
+ *  This class reduces a buffer of floats to a single value (sum, min or max)
+ *  on the GPU.  Each pass reduces blocks of 1024 elements, and the passes are
+ *  repeated until a single value remains, so the result never leaves the GPU.
+ *  The reduction within a workgroup uses subgroup operations when supported by
+ *  the device, and a shared memory tree reduction otherwise.
+ */
+
+class ReduceGPUOp : public ComputeOp {
+public:
+  enum Operation { OPERATION_SUM, OPERATION_MIN, OPERATION_MAX };
+  /** Create the reduce operation
+   *  @param ctx The graphics context
+   *  @param operation The reduction operation
+   *  @param src The input storage buffer
+   *  @param count The number of elements in src
+   */
+  ReduceGPUOp(GraphicsContext *ctx, Operation operation, Buffer *src,
+              uint32_t count);
+  virtual ~ReduceGPUOp();
+  void apply(CommandBuffer *commandBuffer = nullptr,
+             Graphics *graphics = nullptr) override;
+  /** Update the input buffer.  The intermediate buffers are reused when their
+   *  size is unchanged, and reallocated when the element count changes the
+   *  number of workgroups of a pass */
+  void update(Buffer *src, uint32_t count);
+  /** The number of elements reduced by each workgroup */
+  static const uint32_t BLOCK_SIZE = 1024;
+  Operation operation;
+  Buffer *src = nullptr;
+  uint32_t count = 0;
+  /** The result: a storage buffer with a single float */
+  std::unique_ptr<Buffer> bDst;
+
+protected:
+  struct UboData {
+    int32_t count, operation;
+  };
+  struct Pass {
+    std::unique_ptr<Buffer> bUbo, bDst;
+    uint32_t numGroups;
+  };
+  void createPipeline();
+  std::vector<Pass> passes;
+  ComputePipeline *computePipeline;
+  uint32_t U_UBO = 0, SSBO_SRC = 1, SSBO_DST = 2;
+};
+} // namespace ngfx
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/computeOps/ScanGPUOp.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/BufferUtil.h"
+using namespace ngfx;
+
+ScanGPUOp::ScanGPUOp(GraphicsContext *ctx, Buffer *src, uint32_t count,
+                     bool exclusive)
+    : ComputeOp(ctx), exclusive(exclusive) {
+  update(src, count);
+  createPipelines();
+  scanPipeline->getBindings({&U_UBO, &SSBO_SRC, &SSBO_DST, &SSBO_BLOCK_SUMS});
+  addPipeline->getBindings({&U_ADD_UBO, &SSBO_ADD_BLOCK_SUMS, &SSBO_ADD_DST});
+}
+
+ScanGPUOp::~ScanGPUOp() {}
+
+void ScanGPUOp::apply(CommandBuffer *commandBuffer, Graphics *graphics) {
+  auto levelDst = [&](uint32_t j) {
+    return (j == 0) ? bDst.get() : levels[j].bDst.get();
+  };
+  // Scan each block, and the block sums of the previous level
+  graphics->bindComputePipeline(commandBuffer, scanPipeline);
+  for (uint32_t j = 0; j < levels.size(); j++) {
+    auto &level = levels[j];
+    Buffer *levelSrc = (j == 0) ? src : levels[j - 1].bBlockSums.get();
+    graphics->bindUniformBuffer(commandBuffer, level.bUbo.get(), U_UBO,
+                                SHADER_STAGE_COMPUTE_BIT);
+    graphics->bindStorageBuffer(commandBuffer, levelSrc, SSBO_SRC,
+                                SHADER_STAGE_COMPUTE_BIT, true);
+    graphics->bindStorageBuffer(commandBuffer, levelDst(j), SSBO_DST,
+                                SHADER_STAGE_COMPUTE_BIT, false);
+    graphics->bindStorageBuffer(commandBuffer, level.bBlockSums.get(),
+                                SSBO_BLOCK_SUMS, SHADER_STAGE_COMPUTE_BIT,
+                                false);
+    graphics->dispatch(commandBuffer, level.numGroups, 1, 1, BLOCK_SIZE / 4, 1,
+                       1);
+    if (levels.size() > 1)
+      graphics->computeBarrier(commandBuffer);
+  }
+  if (levels.size() == 1)
+    return;
+  // Add the scanned block sums to each block, starting from the top level
+  graphics->bindComputePipeline(commandBuffer, addPipeline);
+  for (int32_t j = int32_t(levels.size()) - 2; j >= 0; j--) {
+    auto &level = levels[j];
+    graphics->bindUniformBuffer(commandBuffer, level.bUbo.get(), U_ADD_UBO,
+                                SHADER_STAGE_COMPUTE_BIT);
+    graphics->bindStorageBuffer(commandBuffer, levelDst(j + 1),
+                                SSBO_ADD_BLOCK_SUMS, SHADER_STAGE_COMPUTE_BIT,
+                                true);
+    graphics->bindStorageBuffer(commandBuffer, levelDst(j), SSBO_ADD_DST,
+                                SHADER_STAGE_COMPUTE_BIT, false);
+    graphics->dispatch(commandBuffer, level.numGroups, 1, 1, BLOCK_SIZE / 4, 1,
+                       1);
+    if (j > 0)
+      graphics->computeBarrier(commandBuffer);
+  }
+}
+
+void ScanGPUOp::update(Buffer *src, uint32_t count) {
+  if (count == 0)
+    NGFX_ERR("cannot scan an empty buffer");
+  this->src = src;
+  this->count = count;
+  uint32_t numLevels = 0;
+  for (uint32_t n = count; n > 1 || numLevels == 0;
+       n = (n + BLOCK_SIZE - 1) / BLOCK_SIZE)
+    numLevels++;
+  levels.resize(numLevels);
+  uint32_t n = count;
+  for (uint32_t j = 0; j < numLevels; j++) {
+    auto &level = levels[j];
+    level.count = n;
+    level.numGroups = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // The block sums are always scanned with an exclusive scan
+    UboData uboData = {int32_t(n), (j == 0) ? int32_t(exclusive) : 1};
+    updateBuffer(ctx, level.bUbo, &uboData, sizeof(uboData),
+                 BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    if (j > 0)
+      updateBuffer(ctx, level.bDst, nullptr, n * sizeof(float),
+                   BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    updateBuffer(ctx, level.bBlockSums, nullptr,
+                 level.numGroups * sizeof(float),
+                 BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    n = level.numGroups;
+  }
+  updateBuffer(ctx, bDst, nullptr, count * sizeof(float),
+               BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+void ScanGPUOp::createPipelines() {
+  auto createPipeline = [&](const std::string &key,
+                            const std::string &filename) {
+    auto pipeline = (ComputePipeline *)ctx->pipelineCache->get(key);
+    if (pipeline)
+      return pipeline;
+    pipeline = ComputePipeline::create(
+        ctx, ComputeShaderModule::create(ctx->device, filename).get());
+    ctx->pipelineCache->add(key, pipeline);
+    return pipeline;
+  };
+  if (ctx->device->supportsSubgroupArithmetic())
+    scanPipeline =
+        createPipeline("scanSubgroupOp", NGFX_DATA_DIR "/scanSubgroup.comp");
+  else
+    scanPipeline = createPipeline("scanOp", NGFX_DATA_DIR "/scan.comp");
+  addPipeline = createPipeline("scanAddOp", NGFX_DATA_DIR "/scanAdd.comp");
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/compute/ComputeOp.h"
+#include "ngfx/graphics/Buffer.h"
+#include <vector>
+
+namespace ngfx {
+
+/** \class ScanGPUOp
+ *
+ *  This class computes the prefix sum of a buffer of floats on the GPU.
+ *  Each workgroup scans a block of 1024 elements and outputs the block sum.
+ *  The block sums are scanned recursively, and added back to each block.
+ *  The scan within a workgroup uses subgroup operations when supported by
+ *  the device, and shared memory otherwise.
+ */
+
+class ScanGPUOp : public ComputeOp {
+public:
+  /** Create the scan operation
+   *  @param ctx The graphics context
+   *  @param src The input storage buffer
+   *  @param count The number of elements in src
+   *  @param exclusive If true, dst[i] is the sum of src[0 .. i - 1],
+   *         otherwise it's the sum of src[0 .. i]
+   */
+  ScanGPUOp(GraphicsContext *ctx, Buffer *src, uint32_t count,
+            bool exclusive = false);
+  virtual ~ScanGPUOp();
+  void apply(CommandBuffer *commandBuffer = nullptr,
+             Graphics *graphics = nullptr) override;
+  /** Update the input buffer */
+  void update(Buffer *src, uint32_t count);
+  /** The number of elements scanned by each workgroup */
+  static const uint32_t BLOCK_SIZE = 1024;
+  Buffer *src = nullptr;
+  uint32_t count = 0;
+  bool exclusive;
+  /** The result: a storage buffer with count floats */
+  std::unique_ptr<Buffer> bDst;
+
+protected:
+  struct UboData {
+    int32_t count, exclusive;
+  };
+  /** Each level scans the block sums of the previous level */
+  struct Level {
+    std::unique_ptr<Buffer> bUbo, bDst, bBlockSums;
+    uint32_t count, numGroups;
+  };
+  void createPipelines();
+  std::vector<Level> levels;
+  ComputePipeline *scanPipeline, *addPipeline;
+  uint32_t U_UBO = 0, SSBO_SRC = 1, SSBO_DST = 2, SSBO_BLOCK_SUMS = 3;
+  uint32_t U_ADD_UBO = 0, SSBO_ADD_BLOCK_SUMS = 1, SSBO_ADD_DST = 2;
+};
+} // namespace ngfx
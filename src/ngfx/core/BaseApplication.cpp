@@ -20,15 +20,84 @@
  */
 #include "ngfx/core/BaseApplication.h"
 #include "ngfx/core/DebugUtil.h"
-#include "ngfx/core/FPSCounter.h"
+#include "ngfx/core/FileUtil.h"
+#include "ngfx/core/Trace.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <json.hpp>
 using namespace ngfx;
 using namespace std::placeholders;
+using json = nlohmann::json;
+
+namespace {
+uint32_t parseUInt(const std::string &name, const std::string &value) {
+  char *end = nullptr;
+  unsigned long v = strtoul(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0')
+    NGFX_ERR("invalid value for %s: %s", name.c_str(), value.c_str());
+  return uint32_t(v);
+}
+
+// Set a benchmark option, given its name without the prefix (e.g. "frames")
+void setBenchmarkOption(BaseApplication::BenchmarkOptions &options,
+                        const std::string &name, const std::string &value) {
+  if (name == "frames")
+    options.numFrames = parseUInt(name, value);
+  else if (name == "warmup")
+    options.numWarmupFrames = parseUInt(name, value);
+  else if (name == "size") {
+    if (sscanf(value.c_str(), "%dx%d", &options.w, &options.h) != 2 ||
+        options.w <= 0 || options.h <= 0)
+      NGFX_ERR("invalid benchmark size: %s, expected WxH", value.c_str());
+  } else if (name == "output")
+    options.outputFile = value;
+  else
+    NGFX_ERR("unknown benchmark option: %s", name.c_str());
+}
+
+json toJSON(const FrameStats &stats) {
+  auto s = stats.getSummary();
+  return {{"samples", s.numSamples}, {"min_ms", s.min}, {"avg_ms", s.avg},
+          {"p50_ms", s.p50},         {"p95_ms", s.p95}, {"p99_ms", s.p99},
+          {"max_ms", s.max}};
+}
+} // namespace
 
 BaseApplication::BaseApplication(const std::string &appName, int w, int h,
                                  bool enableDepthStencil, bool offscreen)
     : appName(appName), w(w), h(h), enableDepthStencil(enableDepthStencil),
-      offscreen(offscreen) {}
+      offscreen(offscreen) {
+  const char *benchmark = getenv("NGFX_BENCHMARK");
+  benchmarkOptions.enable =
+      benchmark && benchmark[0] && std::string(benchmark) != "0";
+  const std::pair<const char *, const char *> envVars[] = {
+      {"NGFX_BENCHMARK_FRAMES", "frames"},
+      {"NGFX_BENCHMARK_WARMUP", "warmup"},
+      {"NGFX_BENCHMARK_SIZE", "size"},
+      {"NGFX_BENCHMARK_OUTPUT", "output"}};
+  for (auto &envVar : envVars) {
+    if (const char *value = getenv(envVar.first))
+      setBenchmarkOption(benchmarkOptions, envVar.second, value);
+  }
+}
+
+void BaseApplication::parseArgs(int argc, char **argv) {
+  const std::string prefix = "--benchmark-";
+  for (int j = 1; j < argc; j++) {
+    std::string arg = argv[j];
+    if (arg == "--benchmark")
+      benchmarkOptions.enable = true;
+    else if (arg.compare(0, prefix.size(), prefix) == 0) {
+      if (j + 1 >= argc)
+        NGFX_ERR("missing value for %s", arg.c_str());
+      setBenchmarkOption(benchmarkOptions, arg.substr(prefix.size()),
+                         argv[++j]);
+      benchmarkOptions.enable = true;
+    }
+  }
+}
 
 void BaseApplication::init() {
   auto &ctx = graphicsContext;
@@ -40,6 +109,8 @@ void BaseApplication::init() {
     createWindow();
   }
   graphics.reset(Graphics::create(ctx.get()));
+  if (enableGPUProfiler && !persistentCommandBuffers)
+    gpuProfiler.reset(GPUProfiler::create(ctx.get()));
   if (window) {
     window->onUpdate = std::bind(&BaseApplication::onUpdate, this);
     window->onPaint = std::bind(&BaseApplication::onPaint, this);
@@ -62,7 +133,8 @@ void BaseApplication::init() {
     if (enableDepthStencil) {
       depthTexture.reset(ngfx::Texture::create(
           ctx.get(), graphics.get(), nullptr, ctx->depthStencilFormat, size, w, h, 1,
-          1, IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT));
+          1, ImageUsageFlags(IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                             IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)));
       attachments.push_back({depthTexture.get()});
     }
     outputFramebuffer.reset(Framebuffer::create(
@@ -81,19 +153,27 @@ void BaseApplication::createWindow() {
 }
 
 void BaseApplication::run() {
+  if (benchmarkOptions.enable) {
+    runBenchmark();
+    return;
+  }
   if (initOnce) {
     init();
     initOnce = false;
   }
-  FPSCounter fpsCounter;
   while (!window->shouldClose()) {
+    auto t0 = std::chrono::steady_clock::now();
     drawFrame();
+    fpsCounter.addCPUTime(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - t0)
+                              .count());
     fpsCounter.update();
   }
   close();
 }
 
 void BaseApplication::drawFrame() {
+  NGFX_TRACE_ZONE("frame", "drawFrame");
   if (initOnce) {
     init();
     initOnce = false;
@@ -106,6 +186,84 @@ void BaseApplication::drawFrame() {
   }
 }
 
+void BaseApplication::runBenchmark() {
+  auto &options = benchmarkOptions;
+  offscreen = true;
+  if (options.w > 0 && options.h > 0) {
+    w = options.w;
+    h = options.h;
+  }
+  if (initOnce) {
+    init();
+    initOnce = false;
+  }
+  auto runFrame = [&]() {
+    auto t0 = std::chrono::steady_clock::now();
+    drawFrame();
+    fpsCounter.addCPUTime(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - t0)
+                              .count());
+    fpsCounter.update();
+  };
+  fpsCounter.logInterval = 0;
+  for (uint32_t j = 0; j < options.numWarmupFrames; j++)
+    runFrame();
+  // Restart the frame clock, so the first measured frame has a frame time.
+  // Then keep all the measured frames in the sliding windows
+  fpsCounter.update();
+  uint32_t windowSize = std::max(options.numFrames, 1u);
+  fpsCounter.frameTime = FrameStats(windowSize);
+  fpsCounter.cpuTime = FrameStats(windowSize);
+  fpsCounter.gpuTime = FrameStats(windowSize);
+  graphicsContext->memoryTracker.resetPeak();
+  CommandStats commandStats;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t j = 0; j < options.numFrames; j++) {
+    runFrame();
+    commandStats += graphics->getStats(graphicsContext->drawCommandBuffer());
+  }
+  double totalTime = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - t0)
+                         .count();
+  close();
+
+  double numFrames = std::max(options.numFrames, 1u);
+  json commands = {
+      {"draws", commandStats.numDraws / numFrames},
+      {"dispatches", commandStats.numDispatches / numFrames},
+      {"render_passes", commandStats.numRenderPasses / numFrames},
+      {"pipeline_binds", commandStats.numPipelineBinds / numFrames},
+      {"descriptor_set_binds", commandStats.numDescriptorSetBinds / numFrames},
+      {"barriers", commandStats.numBarriers / numFrames},
+      {"copies", commandStats.numCopies / numFrames}};
+  if (!persistentCommandBuffers)
+    commands["recording_ms"] = commandStats.recordingTime / numFrames;
+  auto memory = graphicsContext->memoryTracker.getSnapshot(false);
+  json report = {
+      {"app", appName},
+      {"width", w},
+      {"height", h},
+      {"frames", options.numFrames},
+      {"warmup_frames", options.numWarmupFrames},
+      {"persistent_command_buffers", persistentCommandBuffers},
+      {"total_ms", totalTime},
+      {"fps", totalTime > 0.0 ? options.numFrames * 1000.0 / totalTime : 0.0},
+      {"frame_time", toJSON(fpsCounter.frameTime)},
+      {"cpu_time", toJSON(fpsCounter.cpuTime)},
+      {"commands_per_frame", commands},
+      {"memory",
+       {{"bytes", memory.totalBytes},
+        {"peak_bytes", memory.peakTotalBytes},
+        {"allocations", memory.numAllocations}}}};
+  if (fpsCounter.gpuTime.getNumSamples())
+    report["gpu_time"] = toJSON(fpsCounter.gpuTime);
+  // The report is too long for a log record
+  if (options.outputFile.empty())
+    printf("%s\n", report.dump(2).c_str());
+  else
+    FileUtil::writeFile(options.outputFile, report.dump(2));
+}
+
 void BaseApplication::close() {
   auto commandBuffer = graphicsContext->drawCommandBuffer();
   graphics->waitIdle(commandBuffer);
@@ -115,6 +273,7 @@ void BaseApplication::recordCommandBuffers() {
   auto &ctx = graphicsContext;
   for (uint32_t j = 0; j < ctx->numDrawCommandBuffers; j++) {
     auto commandBuffer = ctx->drawCommandBuffer(j);
+    NGFX_TRACE_ZONE("record", "recordCommandBuffer");
     commandBuffer->begin();
     ctx->currentImageIndex = j;
     onRecordCommandBuffer(commandBuffer);
@@ -124,14 +283,32 @@ void BaseApplication::recordCommandBuffers() {
 
 void BaseApplication::onPaint() { paint(); }
 
+void BaseApplication::beginGPUProfile(CommandBuffer *commandBuffer) {
+  int64_t resolvedFrame = gpuProfiler->resolvedFrame;
+  gpuProfiler->beginFrame(commandBuffer);
+  // The frame scope is the first scope of each frame
+  if (gpuProfiler->resolvedFrame != resolvedFrame)
+    fpsCounter.addGPUTime(gpuProfiler->getTimings()[0].duration * 1e-6);
+  gpuProfiler->beginScope(commandBuffer, "frame");
+}
+
 void BaseApplication::paint() {
   auto &ctx = graphicsContext;
   if (!offscreen)
     ctx->swapchain->acquireNextImage();
   auto commandBuffer = ctx->drawCommandBuffer();
   if (!persistentCommandBuffers) {
+    NGFX_TRACE_ZONE("record", "recordCommandBuffer");
+    // graphics->getStats() returns the commands recorded for the last frame
+    graphics->resetStats();
     commandBuffer->begin();
+    if (gpuProfiler)
+      beginGPUProfile(commandBuffer);
     onRecordCommandBuffer(commandBuffer);
+    if (gpuProfiler) {
+      gpuProfiler->endScope(commandBuffer);
+      gpuProfiler->endFrame();
+    }
     commandBuffer->end();
   }
   ctx->queue->submit(commandBuffer);
@@ -19,7 +19,9 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/core/FPSCounter.h"
 #include "ngfx/graphics/CommandBuffer.h"
+#include "ngfx/graphics/GPUProfiler.h"
 #include "ngfx/graphics/Graphics.h"
 #include "ngfx/graphics/GraphicsContext.h"
 #include "ngfx/graphics/Window.h"
@@ -47,6 +49,18 @@ public:
   virtual void onPaint();
   virtual void run();
   virtual void drawFrame();
+  /** Run offscreen for a fixed number of frames, and write a JSON report with the
+   *  frame statistics, the commands recorded per frame and the memory usage.
+   *  The report includes the GPU time if enableGPUProfiler is set.
+   *  run() calls this function when the benchmark mode is enabled
+   */
+  virtual void runBenchmark();
+  /** Parse the benchmark options from the command line: --benchmark,
+   *  --benchmark-frames N, --benchmark-warmup N, --benchmark-size WxH and
+   *  --benchmark-output file.  Any of them enables the benchmark mode, and the
+   *  other arguments are ignored
+   */
+  void parseArgs(int argc, char **argv);
 
   std::unique_ptr<Graphics> graphics;
   std::unique_ptr<Window> window;
@@ -56,8 +70,31 @@ public:
   bool enableDepthStencil = false;
   bool offscreen = false;
   bool persistentCommandBuffers = true;
+  /** Measure the GPU time of each frame with a GPUProfiler.
+   *  This requires recording the command buffers every frame (persistentCommandBuffers = false)
+   */
+  bool enableGPUProfiler = false;
+  std::unique_ptr<GPUProfiler> gpuProfiler;
+  /** The frame rate and the frame time, CPU time and GPU time statistics */
+  FPSCounter fpsCounter;
+  struct BenchmarkOptions {
+    bool enable = false;
+    /** The number of measured frames, after the warm-up frames */
+    uint32_t numFrames = 100, numWarmupFrames = 10;
+    /** The offscreen resolution, or 0 to keep the application size */
+    int w = 0, h = 0;
+    /** The JSON report file, or empty to print the report to stdout */
+    std::string outputFile;
+  };
+  /** The benchmark options, initialized from the environment variables
+   *  NGFX_BENCHMARK, NGFX_BENCHMARK_FRAMES, NGFX_BENCHMARK_WARMUP,
+   *  NGFX_BENCHMARK_SIZE and NGFX_BENCHMARK_OUTPUT
+   */
+  BenchmarkOptions benchmarkOptions;
 
 protected:
+  /** Begin the GPU profiler frame, and add the GPU time of the last resolved frame */
+  void beginGPUProfile(CommandBuffer *commandBuffer);
   bool initOnce = true;
   std::unique_ptr<ngfx::Texture> outputTexture, depthTexture;
   std::unique_ptr<Framebuffer> outputFramebuffer;
@@ -19,6 +19,7 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/core/Log.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
@@ -44,21 +45,26 @@ inline void debugMessage(FILE* filenum, const char* fmt, ...) {
 #define LOG_FN fprintf
 #endif
 
-#define NGFX_LOG(fmt, ...) LOG_FN(stderr, fmt "\n", ##__VA_ARGS__)
+/** Log a message at the info level, see ngfx::Log */
+#define NGFX_LOG(fmt, ...) NGFX_LOG_INFO(fmt, ##__VA_ARGS__)
+/** Log an error and throw an exception.
+ *  The error is written synchronously, with the full message */
 #define NGFX_ERR(fmt, ...) \
 { \
     char buffer[4096]; \
-    snprintf(buffer, sizeof(buffer), "ERROR: [%s][%s][%d] " fmt "\n", __FILE__, \
+    snprintf(buffer, sizeof(buffer), "ERROR: [%s][%s][%d] " fmt, __FILE__, \
         __PRETTY_FUNCTION__, __LINE__, ##__VA_ARGS__); \
-    LOG_FN(stderr, "%s", buffer); \
+    if (ngfx::LOG_LEVEL_ERROR >= NGFX_LOG_MIN_LEVEL && \
+        ngfx::Log::isEnabled(ngfx::LOG_LEVEL_ERROR)) \
+        ngfx::Log::writeMessage(ngfx::LOG_LEVEL_ERROR, __FILE__, __LINE__, buffer); \
     throw std::runtime_error(buffer); \
 }
 #define NGFX_LOG_TRACE(fmt, ...)                                               \
   NGFX_LOG("[%s][%s][%d] " fmt, __FILE__, __PRETTY_FUNCTION__, __LINE__,       \
            ##__VA_ARGS__)
 #define NGFX_TODO(fmt, ...)                                                    \
-  NGFX_LOG("[%s][%s][%d] TODO: " fmt, __FILE__, __FUNCTION__, __LINE__,        \
-           ##__VA_ARGS__)
+  NGFX_LOG_WARNING("[%s][%s][%d] TODO: " fmt, __FILE__, __FUNCTION__,          \
+                   __LINE__, ##__VA_ARGS__)
 
 struct DebugUtil {
   static inline void Exit(uint32_t code) {
@@ -23,11 +23,38 @@
 using namespace ngfx;
 
 void FPSCounter::update() {
-  numFrames++;
-  if (numFrames == 100) {
-    timer.update();
-    fps = 100 / timer.elapsed;
-    NGFX_LOG("FPS: %3.2f", fps);
-    numFrames = 0;
+  auto t1 = std::chrono::steady_clock::now();
+  if (started) {
+    frameTime.add(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    double avg = frameTime.getAverage();
+    fps = (avg > 0.0) ? float(1000.0 / avg) : 0.0f;
   }
+  started = true;
+  t0 = t1;
+  numFrames++;
+  if (logInterval && numFrames % logInterval == 0)
+    log();
+}
+
+void FPSCounter::log() const {
+  NGFX_LOG("FPS: %3.2f", fps);
+  auto logStats = [](const char *name, const FrameStats &stats) {
+    if (stats.getNumSamples() == 0)
+      return;
+    auto s = stats.getSummary();
+    NGFX_LOG("%s (ms): min %.3f avg %.3f p50 %.3f p95 %.3f p99 %.3f max %.3f",
+             name, s.min, s.avg, s.p50, s.p95, s.p99, s.max);
+  };
+  logStats("frame time", frameTime);
+  logStats("CPU time", cpuTime);
+  logStats("GPU time", gpuTime);
+}
+
+void FPSCounter::reset() {
+  frameTime.reset();
+  cpuTime.reset();
+  gpuTime.reset();
+  numFrames = 0;
+  started = false;
+  fps = 0.0f;
 }
@@ -19,17 +19,43 @@
  * under the License.
  */
 #pragma once
-#include "ngfx/core/Timer.h"
+#include "ngfx/core/FrameStats.h"
+#include <chrono>
 
 namespace ngfx {
+/** \class FPSCounter
+ *
+ *  This class measures the frame rate, and collects the statistics of the frame time
+ *  (the interval between frames), the CPU time and the GPU time of each frame.
+ */
 class FPSCounter {
 public:
-  FPSCounter() {}
+  /** Create the counter
+   *  @param windowSize The number of frames of the sliding window (at least 1)
+   */
+  FPSCounter(uint32_t windowSize = 256)
+      : frameTime(windowSize), cpuTime(windowSize), gpuTime(windowSize) {}
+  /** Mark the end of a frame */
   void update();
+  /** Add the CPU time of the current frame, in milliseconds */
+  void addCPUTime(double ms) { cpuTime.add(ms); }
+  /** Add the GPU time of a frame, in milliseconds.
+   *  The GPU time is typically resolved a few frames later, e.g. by GPUProfiler
+   */
+  void addGPUTime(double ms) { gpuTime.add(ms); }
+  /** Log the frame rate and the statistics */
+  void log() const;
+  /** Clear the statistics */
+  void reset();
+  /** The average frame rate over the sliding window */
   float fps = 0.0f;
+  FrameStats frameTime, cpuTime, gpuTime;
+  /** Log the statistics every logInterval frames, or never if 0 */
+  uint32_t logInterval = 100;
 
 private:
-  int numFrames = 0;
-  Timer timer;
+  uint32_t numFrames = 0;
+  bool started = false;
+  std::chrono::steady_clock::time_point t0;
 };
 } // namespace ngfx
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/core/FrameStats.h"
+#include "ngfx/core/DebugUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+using namespace ngfx;
+
+// Each power of 2 range is divided into SUB_BUCKETS / 2 linear buckets,
+// and the values below SUB_BUCKETS us have one bucket per microsecond
+#define SUB_BUCKET_BITS 5
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define HALF_SUB_BUCKETS (SUB_BUCKETS / 2)
+// The largest value, in microseconds (about 67 seconds)
+#define MAX_VALUE_BITS 26
+
+static uint32_t getBucket(uint64_t v) {
+  if (v < SUB_BUCKETS)
+    return uint32_t(v);
+  uint32_t msb = 0;
+  while ((v >> (msb + 1)) != 0)
+    msb++;
+  uint32_t shift = msb - (SUB_BUCKET_BITS - 1);
+  return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS +
+         uint32_t(v >> shift) - HALF_SUB_BUCKETS;
+}
+
+FrameStats::Histogram::Histogram() {
+  counts.resize(getBucket((1ull << MAX_VALUE_BITS) - 1) + 1);
+}
+
+void FrameStats::Histogram::add(double value) {
+  uint64_t v = uint64_t(std::max(value * 1000.0, 0.0));
+  v = std::min<uint64_t>(v, (1ull << MAX_VALUE_BITS) - 1);
+  counts[getBucket(v)]++;
+  totalCount++;
+}
+
+void FrameStats::Histogram::reset() {
+  std::fill(counts.begin(), counts.end(), 0);
+  totalCount = 0;
+}
+
+void FrameStats::Histogram::getBucketRange(uint32_t bucket, double &lower,
+                                           double &upper) const {
+  if (bucket < SUB_BUCKETS) {
+    lower = bucket * 0.001;
+    upper = (bucket + 1) * 0.001;
+    return;
+  }
+  uint32_t shift = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+  uint64_t m = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+  lower = double(m << shift) * 0.001;
+  upper = double((m + 1) << shift) * 0.001;
+}
+
+double FrameStats::Histogram::getPercentile(double percentile) const {
+  if (totalCount == 0)
+    return 0.0;
+  uint64_t rank = std::max(uint64_t(ceil(percentile / 100.0 * totalCount)), uint64_t(1));
+  uint64_t count = 0;
+  for (uint32_t j = 0; j < counts.size(); j++) {
+    count += counts[j];
+    if (count >= rank) {
+      double lower, upper;
+      getBucketRange(j, lower, upper);
+      return (lower + upper) * 0.5;
+    }
+  }
+  return 0.0;
+}
+
+std::string FrameStats::Histogram::toString() const {
+  std::string str;
+  char line[128];
+  for (uint32_t j = 0; j < counts.size(); j++) {
+    if (counts[j] == 0)
+      continue;
+    double lower, upper;
+    getBucketRange(j, lower, upper);
+    snprintf(line, sizeof(line), "[%.3f, %.3f) ms: %llu (%.2f%%)\n", lower,
+             upper, (unsigned long long)counts[j],
+             counts[j] * 100.0 / totalCount);
+    str += line;
+  }
+  return str;
+}
+
+FrameStats::FrameStats(uint32_t windowSize) : windowSize(windowSize) {
+  if (windowSize == 0)
+    NGFX_ERR("invalid window size: %d", windowSize);
+  window.reserve(windowSize);
+}
+
+void FrameStats::add(double value) {
+  if (window.size() < windowSize)
+    window.push_back(value);
+  else
+    window[next] = value;
+  next = (next + 1) % windowSize;
+  histogram.add(value);
+}
+
+FrameStats::Summary FrameStats::getSummary() const {
+  Summary summary;
+  uint32_t n = uint32_t(window.size());
+  summary.numSamples = n;
+  if (n == 0)
+    return summary;
+  std::vector<double> sorted(window);
+  std::sort(sorted.begin(), sorted.end());
+  // Nearest-rank percentiles
+  auto percentile = [&](double p) {
+    uint32_t rank = std::max(uint32_t(ceil(p / 100.0 * n)), 1u);
+    return sorted[rank - 1];
+  };
+  double sum = 0.0;
+  for (double v : sorted)
+    sum += v;
+  summary.min = sorted.front();
+  summary.max = sorted.back();
+  summary.avg = sum / n;
+  summary.p50 = percentile(50.0);
+  summary.p95 = percentile(95.0);
+  summary.p99 = percentile(99.0);
+  return summary;
+}
+
+double FrameStats::getAverage() const {
+  if (window.empty())
+    return 0.0;
+  double sum = 0.0;
+  for (double v : window)
+    sum += v;
+  return sum / window.size();
+}
+
+void FrameStats::reset() {
+  window.clear();
+  next = 0;
+  histogram.reset();
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ngfx {
+/** \class FrameStats
+ *
+ *  This class collects a per-frame timing, in milliseconds.
+ *  The summary statistics are computed over a sliding window of the most recent frames,
+ *  while the histogram accumulates all the frames since the last reset.
+ */
+class FrameStats {
+public:
+  /** An HDR-style histogram: each power of 2 range of microseconds is divided into
+   *  the same number of linear buckets, so the relative error is bounded (about 3%)
+   *  over the whole range, from 1 us to more than a minute
+   */
+  class Histogram {
+  public:
+    Histogram();
+    void add(double value);
+    void reset();
+    uint32_t getNumBuckets() const { return uint32_t(counts.size()); }
+    uint64_t getCount(uint32_t bucket) const { return counts[bucket]; }
+    /** Get the range of values of a bucket, in milliseconds */
+    void getBucketRange(uint32_t bucket, double &lower, double &upper) const;
+    /** Get the value at the given percentile, in milliseconds, or 0 if the histogram is empty */
+    double getPercentile(double percentile) const;
+    /** Format the non-empty buckets, one per line */
+    std::string toString() const;
+    uint64_t totalCount = 0;
+
+  private:
+    std::vector<uint64_t> counts;
+  };
+  struct Summary {
+    double min = 0.0, avg = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    uint32_t numSamples = 0;
+  };
+  /** Create the statistics
+   *  @param windowSize The number of frames of the sliding window (at least 1)
+   */
+  FrameStats(uint32_t windowSize = 256);
+  /** Add the timing of a frame, in milliseconds */
+  void add(double value);
+  /** Get the statistics over the sliding window */
+  Summary getSummary() const;
+  /** Get the average over the sliding window */
+  double getAverage() const;
+  const Histogram &getHistogram() const { return histogram; }
+  /** Clear the sliding window and the histogram */
+  void reset();
+  uint32_t getNumSamples() const { return uint32_t(window.size()); }
+
+private:
+  std::vector<double> window;
+  uint32_t windowSize, next = 0;
+  Histogram histogram;
+};
+} // namespace ngfx
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/core/Log.h"
+#include "ngfx/core/DebugUtil.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+using namespace ngfx;
+
+std::atomic<int> Log::runtimeLevel(LOG_LEVEL_INFO);
+
+namespace {
+// The ring buffer size, a power of 2
+const uint64_t NUM_SLOTS = 1024;
+const char *levelNames[] = {"verbose", "debug", "info", "warning", "error", "off"};
+
+// A bounded multi-producer queue: a slot is free for the producer at position pos
+// when its sequence is pos, and ready for the consumer when its sequence is pos + 1
+struct Slot {
+  std::atomic<uint64_t> sequence;
+  Log::Message message;
+};
+
+std::atomic<uint32_t> nextThreadId(1);
+thread_local uint32_t threadId = nextThreadId++;
+// The message used when writing synchronously
+thread_local Log::Message syncMessage;
+// Set while the sink is called, to detect the records written from the sink
+thread_local bool inSink = false;
+
+// The system time, in microseconds since the epoch
+uint64_t getTimestamp() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void writeJSONString(std::string &out, const char *str) {
+  out += '"';
+  for (const char *c = str; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      out += '\\';
+      out += *c;
+    } else if ((unsigned char)*c < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", *c);
+      out += escape;
+    } else
+      out += *c;
+  }
+  out += '"';
+}
+
+class Logger {
+public:
+  Logger() {
+    for (uint64_t j = 0; j < NUM_SLOTS; j++)
+      slots[j].sequence.store(j, std::memory_order_relaxed);
+    thread = std::thread([this] { run(); });
+  }
+  Log::Message *beginMessage(LogLevel level) {
+    if (!async.load(std::memory_order_relaxed) || level >= LOG_LEVEL_ERROR)
+      return &syncMessage;
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = slots[pos & (NUM_SLOTS - 1)];
+      uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+      int64_t diff = int64_t(sequence) - int64_t(pos);
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          slot.message.pos = pos;
+          return &slot.message;
+        }
+      } else if (diff < 0) {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      } else
+        pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+  void endMessage(Log::Message *message) {
+    if (message == &syncMessage) {
+      writeSync(toRecord(*message));
+      return;
+    }
+    slots[message->pos & (NUM_SLOTS - 1)].sequence.store(
+        message->pos + 1, std::memory_order_release);
+    if (message->level >= LOG_LEVEL_WARNING)
+      wakeup.notify_one();
+  }
+  void flush() {
+    if (!thread.joinable() || std::this_thread::get_id() == thread.get_id())
+      return;
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (dequeuePos.load(std::memory_order_acquire) < pos) {
+      wakeup.notify_one();
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  // Write the pending records, and write the next ones synchronously
+  void stop() {
+    async = false;
+    flush();
+    stopping = true;
+    wakeup.notify_one();
+    if (thread.joinable())
+      thread.join();
+  }
+  // Write a record after the pending records, to keep their order
+  void writeSync(const Log::Record &record) {
+    if (!inSink)
+      flush();
+    write(record);
+  }
+  void write(const Log::Record &record) {
+    // The sink is called without holding the lock,
+    // so that it can write records (e.g. errors, which are synchronous)
+    Log::Sink currentSink;
+    Log::Format currentFormat;
+    {
+      std::lock_guard<std::mutex> lock(sinkMutex);
+      if (!inSink)
+        currentSink = sink;
+      currentFormat = format;
+    }
+    if (currentSink) {
+      inSink = true;
+      currentSink(record);
+      inSink = false;
+      return;
+    }
+    if (currentFormat == Log::FORMAT_TEXT) {
+      LOG_FN(stderr, "%s\n", record.message.c_str());
+      return;
+    }
+    std::string line = "{\"time\": " + std::to_string(record.timestamp) +
+                       ", \"level\": \"" + levelNames[record.level] +
+                       "\", \"thread\": " + std::to_string(record.threadId) +
+                       ", \"file\": ";
+    writeJSONString(line, record.file);
+    line += ", \"line\": " + std::to_string(record.line) + ", \"message\": ";
+    writeJSONString(line, record.message.c_str());
+    line += "}";
+    LOG_FN(stderr, "%s\n", line.c_str());
+  }
+  std::atomic<bool> async{true};
+  std::atomic<uint64_t> numDropped{0};
+  std::mutex sinkMutex;
+  Log::Sink sink;
+  Log::Format format = Log::FORMAT_TEXT;
+
+private:
+  Log::Record toRecord(const Log::Message &message) {
+    return {message.level, message.timestamp, message.threadId,
+            message.file,  message.line,      Log::format(message)};
+  }
+  void run() {
+    uint64_t pos = 0;
+    while (true) {
+      Slot &slot = slots[pos & (NUM_SLOTS - 1)];
+      if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+        Log::Record record = toRecord(slot.message);
+        slot.sequence.store(pos + NUM_SLOTS, std::memory_order_release);
+        write(record);
+        dequeuePos.store(++pos, std::memory_order_release);
+        continue;
+      }
+      if (stopping && enqueuePos.load() == pos)
+        break;
+      // The producers only wake up the thread for warnings and errors
+      std::unique_lock<std::mutex> lock(wakeupMutex);
+      wakeup.wait_for(lock, std::chrono::milliseconds(5));
+    }
+  }
+  Slot slots[NUM_SLOTS];
+  std::atomic<uint64_t> enqueuePos{0}, dequeuePos{0};
+  std::atomic<bool> stopping{false};
+  std::mutex wakeupMutex;
+  std::condition_variable wakeup;
+  std::thread thread;
+};
+
+Logger &logger() {
+  // The logger is never destroyed, so the static destructors can still log
+  static Logger *instance = [] {
+    Logger *instance = new Logger();
+    std::atexit([] { logger().stop(); });
+    return instance;
+  }();
+  return *instance;
+}
+
+const bool envInitialized = [] {
+  const char *env = getenv("NGFX_LOG_LEVEL");
+  if (!env)
+    return false;
+  for (int j = LOG_LEVEL_VERBOSE; j <= LOG_LEVEL_OFF; j++) {
+    if (strcmp(env, levelNames[j]) == 0 || (env[0] == '0' + j && !env[1]))
+      Log::setLevel(LogLevel(j));
+  }
+  return true;
+}();
+} // namespace
+
+void Log::setSink(Sink sink) {
+  auto &l = logger();
+  std::lock_guard<std::mutex> lock(l.sinkMutex);
+  l.sink = sink;
+}
+
+void Log::setFormat(Format format) {
+  auto &l = logger();
+  std::lock_guard<std::mutex> lock(l.sinkMutex);
+  l.format = format;
+}
+
+void Log::setAsync(bool async) {
+  logger().flush();
+  logger().async = async;
+}
+
+void Log::flush() { logger().flush(); }
+
+uint64_t Log::getNumDropped() { return logger().numDropped.load(); }
+
+Log::Message *Log::beginMessage(LogLevel level, const char *file,
+                                uint32_t line, const char *fmt) {
+  Message *message = logger().beginMessage(level);
+  if (!message)
+    return nullptr;
+  message->timestamp = getTimestamp();
+  message->file = file;
+  message->fmt = fmt;
+  message->line = line;
+  message->threadId = threadId;
+  message->level = level;
+  message->numArgs = 0;
+  message->truncated = false;
+  message->dataSize = 0;
+  return message;
+}
+
+void Log::endMessage(Message *message) { logger().endMessage(message); }
+
+void Log::writeMessage(LogLevel level, const char *file, uint32_t line,
+                       const std::string &message) {
+  logger().writeSync({level, getTimestamp(), threadId, file, line, message});
+}
+
+void Log::Message::addString(const char *str, size_t size) {
+  if (numArgs == MAX_ARGS || dataSize + sizeof(uint16_t) > MAX_DATA_SIZE) {
+    truncated = true;
+    return;
+  }
+  size_t maxSize = MAX_DATA_SIZE - dataSize - sizeof(uint16_t);
+  if (size > maxSize) {
+    size = maxSize;
+    truncated = true;
+  }
+  uint16_t size16 = uint16_t(size);
+  argTypes[numArgs++] = ARG_STRING;
+  memcpy(&data[dataSize], &size16, sizeof(size16));
+  memcpy(&data[dataSize + sizeof(size16)], str, size);
+  dataSize += uint16_t(sizeof(size16) + size);
+}
+
+namespace {
+// Read the arguments of a message in order
+struct ArgReader {
+  ArgReader(const Log::Message &message) : message(message) {}
+  bool next() {
+    if (index == message.numArgs)
+      return false;
+    type = message.argTypes[index++];
+    const uint8_t *data = &message.data[offset];
+    switch (type) {
+    case Log::ARG_INT:
+      memcpy(&i, data, sizeof(i));
+      offset += sizeof(i);
+      break;
+    case Log::ARG_UINT:
+      memcpy(&u, data, sizeof(u));
+      offset += sizeof(u);
+      break;
+    case Log::ARG_DOUBLE:
+      memcpy(&d, data, sizeof(d));
+      offset += sizeof(d);
+      break;
+    case Log::ARG_POINTER:
+      memcpy(&p, data, sizeof(p));
+      offset += sizeof(p);
+      break;
+    case Log::ARG_STRING: {
+      uint16_t size;
+      memcpy(&size, data, sizeof(size));
+      s.assign((const char *)data + sizeof(size), size);
+      offset += sizeof(size) + size;
+    } break;
+    }
+    return true;
+  }
+  int64_t toInt() const {
+    switch (type) {
+    case Log::ARG_INT:
+      return i;
+    case Log::ARG_UINT:
+      return int64_t(u);
+    case Log::ARG_DOUBLE:
+      return int64_t(d);
+    case Log::ARG_POINTER:
+      return int64_t(uintptr_t(p));
+    default:
+      return 0;
+    }
+  }
+  const Log::Message &message;
+  uint32_t index = 0, offset = 0;
+  Log::ArgType type = Log::ARG_INT;
+  int64_t i = 0;
+  uint64_t u = 0;
+  double d = 0.0;
+  const void *p = nullptr;
+  std::string s;
+};
+
+template <typename T>
+void appendFormatted(std::string &out, const std::string &spec, T value) {
+  char buffer[256];
+  int size = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+  if (size < 0)
+    return;
+  if (size_t(size) < sizeof(buffer)) {
+    out.append(buffer, size);
+    return;
+  }
+  std::string str(size + 1, '\0');
+  snprintf(&str[0], str.size(), spec.c_str(), value);
+  out.append(str.c_str(), size);
+}
+} // namespace
+
+std::string Log::format(const Message &message) {
+  std::string out;
+  ArgReader arg(message);
+  for (const char *c = message.fmt; *c; c++) {
+    if (*c != '%') {
+      out += *c;
+      continue;
+    }
+    if (c[1] == '%') {
+      out += '%';
+      c++;
+      continue;
+    }
+    // Parse the conversion specification, and replace '*' with the argument value
+    std::string spec = "%";
+    const char *p = c + 1;
+    while (*p && strchr("-+ #0", *p))
+      spec += *p++;
+    for (int j = 0; j < 2; j++) {
+      if (*p == '*') {
+        spec += std::to_string(arg.next() ? arg.toInt() : 0);
+        p++;
+      } else {
+        while (*p >= '0' && *p <= '9')
+          spec += *p++;
+      }
+      if (j == 0 && *p == '.')
+        spec += *p++;
+      else
+        break;
+    }
+    while (*p && strchr("hlLqjzt", *p))
+      p++;
+    char conversion = *p;
+    if (!conversion)
+      break;
+    c = p;
+    if (!arg.next()) {
+      out += spec + conversion;
+      continue;
+    }
+    if (arg.type == ARG_STRING && conversion != 's') {
+      out += arg.s;
+      continue;
+    }
+    switch (conversion) {
+    case 'd':
+    case 'i':
+      appendFormatted(out, spec + "lld", (long long)arg.toInt());
+      break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      appendFormatted(out, spec + "ll" + conversion,
+                      (unsigned long long)(arg.type == ARG_UINT ? arg.u : arg.toInt()));
+      break;
+    case 'c':
+      appendFormatted(out, spec + "c", int(arg.toInt()));
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      appendFormatted(out, spec + conversion,
+                      arg.type == ARG_DOUBLE ? arg.d : double(arg.toInt()));
+      break;
+    case 's':
+      if (arg.type == ARG_STRING)
+        appendFormatted(out, spec + "s", arg.s.c_str());
+      else if (arg.type == ARG_DOUBLE)
+        appendFormatted(out, "%g", arg.d);
+      else
+        out += std::to_string(arg.toInt());
+      break;
+    case 'p':
+      appendFormatted(out, spec + "p", arg.type == ARG_POINTER ? arg.p : (const void *)uintptr_t(arg.toInt()));
+      break;
+    default:
+      out += spec + conversion;
+      break;
+    }
+  }
+  if (message.truncated)
+    out += " [truncated]";
+  return out;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+/** The minimum log level compiled in: the log statements below this level are
+ *  removed at compile time (0: verbose, 1: debug, 2: info, 3: warning, 4: error) */
+#ifndef NGFX_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define NGFX_LOG_MIN_LEVEL 2
+#else
+#define NGFX_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+namespace ngfx {
+enum LogLevel {
+  LOG_LEVEL_VERBOSE,
+  LOG_LEVEL_DEBUG,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_WARNING,
+  LOG_LEVEL_ERROR,
+  LOG_LEVEL_OFF
+};
+
+/** \class Log
+ *
+ *  This module writes log records without blocking the calling thread.
+ *  The arguments are copied to a lock-free ring buffer, and a background thread
+ *  formats them (printf style) and writes them to the sink.
+ *  When the ring buffer is full, the records are dropped instead of blocking.
+ *  Errors are written synchronously, after the pending records.
+ *  The runtime level is set by setLevel, or by the environment variable NGFX_LOG_LEVEL
+ *  (verbose, debug, info, warning, error or off).
+ */
+class Log {
+public:
+  struct Record {
+    LogLevel level;
+    /** The system time, in microseconds since the epoch */
+    uint64_t timestamp;
+    uint32_t threadId;
+    const char *file;
+    uint32_t line;
+    std::string message;
+  };
+  using Sink = std::function<void(const Record &record)>;
+  enum Format { FORMAT_TEXT, FORMAT_JSON };
+
+  static bool isEnabled(LogLevel level) {
+    return level >= runtimeLevel.load(std::memory_order_relaxed);
+  }
+  static void setLevel(LogLevel level) {
+    runtimeLevel.store(level, std::memory_order_relaxed);
+  }
+  static LogLevel getLevel() {
+    return LogLevel(runtimeLevel.load(std::memory_order_relaxed));
+  }
+  /** Set the output of the records, or nullptr to restore the default output (stderr).
+   *  The sink is called from the background thread, and from the calling thread
+   *  for the synchronous records, so it must be thread-safe.
+   *  The records written from within the sink go to the default output */
+  static void setSink(Sink sink);
+  /** Set the format of the default output: the message only, or one JSON object per line */
+  static void setFormat(Format format);
+  /** Write the records synchronously on the calling thread, or asynchronously (default) */
+  static void setAsync(bool async);
+  /** Wait until the pending records are written */
+  static void flush();
+  /** Get the number of records dropped because the ring buffer was full */
+  static uint64_t getNumDropped();
+
+  /** Write a record.
+   *  The format string is not copied: it must be a string literal.
+   *  The arguments can be integers, floating point numbers, pointers, C strings and std::string,
+   *  and the strings are copied (up to the capacity of the record) */
+  template <typename... Args>
+  static void write(LogLevel level, const char *file, uint32_t line,
+                    const char *fmt, const Args &...args) {
+    Message *message = beginMessage(level, file, line, fmt);
+    if (!message)
+      return;
+    (message->add(args), ...);
+    endMessage(message);
+  }
+  /** Write a record with a preformatted message, synchronously.
+   *  Unlike write, the message is not truncated */
+  static void writeMessage(LogLevel level, const char *file, uint32_t line,
+                           const std::string &message);
+
+  enum ArgType : uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_POINTER, ARG_STRING };
+  static const uint32_t MAX_ARGS = 16, MAX_DATA_SIZE = 400;
+  /** The arguments of a record, formatted later by the background thread */
+  struct Message {
+    void add(const char *str) { addString(str ? str : "(null)", str ? strlen(str) : 6); }
+    void add(char *str) { add((const char *)str); }
+    void add(const std::string &str) { addString(str.data(), str.size()); }
+    template <typename T> void add(const T &value) {
+      if constexpr (std::is_array_v<T>)
+        add((const char *)value);
+      else if constexpr (std::is_floating_point_v<T>)
+        addValue(ARG_DOUBLE, double(value));
+      else if constexpr (std::is_pointer_v<T>)
+        addValue(ARG_POINTER, (const void *)value);
+      else if constexpr (std::is_enum_v<T> || std::is_signed_v<T>)
+        addValue(ARG_INT, int64_t(value));
+      else {
+        static_assert(std::is_integral_v<T>, "unsupported log argument type");
+        addValue(ARG_UINT, uint64_t(value));
+      }
+    }
+    template <typename T> void addValue(ArgType type, T value) {
+      if (numArgs == MAX_ARGS || dataSize + sizeof(T) > MAX_DATA_SIZE) {
+        truncated = true;
+        return;
+      }
+      argTypes[numArgs++] = type;
+      memcpy(&data[dataSize], &value, sizeof(T));
+      dataSize += uint16_t(sizeof(T));
+    }
+    void addString(const char *str, size_t size);
+
+    uint64_t pos, timestamp;
+    const char *file, *fmt;
+    uint32_t line, threadId;
+    LogLevel level;
+    uint8_t numArgs;
+    bool truncated;
+    uint16_t dataSize;
+    ArgType argTypes[MAX_ARGS];
+    uint8_t data[MAX_DATA_SIZE];
+  };
+  /** Format a message, e.g. for a test */
+  static std::string format(const Message &message);
+
+private:
+  /** Reserve a record in the ring buffer, or return nullptr if it's full */
+  static Message *beginMessage(LogLevel level, const char *file, uint32_t line,
+                               const char *fmt);
+  /** Publish the record to the background thread */
+  static void endMessage(Message *message);
+  static std::atomic<int> runtimeLevel;
+};
+} // namespace ngfx
+
+/** Write a log record at the given level.
+ *  The arguments aren't evaluated when the level is filtered out */
+#define NGFX_LOG_AT(level, fmt, ...)                                           \
+  do {                                                                         \
+    if ((level) >= NGFX_LOG_MIN_LEVEL && ngfx::Log::isEnabled(level))          \
+      ngfx::Log::write(level, __FILE__, __LINE__, "" fmt, ##__VA_ARGS__);     \
+  } while (0)
+#define NGFX_LOG_VERBOSE(fmt, ...)                                             \
+  NGFX_LOG_AT(ngfx::LOG_LEVEL_VERBOSE, fmt, ##__VA_ARGS__)
+#define NGFX_LOG_DEBUG(fmt, ...)                                               \
+  NGFX_LOG_AT(ngfx::LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define NGFX_LOG_INFO(fmt, ...)                                                \
+  NGFX_LOG_AT(ngfx::LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define NGFX_LOG_WARNING(fmt, ...)                                             \
+  NGFX_LOG_AT(ngfx::LOG_LEVEL_WARNING, fmt, ##__VA_ARGS__)
+#define NGFX_LOG_ERROR(fmt, ...)                                               \
+  NGFX_LOG_AT(ngfx::LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
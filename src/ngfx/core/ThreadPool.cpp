@@ -0,0 +1,106 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/core/ThreadPool.h"
+using namespace ngfx;
+
+static thread_local bool isWorkerThread = false;
+
+ThreadPool::ThreadPool(int32_t numThreads) {
+  if (numThreads < 0)
+    numThreads = int32_t(std::thread::hardware_concurrency()) - 1;
+  for (int32_t j = 0; j < numThreads; j++)
+    threads.emplace_back([this]() { run(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  cv.notify_all();
+  for (auto &thread : threads)
+    thread.join();
+}
+
+ThreadPool *ThreadPool::getDefault() {
+  static ThreadPool threadPool;
+  return &threadPool;
+}
+
+void ThreadPool::runJob() {
+  uint32_t j;
+  while ((j = job.next++) < job.end)
+    (*job.fn)(j);
+}
+
+void ThreadPool::run() {
+  isWorkerThread = true;
+  uint64_t lastGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return quit || generation != lastGeneration; });
+      if (quit)
+        return;
+      lastGeneration = generation;
+    }
+    runJob();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--numActiveThreads == 0)
+      doneCv.notify_one();
+  }
+}
+
+void ThreadPool::parallelFor(uint32_t begin, uint32_t end,
+                             const std::function<void(uint32_t)> &fn) {
+  if (end <= begin)
+    return;
+  if (threads.empty() || isWorkerThread || (end - begin) == 1) {
+    for (uint32_t j = begin; j < end; j++)
+      fn(j);
+    return;
+  }
+  std::lock_guard<std::mutex> submitLock(submitMutex);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job.fn = &fn;
+    job.next = begin;
+    job.end = end;
+    numActiveThreads = uint32_t(threads.size());
+    generation++;
+  }
+  cv.notify_all();
+  runJob();
+  // Wait until every worker has finished, so the job can be safely reused
+  std::unique_lock<std::mutex> lock(mutex);
+  doneCv.wait(lock, [&]() { return numActiveThreads == 0; });
+}
+
+void ThreadPool::parallelFor(ThreadPool *threadPool, uint32_t begin,
+                             uint32_t end,
+                             const std::function<void(uint32_t)> &fn) {
+  if (threadPool) {
+    threadPool->parallelFor(begin, end, fn);
+    return;
+  }
+  for (uint32_t j = begin; j < end; j++)
+    fn(j);
+}
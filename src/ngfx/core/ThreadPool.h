@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ngfx {
+
+/** \class ThreadPool
+ *
+ *  This class provides a pool of worker threads for data-parallel loops.
+ *  The calling thread also participates in the work.
+ */
+
+class ThreadPool {
+public:
+  /** Create the thread pool
+   *  @param numThreads The number of worker threads, or -1 to use one thread
+   *  per hardware core (including the calling thread)
+   */
+  ThreadPool(int32_t numThreads = -1);
+  virtual ~ThreadPool();
+  /** Call fn(j) for each j in [begin, end), distributed across the worker threads.
+   *  Blocks until all the iterations are complete.  The function must not throw.
+   *  When called from a worker thread, the loop is executed serially
+   */
+  void parallelFor(uint32_t begin, uint32_t end,
+                   const std::function<void(uint32_t)> &fn);
+  /** Call fn(j) for each j in [begin, end) using the given thread pool.
+   *  The loop is processed serially if threadPool is null
+   */
+  static void parallelFor(ThreadPool *threadPool, uint32_t begin, uint32_t end,
+                          const std::function<void(uint32_t)> &fn);
+  /** Get the number of threads, including the calling thread */
+  uint32_t getNumThreads() const { return uint32_t(threads.size()) + 1; }
+  /** Get the shared thread pool */
+  static ThreadPool *getDefault();
+
+private:
+  void run();
+  void runJob();
+  struct {
+    const std::function<void(uint32_t)> *fn = nullptr;
+    std::atomic<uint32_t> next{0};
+    uint32_t end = 0;
+  } job;
+  std::vector<std::thread> threads;
+  std::mutex mutex, submitMutex;
+  std::condition_variable cv, doneCv;
+  uint64_t generation = 0;
+  uint32_t numActiveThreads = 0;
+  bool quit = false;
+};
+} // namespace ngfx
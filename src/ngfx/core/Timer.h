@@ -27,6 +27,6 @@ public:
   Timer();
   void update();
   float elapsed;
-  std::chrono::system_clock::time_point t0;
+  std::chrono::steady_clock::time_point t0;
 };
 } // namespace ngfx
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/core/Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+using namespace ngfx;
+
+std::atomic<bool> Trace::enabled(false);
+
+namespace {
+struct Event {
+  const char *category, *name;
+  uint64_t begin, end;
+};
+// The zones recorded by a thread.  The mutex is only contended while writing the trace
+struct ThreadBuffer {
+  std::mutex mutex;
+  uint32_t tid = 0;
+  std::string name;
+  // A ring of the most recent zones: once it's full, next is the oldest zone
+  std::vector<Event> events;
+  uint32_t capacity = 0, next = 0;
+  uint64_t numDropped = 0;
+  void add(const Event &e) {
+    if (events.size() < capacity) {
+      events.push_back(e);
+      return;
+    }
+    if (capacity == 0)
+      return;
+    events[next] = e;
+    next = (next + 1) % capacity;
+    numDropped++;
+  }
+  void clear() {
+    events.clear();
+    next = 0;
+    numDropped = 0;
+  }
+};
+// The GPU track uses a reserved thread id
+const uint32_t GPU_TID = 0;
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+uint32_t nextTid = GPU_TID + 1;
+uint64_t startTime = 0;
+uint32_t maxZonesPerThread = Trace::DEFAULT_MAX_ZONES_PER_THREAD;
+std::shared_ptr<ThreadBuffer> gpuThreadBuffer;
+// The GPU zone names, stored once so that the events only keep a pointer
+std::mutex namesMutex;
+std::unordered_set<std::string> names;
+
+const char *intern(const std::string &name) {
+  std::lock_guard<std::mutex> lock(namesMutex);
+  return names.insert(name).first->c_str();
+}
+
+ThreadBuffer &gpuBuffer() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  if (!gpuThreadBuffer) {
+    gpuThreadBuffer = std::make_shared<ThreadBuffer>();
+    gpuThreadBuffer->tid = GPU_TID;
+    gpuThreadBuffer->capacity = maxZonesPerThread;
+    gpuThreadBuffer->name = "GPU";
+    threadBuffers.push_back(gpuThreadBuffer);
+  }
+  return *gpuThreadBuffer;
+}
+
+ThreadBuffer &threadBuffer() {
+  // The buffer is shared with the registry, so its zones outlive the thread
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->tid = nextTid++;
+    buffer->capacity = maxZonesPerThread;
+    threadBuffers.push_back(buffer);
+    return buffer;
+  }();
+  return *buffer;
+}
+
+void writeString(FILE *file, const char *str) {
+  fputc('"', file);
+  for (const char *c = str; *c; c++) {
+    if (*c == '"' || *c == '\\')
+      fputc('\\', file);
+    if (uint8_t(*c) >= 0x20)
+      fputc(*c, file);
+  }
+  fputc('"', file);
+}
+} // namespace
+
+void Trace::start(uint32_t maxZones) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  if (maxZones != maxZonesPerThread) {
+    maxZonesPerThread = maxZones;
+    for (auto &buffer : threadBuffers) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      buffer->clear();
+      buffer->capacity = maxZones;
+    }
+  }
+  if (startTime == 0)
+    startTime = now();
+  enabled = true;
+}
+
+void Trace::stop() { enabled = false; }
+
+void Trace::clear() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (auto &buffer : threadBuffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->clear();
+  }
+  startTime = enabled ? now() : 0;
+}
+
+uint64_t Trace::getNumDroppedZones() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  uint64_t numDropped = 0;
+  for (auto &buffer : threadBuffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    numDropped += buffer->numDropped;
+  }
+  return numDropped;
+}
+
+uint64_t Trace::now() {
+  using namespace std::chrono;
+  return uint64_t(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void Trace::addZone(const char *category, const char *name, uint64_t begin,
+                    uint64_t end) {
+  auto &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.add({category, name, begin, end});
+}
+
+void Trace::addGPUZone(const std::string &name, uint64_t begin, uint64_t end) {
+  const char *internedName = intern(name);
+  auto &buffer = gpuBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.add({"gpu", internedName, begin, end});
+}
+
+void Trace::setThreadName(const std::string &name) {
+  auto &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.name = name;
+}
+
+bool Trace::writeJSON(const std::string &filename) {
+  FILE *file = fopen(filename.c_str(), "w");
+  if (!file)
+    return false;
+  std::lock_guard<std::mutex> lock(registryMutex);
+  fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ngfx\"}}");
+  uint64_t numDropped = 0;
+  for (auto &buffer : threadBuffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    if (!buffer->name.empty()) {
+      fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+              buffer->tid);
+      writeString(file, buffer->name.c_str());
+      fprintf(file, "}}");
+    }
+    numDropped += buffer->numDropped;
+    // Write the ring from the oldest zone
+    for (size_t j = 0; j < buffer->events.size(); j++) {
+      const Event &e = buffer->events[(buffer->next + j) % buffer->events.size()];
+      // Zones recorded before the trace was started or cleared are skipped
+      if (e.begin < startTime)
+        continue;
+      fprintf(file, ",\n{\"name\":");
+      writeString(file, e.name);
+      fprintf(file, ",\"cat\":");
+      writeString(file, e.category);
+      fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+              (e.begin - startTime) / 1000.0, (e.end - e.begin) / 1000.0,
+              buffer->tid);
+    }
+  }
+  fprintf(file, "\n],\"otherData\":{\"droppedZones\":%llu}}\n",
+          (unsigned long long)numDropped);
+  return fclose(file) == 0;
+}
+
+namespace {
+// Record the whole process if NGFX_TRACE is set
+struct TraceFromEnv {
+  TraceFromEnv() {
+    const char *env = getenv("NGFX_TRACE");
+    if (!env || !env[0])
+      return;
+    filename = env;
+    Trace::start();
+  }
+  ~TraceFromEnv() {
+    if (!filename.empty())
+      Trace::writeJSON(filename);
+  }
+  std::string filename;
+} traceFromEnv;
+} // namespace
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace ngfx {
+/** \class Trace
+ *
+ *  This module records CPU and GPU zones, and writes them in the Chrome JSON trace format,
+ *  which can be opened in chrome://tracing or in the Perfetto UI (ui.perfetto.dev).
+ *  Each thread appends its zones to its own buffer, so recording doesn't contend with other threads.
+ *  The buffers are bounded rings: when a buffer is full, its oldest zone is dropped
+ *  and counted (see getNumDroppedZones).
+ *  The zones are only recorded between start() and stop().
+ *  Setting the environment variable NGFX_TRACE to a filename records the whole process,
+ *  and writes the trace to that file at exit.
+ *  GPU zones are added by GPUProfiler when it resolves a frame.
+ */
+class Trace {
+public:
+  /** The default number of zones kept per thread */
+  static const uint32_t DEFAULT_MAX_ZONES_PER_THREAD = 1 << 16;
+  /** Start recording zones
+   *  @param maxZonesPerThread The capacity of each thread buffer.
+   *  Changing the capacity discards the recorded zones
+   */
+  static void start(uint32_t maxZonesPerThread = DEFAULT_MAX_ZONES_PER_THREAD);
+  /** Stop recording zones */
+  static void stop();
+  static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+  /** Discard the recorded zones, and reset the number of dropped zones */
+  static void clear();
+  /** Get the number of zones dropped because a thread buffer was full */
+  static uint64_t getNumDroppedZones();
+  /** Write the recorded zones in Chrome JSON trace format
+   *  @param filename The output filename
+   *  @return false if the file can't be written
+   */
+  static bool writeJSON(const std::string &filename);
+  /** Get the current time of the trace clock (a monotonic clock), in nanoseconds */
+  static uint64_t now();
+  /** Add a zone on the calling thread.
+   *  The category and name are not copied: they must be string literals
+   */
+  static void addZone(const char *category, const char *name, uint64_t begin,
+                      uint64_t end);
+  /** Add a zone on the GPU track
+   *  @param name The zone name.  The distinct names are stored once, for the lifetime of the process
+   *  @param begin The begin time, on the trace clock
+   *  @param end The end time, on the trace clock
+   */
+  static void addGPUZone(const std::string &name, uint64_t begin, uint64_t end);
+  /** Set the name of the calling thread in the trace */
+  static void setThreadName(const std::string &name);
+
+  /** A zone covering the lifetime of the object, recorded on the calling thread */
+  class Zone {
+  public:
+    Zone(const char *category, const char *name)
+        : category(category), name(name), begin(isEnabled() ? now() : 0) {}
+    ~Zone() {
+      if (begin)
+        addZone(category, name, begin, now());
+    }
+
+  private:
+    const char *category, *name;
+    uint64_t begin;
+  };
+
+private:
+  static std::atomic<bool> enabled;
+};
+} // namespace ngfx
+
+#ifdef NGFX_ENABLE_TRACE
+#define NGFX_TRACE_CONCAT_(a, b) a##b
+#define NGFX_TRACE_CONCAT(a, b) NGFX_TRACE_CONCAT_(a, b)
+/** Record a CPU zone until the end of the enclosing block */
+#define NGFX_TRACE_ZONE(category, name)                                        \
+  ngfx::Trace::Zone NGFX_TRACE_CONCAT(traceZone, __LINE__)(category, name)
+#else
+#define NGFX_TRACE_ZONE(category, name)
+#endif
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "ngfx/graphics/Buffer.h"
+#include <memory>
 
 /** \class BufferUtil
  * 
@@ -86,4 +87,35 @@ namespace ngfx {
                                      uint32_t size) {
     return Buffer::create(ctx, data, size, BUFFER_USAGE_STORAGE_BUFFER_BIT);
   }
+  /** Create an indirect buffer, containing the arguments of indirect draws or dispatches.
+   *  The buffer can also be written by a compute shader
+   *  @param ctx The graphics context
+   *  @param data The buffer data
+   *  @param size The buffer size (in bytes)
+   */
+  static Buffer *createIndirectBuffer(GraphicsContext *ctx, const void *data,
+                                      uint32_t size) {
+    return Buffer::create(
+        ctx, data, size,
+        BufferUsageFlags(BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                         BUFFER_USAGE_STORAGE_BUFFER_BIT));
+  }
+  /** Upload data to a persistent buffer in place, or (re)create the buffer
+   *  if it doesn't exist yet or if the size has changed
+   *  @param ctx The graphics context
+   *  @param buffer The buffer
+   *  @param data The buffer data, or nullptr to keep the existing contents
+   *  @param size The buffer size (in bytes)
+   *  @param usageFlags The buffer usage flags
+   */
+  static void updateBuffer(GraphicsContext *ctx, std::unique_ptr<Buffer> &buffer,
+                           const void *data, uint32_t size,
+                           BufferUsageFlags usageFlags) {
+    if (buffer && buffer->size == size) {
+      if (data)
+        buffer->upload(data, size);
+      return;
+    }
+    buffer.reset(Buffer::create(ctx, data, size, usageFlags));
+  }
 }; // namespace ngfx
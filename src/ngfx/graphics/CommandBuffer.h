@@ -19,6 +19,7 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/graphics/CommandStats.h"
 #include "ngfx/graphics/GraphicsCore.h"
 
 /** \class CommandBuffer
@@ -47,5 +48,7 @@ public:
   virtual void begin() = 0;
   /** End recording */
   virtual void end() = 0;
+  /** The commands recorded since the last call to begin or Graphics::resetStats */
+  CommandStats stats;
 };
 }; // namespace ngfx
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <cstdint>
+
+namespace ngfx {
+/** \struct CommandStats
+ *
+ *  This struct counts the commands recorded to a command buffer,
+ *  and the CPU time spent recording them
+ */
+struct CommandStats {
+  CommandStats &operator+=(const CommandStats &rhs) {
+    numDraws += rhs.numDraws;
+    numDispatches += rhs.numDispatches;
+    numRenderPasses += rhs.numRenderPasses;
+    numPipelineBinds += rhs.numPipelineBinds;
+    numDescriptorSetBinds += rhs.numDescriptorSetBinds;
+    numVertexBufferBinds += rhs.numVertexBufferBinds;
+    numIndexBufferBinds += rhs.numIndexBufferBinds;
+    numBarriers += rhs.numBarriers;
+    numCopies += rhs.numCopies;
+    recordingTime += rhs.recordingTime;
+    return *this;
+  }
+  /** The number of draw calls (each indirect draw counts once per draw) */
+  uint32_t numDraws = 0;
+  uint32_t numDispatches = 0;
+  uint32_t numRenderPasses = 0;
+  uint32_t numPipelineBinds = 0;
+  uint32_t numDescriptorSetBinds = 0;
+  uint32_t numVertexBufferBinds = 0;
+  uint32_t numIndexBufferBinds = 0;
+  /** The number of pipeline barriers, including image layout transitions */
+  uint32_t numBarriers = 0;
+  /** The number of copy and blit commands */
+  uint32_t numCopies = 0;
+  /** The CPU time spent in the recording functions, in milliseconds */
+  double recordingTime = 0.0;
+};
+} // namespace ngfx
@@ -19,6 +19,7 @@
  * under the License.
  */
 #pragma once
+#include <cstdint>
 
 /** \class Device
  * 
@@ -26,5 +27,16 @@
  */
  
 namespace ngfx {
-class Device {};
+class Device {
+public:
+  virtual ~Device() {}
+  /** Get the GPU memory budget for this process in bytes, or 0 if unknown */
+  virtual uint64_t getMemoryBudget() { return 0; }
+  /** Get the GPU memory used by this process in bytes, or 0 if unknown */
+  virtual uint64_t getMemoryUsage() { return 0; }
+  /** Returns true if compute shaders support subgroup arithmetic operations */
+  virtual bool supportsSubgroupArithmetic() { return false; }
+  /** Returns true if the device supports Graphics::drawIndexedIndirectCount */
+  virtual bool supportsDrawIndirectCount() { return false; }
+};
 }; // namespace ngfx
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include "ngfx/graphics/CommandBuffer.h"
+#include "ngfx/graphics/GPUProfiler.h"
 #include "ngfx/graphics/Graphics.h"
 #include "ngfx/graphics/GraphicsContext.h"
 #include <functional>
@@ -46,6 +47,20 @@ public:
    *  @param commandBuffer The command buffer
    *  @param graphics The graphics object */ 
   virtual void draw(CommandBuffer *commandBuffer, Graphics *graphics) = 0;
+  /** Draw in a profiler scope, which measures the GPU time and collects the
+   *  pipeline statistics of the draw op, e.g. its fragment shader invocations.
+   *  @param commandBuffer The command buffer
+   *  @param graphics The graphics object
+   *  @param profiler The GPU profiler, or nullptr to draw without profiling
+   *  @param name The scope name */
+  void profileDraw(CommandBuffer *commandBuffer, Graphics *graphics,
+                   GPUProfiler *profiler, const std::string &name) {
+    if (!profiler)
+      return draw(commandBuffer, graphics);
+    profiler->beginScope(commandBuffer, name, true);
+    draw(commandBuffer, graphics);
+    profiler->endScope(commandBuffer);
+  }
 
 protected:
   GraphicsContext *ctx;
@@ -35,9 +35,8 @@ void FilterOp::init(GraphicsContext* ctx, Graphics* graphics, uint32_t w, uint32
     vector<Framebuffer::Attachment> attachments = { {  outputTexture } };
     if (enableDepthStencil)
         attachments.push_back({ { depthStencilTexture.get() } });
-    outputFramebuffer.reset(Framebuffer::create(ctx->device,
-        ctx->defaultOffscreenRenderPass,
-        attachments, w, h));
+    outputFramebuffer = ctx->getFramebuffer(ctx->defaultOffscreenRenderPass,
+        attachments, w, h);
 }
 
 FilterOp::FilterOp(GraphicsContext* ctx, Graphics* graphics, Texture* outputTexture, bool enableDepthStencil)
@@ -67,7 +66,7 @@ void FilterOp::apply(GraphicsContext *ctx, CommandBuffer *commandBuffer,
   outputTexture->changeLayout(commandBuffer,
                               IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
   ctx->beginOffscreenRenderPass(commandBuffer, graphics,
-                                outputFramebuffer.get());
+                                outputFramebuffer);
   draw(commandBuffer, graphics);
   ctx->endOffscreenRenderPass(commandBuffer, graphics);
   outputTexture->changeLayout(commandBuffer,
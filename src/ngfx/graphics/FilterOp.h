@@ -56,8 +56,8 @@ public:
   Texture* outputTexture = nullptr;
   /** The depth / stencil attachment */
   std::unique_ptr<Texture> depthStencilTexture;
-  /** The output framebuffer */
-  std::unique_ptr<Framebuffer> outputFramebuffer;
+  /** The output framebuffer (owned by the graphics context) */
+  Framebuffer *outputFramebuffer = nullptr;
 private:
     void init(GraphicsContext* ctx, Graphics* graphics, uint32_t w, uint32_t h, bool enableDepthStencil);
     /** If output texture is allocated internally, stores the output texture */
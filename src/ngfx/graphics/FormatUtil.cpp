@@ -44,4 +44,50 @@ int FormatUtil::getBytesPerPixel(PixelFormat format) {
         { PIXELFORMAT_D32_SFLOAT_S8_UINT, 8 }
     };
     return bppMap.at(format);
+}
+
+static const std::map<PixelFormat, FormatUtil::BlockInfo> &compressedFormats() {
+    static const std::map<PixelFormat, FormatUtil::BlockInfo> blockInfoMap = {
+        { PIXELFORMAT_BC1_RGBA_UNORM, { 4, 4, 8 } },
+        { PIXELFORMAT_BC2_UNORM, { 4, 4, 16 } },
+        { PIXELFORMAT_BC3_UNORM, { 4, 4, 16 } },
+        { PIXELFORMAT_BC4_UNORM, { 4, 4, 8 } },
+        { PIXELFORMAT_BC5_UNORM, { 4, 4, 16 } },
+        { PIXELFORMAT_BC6H_UFLOAT, { 4, 4, 16 } },
+        { PIXELFORMAT_BC6H_SFLOAT, { 4, 4, 16 } },
+        { PIXELFORMAT_BC7_UNORM, { 4, 4, 16 } },
+#ifndef NGFX_GRAPHICS_BACKEND_DIRECT3D12
+        { PIXELFORMAT_ETC2_RGB8_UNORM, { 4, 4, 8 } },
+        { PIXELFORMAT_ETC2_RGB8A1_UNORM, { 4, 4, 8 } },
+        { PIXELFORMAT_ETC2_RGBA8_UNORM, { 4, 4, 16 } },
+        { PIXELFORMAT_ASTC_4x4_UNORM, { 4, 4, 16 } },
+        { PIXELFORMAT_ASTC_5x5_UNORM, { 5, 5, 16 } },
+        { PIXELFORMAT_ASTC_6x6_UNORM, { 6, 6, 16 } },
+        { PIXELFORMAT_ASTC_8x8_UNORM, { 8, 8, 16 } },
+#endif
+    };
+    return blockInfoMap;
+}
+
+FormatUtil::BlockInfo FormatUtil::getBlockInfo(PixelFormat format) {
+    auto &blockInfoMap = compressedFormats();
+    auto it = blockInfoMap.find(format);
+    if (it != blockInfoMap.end()) return it->second;
+    return { 1, 1, uint32_t(getBytesPerPixel(format)) };
+}
+
+bool FormatUtil::isCompressed(PixelFormat format) {
+    return compressedFormats().count(format) != 0;
+}
+
+uint32_t FormatUtil::getRowPitch(PixelFormat format, uint32_t w) {
+    auto blockInfo = getBlockInfo(format);
+    return (w + blockInfo.w - 1) / blockInfo.w * blockInfo.size;
+}
+
+uint32_t FormatUtil::getImageSize(PixelFormat format, uint32_t w, uint32_t h,
+                                  uint32_t d) {
+    auto blockInfo = getBlockInfo(format);
+    uint32_t numBlockRows = (h + blockInfo.h - 1) / blockInfo.h;
+    return getRowPitch(format, w) * numBlockRows * d;
 }
\ No newline at end of file
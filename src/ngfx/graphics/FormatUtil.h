@@ -27,7 +27,21 @@ namespace ngfx {
 
     class FormatUtil {
     public:
+        /** Block dimensions (in pixels) and size (in bytes) of a pixel format.
+         *  Uncompressed formats are treated as 1x1 blocks */
+        struct BlockInfo {
+            uint32_t w, h, size;
+        };
         /** Get the number of bytes per pixel for a given format */
         static int getBytesPerPixel(PixelFormat format);
+        /** Get the block info for a given format */
+        static BlockInfo getBlockInfo(PixelFormat format);
+        /** Check if the format is block-compressed */
+        static bool isCompressed(PixelFormat format);
+        /** Get the size in bytes of a row of blocks */
+        static uint32_t getRowPitch(PixelFormat format, uint32_t w);
+        /** Get the size in bytes of an image with the given dimensions */
+        static uint32_t getImageSize(PixelFormat format, uint32_t w, uint32_t h,
+                                     uint32_t d = 1);
     };
 }
\ No newline at end of file
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/GPUProfiler.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/core/Trace.h"
+#include <algorithm>
+using namespace ngfx;
+
+GPUProfiler *GPUProfiler::create(GraphicsContext *ctx, uint32_t numFrames,
+                                 uint32_t maxScopes, uint32_t statsWindow) {
+  auto profiler = new GPUProfiler();
+  if (!profiler->init(ctx, numFrames, maxScopes, statsWindow)) {
+    delete profiler;
+    return nullptr;
+  }
+  return profiler;
+}
+
+bool GPUProfiler::init(GraphicsContext *ctx, uint32_t numFrames,
+                       uint32_t maxScopes, uint32_t statsWindow) {
+  if (statsWindow == 0)
+    NGFX_ERR("statsWindow must be greater than 0");
+  this->ctx = ctx;
+  this->statsWindow = statsWindow;
+  frames.resize(numFrames);
+  maxQueries = maxScopes * 2;
+  maxStatsQueries = maxScopes;
+  // The queries are reset from the host once their frame is resolved.  A reset
+  // recorded in the command buffer would leave the results of the previous frame
+  // using the pool available until the GPU executes it
+  for (uint32_t j = 0; j < numFrames; j++) {
+    QueryPool *queryPool = createQueryPool(QUERY_TYPE_TIMESTAMP, maxQueries);
+    if (!queryPool)
+      return false;
+    timestampPools.emplace_back(queryPool);
+    if (!queryPool->hostReset()) {
+      NGFX_LOG("the device doesn't support resetting queries from the host");
+      return false;
+    }
+  }
+  // Pipeline statistics are optional
+  for (uint32_t j = 0; j < numFrames; j++) {
+    QueryPool *queryPool =
+        createQueryPool(QUERY_TYPE_PIPELINE_STATISTICS, maxStatsQueries);
+    if (!queryPool) {
+      statsPools.clear();
+      break;
+    }
+    statsPools.emplace_back(queryPool);
+    queryPool->hostReset();
+  }
+  return true;
+}
+
+QueryPool *GPUProfiler::createQueryPool(QueryType type, uint32_t count) {
+  return QueryPool::create(ctx, type, count);
+}
+
+void GPUProfiler::beginFrame(CommandBuffer *commandBuffer) {
+  if (inFrame)
+    NGFX_ERR("beginFrame called twice without endFrame");
+  resolve();
+  frameIndex++;
+  inFrame = true;
+  uint32_t pool = uint32_t(frameIndex % frames.size());
+  Frame &frame = frames[pool];
+  // Don't wait for the GPU: the queries of the previous frame using the pool
+  // are still in use, so the current frame is dropped
+  dropFrame = frame.pending;
+  if (dropFrame) {
+    numDroppedFrames++;
+    return;
+  }
+  frame.index = frameIndex;
+  frame.cpuTime = Trace::now();
+  frame.numQueries = 0;
+  frame.numStatsQueries = 0;
+  frame.scopes.clear();
+}
+
+void GPUProfiler::endFrame() {
+  if (!inFrame)
+    NGFX_ERR("endFrame called without beginFrame");
+  if (!scopeStack.empty())
+    NGFX_ERR("%d scopes are still open", int(scopeStack.size()));
+  Frame &frame = frames[frameIndex % frames.size()];
+  if (!dropFrame)
+    frame.pending = (frame.numQueries != 0);
+  inFrame = false;
+}
+
+void GPUProfiler::beginScope(CommandBuffer *commandBuffer, const std::string &name,
+                             bool pipelineStatistics) {
+  if (!inFrame)
+    NGFX_ERR("beginScope called outside a frame");
+  uint32_t pool = uint32_t(frameIndex % frames.size());
+  Frame &frame = frames[pool];
+  if (dropFrame || frame.numQueries + 2 > maxQueries) {
+    // Out of queries: the scope is not measured, but still needs to be closed
+    scopeStack.push_back(-1);
+    return;
+  }
+  int32_t parent = -1;
+  for (auto it = scopeStack.rbegin(); it != scopeStack.rend() && parent < 0; it++)
+    parent = *it;
+  Scope scope;
+  scope.name = name;
+  scope.path = (parent < 0) ? name : frame.scopes[parent].path + "/" + name;
+  scope.parent = parent;
+  scope.depth = uint32_t(scopeStack.size());
+  scope.beginQuery = frame.numQueries++;
+  scope.endQuery = frame.numQueries++;
+  scope.statsQuery = -1;
+  int32_t index = int32_t(frame.scopes.size());
+  timestampPools[pool]->writeTimestamp(commandBuffer, scope.beginQuery);
+  if (pipelineStatistics && !statsPools.empty() && statsScope < 0 &&
+      frame.numStatsQueries < maxStatsQueries) {
+    scope.statsQuery = int32_t(frame.numStatsQueries++);
+    statsPools[pool]->begin(commandBuffer, uint32_t(scope.statsQuery));
+    statsScope = index;
+  }
+  scopeStack.push_back(index);
+  frame.scopes.emplace_back(std::move(scope));
+}
+
+void GPUProfiler::endScope(CommandBuffer *commandBuffer) {
+  if (scopeStack.empty())
+    NGFX_ERR("endScope called without beginScope");
+  int32_t index = scopeStack.back();
+  scopeStack.pop_back();
+  if (index < 0)
+    return;
+  uint32_t pool = uint32_t(frameIndex % frames.size());
+  const Scope &scope = frames[pool].scopes[index];
+  if (scope.statsQuery >= 0) {
+    statsPools[pool]->end(commandBuffer, uint32_t(scope.statsQuery));
+    statsScope = -1;
+  }
+  timestampPools[pool]->writeTimestamp(commandBuffer, scope.endQuery);
+}
+
+void GPUProfiler::resolve() {
+  std::vector<uint32_t> pendingFrames;
+  for (uint32_t j = 0; j < frames.size(); j++) {
+    if (frames[j].pending)
+      pendingFrames.push_back(j);
+  }
+  std::sort(pendingFrames.begin(), pendingFrames.end(), [&](uint32_t a, uint32_t b) {
+    return frames[a].index < frames[b].index;
+  });
+  std::vector<uint64_t> timestamps;
+  std::vector<PipelineStatistics> pipelineStatistics;
+  for (uint32_t pool : pendingFrames) {
+    Frame &frame = frames[pool];
+    timestamps.resize(frame.numQueries);
+    pipelineStatistics.resize(frame.numStatsQueries);
+    // The frames complete in order, so the next frames are not available either
+    if (!timestampPools[pool]->getResults(0, frame.numQueries, timestamps.data()))
+      break;
+    if (frame.numStatsQueries != 0 &&
+        !statsPools[pool]->getResults(0, frame.numStatsQueries,
+                                      pipelineStatistics.data()))
+      break;
+    resolveFrame(frame, timestamps, pipelineStatistics);
+    frame.pending = false;
+    timestampPools[pool]->hostReset(0, frame.numQueries);
+    if (frame.numStatsQueries != 0)
+      statsPools[pool]->hostReset(0, frame.numStatsQueries);
+  }
+}
+
+void GPUProfiler::resolveFrame(
+    Frame &frame, const std::vector<uint64_t> &timestamps,
+    const std::vector<PipelineStatistics> &pipelineStatistics) {
+  QueryPool *queryPool = timestampPools[frame.index % frames.size()].get();
+  auto toNs = [&](uint64_t t0, uint64_t t1) {
+    return double((t1 - t0) & queryPool->timestampMask) *
+           queryPool->timestampPeriod;
+  };
+  uint64_t origin = timestamps[frame.scopes[0].beginQuery];
+  timings.resize(frame.scopes.size());
+  std::map<std::string, double> frameDurations;
+  lastPipelineStatistics.clear();
+  for (size_t j = 0; j < frame.scopes.size(); j++) {
+    const Scope &scope = frame.scopes[j];
+    ScopeTiming &timing = timings[j];
+    timing.path = scope.path;
+    timing.name = scope.name;
+    timing.parent = scope.parent;
+    timing.depth = scope.depth;
+    timing.begin = toNs(origin, timestamps[scope.beginQuery]);
+    timing.end = toNs(origin, timestamps[scope.endQuery]);
+    timing.duration = toNs(timestamps[scope.beginQuery], timestamps[scope.endQuery]);
+    timing.hasPipelineStatistics = (scope.statsQuery >= 0);
+    timing.pipelineStatistics = timing.hasPipelineStatistics
+                                    ? pipelineStatistics[scope.statsQuery]
+                                    : PipelineStatistics();
+    // A scope opened several times in a frame contributes its total duration
+    frameDurations[scope.path] += timing.duration;
+    if (timing.hasPipelineStatistics)
+      lastPipelineStatistics[scope.path] += timing.pipelineStatistics;
+    if (Trace::isEnabled())
+      Trace::addGPUZone(scope.name, frame.cpuTime + uint64_t(timing.begin),
+                        frame.cpuTime + uint64_t(timing.end));
+  }
+  for (auto &it : frameDurations) {
+    ScopeSamples &s = samples[it.first];
+    if (s.values.size() < statsWindow)
+      s.values.push_back(it.second);
+    else
+      s.values[s.next] = it.second;
+    s.next = (s.next + 1) % statsWindow;
+  }
+  resolvedFrame = frame.index;
+}
+
+std::map<std::string, GPUProfiler::ScopeStats> GPUProfiler::getStats() const {
+  std::map<std::string, ScopeStats> stats;
+  for (auto &it : samples) {
+    const ScopeSamples &s = it.second;
+    ScopeStats &scopeStats = stats[it.first];
+    uint32_t n = uint32_t(s.values.size());
+    scopeStats.numSamples = n;
+    scopeStats.last = s.values[(s.next + n - 1) % n];
+    scopeStats.min = *std::min_element(s.values.begin(), s.values.end());
+    scopeStats.max = *std::max_element(s.values.begin(), s.values.end());
+    double sum = 0.0;
+    for (double v : s.values)
+      sum += v;
+    scopeStats.avg = sum / n;
+    auto pipelineStatistics = lastPipelineStatistics.find(it.first);
+    if (pipelineStatistics != lastPipelineStatistics.end()) {
+      scopeStats.hasPipelineStatistics = true;
+      scopeStats.pipelineStatistics = pipelineStatistics->second;
+    }
+  }
+  return stats;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/graphics/CommandBuffer.h"
+#include "ngfx/graphics/QueryPool.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ngfx {
+class GraphicsContext;
+
+/** \class GPUProfiler
+ *
+ *  This class measures the GPU time of nested, named scopes using timestamp queries.
+ *  Each frame uses its own set of queries in a ring of numFrames query pools, and the
+ *  results of a frame are resolved when they become available, typically numFrames - 1
+ *  frames later, without waiting for the GPU.  The queries are reset from the host once
+ *  their frame is resolved.  If the results of the previous frame using a query pool are
+ *  still not available when the pool is reused, the new frame is dropped: its scopes
+ *  are not measured.
+ *  When tracing is enabled, the resolved scopes are added to the GPU track of the trace.
+ *  The GPU clock isn't calibrated against the CPU clock, so each frame is aligned to
+ *  the CPU time of beginFrame.
+ *  A scope can also collect pipeline statistics, such as the number of fragment shader
+ *  invocations, e.g. to find which DrawOp dominates the fragment work (see DrawOp::profileDraw).
+ *
+ *  Usage:
+ *    profiler->beginFrame(commandBuffer);
+ *    profiler->beginScope(commandBuffer, "shadows");
+ *    ...
+ *    profiler->endScope(commandBuffer);
+ *    profiler->endFrame();
+ */
+class GPUProfiler {
+public:
+  /** Create the GPU profiler
+   *  @param ctx The graphics context
+   *  @param numFrames The number of frames in flight, i.e. the size of the query pool ring
+   *  @param maxScopes The maximum number of scopes per frame
+   *  @param statsWindow The number of resolved frames over which the rolling statistics
+   *  are computed
+   *  @return The GPU profiler, or nullptr if the device doesn't support timestamp queries
+   *  or resetting queries from the host
+   */
+  static GPUProfiler *create(GraphicsContext *ctx, uint32_t numFrames = 3,
+                             uint32_t maxScopes = 256, uint32_t statsWindow = 120);
+  virtual ~GPUProfiler() {}
+  /** Begin a frame: resolve the completed frames.
+   *  The queries are reset from the host, so no command is recorded in the command buffer
+   *  @param commandBuffer The command buffer of the frame
+   */
+  void beginFrame(CommandBuffer *commandBuffer);
+  /** End the frame.  All the scopes must be closed */
+  void endFrame();
+  /** Begin a scope.  Scopes can be nested, and can span several command buffers
+   *  submitted in order on the same queue
+   *  @param commandBuffer The command buffer
+   *  @param name The scope name
+   *  @param pipelineStatistics Also collect the pipeline statistics of the scope, if the
+   *  device supports it.  Only one scope can collect them at a time, so they're ignored
+   *  for a scope nested in such a scope, and the scope must end in the same subpass
+   */
+  void beginScope(CommandBuffer *commandBuffer, const std::string &name,
+                  bool pipelineStatistics = false);
+  /** End the innermost scope
+   *  @param commandBuffer The command buffer
+   */
+  void endScope(CommandBuffer *commandBuffer);
+  /** Resolve the frames whose results are available, without waiting.
+   *  This is called by beginFrame
+   */
+  void resolve();
+
+  /** The timing of a scope in a resolved frame */
+  struct ScopeTiming {
+    /** The scope path: the names of the enclosing scopes and of the scope, separated by '/' */
+    std::string path;
+    std::string name;
+    /** The index of the parent scope, or -1 for a top level scope */
+    int32_t parent;
+    uint32_t depth;
+    /** The GPU timestamps relative to the first scope of the frame, and the duration, in nanoseconds */
+    double begin, end, duration;
+    /** The pipeline statistics of the scope, if it collected them */
+    bool hasPipelineStatistics = false;
+    PipelineStatistics pipelineStatistics;
+  };
+  /** The rolling statistics of a scope over the last numSamples resolved frames, in nanoseconds */
+  struct ScopeStats {
+    double last = 0.0, min = 0.0, avg = 0.0, max = 0.0;
+    uint32_t numSamples = 0;
+    /** The pipeline statistics of the scope in the last resolved frame, if it collected them */
+    bool hasPipelineStatistics = false;
+    PipelineStatistics pipelineStatistics;
+  };
+  /** Get the scope timings of the last resolved frame, in the order the scopes were opened */
+  const std::vector<ScopeTiming> &getTimings() const { return timings; }
+  /** Get the rolling statistics of each scope, indexed by scope path */
+  std::map<std::string, ScopeStats> getStats() const;
+  /** Check if the scopes can collect pipeline statistics */
+  bool supportsPipelineStatistics() const { return !statsPools.empty(); }
+  /** The index of the last resolved frame, or -1 if no frame has been resolved yet */
+  int64_t resolvedFrame = -1;
+  /** The number of frames dropped because the results of the previous frame using
+   *  their query pool were not available in time */
+  uint64_t numDroppedFrames = 0;
+  /** Get the number of resolved frames over which the rolling statistics are computed */
+  uint32_t getStatsWindow() const { return statsWindow; }
+
+protected:
+  /** Create the query pools
+   *  @return false if the timestamp query pools can't be created */
+  bool init(GraphicsContext *ctx, uint32_t numFrames, uint32_t maxScopes,
+            uint32_t statsWindow = 120);
+  /** Create a query pool.  This can be overridden to simulate the queries */
+  virtual QueryPool *createQueryPool(QueryType type, uint32_t count);
+
+private:
+  struct Scope {
+    std::string path, name;
+    int32_t parent;
+    uint32_t depth, beginQuery, endQuery;
+    /** The pipeline statistics query, or -1 */
+    int32_t statsQuery;
+  };
+  struct Frame {
+    int64_t index = -1;
+    bool pending = false;
+    /** The CPU time of beginFrame, on the trace clock */
+    uint64_t cpuTime = 0;
+    uint32_t numQueries = 0, numStatsQueries = 0;
+    std::vector<Scope> scopes;
+  };
+  void resolveFrame(Frame &frame, const std::vector<uint64_t> &timestamps,
+                    const std::vector<PipelineStatistics> &pipelineStatistics);
+  struct ScopeSamples {
+    std::vector<double> values;
+    uint32_t next = 0;
+  };
+  GraphicsContext *ctx = nullptr;
+  std::vector<std::unique_ptr<QueryPool>> timestampPools, statsPools;
+  std::vector<Frame> frames;
+  std::vector<int32_t> scopeStack;
+  /** The scope collecting pipeline statistics, or -1 */
+  int32_t statsScope = -1;
+  std::map<std::string, PipelineStatistics> lastPipelineStatistics;
+  std::vector<ScopeTiming> timings;
+  std::map<std::string, ScopeSamples> samples;
+  uint32_t maxQueries = 0, maxStatsQueries = 0;
+  uint32_t statsWindow = 120;
+  int64_t frameIndex = -1;
+  bool inFrame = false;
+  /** The current frame is not measured, because its query pool is still in use */
+  bool dropFrame = false;
+};
+} // namespace ngfx
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/Graphics.h"
+#include "ngfx/graphics/GraphicsContext.h"
+using namespace ngfx;
+
+CommandStats Graphics::getStats(CommandBuffer *cmdBuffer) const {
+  if (cmdBuffer)
+    return cmdBuffer->stats;
+  CommandStats stats;
+  for (auto statsCmdBuffer : ctx->statsCmdBuffers)
+    stats += statsCmdBuffer->stats;
+  return stats;
+}
+
+void Graphics::resetStats() {
+  for (auto statsCmdBuffer : ctx->statsCmdBuffers)
+    statsCmdBuffer->stats = {};
+  ctx->statsCmdBuffers.clear();
+}
+
+void Graphics::resourceBarrier(CommandBuffer *cmdBuffer,
+                               const std::vector<ResourceBarrier> &barriers) {
+  if (!barriers.empty())
+    computeBarrier(cmdBuffer);
+}
+
+void Graphics::computeToDrawBarrier(CommandBuffer *cmdBuffer) {
+  computeBarrier(cmdBuffer);
+}
+
+CommandStats &Graphics::getRecordingStats(CommandBuffer *cmdBuffer) {
+  return ctx->getRecordingStats(cmdBuffer);
+}
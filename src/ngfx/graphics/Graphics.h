@@ -28,9 +28,40 @@
 #include "ngfx/graphics/Texture.h"
 #include <cstdint>
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace ngfx {
 
+/** The arguments of an indirect draw, as stored in the indirect buffer */
+struct DrawIndirectCommand {
+  uint32_t vertexCount, instanceCount, firstVertex, firstInstance;
+};
+/** The arguments of an indirect indexed draw, as stored in the indirect buffer */
+struct DrawIndexedIndirectCommand {
+  uint32_t indexCount, instanceCount, firstIndex;
+  int32_t vertexOffset;
+  uint32_t firstInstance;
+};
+/** The arguments of an indirect dispatch, as stored in the indirect buffer */
+struct DispatchIndirectCommand {
+  uint32_t groupCountX, groupCountY, groupCountZ;
+};
+/** The shader accesses to a resource */
+enum ShaderAccessFlagBits {
+  SHADER_ACCESS_READ_BIT = 1,
+  SHADER_ACCESS_WRITE_BIT = 2
+};
+typedef uint32_t ShaderAccessFlags;
+/** A dependency on a buffer or a texture between compute dispatches */
+struct ResourceBarrier {
+  Buffer *buffer = nullptr;
+  Texture *texture = nullptr;
+  /** The accesses by the previous dispatches, and by the subsequent dispatches */
+  ShaderAccessFlags srcAccess = 0, dstAccess = 0;
+  /** The texture layout for the subsequent dispatches */
+  ImageLayout imageLayout = IMAGE_LAYOUT_GENERAL;
+};
+
 /** \class Graphics
  *
  *  This class defines the interface for a graphics commands module.
@@ -71,6 +102,7 @@ public:
   virtual void endRenderPass(CommandBuffer *commandBuffer) = 0;
   /** Begin GPU profiling.
       Use beginProfile/endProfile to profile a group of commands in the command buffer.
+      endProfile waits for the results: use GPUProfiler to profile nested scopes without blocking.
   *   @param commandBuffer The command buffer
   */
   virtual void beginProfile(CommandBuffer *commandBuffer) = 0;
@@ -193,6 +225,43 @@ public:
                            uint32_t instanceCount = 1, uint32_t firstIndex = 0,
                            int32_t vertexOffset = 0,
                            uint32_t firstInstance = 0) = 0;
+  /** Draw primitives, reading the draw arguments from a GPU buffer.
+  *   @param cmdBuffer The command buffer
+  *   @param buffer The indirect buffer, containing an array of DrawIndirectCommand.
+  *   The buffer must be created with BUFFER_USAGE_INDIRECT_BUFFER_BIT
+  *   @param offset The byte offset of the first command in the buffer
+  *   @param drawCount The number of draws
+  *   @param stride The byte stride between consecutive commands
+  */
+  virtual void drawIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                            uint32_t offset = 0, uint32_t drawCount = 1,
+                            uint32_t stride = sizeof(DrawIndirectCommand)) = 0;
+  /** Draw indexed primitives, reading the draw arguments from a GPU buffer.
+  *   @param cmdBuffer The command buffer
+  *   @param buffer The indirect buffer, containing an array of DrawIndexedIndirectCommand.
+  *   The buffer must be created with BUFFER_USAGE_INDIRECT_BUFFER_BIT
+  *   @param offset The byte offset of the first command in the buffer
+  *   @param drawCount The number of draws
+  *   @param stride The byte stride between consecutive commands
+  */
+  virtual void drawIndexedIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                   uint32_t offset = 0, uint32_t drawCount = 1,
+                                   uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
+  /** Draw indexed primitives, reading both the draw arguments and the number of draws from GPU buffers.
+  *   This requires Device::supportsDrawIndirectCount.
+  *   @param cmdBuffer The command buffer
+  *   @param buffer The indirect buffer, containing an array of DrawIndexedIndirectCommand
+  *   @param offset The byte offset of the first command in the buffer
+  *   @param countBuffer The buffer containing the number of draws, as a uint32_t.
+  *   The buffer must be created with BUFFER_USAGE_INDIRECT_BUFFER_BIT
+  *   @param countBufferOffset The byte offset of the draw count in countBuffer
+  *   @param maxDrawCount The maximum number of draws
+  *   @param stride The byte stride between consecutive commands
+  */
+  virtual void drawIndexedIndirectCount(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                        uint32_t offset, Buffer *countBuffer,
+                                        uint32_t countBufferOffset, uint32_t maxDrawCount,
+                                        uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
   /** Dispatch compute worker threads
   *   @param cmdBuffer The command buffer
   *   @param groupCountX, groupCountY, groupCountZ The number of groups (tensor)
@@ -203,6 +272,37 @@ public:
                         uint32_t groupCountY, uint32_t groupCountZ,
                         int32_t threadsPerGroupX = -1, int32_t threadsPerGroupY = -1,
                         int32_t threadsPerGroupZ = -1) = 0;
+  /** Dispatch compute worker threads, reading the number of groups from a GPU buffer
+  *   @param cmdBuffer The command buffer
+  *   @param buffer The indirect buffer, containing a DispatchIndirectCommand.
+  *   The buffer must be created with BUFFER_USAGE_INDIRECT_BUFFER_BIT
+  *   @param offset The byte offset of the command in the buffer
+  *   @param threadsPerGroupX, threadsPerGroupY, threadsPerGroupZ The number of threads per group (tensor)
+  */
+  virtual void dispatchIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                uint32_t offset = 0, int32_t threadsPerGroupX = -1,
+                                int32_t threadsPerGroupY = -1,
+                                int32_t threadsPerGroupZ = -1) = 0;
+  /** Insert a memory barrier between compute dispatches.
+  *   Writes to buffers and images from the previous dispatches become visible
+  *   to the subsequent dispatches.
+  *   @param cmdBuffer The command buffer
+  */
+  virtual void computeBarrier(CommandBuffer *cmdBuffer) = 0;
+  /** Insert a barrier between compute dispatches, limited to the given resources.
+  *   The default implementation inserts a computeBarrier.
+  *   @param cmdBuffer The command buffer
+  *   @param barriers The resources accessed by the previous and the subsequent dispatches
+  */
+  virtual void resourceBarrier(CommandBuffer *cmdBuffer,
+                               const std::vector<ResourceBarrier> &barriers);
+  /** Insert a memory barrier between compute dispatches and subsequent draws, outside a render pass.
+  *   Writes to buffers and images from the previous dispatches become visible
+  *   to the indirect draw arguments, the vertex and index buffers and the shaders of the subsequent draws.
+  *   The default implementation inserts a computeBarrier.
+  *   @param cmdBuffer The command buffer
+  */
+  virtual void computeToDrawBarrier(CommandBuffer *cmdBuffer);
   /** Set the viewport
   *   This defines the mapping of view coordinates to NDC coordinates.
   *   @param cmdBuffer The command buffer
@@ -221,6 +321,15 @@ public:
   */
   virtual void waitIdle(CommandBuffer *cmdBuffer) = 0;
 
+  /** Get the statistics of the commands recorded since the last call to resetStats.
+  *   @param cmdBuffer The command buffer, or nullptr to get the sum over all the
+  *   command buffers recorded since the last call to resetStats, including the
+  *   copy command buffer used by the texture and buffer uploads
+  */
+  CommandStats getStats(CommandBuffer *cmdBuffer = nullptr) const;
+  /** Reset the statistics of the recorded command buffers, e.g. at the start of each frame */
+  void resetStats();
+
   Rect2D scissorRect;
   Rect2D viewport;
   Pipeline *currentPipeline = nullptr;
@@ -228,6 +337,8 @@ public:
   Framebuffer *currentFramebuffer = nullptr;
 
 protected:
+  /** Get the statistics of a command buffer that is recorded through this interface */
+  CommandStats &getRecordingStats(CommandBuffer *cmdBuffer);
   GraphicsContext *ctx;
 };
 } // namespace ngfx
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/GraphicsContext.h"
+#include "ngfx/core/DebugUtil.h"
+#include <algorithm>
+using namespace ngfx;
+
+static bool isSameFramebuffer(Framebuffer *framebuffer,
+                              const std::vector<Framebuffer::Attachment> &attachments,
+                              uint32_t w, uint32_t h, uint32_t layers) {
+  if (framebuffer->w != w || framebuffer->h != h || framebuffer->layers != layers ||
+      framebuffer->attachments.size() != attachments.size())
+    return false;
+  for (uint32_t j = 0; j < attachments.size(); j++) {
+    auto &a0 = framebuffer->attachments[j], &a1 = attachments[j];
+    if (a0.texture != a1.texture || a0.level != a1.level || a0.layer != a1.layer)
+      return false;
+  }
+  return true;
+}
+
+GraphicsContext::~GraphicsContext() {
+  auto snapshot = memoryTracker.getSnapshot();
+  if (snapshot.allocations.empty())
+    return;
+  NGFX_LOG_WARNING("GPU memory still allocated at graphics context destruction: "
+                   "%u allocations, %llu bytes",
+                   snapshot.numAllocations, (unsigned long long)snapshot.totalBytes);
+  // One record per allocation, so the report isn't truncated
+  std::string leakReport = memoryTracker.getLeakReport();
+  size_t begin = 0, end;
+  while ((end = leakReport.find('\n', begin)) != std::string::npos) {
+    NGFX_LOG_WARNING("%s", leakReport.substr(begin, end - begin));
+    begin = end + 1;
+  }
+}
+
+Framebuffer *GraphicsContext::getFramebuffer(RenderPass *renderPass,
+    const std::vector<Framebuffer::Attachment> &attachments,
+    uint32_t w, uint32_t h, uint32_t layers) {
+  size_t key = HashUtil::combine(renderPass, w, h, layers);
+  for (auto &attachment : attachments) {
+    HashUtil::combine(key, attachment.texture);
+    HashUtil::combine(key, attachment.level);
+    HashUtil::combine(key, attachment.layer);
+  }
+  auto range = framebufferCache.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto &entry = it->second;
+    if (entry.renderPass == renderPass &&
+        isSameFramebuffer(entry.framebuffer.get(), attachments, w, h, layers))
+      return entry.framebuffer.get();
+  }
+  Framebuffer *framebuffer =
+      Framebuffer::create(device, renderPass, attachments, w, h, layers);
+  framebufferCache.emplace(key, FramebufferCacheEntry{
+                                    renderPass, std::unique_ptr<Framebuffer>(framebuffer)});
+  return framebuffer;
+}
+
+void GraphicsContext::onTextureDestroyed(Texture *texture) {
+  for (auto it = framebufferCache.begin(); it != framebufferCache.end();) {
+    auto &attachments = it->second.framebuffer->attachments;
+    bool usesTexture = std::any_of(attachments.begin(), attachments.end(),
+        [&](const Framebuffer::Attachment &attachment) {
+          return attachment.texture == texture;
+        });
+    if (usesTexture)
+      it = framebufferCache.erase(it);
+    else
+      ++it;
+  }
+}
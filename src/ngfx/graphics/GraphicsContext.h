@@ -20,17 +20,22 @@
  */
 #pragma once
 #include "ngfx/compute/ComputePass.h"
+#include "ngfx/core/HashUtil.h"
 #include "ngfx/graphics/CommandBuffer.h"
 #include "ngfx/graphics/Device.h"
 #include "ngfx/graphics/Framebuffer.h"
 #include "ngfx/graphics/Graphics.h"
+#include "ngfx/graphics/MemoryTracker.h"
 #include "ngfx/graphics/PipelineCache.h"
 #include "ngfx/graphics/Queue.h"
 #include "ngfx/graphics/RenderPass.h"
 #include "ngfx/graphics/Surface.h"
 #include "ngfx/graphics/Swapchain.h"
+#include <algorithm>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace ngfx {
@@ -58,7 +63,9 @@ public:
                                  bool enableDepthStencil = false,
                                  bool debug = true,
                                  OnSelectDepthStencilFormats onSelectDepthStencilFormats = nullptr);
-  virtual ~GraphicsContext() {}
+  /** Destroy the graphics context.
+   *  The GPU memory allocations that are still alive are reported as leaks */
+  virtual ~GraphicsContext();
   /** Set the surface for the graphics context 
    *  This can be an offscreen or onscreen surface.
    *  Also, if the user passes nullptr, then the graphics context will work in 
@@ -126,12 +133,22 @@ public:
   struct AttachmentDescription {
       bool operator==(const AttachmentDescription& rhs) const {
           return rhs.format == format && rhs.initialLayout == initialLayout &&
-              rhs.finalLayout == finalLayout && rhs.loadOp == loadOp && rhs.storeOp == storeOp;
+              rhs.finalLayout == finalLayout && rhs.loadOp == loadOp && rhs.storeOp == storeOp &&
+              rhs.multisampleStoreOp == multisampleStoreOp;
+      }
+      /** Get the hash key of the attachment description */
+      size_t key() const {
+          return HashUtil::combine(format, initialLayout, finalLayout, loadOp, storeOp,
+                                   multisampleStoreOp);
       }
       PixelFormat format;
       std::optional<ImageLayout> initialLayout, finalLayout;
       AttachmentLoadOp loadOp;
+      /** The store operation.  When using multisampling, this applies to the resolved attachment */
       AttachmentStoreOp storeOp;
+      /** The store operation of the multisample color attachment (optional).
+       *  By default, the multisample attachment uses the same store operation as the resolved attachment */
+      std::optional<AttachmentStoreOp> multisampleStoreOp;
   };
 
   /** \struct RenderPassConfig
@@ -146,6 +163,15 @@ public:
              rhs.enableDepthStencilResolve == enableDepthStencilResolve &&
              rhs.numSamples == numSamples;
     };
+    /** Get the hash key of the render pass configuration */
+    size_t key() const {
+      size_t seed = HashUtil::combine(enableDepthStencilResolve, numSamples);
+      for (auto &colorAttachmentDescription : colorAttachmentDescriptions)
+        HashUtil::combine(seed, colorAttachmentDescription.key());
+      if (depthStencilAttachmentDescription)
+        HashUtil::combine(seed, depthStencilAttachmentDescription->key());
+      return seed;
+    }
     /** Get the number of color attachments */
     uint32_t numColorAttachments() const {
       return uint32_t(colorAttachmentDescriptions.size());
@@ -161,6 +187,33 @@ public:
   };
   /** Get a render pass object that supports a given configuration */
   virtual RenderPass *getRenderPass(RenderPassConfig config) = 0;
+  /** Get a framebuffer object for a given render pass and set of attachments.
+   *  The framebuffer is owned by the graphics context, and it's cached
+   *  until one of the attachment textures is destroyed
+   *  @param renderPass The renderPass object
+   *  @param attachments The output attachments
+   *  @param w The destination width
+   *  @param h The destination height
+   *  @param layers The number of output layers
+   */
+  Framebuffer *getFramebuffer(RenderPass *renderPass,
+                              const std::vector<Framebuffer::Attachment> &attachments,
+                              uint32_t w, uint32_t h, uint32_t layers = 1);
+  /** Evict the cached objects which reference a texture.
+   *  This is called by the texture destructor */
+  void onTextureDestroyed(Texture *texture);
+  /** Get the statistics of a command buffer that is being recorded,
+   *  and include them in Graphics::getStats until the next call to Graphics::resetStats */
+  CommandStats &getRecordingStats(CommandBuffer *cmdBuffer) {
+    if (statsCmdBuffers.empty() || statsCmdBuffers.back() != cmdBuffer) {
+      if (std::find(statsCmdBuffers.begin(), statsCmdBuffers.end(), cmdBuffer) ==
+          statsCmdBuffers.end())
+        statsCmdBuffers.push_back(cmdBuffer);
+    }
+    return cmdBuffer->stats;
+  }
+  /** The command buffers with statistics since the last call to Graphics::resetStats */
+  std::vector<CommandBuffer *> statsCmdBuffers;
 
   std::vector<Framebuffer *> swapchainFramebuffers;
   Queue *queue = nullptr;
@@ -180,9 +233,16 @@ public:
               depthFormat = PIXELFORMAT_UNDEFINED,
               depthStencilFormat = PIXELFORMAT_UNDEFINED;
   glm::vec4 clearColor = glm::vec4(0.0f);
+  /** The GPU memory allocated by the resources of this context */
+  MemoryTracker memoryTracker;
 
 protected:
   bool debug = false, enableDepthStencil = false;
   OnSelectDepthStencilFormats onSelectDepthStencilFormats;
+  struct FramebufferCacheEntry {
+    RenderPass *renderPass;
+    std::unique_ptr<Framebuffer> framebuffer;
+  };
+  std::unordered_multimap<size_t, FramebufferCacheEntry> framebufferCache;
 };
 }; // namespace ngfx
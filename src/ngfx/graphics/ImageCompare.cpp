@@ -0,0 +1,346 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/ImageCompare.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/core/ThreadPool.h"
+#include "ngfx/graphics/ImageUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NGFX_IMAGE_COMPARE_SSE2
+#endif
+using namespace ngfx;
+
+// Number of rows processed by each task
+#define ROWS_PER_TASK 16
+// SSIM window size and stride
+#define SSIM_WINDOW 8
+#define SSIM_STRIDE 4
+
+namespace {
+struct BlockStats {
+  uint64_t sumSquares = 0, numDifferentPixels = 0;
+  uint8_t maxDifference[4] = {0, 0, 0, 0};
+  double sumDeltaE = 0.0, maxDeltaE = 0.0;
+};
+
+inline float luma(const uint8_t *p, int numChannels) {
+  if (numChannels < 3)
+    return p[0];
+  return 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+}
+
+// Convert an sRGB color to CIE Lab (D65 white point)
+inline void toLab(const uint8_t *p, float *lab) {
+  static const auto linearTable = []() {
+    std::vector<float> table(256);
+    for (int j = 0; j < 256; j++) {
+      float v = j / 255.0f;
+      table[j] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+    return table;
+  }();
+  float r = linearTable[p[0]], g = linearTable[p[1]], b = linearTable[p[2]];
+  float xyz[3] = {(0.4124f * r + 0.3576f * g + 0.1805f * b) / 0.95047f,
+                  0.2126f * r + 0.7152f * g + 0.0722f * b,
+                  (0.0193f * r + 0.1192f * g + 0.9505f * b) / 1.08883f};
+  for (float &v : xyz) {
+    v = v > 0.008856f ? std::cbrt(v) : 7.787f * v + 16.0f / 116.0f;
+  }
+  lab[0] = 116.0f * xyz[1] - 16.0f;
+  lab[1] = 500.0f * (xyz[0] - xyz[1]);
+  lab[2] = 200.0f * (xyz[1] - xyz[2]);
+}
+
+void compareRowScalar(const uint8_t *a, const uint8_t *b, uint32_t numPixels,
+                      int numChannels, const uint8_t *tolerance,
+                      BlockStats &stats) {
+  for (uint32_t j = 0; j < numPixels; j++) {
+    bool different = false;
+    for (int c = 0; c < numChannels; c++) {
+      int d = std::abs(int(a[c]) - int(b[c]));
+      stats.sumSquares += uint32_t(d * d);
+      stats.maxDifference[c] = std::max(stats.maxDifference[c], uint8_t(d));
+      different |= d > tolerance[c];
+    }
+    stats.numDifferentPixels += different;
+    a += numChannels;
+    b += numChannels;
+  }
+}
+
+void compareRow(const uint8_t *a, const uint8_t *b, uint32_t numPixels,
+                int numChannels, const uint8_t *tolerance, BlockStats &stats) {
+#ifdef NGFX_IMAGE_COMPARE_SSE2
+  if (numChannels == 4) {
+    // Process 4 RGBA pixels per iteration
+    static const uint8_t bitCount[16] = {0, 1, 1, 2, 1, 2, 2, 3,
+                                         1, 2, 2, 3, 2, 3, 3, 4};
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tol = _mm_set1_epi32(int32_t(
+        uint32_t(tolerance[0]) | uint32_t(tolerance[1]) << 8 |
+        uint32_t(tolerance[2]) << 16 | uint32_t(tolerance[3]) << 24));
+    __m128i maxDiff = zero;
+    uint32_t j = 0;
+    while (j + 4 <= numPixels) {
+      // Flush the 32-bit sums before they can overflow
+      uint32_t end = std::min(numPixels & ~3u, j + 4 * 4096);
+      __m128i sumSquares = zero;
+      for (; j < end; j += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + 4 * j));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + 4 * j));
+        __m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        maxDiff = _mm_max_epu8(maxDiff, d);
+        __m128i withinTolerance =
+            _mm_cmpeq_epi32(_mm_subs_epu8(d, tol), zero);
+        stats.numDifferentPixels +=
+            4 - bitCount[_mm_movemask_ps(_mm_castsi128_ps(withinTolerance))];
+        __m128i lo = _mm_unpacklo_epi8(d, zero), hi = _mm_unpackhi_epi8(d, zero);
+        sumSquares = _mm_add_epi32(sumSquares,
+                                   _mm_add_epi32(_mm_madd_epi16(lo, lo),
+                                                 _mm_madd_epi16(hi, hi)));
+      }
+      uint32_t sums[4];
+      _mm_storeu_si128((__m128i *)sums, sumSquares);
+      stats.sumSquares += uint64_t(sums[0]) + sums[1] + sums[2] + sums[3];
+    }
+    uint8_t maxDiffs[16];
+    _mm_storeu_si128((__m128i *)maxDiffs, maxDiff);
+    for (int k = 0; k < 16; k++) {
+      stats.maxDifference[k & 3] =
+          std::max(stats.maxDifference[k & 3], maxDiffs[k]);
+    }
+    compareRowScalar(a + 4 * j, b + 4 * j, numPixels - j, numChannels,
+                     tolerance, stats);
+    return;
+  }
+#endif
+  compareRowScalar(a, b, numPixels, numChannels, tolerance, stats);
+}
+
+void deltaERow(const uint8_t *a, const uint8_t *b, uint32_t numPixels,
+               int numChannels, BlockStats &stats) {
+  for (uint32_t j = 0; j < numPixels; j++) {
+    if (a[0] != b[0] || a[1] != b[1] || a[2] != b[2]) {
+      float labA[3], labB[3];
+      toLab(a, labA);
+      toLab(b, labB);
+      double deltaE = std::sqrt(double((labA[0] - labB[0]) * (labA[0] - labB[0]) +
+                                       (labA[1] - labB[1]) * (labA[1] - labB[1]) +
+                                       (labA[2] - labB[2]) * (labA[2] - labB[2])));
+      stats.sumDeltaE += deltaE;
+      stats.maxDeltaE = std::max(stats.maxDeltaE, deltaE);
+    }
+    a += numChannels;
+    b += numChannels;
+  }
+}
+
+double windowSSIM(const float *x, const float *y, uint32_t stride, uint32_t w,
+                  uint32_t h) {
+  const double c1 = (0.01 * 255.0) * (0.01 * 255.0),
+               c2 = (0.03 * 255.0) * (0.03 * 255.0);
+  double sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
+  for (uint32_t j = 0; j < h; j++) {
+    for (uint32_t k = 0; k < w; k++) {
+      double vx = x[j * stride + k], vy = y[j * stride + k];
+      sumX += vx;
+      sumY += vy;
+      sumXX += vx * vx;
+      sumYY += vy * vy;
+      sumXY += vx * vy;
+    }
+  }
+  double n = double(w * h);
+  double meanX = sumX / n, meanY = sumY / n;
+  double varX = sumXX / n - meanX * meanX, varY = sumYY / n - meanY * meanY;
+  double covXY = sumXY / n - meanX * meanY;
+  return ((2.0 * meanX * meanY + c1) * (2.0 * covXY + c2)) /
+         ((meanX * meanX + meanY * meanY + c1) * (varX + varY + c2));
+}
+
+bool sameFormat(const ImageData &image, const ImageData &ref) {
+  return image.data && ref.data && image.w == ref.w && image.h == ref.h &&
+         image.numChannels == ref.numChannels && image.numChannels >= 1 &&
+         image.numChannels <= 4 && image.size == ref.size &&
+         image.size == image.w * image.h * image.numChannels;
+}
+} // namespace
+
+std::string ImageCompareResult::toString() const {
+  if (sizeMismatch)
+    return "image size mismatch";
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "different pixels: %llu / %llu, max difference: (%d, %d, %d, %d), "
+           "PSNR: %.2f dB, SSIM: %.5f, delta E: %.3f (max: %.3f)",
+           (unsigned long long)numDifferentPixels, (unsigned long long)numPixels,
+           maxDifference[0], maxDifference[1], maxDifference[2],
+           maxDifference[3], psnr, ssim, meanDeltaE, maxDeltaE);
+  return buffer;
+}
+
+ImageCompare::Result ImageCompare::compare(const ImageData &image,
+                                           const ImageData &ref,
+                                           const Options &options) {
+  Result result;
+  if (!sameFormat(image, ref)) {
+    result.sizeMismatch = true;
+    return result;
+  }
+  const uint32_t w = image.w, h = image.h;
+  const int numChannels = image.numChannels;
+  const uint8_t *imageData = (const uint8_t *)image.data,
+                *refData = (const uint8_t *)ref.data;
+  const uint32_t rowSize = w * numChannels;
+  const bool computePerceptualMetrics = options.computePerceptualMetrics;
+  std::vector<float> imageLuma, refLuma;
+  if (computePerceptualMetrics) {
+    imageLuma.resize(w * h);
+    refLuma.resize(w * h);
+  }
+  const uint32_t numBlocks = (h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  std::vector<BlockStats> blocks(numBlocks);
+  auto threadPool = ThreadPool::getDefault();
+  threadPool->parallelFor(0, numBlocks, [&](uint32_t block) {
+    BlockStats &stats = blocks[block];
+    uint32_t y1 = std::min(h, (block + 1) * ROWS_PER_TASK);
+    for (uint32_t y = block * ROWS_PER_TASK; y < y1; y++) {
+      const uint8_t *a = &imageData[y * rowSize], *b = &refData[y * rowSize];
+      compareRow(a, b, w, numChannels, options.tolerance, stats);
+      if (!computePerceptualMetrics)
+        continue;
+      if (numChannels >= 3)
+        deltaERow(a, b, w, numChannels, stats);
+      for (uint32_t x = 0; x < w; x++) {
+        imageLuma[y * w + x] = luma(&a[x * numChannels], numChannels);
+        refLuma[y * w + x] = luma(&b[x * numChannels], numChannels);
+      }
+    }
+  });
+  BlockStats total;
+  for (const BlockStats &stats : blocks) {
+    total.sumSquares += stats.sumSquares;
+    total.numDifferentPixels += stats.numDifferentPixels;
+    for (int c = 0; c < 4; c++)
+      total.maxDifference[c] =
+          std::max(total.maxDifference[c], stats.maxDifference[c]);
+    total.sumDeltaE += stats.sumDeltaE;
+    total.maxDeltaE = std::max(total.maxDeltaE, stats.maxDeltaE);
+  }
+  result.numPixels = uint64_t(w) * h;
+  result.numDifferentPixels = total.numDifferentPixels;
+  std::copy(total.maxDifference, total.maxDifference + 4, result.maxDifference);
+  result.mse = double(total.sumSquares) / double(result.numPixels * numChannels);
+  result.psnr = result.mse == 0.0
+                    ? std::numeric_limits<double>::infinity()
+                    : 10.0 * std::log10(255.0 * 255.0 / result.mse);
+  if (computePerceptualMetrics) {
+    result.meanDeltaE = total.sumDeltaE / double(result.numPixels);
+    result.maxDeltaE = total.maxDeltaE;
+    uint32_t windowW = std::min(w, uint32_t(SSIM_WINDOW)),
+             windowH = std::min(h, uint32_t(SSIM_WINDOW));
+    uint32_t numWindowsX = (w - windowW) / SSIM_STRIDE + 1,
+             numWindowsY = (h - windowH) / SSIM_STRIDE + 1;
+    std::vector<double> rowSSIM(numWindowsY);
+    threadPool->parallelFor(0, numWindowsY, [&](uint32_t j) {
+      double sum = 0.0;
+      for (uint32_t k = 0; k < numWindowsX; k++) {
+        uint32_t offset = j * SSIM_STRIDE * w + k * SSIM_STRIDE;
+        sum += windowSSIM(&imageLuma[offset], &refLuma[offset], w, windowW,
+                          windowH);
+      }
+      rowSSIM[j] = sum;
+    });
+    double sum = 0.0;
+    for (double v : rowSSIM)
+      sum += v;
+    result.ssim = sum / double(numWindowsX * numWindowsY);
+  }
+  result.passed =
+      double(result.numDifferentPixels) <=
+          options.maxDifferentPixels * double(result.numPixels) &&
+      (options.minPSNR <= 0.0 || result.psnr >= options.minPSNR) &&
+      (options.minSSIM <= 0.0 || result.ssim >= options.minSSIM) &&
+      (options.maxMeanDeltaE < 0.0 || result.meanDeltaE <= options.maxMeanDeltaE);
+  return result;
+}
+
+void ImageCompare::diffHeatmap(const ImageData &image, const ImageData &ref,
+                               ImageData &heatmap, const Options &options) {
+  if (!sameFormat(image, ref)) {
+    NGFX_ERR("image size mismatch: %dx%dx%d, %dx%dx%d", image.w, image.h,
+             image.numChannels, ref.w, ref.h, ref.numChannels);
+  }
+  const uint32_t w = image.w, h = image.h;
+  const int numChannels = image.numChannels;
+  free(heatmap.data);
+  heatmap.w = w;
+  heatmap.h = h;
+  heatmap.numChannels = 4;
+  heatmap.size = w * h * 4;
+  heatmap.data = malloc(heatmap.size);
+  const uint8_t *imageData = (const uint8_t *)image.data,
+                *refData = (const uint8_t *)ref.data;
+  uint8_t *heatmapData = (uint8_t *)heatmap.data;
+  const uint32_t numBlocks = (h + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  ThreadPool::getDefault()->parallelFor(0, numBlocks, [&](uint32_t block) {
+    uint32_t y1 = std::min(h, (block + 1) * ROWS_PER_TASK);
+    for (uint32_t j = block * ROWS_PER_TASK * w; j < y1 * w; j++) {
+      const uint8_t *a = &imageData[j * numChannels],
+                    *b = &refData[j * numChannels];
+      uint8_t *dst = &heatmapData[j * 4];
+      int maxDiff = 0;
+      bool different = false;
+      for (int c = 0; c < numChannels; c++) {
+        int d = std::abs(int(a[c]) - int(b[c]));
+        maxDiff = std::max(maxDiff, d);
+        different |= d > options.tolerance[c];
+      }
+      if (!different) {
+        dst[0] = dst[1] = dst[2] = uint8_t(luma(b, numChannels) * 0.25f);
+      } else {
+        // Boost the small differences, and map to blue, cyan, green, yellow, red
+        float t = 4.0f * std::sqrt(maxDiff / 255.0f);
+        int segment = std::min(int(t), 3);
+        uint8_t f = uint8_t((t - segment) * 255.0f);
+        const uint8_t colors[4][3] = {{0, f, 255},
+                                      {0, 255, uint8_t(255 - f)},
+                                      {f, 255, 0},
+                                      {255, uint8_t(255 - f), 0}};
+        std::copy(colors[segment], colors[segment] + 3, dst);
+      }
+      dst[3] = 255;
+    }
+  });
+}
+
+void ImageCompare::storeDiffHeatmap(const std::string &filename,
+                                    const ImageData &image, const ImageData &ref,
+                                    const Options &options) {
+  ImageData heatmap;
+  diffHeatmap(image, ref, heatmap, options);
+  ImageUtil::storePNG(filename, heatmap);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/graphics/ImageData.h"
+#include <cstdint>
+#include <string>
+
+namespace ngfx {
+
+/** Options of ImageCompare */
+struct ImageCompareOptions {
+  /** The maximum absolute difference per channel (0 - 255) */
+  uint8_t tolerance[4] = {0, 0, 0, 0};
+  /** The fraction of pixels allowed to exceed the tolerance */
+  double maxDifferentPixels = 0.0;
+  /** The minimum PSNR (in dB), or 0 to ignore */
+  double minPSNR = 0.0;
+  /** The minimum SSIM (from -1 to 1), or 0 to ignore */
+  double minSSIM = 0.0;
+  /** The maximum mean delta E, or a negative value to ignore.
+   *  A delta E of ~2.3 is a just noticeable difference */
+  double maxMeanDeltaE = -1.0;
+  /** Compute SSIM and delta E (slower) */
+  bool computePerceptualMetrics = true;
+  /** Set the same tolerance for all the channels */
+  ImageCompareOptions &setTolerance(uint8_t v) {
+    tolerance[0] = tolerance[1] = tolerance[2] = tolerance[3] = v;
+    return *this;
+  }
+};
+
+/** The result of ImageCompare::compare */
+struct ImageCompareResult {
+  /** The images have different dimensions or formats */
+  bool sizeMismatch = false;
+  uint64_t numPixels = 0;
+  /** The number of pixels exceeding the tolerance in at least one channel */
+  uint64_t numDifferentPixels = 0;
+  /** The maximum absolute difference, per channel */
+  uint8_t maxDifference[4] = {0, 0, 0, 0};
+  /** The mean squared error, over all the channels */
+  double mse = 0.0;
+  /** The peak signal to noise ratio (in dB), or infinity if the images are identical */
+  double psnr = 0.0;
+  /** The mean structural similarity index of the luma (1 if identical) */
+  double ssim = 1.0;
+  /** The mean and maximum CIE76 delta E */
+  double meanDeltaE = 0.0, maxDeltaE = 0.0;
+  /** The image matches the reference, according to the options */
+  bool passed = false;
+  std::string toString() const;
+};
+
+/** \class ImageCompare
+ *
+ *  This class compares an image against a reference image, with a per-channel
+ *  tolerance, so that small differences between drivers (e.g. 1-LSB rounding)
+ *  don't cause a mismatch.  It also computes PSNR, SSIM (on luma), and a
+ *  perceptual difference (CIE76 delta E in Lab space), and it can generate a
+ *  heatmap of the differences.
+ *  The images are 8 bits per channel, and the work is split across rows
+ *  using the default thread pool.
+ */
+class ImageCompare {
+public:
+  using Options = ImageCompareOptions;
+  using Result = ImageCompareResult;
+  /** Compare an image with a reference image */
+  static Result compare(const ImageData &image, const ImageData &ref,
+                        const Options &options = Options());
+  /** Generate a heatmap of the differences (RGBA).  The pixels within the tolerance
+   *  show the reference luma (dimmed), and the other pixels go from blue to red
+   *  as the maximum channel difference increases */
+  static void diffHeatmap(const ImageData &image, const ImageData &ref,
+                          ImageData &heatmap, const Options &options = Options());
+  /** Generate a heatmap of the differences, and store it as a PNG file */
+  static void storeDiffHeatmap(const std::string &filename, const ImageData &image,
+                               const ImageData &ref,
+                               const Options &options = Options());
+};
+} // namespace ngfx
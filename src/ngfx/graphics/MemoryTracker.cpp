@@ -0,0 +1,174 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/MemoryTracker.h"
+#include <algorithm>
+#include <cstdio>
+using namespace ngfx;
+
+static std::string formatSize(uint64_t size) {
+  char str[32];
+  if (size >= (1ull << 20))
+    snprintf(str, sizeof(str), "%.2f MB", double(size) / (1 << 20));
+  else
+    snprintf(str, sizeof(str), "%.2f KB", double(size) / (1 << 10));
+  return str;
+}
+
+static std::string formatAllocation(const MemoryTracker::Allocation &allocation) {
+  char line[256];
+  snprintf(line, sizeof(line), "%s %s: %s%s, %u descriptor sets, %u image views\n",
+           MemoryTracker::getCategoryName(allocation.category),
+           allocation.name.empty() ? "<unnamed>" : allocation.name.c_str(),
+           formatSize(allocation.size).c_str(),
+           allocation.hostVisible ? " (host visible)" : "",
+           allocation.numDescriptorSets, allocation.numImageViews);
+  return line;
+}
+
+const char *MemoryTracker::getCategoryName(MemoryCategory category) {
+  static const char *names[MEMORY_CATEGORY_COUNT] = {
+      "vertex", "index", "uniform", "storage", "texture", "staging", "attachment"};
+  return names[category];
+}
+
+void MemoryTracker::onAllocate(const void *handle, MemoryCategory category,
+                               uint64_t size, bool hostVisible,
+                               const std::string &name) {
+  onFree(handle);
+  std::lock_guard<std::mutex> lock(mutex);
+  Allocation &allocation = allocations[handle];
+  allocation.category = category;
+  allocation.size = size;
+  allocation.hostVisible = hostVisible;
+  allocation.name = name;
+  auto &stats = categories[category];
+  stats.bytes += size;
+  stats.count++;
+  stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+  stats.peakCount = std::max(stats.peakCount, stats.count);
+  totalBytes += size;
+  peakTotalBytes = std::max(peakTotalBytes, totalBytes);
+}
+
+void MemoryTracker::onFree(const void *handle) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = allocations.find(handle);
+  if (it == allocations.end())
+    return;
+  auto &stats = categories[it->second.category];
+  stats.bytes -= it->second.size;
+  stats.count--;
+  totalBytes -= it->second.size;
+  allocations.erase(it);
+}
+
+void MemoryTracker::setName(const void *handle, const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = allocations.find(handle);
+  if (it != allocations.end())
+    it->second.name = name;
+}
+
+void MemoryTracker::addDescriptorSets(const void *handle, int32_t count) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = allocations.find(handle);
+  if (it != allocations.end())
+    it->second.numDescriptorSets += count;
+}
+
+void MemoryTracker::addImageViews(const void *handle, int32_t count) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = allocations.find(handle);
+  if (it != allocations.end())
+    it->second.numImageViews += count;
+}
+
+MemoryTracker::Snapshot
+MemoryTracker::getSnapshot(bool includeAllocations) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Snapshot snapshot;
+  std::copy(categories, categories + MEMORY_CATEGORY_COUNT,
+            snapshot.categories);
+  snapshot.totalBytes = totalBytes;
+  snapshot.peakTotalBytes = peakTotalBytes;
+  snapshot.numAllocations = uint32_t(allocations.size());
+  for (auto &it : allocations) {
+    auto &allocation = it.second;
+    if (allocation.hostVisible)
+      snapshot.hostVisibleBytes += allocation.size;
+    else
+      snapshot.deviceLocalBytes += allocation.size;
+    snapshot.numDescriptorSets += allocation.numDescriptorSets;
+    snapshot.numImageViews += allocation.numImageViews;
+    if (includeAllocations)
+      snapshot.allocations.push_back(allocation);
+  }
+  std::sort(snapshot.allocations.begin(), snapshot.allocations.end(),
+            [](const Allocation &a0, const Allocation &a1) {
+              return a0.size > a1.size;
+            });
+  return snapshot;
+}
+
+void MemoryTracker::resetPeak() {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto &stats : categories) {
+    stats.peakBytes = stats.bytes;
+    stats.peakCount = stats.count;
+  }
+  peakTotalBytes = totalBytes;
+}
+
+std::string MemoryTracker::getLeakReport() const {
+  Snapshot snapshot = getSnapshot();
+  if (snapshot.allocations.empty())
+    return "";
+  std::string report;
+  for (auto &allocation : snapshot.allocations)
+    report += formatAllocation(allocation);
+  return report;
+}
+
+std::string MemoryTracker::Snapshot::toString(uint32_t maxAllocations) const {
+  std::string str;
+  char line[256];
+  snprintf(line, sizeof(line),
+           "total: %s (peak: %s), device local: %s, host visible: %s, "
+           "%u allocations, %u descriptor sets, %u image views\n",
+           formatSize(totalBytes).c_str(), formatSize(peakTotalBytes).c_str(),
+           formatSize(deviceLocalBytes).c_str(),
+           formatSize(hostVisibleBytes).c_str(), numAllocations,
+           numDescriptorSets, numImageViews);
+  str += line;
+  for (uint32_t j = 0; j < MEMORY_CATEGORY_COUNT; j++) {
+    auto &stats = categories[j];
+    if (stats.peakCount == 0)
+      continue;
+    snprintf(line, sizeof(line), "%s: %s in %u allocations (peak: %s in %u)\n",
+             getCategoryName(MemoryCategory(j)), formatSize(stats.bytes).c_str(),
+             stats.count, formatSize(stats.peakBytes).c_str(), stats.peakCount);
+    str += line;
+  }
+  uint32_t numListed = std::min(maxAllocations, uint32_t(allocations.size()));
+  for (uint32_t j = 0; j < numListed; j++)
+    str += formatAllocation(allocations[j]);
+  return str;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ngfx {
+enum MemoryCategory {
+  MEMORY_CATEGORY_VERTEX,
+  MEMORY_CATEGORY_INDEX,
+  MEMORY_CATEGORY_UNIFORM,
+  MEMORY_CATEGORY_STORAGE,
+  MEMORY_CATEGORY_TEXTURE,
+  MEMORY_CATEGORY_STAGING,
+  MEMORY_CATEGORY_ATTACHMENT,
+  MEMORY_CATEGORY_COUNT
+};
+
+/** \class MemoryTracker
+ *
+ *  This class keeps track of the GPU memory allocated by the graphics context,
+ *  per category, along with the descriptor sets and image views owned by each resource.
+ *  Each allocation is identified by the address of the resource that owns it.
+ *  The backend reports the allocations, and the tracker is thread-safe.
+ */
+class MemoryTracker {
+public:
+  struct Allocation {
+    MemoryCategory category;
+    uint64_t size = 0;
+    /** The memory is visible from the CPU (e.g. staging or shared memory) */
+    bool hostVisible = false;
+    uint32_t numDescriptorSets = 0, numImageViews = 0;
+    std::string name;
+  };
+  struct CategoryStats {
+    uint64_t bytes = 0, peakBytes = 0;
+    uint32_t count = 0, peakCount = 0;
+  };
+  struct Snapshot {
+    CategoryStats categories[MEMORY_CATEGORY_COUNT];
+    uint64_t totalBytes = 0, peakTotalBytes = 0;
+    uint64_t deviceLocalBytes = 0, hostVisibleBytes = 0;
+    uint32_t numAllocations = 0;
+    uint32_t numDescriptorSets = 0, numImageViews = 0;
+    /** The live allocations, sorted by decreasing size */
+    std::vector<Allocation> allocations;
+    /** Format the per-category usage, and the largest allocations */
+    std::string toString(uint32_t maxAllocations = 16) const;
+  };
+  void onAllocate(const void *handle, MemoryCategory category, uint64_t size,
+                  bool hostVisible, const std::string &name = "");
+  void onFree(const void *handle);
+  void setName(const void *handle, const std::string &name);
+  /** Add (or remove, if count is negative) descriptor sets owned by a resource */
+  void addDescriptorSets(const void *handle, int32_t count);
+  /** Add (or remove, if count is negative) image views owned by a resource */
+  void addImageViews(const void *handle, int32_t count);
+  /** Get the current usage
+   *  @param includeAllocations Also return the list of live allocations */
+  Snapshot getSnapshot(bool includeAllocations = true) const;
+  /** Restart the peak tracking from the current usage */
+  void resetPeak();
+  /** Get the list of the live allocations, one per line, or an empty string
+   *  if everything has been released */
+  std::string getLeakReport() const;
+  static const char *getCategoryName(MemoryCategory category);
+
+private:
+  mutable std::mutex mutex;
+  std::unordered_map<const void *, Allocation> allocations;
+  CategoryStats categories[MEMORY_CATEGORY_COUNT];
+  uint64_t totalBytes = 0, peakTotalBytes = 0;
+};
+} // namespace ngfx
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/graphics/CommandBuffer.h"
+#include <cstdint>
+
+namespace ngfx {
+class GraphicsContext;
+
+enum QueryType {
+  /** The GPU time when the previous commands have completed */
+  QUERY_TYPE_TIMESTAMP,
+  /** The number of samples passing the depth and stencil tests */
+  QUERY_TYPE_OCCLUSION,
+  /** The number of primitives and shader invocations processed by the pipeline */
+  QUERY_TYPE_PIPELINE_STATISTICS
+};
+
+/** \struct PipelineStatistics
+ *
+ *  The result of a pipeline statistics query.
+ *  The counters are laid out in the order the backend returns them
+ */
+struct PipelineStatistics {
+  uint64_t inputAssemblyVertices = 0, inputAssemblyPrimitives = 0,
+           vertexShaderInvocations = 0, clippingInvocations = 0,
+           clippingPrimitives = 0, fragmentShaderInvocations = 0,
+           computeShaderInvocations = 0;
+  PipelineStatistics &operator+=(const PipelineStatistics &rhs) {
+    inputAssemblyVertices += rhs.inputAssemblyVertices;
+    inputAssemblyPrimitives += rhs.inputAssemblyPrimitives;
+    vertexShaderInvocations += rhs.vertexShaderInvocations;
+    clippingInvocations += rhs.clippingInvocations;
+    clippingPrimitives += rhs.clippingPrimitives;
+    fragmentShaderInvocations += rhs.fragmentShaderInvocations;
+    computeShaderInvocations += rhs.computeShaderInvocations;
+    return *this;
+  }
+};
+
+/** \class QueryPool
+ *
+ *  This class implements a pool of GPU queries of a given type.
+ *  The queries are reset, written and read back in batches: getResults
+ *  doesn't wait for the GPU by default, so the results of a frame can be
+ *  read back a few frames later without stalling the pipeline.
+ *  A reset recorded in a command buffer only takes effect when the GPU executes it:
+ *  until then, the previous results of the queries are still available.
+ *
+ *  Usage:
+ *    queryPool->reset(commandBuffer);           // outside a render pass
+ *    queryPool->begin(commandBuffer, 0);
+ *    ... draw ...
+ *    queryPool->end(commandBuffer, 0);
+ *    ...
+ *    if (queryPool->getResults(0, 1, &samples)) ...
+ */
+class QueryPool {
+public:
+  /** Create the query pool
+   *  @param ctx The graphics context
+   *  @param type The query type
+   *  @param count The number of queries
+   *  @return The query pool, or nullptr if the device doesn't support the query type
+   */
+  static QueryPool *create(GraphicsContext *ctx, QueryType type,
+                           uint32_t count);
+  virtual ~QueryPool() {}
+  /** Reset a range of queries.  A query must be reset before it's written
+   *  @param commandBuffer The command buffer, outside a render pass
+   *  @param first The first query
+   *  @param count The number of queries, or all the queries starting at first if 0
+   */
+  virtual void reset(CommandBuffer *commandBuffer, uint32_t first = 0,
+                     uint32_t count = 0) = 0;
+  /** Reset a range of queries from the host, e.g. once their results have been read back.
+   *  The queries must not be used by any pending command buffer
+   *  @param first The first query
+   *  @param count The number of queries, or all the queries starting at first if 0
+   *  @return false if the device doesn't support resetting queries from the host
+   */
+  virtual bool hostReset(uint32_t first = 0, uint32_t count = 0) = 0;
+  /** Write a timestamp when the previous commands have completed
+   *  @param commandBuffer The command buffer
+   *  @param query The query index
+   */
+  virtual void writeTimestamp(CommandBuffer *commandBuffer, uint32_t query) = 0;
+  /** Begin an occlusion or pipeline statistics query.
+   *  Only one query of a given type can be active at a time in a command buffer,
+   *  and a query begun in a render pass must end in the same subpass
+   *  @param commandBuffer The command buffer
+   *  @param query The query index
+   *  @param precise Count the exact number of samples of an occlusion query,
+   *  instead of a boolean result
+   */
+  virtual void begin(CommandBuffer *commandBuffer, uint32_t query,
+                     bool precise = false) = 0;
+  /** End an occlusion or pipeline statistics query
+   *  @param commandBuffer The command buffer
+   *  @param query The query index
+   */
+  virtual void end(CommandBuffer *commandBuffer, uint32_t query) = 0;
+  /** Get the results of a range of queries.
+   *  Each query returns getNumValues() values
+   *  @param first The first query
+   *  @param count The number of queries
+   *  @param results The output results: timestamps in ticks, numbers of samples, or
+   *  the counters of PipelineStatistics
+   *  @param wait Wait until the results are available
+   *  @return false if the results of some queries are not available yet
+   */
+  virtual bool getResults(uint32_t first, uint32_t count, uint64_t *results,
+                          bool wait = false) = 0;
+  /** Get the results of a range of pipeline statistics queries */
+  bool getResults(uint32_t first, uint32_t count, PipelineStatistics *results,
+                  bool wait = false) {
+    return getResults(first, count, (uint64_t *)results, wait);
+  }
+  /** Get the number of values returned per query */
+  uint32_t getNumValues() const {
+    return type == QUERY_TYPE_PIPELINE_STATISTICS
+               ? uint32_t(sizeof(PipelineStatistics) / sizeof(uint64_t))
+               : 1;
+  }
+  QueryType type = QUERY_TYPE_TIMESTAMP;
+  uint32_t count = 0;
+  /** The number of nanoseconds per timestamp tick */
+  double timestampPeriod = 1.0;
+  /** The mask of the valid timestamp bits */
+  uint64_t timestampMask = ~0ull;
+};
+} // namespace ngfx
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/RenderPassUtil.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/FormatUtil.h"
+using namespace ngfx;
+using namespace std;
+
+AttachmentLoadOp RenderPassUtil::getLoadOp(const AttachmentAccess &access) {
+  if (access.clear)
+    return ATTACHMENT_LOAD_OP_CLEAR;
+  if (access.fullyOverwritten)
+    return ATTACHMENT_LOAD_OP_DONT_CARE;
+  return ATTACHMENT_LOAD_OP_LOAD;
+}
+
+AttachmentStoreOp RenderPassUtil::getStoreOp(const AttachmentAccess &access) {
+  return access.readAfterPass ? ATTACHMENT_STORE_OP_STORE
+                              : ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
+void RenderPassUtil::inferLoadStoreOps(
+    GraphicsContext::RenderPassConfig &config,
+    const std::vector<AttachmentAccess> &colorAttachmentAccess,
+    const std::optional<AttachmentAccess> &depthStencilAttachmentAccess) {
+  if (colorAttachmentAccess.size() != config.numColorAttachments())
+    NGFX_ERR("number of color attachment accesses: %d doesn't match number of color attachments: %d",
+             int(colorAttachmentAccess.size()), config.numColorAttachments());
+  for (uint32_t j = 0; j < colorAttachmentAccess.size(); j++) {
+    auto &desc = config.colorAttachmentDescriptions[j];
+    desc.loadOp = getLoadOp(colorAttachmentAccess[j]);
+    desc.storeOp = getStoreOp(colorAttachmentAccess[j]);
+    if (config.numSamples > 1)
+      desc.multisampleStoreOp = colorAttachmentAccess[j].multisampleReadAfterPass
+                                    ? ATTACHMENT_STORE_OP_STORE
+                                    : ATTACHMENT_STORE_OP_DONT_CARE;
+    else
+      desc.multisampleStoreOp = nullopt;
+  }
+  if (config.depthStencilAttachmentDescription && depthStencilAttachmentAccess) {
+    auto &desc = *config.depthStencilAttachmentDescription;
+    desc.loadOp = getLoadOp(*depthStencilAttachmentAccess);
+    desc.storeOp = getStoreOp(*depthStencilAttachmentAccess);
+  }
+}
+
+RenderPassUtil::BandwidthEstimate
+RenderPassUtil::estimateBandwidth(const GraphicsContext::RenderPassConfig &config,
+                                  uint32_t w, uint32_t h, uint32_t layers) {
+  BandwidthEstimate result;
+  uint64_t numPixels = uint64_t(w) * h * layers, numSamples = config.numSamples;
+  for (auto &desc : config.colorAttachmentDescriptions) {
+    uint64_t size = numPixels * FormatUtil::getBytesPerPixel(desc.format);
+    if (desc.loadOp == ATTACHMENT_LOAD_OP_LOAD)
+      result.loadBytes += size * numSamples;
+    if (numSamples == 1) {
+      if (desc.storeOp == ATTACHMENT_STORE_OP_STORE)
+        result.storeBytes += size;
+      continue;
+    }
+    // A multisample color attachment is resolved, and the multisample data is
+    // only stored when requested
+    if (desc.storeOp == ATTACHMENT_STORE_OP_STORE)
+      result.resolveBytes += size;
+    if (desc.multisampleStoreOp.value_or(desc.storeOp) == ATTACHMENT_STORE_OP_STORE)
+      result.storeBytes += size * numSamples;
+  }
+  if (config.depthStencilAttachmentDescription) {
+    auto &desc = *config.depthStencilAttachmentDescription;
+    uint64_t size = numPixels * FormatUtil::getBytesPerPixel(desc.format);
+    if (desc.loadOp == ATTACHMENT_LOAD_OP_LOAD)
+      result.loadBytes += size * numSamples;
+    if (desc.storeOp == ATTACHMENT_STORE_OP_STORE) {
+      if (config.enableDepthStencilResolve)
+        result.resolveBytes += size;
+      else
+        result.storeBytes += size * numSamples;
+    }
+  }
+  return result;
+}
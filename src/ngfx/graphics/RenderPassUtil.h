@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/graphics/GraphicsContext.h"
+#include <optional>
+#include <vector>
+
+namespace ngfx {
+/** \class RenderPassUtil
+ *
+ *  This module provides utility functions for configuring render passes.
+ *  It infers the attachment load / store operations from how the attachments are used,
+ *  so that the GPU doesn't load or store attachment contents unnecessarily,
+ *  and it estimates the attachment memory traffic of a render pass
+ */
+class RenderPassUtil {
+public:
+  /** \struct AttachmentAccess
+   *
+   *  Describes how an attachment is accessed by a render pass */
+  struct AttachmentAccess {
+    /** The attachment is cleared at the beginning of the render pass */
+    bool clear = false;
+    /** Every pixel of the attachment is written by the render pass */
+    bool fullyOverwritten = false;
+    /** The attachment contents are used after the render pass
+     *  (e.g. sampled, downloaded, or presented) */
+    bool readAfterPass = true;
+    /** The multisample contents of a color attachment are used after the render pass
+     *  (e.g. loaded by a later render pass).  Otherwise only the resolved contents are stored */
+    bool multisampleReadAfterPass = false;
+  };
+  /** \struct BandwidthEstimate
+   *
+   *  The estimated number of bytes transferred between the attachments and memory
+   *  for a single execution of a render pass */
+  struct BandwidthEstimate {
+    uint64_t loadBytes = 0, /**< Bytes loaded at the beginning of the render pass */
+             storeBytes = 0, /**< Bytes stored at the end of the render pass */
+             resolveBytes = 0; /**< Bytes written when resolving multisample attachments */
+    /** Get the total number of bytes */
+    uint64_t total() const { return loadBytes + storeBytes + resolveBytes; }
+  };
+  /** Infer the load operation for a given attachment access */
+  static AttachmentLoadOp getLoadOp(const AttachmentAccess &access);
+  /** Infer the store operation for a given attachment access */
+  static AttachmentStoreOp getStoreOp(const AttachmentAccess &access);
+  /** Set the load / store operations of a render pass configuration
+   *  @param config The render pass configuration
+   *  @param colorAttachmentAccess The access for each color attachment
+   *  @param depthStencilAttachmentAccess The access for the depth stencil attachment (optional)
+   */
+  static void inferLoadStoreOps(
+      GraphicsContext::RenderPassConfig &config,
+      const std::vector<AttachmentAccess> &colorAttachmentAccess,
+      const std::optional<AttachmentAccess> &depthStencilAttachmentAccess = std::nullopt);
+  /** Estimate the attachment memory traffic of a render pass
+   *  @param config The render pass configuration
+   *  @param w The framebuffer width
+   *  @param h The framebuffer height
+   *  @param layers The number of framebuffer layers
+   */
+  static BandwidthEstimate estimateBandwidth(const GraphicsContext::RenderPassConfig &config,
+                                             uint32_t w, uint32_t h, uint32_t layers = 1);
+};
+} // namespace ngfx
@@ -23,6 +23,7 @@
 #include "ngfx/core/DebugUtil.h"
 #include "ngfx/core/FileUtil.h"
 #include "ngfx/core/StringUtil.h"
+#include "ngfx/core/Trace.h"
 #include <cctype>
 #include <filesystem>
 #include <fstream>
@@ -115,6 +116,10 @@ int ShaderTools::compileShaderToSPV(
   compileOptions.SetOptimizationLevel(optimizationLevel);
   compileOptions.SetGenerateDebugInfo();
   compileOptions.SetSourceLanguage(sourceLanguage);
+  // Subgroup operations require SPIR-V 1.3
+  if (src.find("GL_KHR_shader_subgroup") != string::npos)
+    compileOptions.SetTargetEnvironment(shaderc_target_env_vulkan,
+                                        shaderc_env_version_vulkan_1_1);
   vector<string> includePaths = { parentPath };
   auto fileIncluder = make_unique<FileIncluder>(includePaths);
   compileOptions.SetIncluder(std::move(fileIncluder));
@@ -200,6 +205,7 @@ int ShaderTools::compileShaderGLSL(string filename,
                                    const MacroDefinitions &defines,
                                    const string &outDir,
                                    vector<string> &outFiles, int flags) {
+  NGFX_TRACE_ZONE("shader", "compileShaderGLSL");
   string parentPath = fs::path(filename).parent_path().string();
   filename = fs::path(filename).filename().string();
   string inFileName =
@@ -236,6 +242,7 @@ int ShaderTools::compileShaderGLSL(string filename,
 int ShaderTools::compileShaderMSL(const string &file,
                                   const MacroDefinitions &defines,
                                   string outDir, vector<string> &outFiles, int flags) {
+  NGFX_TRACE_ZONE("shader", "compileShaderMSL");
   string strippedFilename =
       FileUtil::splitExt(fs::path(file).filename().string())[0];
   string inFileName = fs::path(outDir + "/" + strippedFilename + ".metal")
@@ -266,6 +273,7 @@ int ShaderTools::compileShaderMSL(const string &file,
 int ShaderTools::compileShaderHLSL(const string &file,
                                    const MacroDefinitions &defines,
                                    string outDir, vector<string> &outFiles, int flags) {
+  NGFX_TRACE_ZONE("shader", "compileShaderHLSL");
   string filename = fs::path(file).filename().string();
   string inFileName =fs::path(file).make_preferred().string();
   string outFileName = fs::path(outDir + "/" + filename + ".dxc").make_preferred().string();
@@ -326,6 +334,10 @@ int ShaderTools::convertSPVToMSL(const string &spv,
                                  shaderc_shader_kind shaderKind, string &msl) {
   auto compilerMSL = make_unique<spirv_cross::CompilerMSL>(
       (const uint32_t *)spv.data(), spv.size() / sizeof(uint32_t));
+  // Required for subgroup (SIMD-group) operations
+  auto options = compilerMSL->get_msl_options();
+  options.set_msl_version(2, 1);
+  compilerMSL->set_msl_options(options);
   msl = compilerMSL->compile();
   return 0;
 }
@@ -23,6 +23,7 @@
 #include "ngfx/graphics/CommandBuffer.h"
 #include "ngfx/graphics/GraphicsPipeline.h"
 #include "ngfx/graphics/SamplerDesc.h"
+#include <algorithm>
 
 namespace ngfx {
 class Graphics;
@@ -90,6 +91,48 @@ public:
             IMAGE_USAGE_TRANSFER_DST_BIT),
         TextureType textureType = TEXTURE_TYPE_2D,
         uint32_t numSamples = 1, SamplerDesc* samplerDesc = nullptr);
+
+  /** The data of a single mip level, including all array layers, faces and depth slices */
+  struct MipLevelData {
+    void *data;
+    uint32_t size;
+  };
+  /** Get the number of mip levels of a full mip chain
+   *  @param w The width of the base level
+   *  @param h The height of the base level
+   *  @param d The depth of the base level
+   */
+  static uint32_t getMaxMipLevels(uint32_t w, uint32_t h, uint32_t d = 1) {
+    uint32_t mipLevels = 1;
+    for (uint32_t size = std::max(std::max(w, h), d); size > 1; size >>= 1)
+      mipLevels++;
+    return mipLevels;
+  }
+  /** Create a texture from a prebuilt mip chain.
+   *  Block-compressed formats are uploaded as-is, without decoding.
+   *  @param graphicsContext The graphics context
+   *  @param graphics The graphics object
+   *  @param mipLevelData The data for each mip level, starting from the base level.
+   *  It contains between 1 and getMaxMipLevels(w, h, d) levels
+   *  @param format The pixel format
+   *  @param w      The width of the base level
+   *  @param h      The height of the base level
+   *  @param d      The depth of the base level
+   *  @param arrayLayers The number of array layers
+   *  @param imageUsageFlags A bitmask of flags describing the image usage
+   *  @param textureType The texture type
+   *  @param samplerDesc The sampler description, or nullptr to use the default sampler
+   */
+  static Texture *
+  createFromMipLevels(GraphicsContext *graphicsContext, Graphics *graphics,
+         const std::vector<MipLevelData> &mipLevelData,
+         PixelFormat format, uint32_t w, uint32_t h, uint32_t d,
+         uint32_t arrayLayers,
+         ImageUsageFlags imageUsageFlags = ImageUsageFlags(
+             IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT |
+             IMAGE_USAGE_TRANSFER_DST_BIT),
+         TextureType textureType = TEXTURE_TYPE_2D,
+         SamplerDesc *samplerDesc = nullptr);
   virtual ~Texture() {}
   /** Upload data to texture */
   virtual void upload(void *data, uint32_t size, uint32_t x = 0, uint32_t y = 0,
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/graphics/TextureStreamer.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/graphics/FormatUtil.h"
+#include "ngfx/graphics/ImageUtil.h"
+#include "ngfx/graphics/TextureUtil.h"
+#include <algorithm>
+using namespace ngfx;
+using namespace std;
+
+#define DEFAULT_MEMORY_BUDGET (256 * 1024 * 1024)
+
+static unique_ptr<ImageData> downsample(const ImageData &src) {
+  // 2x2 box filter
+  int w = std::max(src.w / 2, 1), h = std::max(src.h / 2, 1);
+  auto dst = make_unique<ImageData>(w, h, src.numChannels);
+  const uint8_t *srcData = (const uint8_t *)src.data;
+  uint8_t *dstData = (uint8_t *)dst->data;
+  int nc = src.numChannels;
+  for (int y = 0; y < h; y++) {
+    int y0 = std::min(2 * y, src.h - 1), y1 = std::min(2 * y + 1, src.h - 1);
+    for (int x = 0; x < w; x++) {
+      int x0 = std::min(2 * x, src.w - 1), x1 = std::min(2 * x + 1, src.w - 1);
+      for (int c = 0; c < nc; c++) {
+        uint32_t sum = srcData[(y0 * src.w + x0) * nc + c] +
+                       srcData[(y0 * src.w + x1) * nc + c] +
+                       srcData[(y1 * src.w + x0) * nc + c] +
+                       srcData[(y1 * src.w + x1) * nc + c];
+        dstData[(y * w + x) * nc + c] = uint8_t((sum + 2) / 4);
+      }
+    }
+  }
+  return dst;
+}
+
+Texture *StreamedTexture::get() {
+  lastUsedFrame = streamer->frameIndex;
+  if (!texture && !fullResPending && !failed &&
+      streamer->frameIndex >= retryFrame)
+    streamer->request(this, false);
+  if (texture)
+    return texture.get();
+  return lowResTexture.get();
+}
+
+TextureStreamer::TextureStreamer(GraphicsContext *ctx, Graphics *graphics,
+                                 uint64_t memoryBudget, uint32_t lowResolution)
+    : ctx(ctx), graphics(graphics), memoryBudget(memoryBudget),
+      lowResolution(lowResolution) {
+  thread = std::thread([this]() { run(); });
+}
+
+TextureStreamer::~TextureStreamer() {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  cv.notify_all();
+  thread.join();
+}
+
+StreamedTexture *TextureStreamer::load(const std::string &filename,
+                                       SamplerDesc *samplerDesc) {
+  auto streamedTexture = make_unique<StreamedTexture>();
+  streamedTexture->filename = filename;
+  streamedTexture->streamer = this;
+  if (samplerDesc)
+    streamedTexture->samplerDesc = make_unique<SamplerDesc>(*samplerDesc);
+  StreamedTexture *result = streamedTexture.get();
+  streamedTextures.push_back(std::move(streamedTexture));
+  request(result, true);
+  return result;
+}
+
+void TextureStreamer::request(StreamedTexture *streamedTexture, bool lowRes) {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    if (lowRes) {
+      streamedTexture->lowResPending = true;
+      lowResRequests.push_back({streamedTexture, true});
+    } else {
+      streamedTexture->fullResPending = true;
+      fullResRequests.push_back({streamedTexture, false});
+    }
+  }
+  cv.notify_one();
+}
+
+void TextureStreamer::run() {
+  while (true) {
+    LoadRequest request;
+    {
+      unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() {
+        return quit || !lowResRequests.empty() || !fullResRequests.empty();
+      });
+      if (quit)
+        return;
+      // Low resolution requests have priority, so that every texture
+      // has a fallback as soon as possible
+      auto &requests = lowResRequests.empty() ? fullResRequests : lowResRequests;
+      request = requests.front();
+      requests.pop_front();
+    }
+    auto imageData = decode(request);
+    lock_guard<std::mutex> lock(mutex);
+    results.push_back({request.streamedTexture, request.lowRes, std::move(imageData)});
+  }
+}
+
+unique_ptr<ImageData> TextureStreamer::decode(const LoadRequest &request) {
+  auto imageData = make_unique<ImageData>();
+  try {
+    ImageUtil::load(request.streamedTexture->filename, *imageData);
+  } catch (std::exception &e) {
+    NGFX_LOG("%s", e.what());
+    return nullptr;
+  }
+  if (request.lowRes) {
+    while (uint32_t(std::max(imageData->w, imageData->h)) > lowResolution)
+      imageData = downsample(*imageData);
+  }
+  return imageData;
+}
+
+uint64_t TextureStreamer::getTextureMemorySize(Texture *texture) {
+  uint64_t size = 0;
+  for (uint32_t j = 0; j < texture->mipLevels; j++) {
+    size += FormatUtil::getImageSize(texture->format, std::max(texture->w >> j, 1u),
+                                     std::max(texture->h >> j, 1u),
+                                     std::max(texture->d >> j, 1u)) *
+            texture->arrayLayers;
+  }
+  return size;
+}
+
+uint64_t TextureStreamer::getMemoryBudget() {
+  if (memoryBudget)
+    return memoryBudget;
+  uint64_t deviceBudget = ctx->device->getMemoryBudget();
+  if (!deviceBudget)
+    return DEFAULT_MEMORY_BUDGET;
+  // Leave room for the memory allocated outside of the texture streamer
+  uint64_t deviceUsage = ctx->device->getMemoryUsage();
+  uint64_t otherUsage = deviceUsage > memoryUsage ? deviceUsage - memoryUsage : 0;
+  return deviceBudget > otherUsage ? deviceBudget - otherUsage : 0;
+}
+
+void TextureStreamer::release(std::unique_ptr<Texture> texture) {
+  memoryUsage -= getTextureMemorySize(texture.get());
+  // The texture may still be used by command buffers in flight
+  pendingDeletes.push_back({std::move(texture), frameIndex});
+}
+
+bool TextureStreamer::evict(uint64_t size) {
+  uint64_t budget = getMemoryBudget();
+  if (memoryUsage + size <= budget)
+    return true;
+  // The textures used in the current or previous frame can't be evicted
+  auto isEvictable = [&](const StreamedTexture *streamedTexture) {
+    return streamedTexture->texture &&
+           streamedTexture->lastUsedFrame + 1 < frameIndex;
+  };
+  // Don't evict anything unless it frees enough memory
+  uint64_t evictableSize = 0;
+  for (auto &streamedTexture : streamedTextures) {
+    if (isEvictable(streamedTexture.get()))
+      evictableSize += getTextureMemorySize(streamedTexture->texture.get());
+  }
+  if (memoryUsage - evictableSize + size > budget)
+    return false;
+  while (memoryUsage + size > budget) {
+    // Evict the least recently used texture
+    StreamedTexture *lruTexture = nullptr;
+    for (auto &streamedTexture : streamedTextures) {
+      if (!isEvictable(streamedTexture.get()))
+        continue;
+      if (!lruTexture || streamedTexture->lastUsedFrame < lruTexture->lastUsedFrame)
+        lruTexture = streamedTexture.get();
+    }
+    release(std::move(lruTexture->texture));
+    stats.numEvicted++;
+  }
+  return true;
+}
+
+void TextureStreamer::upload(LoadResult &result) {
+  auto streamedTexture = result.streamedTexture;
+  if (result.lowRes)
+    streamedTexture->lowResPending = false;
+  else
+    streamedTexture->fullResPending = false;
+  if (!result.imageData) {
+    streamedTexture->failed = true;
+    return;
+  }
+  auto &imageData = *result.imageData;
+  if (!result.lowRes) {
+    // Skip the texture if it's no longer used, it will be requested again on the next use
+    if (streamedTexture->lastUsedFrame + numFramesInFlight < frameIndex)
+      return;
+    uint64_t size = FormatUtil::getImageSize(PIXELFORMAT_RGBA8_UNORM, imageData.w, imageData.h);
+    // Account for the mip chain.  If the texture doesn't fit, wait before
+    // requesting it again, instead of decoding it again on every use
+    if (!evict(size + size / 3)) {
+      streamedTexture->retryFrame = frameIndex + budgetRetryFrames;
+      stats.numOverBudget++;
+      return;
+    }
+  }
+  Texture *texture = TextureUtil::load(ctx, graphics, imageData, ImageUsageFlags(
+      IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT |
+      IMAGE_USAGE_TRANSFER_DST_BIT), TEXTURE_TYPE_2D, true, 1,
+      streamedTexture->samplerDesc.get());
+  memoryUsage += getTextureMemorySize(texture);
+  auto &dst = result.lowRes ? streamedTexture->lowResTexture : streamedTexture->texture;
+  if (dst)
+    release(std::move(dst));
+  dst.reset(texture);
+}
+
+void TextureStreamer::update() {
+  while (!pendingDeletes.empty() &&
+         pendingDeletes.front().frame + numFramesInFlight <= frameIndex)
+    pendingDeletes.pop_front();
+  uint64_t uploadSize = 0;
+  while (uploadSize < uploadBudget) {
+    LoadResult result;
+    {
+      lock_guard<std::mutex> lock(mutex);
+      if (results.empty())
+        break;
+      result = std::move(results.front());
+      results.pop_front();
+    }
+    if (result.imageData) {
+      uploadSize += result.imageData->size;
+      stats.numDecoded++;
+    }
+    upload(result);
+  }
+  frameIndex++;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+#include "ngfx/graphics/GraphicsContext.h"
+#include "ngfx/graphics/ImageData.h"
+#include "ngfx/graphics/Texture.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ngfx {
+class TextureStreamer;
+
+/** \class StreamedTexture
+ *
+ *  This class provides a handle to a texture managed by the TextureStreamer.
+ *  A low resolution copy of the texture stays resident once it's loaded,
+ *  while the full resolution texture (with mipmaps) is loaded on demand
+ *  and can be evicted when it's not used.
+ */
+
+class StreamedTexture {
+public:
+  /** Get the best resident version of the texture, and mark it as used in the current frame.
+   *  Requests the full resolution texture if it isn't resident.
+   *  Returns nullptr until the low resolution texture is loaded
+   */
+  Texture *get();
+  /** Check if the full resolution texture is resident */
+  bool isFullResolution() const { return texture != nullptr; }
+  /** The image filename */
+  std::string filename;
+
+private:
+  friend class TextureStreamer;
+  TextureStreamer *streamer = nullptr;
+  std::unique_ptr<SamplerDesc> samplerDesc;
+  std::unique_ptr<Texture> lowResTexture, texture;
+  uint64_t memorySize = 0, lastUsedFrame = 0;
+  /** The frame before which the full resolution texture isn't requested again,
+   *  after it didn't fit in the memory budget */
+  uint64_t retryFrame = 0;
+  bool lowResPending = false, fullResPending = false, failed = false;
+};
+
+/** \class TextureStreamer
+ *
+ *  This class provides support for streaming textures within a GPU memory budget.
+ *  Images are decoded on a background thread: low resolution versions are loaded first,
+ *  and full resolution versions are loaded when the texture is used.
+ *  When the memory used by full resolution textures exceeds the budget, the least
+ *  recently used textures are evicted and fall back to their low resolution version.
+ *  When the graphics backend supports it (e.g. VK_EXT_memory_budget), the budget
+ *  is derived from the memory budget reported by the device.
+ */
+
+class TextureStreamer {
+public:
+  /** Create the texture streamer
+   *  @param ctx The graphics context
+   *  @param graphics The graphics interface
+   *  @param memoryBudget The memory budget for the streamed textures (in bytes),
+   *         or 0 to use the memory budget reported by the device
+   *  @param lowResolution The maximum dimension of the low resolution textures
+   */
+  TextureStreamer(GraphicsContext *ctx, Graphics *graphics,
+                  uint64_t memoryBudget = 0, uint32_t lowResolution = 64);
+  /** Destroy the texture streamer and all the streamed textures.
+   *  The user must make sure the GPU is no longer using the textures */
+  virtual ~TextureStreamer();
+  /** Load a texture from an image file (e.g. PNG or JPEG).
+   *  The texture is loaded asynchronously */
+  StreamedTexture *load(const std::string &filename,
+                        SamplerDesc *samplerDesc = nullptr);
+  /** Upload the decoded images, evict unused textures and advance to the next frame.
+   *  This function should be called once per frame from the rendering thread */
+  void update();
+  /** Get the memory budget for the streamed textures (in bytes) */
+  uint64_t getMemoryBudget();
+  /** Get the memory used by the streamed textures (in bytes) */
+  uint64_t getMemoryUsage() const { return memoryUsage; }
+  /** The maximum number of bytes uploaded per update */
+  uint64_t uploadBudget = 32 * 1024 * 1024;
+  /** The number of frames before a replaced or evicted texture is destroyed */
+  uint32_t numFramesInFlight = 3;
+  /** The number of frames before a full resolution texture that didn't fit
+   *  in the memory budget is requested again */
+  uint32_t budgetRetryFrames = 60;
+  struct Stats {
+    /** The number of decoded images, at low and full resolution */
+    uint64_t numDecoded = 0;
+    /** The number of evicted full resolution textures */
+    uint64_t numEvicted = 0;
+    /** The number of full resolution textures dropped because they didn't fit in the budget */
+    uint64_t numOverBudget = 0;
+  };
+  const Stats &getStats() const { return stats; }
+
+private:
+  friend class StreamedTexture;
+  struct LoadRequest {
+    StreamedTexture *streamedTexture;
+    bool lowRes;
+  };
+  struct LoadResult {
+    StreamedTexture *streamedTexture;
+    bool lowRes;
+    std::unique_ptr<ImageData> imageData;
+  };
+  struct PendingDelete {
+    std::unique_ptr<Texture> texture;
+    uint64_t frame;
+  };
+  void request(StreamedTexture *streamedTexture, bool lowRes);
+  void run();
+  std::unique_ptr<ImageData> decode(const LoadRequest &request);
+  void upload(LoadResult &result);
+  bool evict(uint64_t size);
+  void release(std::unique_ptr<Texture> texture);
+  static uint64_t getTextureMemorySize(Texture *texture);
+  GraphicsContext *ctx;
+  Graphics *graphics;
+  uint64_t memoryBudget, memoryUsage = 0, frameIndex = 0;
+  uint32_t lowResolution;
+  Stats stats;
+  std::vector<std::unique_ptr<StreamedTexture>> streamedTextures;
+  std::deque<PendingDelete> pendingDeletes;
+  std::deque<LoadRequest> lowResRequests, fullResRequests;
+  std::deque<LoadResult> results;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool quit = false;
+  std::thread thread;
+};
+} // namespace ngfx
@@ -20,9 +20,57 @@
  */
 
 #include "TextureUtil.h"
+#include "ngfx/core/DebugUtil.h"
+#include "ngfx/core/File.h"
+#include "ngfx/graphics/FormatUtil.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
 using namespace ngfx;
 using namespace std;
 
+namespace {
+struct KTX2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth,
+        layerCount, faceCount, levelCount, supercompressionScheme;
+    uint32_t dfdByteOffset, dfdByteLength, kvdByteOffset, kvdByteLength;
+    uint64_t sgdByteOffset, sgdByteLength;
+};
+struct KTX2LevelIndex {
+    uint64_t byteOffset, byteLength, uncompressedByteLength;
+};
+const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+PixelFormat getKTX2PixelFormat(uint32_t vkFormat) {
+    // KTX2 files store the format as a VkFormat value
+    static const std::map<uint32_t, PixelFormat> formatMap = {
+        { 9, PIXELFORMAT_R8_UNORM }, { 16, PIXELFORMAT_RG8_UNORM },
+        { 37, PIXELFORMAT_RGBA8_UNORM }, { 44, PIXELFORMAT_BGRA8_UNORM },
+        { 74, PIXELFORMAT_R16_UINT }, { 81, PIXELFORMAT_RG16_UINT },
+        { 95, PIXELFORMAT_RGBA16_UINT }, { 76, PIXELFORMAT_R16_SFLOAT },
+        { 83, PIXELFORMAT_RG16_SFLOAT }, { 97, PIXELFORMAT_RGBA16_SFLOAT },
+        { 98, PIXELFORMAT_R32_UINT }, { 101, PIXELFORMAT_RG32_UINT },
+        { 107, PIXELFORMAT_RGBA32_UINT }, { 100, PIXELFORMAT_R32_SFLOAT },
+        { 103, PIXELFORMAT_RG32_SFLOAT }, { 109, PIXELFORMAT_RGBA32_SFLOAT },
+        { 133, PIXELFORMAT_BC1_RGBA_UNORM }, { 135, PIXELFORMAT_BC2_UNORM },
+        { 137, PIXELFORMAT_BC3_UNORM }, { 139, PIXELFORMAT_BC4_UNORM },
+        { 141, PIXELFORMAT_BC5_UNORM }, { 143, PIXELFORMAT_BC6H_UFLOAT },
+        { 144, PIXELFORMAT_BC6H_SFLOAT }, { 145, PIXELFORMAT_BC7_UNORM },
+#ifndef NGFX_GRAPHICS_BACKEND_DIRECT3D12
+        { 147, PIXELFORMAT_ETC2_RGB8_UNORM }, { 149, PIXELFORMAT_ETC2_RGB8A1_UNORM },
+        { 151, PIXELFORMAT_ETC2_RGBA8_UNORM }, { 157, PIXELFORMAT_ASTC_4x4_UNORM },
+        { 161, PIXELFORMAT_ASTC_5x5_UNORM }, { 165, PIXELFORMAT_ASTC_6x6_UNORM },
+        { 171, PIXELFORMAT_ASTC_8x8_UNORM },
+#endif
+    };
+    auto it = formatMap.find(vkFormat);
+    if (it == formatMap.end())
+        NGFX_ERR("unsupported KTX2 format: %d", vkFormat);
+    return it->second;
+}
+} // namespace
+
 Texture* TextureUtil::load(GraphicsContext* ctx, Graphics* graphics,
     const ImageData &imageData, ImageUsageFlags imageUsageFlags, TextureType textureType,
     bool genMipmaps, uint32_t numSamples, SamplerDesc* samplerDesc) {
@@ -38,6 +86,67 @@ Texture* TextureUtil::load(GraphicsContext* ctx, Graphics* graphics,
     return TextureUtil::load(ctx, graphics, v, imageUsageFlags, textureType, genMipmaps, numSamples, samplerDesc);
 }
 
+Texture* TextureUtil::loadKTX2(GraphicsContext* ctx, Graphics* graphics,
+    const char* filename, ImageUsageFlags imageUsageFlags, SamplerDesc* samplerDesc) {
+    File file;
+    if (!file.read(filename))
+        NGFX_ERR("cannot open file: %s", filename);
+    const uint8_t* data = (const uint8_t*)file.data.get();
+    uint64_t fileSize = uint64_t(file.size);
+    KTX2Header header;
+    if (fileSize < sizeof(header))
+        NGFX_ERR("invalid KTX2 file: %s", filename);
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        NGFX_ERR("invalid KTX2 identifier: %s", filename);
+    if (header.supercompressionScheme != 0)
+        NGFX_ERR("KTX2 supercompression scheme: %d is not supported: %s",
+            header.supercompressionScheme, filename);
+    if (header.faceCount != 1 && header.faceCount != 6)
+        NGFX_ERR("invalid KTX2 face count: %d: %s", header.faceCount, filename);
+    if (header.faceCount == 6 && header.layerCount > 1)
+        NGFX_ERR("KTX2 cube map arrays are not supported: %s", filename);
+    if (header.pixelWidth == 0)
+        NGFX_ERR("invalid KTX2 width: %s", filename);
+    if (header.pixelDepth > 0 && header.layerCount > 0)
+        NGFX_ERR("KTX2 3D texture arrays are not supported: %s", filename);
+    PixelFormat format = getKTX2PixelFormat(header.vkFormat);
+    uint32_t w = header.pixelWidth, h = std::max(header.pixelHeight, 1u),
+        d = std::max(header.pixelDepth, 1u);
+    uint32_t arrayLayers = std::max(header.layerCount, 1u) * header.faceCount;
+    TextureType textureType;
+    if (header.faceCount == 6) textureType = TEXTURE_TYPE_CUBE;
+    else if (header.pixelDepth > 0) textureType = TEXTURE_TYPE_3D;
+    else if (header.layerCount > 0) textureType = TEXTURE_TYPE_2D_ARRAY;
+    else textureType = TEXTURE_TYPE_2D;
+
+    uint32_t numLevels = std::max(header.levelCount, 1u);
+    if (numLevels > Texture::getMaxMipLevels(w, h, d))
+        NGFX_ERR("invalid KTX2 level count: %d: %s", header.levelCount, filename);
+    if (fileSize < sizeof(header) + numLevels * sizeof(KTX2LevelIndex))
+        NGFX_ERR("invalid KTX2 level index: %s", filename);
+    std::vector<Texture::MipLevelData> mipLevelData(numLevels);
+    for (uint32_t j = 0; j < numLevels; j++) {
+        KTX2LevelIndex levelIndex;
+        memcpy(&levelIndex, data + sizeof(header) + j * sizeof(levelIndex), sizeof(levelIndex));
+        if (levelIndex.byteOffset > fileSize || levelIndex.byteLength > fileSize - levelIndex.byteOffset)
+            NGFX_ERR("invalid KTX2 level: %d: %s", j, filename);
+        uint32_t expectedSize = FormatUtil::getImageSize(format, std::max(w >> j, 1u),
+            std::max(h >> j, 1u), std::max(d >> j, 1u)) * arrayLayers;
+        if (levelIndex.byteLength < expectedSize)
+            NGFX_ERR("invalid KTX2 level size: %d: %s", j, filename);
+        mipLevelData[j] = { (void*)(data + levelIndex.byteOffset), expectedSize };
+    }
+    if (header.levelCount == 0) {
+        // The file requests the mip chain to be generated at load time
+        return Texture::create(ctx, graphics, mipLevelData[0].data, format,
+            mipLevelData[0].size, w, h, d, arrayLayers, imageUsageFlags,
+            textureType, true, 1, samplerDesc);
+    }
+    return Texture::createFromMipLevels(ctx, graphics, mipLevelData, format,
+        w, h, d, arrayLayers, imageUsageFlags, textureType, samplerDesc);
+}
+
 void TextureUtil::download(Texture* texture, ImageData &v) {
     v.data = malloc(texture->size);
     v.size = texture->size;
@@ -44,6 +44,15 @@ public:
           IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT | 
           IMAGE_USAGE_TRANSFER_DST_BIT), TextureType textureType = TEXTURE_TYPE_2D,
       bool genMipmaps = false, uint32_t numSamples = 1, SamplerDesc *samplerDesc = nullptr);
+  /** Load texture from a KTX2 file.
+   *  The prebuilt mip chain is uploaded directly, without decoding block-compressed data.
+   *  Supercompressed files, cube map arrays and 3D texture arrays are not supported.
+   *  If the file doesn't contain any mip levels, the mip chain is generated at load time
+   */
+  static Texture* loadKTX2(GraphicsContext *ctx, Graphics *graphics,
+      const char *filename, ImageUsageFlags imageUsageFlags = ImageUsageFlags(
+          IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT |
+          IMAGE_USAGE_TRANSFER_DST_BIT), SamplerDesc *samplerDesc = nullptr);
   /** Download texture contents into image data object */
   static void download(Texture* texture, ImageData& v);
   /** Store the GPU texture as a JPEG image */
@@ -34,6 +34,7 @@ void D3DCommandList::create(ID3D12Device *device,
 
 void D3DCommandList::begin() {
   HRESULT hResult;
+  stats = {};
   V(cmdAllocator->Reset());
   V(v->Reset(cmdAllocator.Get(), nullptr));
 }
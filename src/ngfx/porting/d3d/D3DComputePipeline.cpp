@@ -41,7 +41,10 @@ void D3DComputePipeline::create(
 }
 
 ComputePipeline *ComputePipeline::create(GraphicsContext *graphicsContext,
-                                         ComputeShaderModule *cs) {
+                                         ComputeShaderModule *cs,
+                                         const std::vector<uint32_t> &specializationConstants) {
+  if (!specializationConstants.empty())
+    NGFX_TODO("support specialization constants, using the shader defaults");
   D3DComputePipeline *d3dComputePipeline = new D3DComputePipeline();
 
   std::vector<CD3DX12_ROOT_PARAMETER1> d3dRootParams;
@@ -23,23 +23,29 @@
 #include <d3d12.h>
 #include <system_error>
 
-/** Trace all Direct3D calls to log output */
-const bool D3D_ENABLE_TRACE = false;
+/** Trace all Direct3D calls to log output, at the verbose level */
+#ifndef D3D_ENABLE_TRACE
+#define D3D_ENABLE_TRACE 0
+#endif
 const bool DEBUG_SHADERS = true;
 // Enabling GPU validation slows down performance but it's useful for debugging
 const bool ENABLE_GPU_VALIDATION = false;
 
+#if D3D_ENABLE_TRACE
+#define D3D_TRACE_CALL(func) NGFX_LOG_VERBOSE("%s", #func)
+#else
+#define D3D_TRACE_CALL(func)
+#endif
+
 #define D3D_TRACE(func)                                                        \
   {                                                                            \
-    if (D3D_ENABLE_TRACE)                                                      \
-      NGFX_LOG("%s", #func);                                                   \
+    D3D_TRACE_CALL(func);                                                      \
     func;                                                                      \
   }
 
 #define V0(func, fmt, ...)                                                     \
   {                                                                            \
-    if (D3D_ENABLE_TRACE)                                                      \
-      NGFX_LOG("%s", #func);                                                   \
+    D3D_TRACE_CALL(func);                                                      \
     hResult = func;                                                            \
     if (FAILED(hResult)) {                                                     \
       NGFX_ERR("%s failed: 0x%08X %s " fmt, #func, hResult,                    \
@@ -385,6 +385,12 @@ void D3DGraphics::dispatch(CommandBuffer *commandBuffer, uint32_t groupCountX,
       d3d(commandBuffer)->v->Dispatch(groupCountX, groupCountY, groupCountZ));
 }
 
+void D3DGraphics::computeBarrier(CommandBuffer *cmdBuffer) {
+  // Wait for all the pending unordered access writes
+  CD3DX12_RESOURCE_BARRIER resourceBarrier = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+  D3D_TRACE(d3d(cmdBuffer)->v->ResourceBarrier(1, &resourceBarrier));
+}
+
 void D3DGraphics::draw(CommandBuffer *cmdBuffer, uint32_t vertexCount,
                        uint32_t instanceCount, uint32_t firstVertex,
                        uint32_t firstInstance) {
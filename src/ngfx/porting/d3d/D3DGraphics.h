@@ -72,11 +72,34 @@ public:
                    uint32_t instanceCount = 1, uint32_t firstIndex = 0,
                    int32_t vertexOffset = 0,
                    uint32_t firstInstance = 0) override;
+  void drawIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                    uint32_t offset = 0, uint32_t drawCount = 1,
+                    uint32_t stride = sizeof(DrawIndirectCommand)) override {
+    NGFX_TODO();
+  }
+  void drawIndexedIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                           uint32_t offset = 0, uint32_t drawCount = 1,
+                           uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override {
+    NGFX_TODO();
+  }
+  void drawIndexedIndirectCount(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                uint32_t offset, Buffer *countBuffer,
+                                uint32_t countBufferOffset, uint32_t maxDrawCount,
+                                uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override {
+    NGFX_TODO();
+  }
 
   void dispatch(CommandBuffer *cmdBuffer, uint32_t groupCountX,
                 uint32_t groupCountY, uint32_t groupCountZ,
                 int32_t threadsPerGroupX = -1, int32_t threadsPerGroupY = -1,
                 int32_t threadsPerGroupZ = -1) override;
+  void dispatchIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                        uint32_t offset = 0, int32_t threadsPerGroupX = -1,
+                        int32_t threadsPerGroupY = -1,
+                        int32_t threadsPerGroupZ = -1) override {
+    NGFX_TODO();
+  }
+  void computeBarrier(CommandBuffer *cmdBuffer) override;
 
   void setViewport(CommandBuffer *cmdBuffer, Rect2D rect) override;
   void setScissor(CommandBuffer *cmdBuffer, Rect2D rect) override;
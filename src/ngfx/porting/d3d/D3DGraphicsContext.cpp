@@ -20,6 +20,7 @@
  */
 #include "ngfx/porting/d3d/D3DGraphicsContext.h"
 #include "ngfx/porting/d3d/D3DDebugUtil.h"
+#include "ngfx/graphics/QueryPool.h"
 #include <dxgi1_4.h>
 #include <wrl.h>
 using namespace ngfx;
@@ -277,3 +278,9 @@ GraphicsContext *GraphicsContext::create(const char *appName,
   d3dGraphicsContext->create(appName, enableDepthStencil, debug);
   return d3dGraphicsContext;
 }
+
+QueryPool *QueryPool::create(GraphicsContext *ctx, QueryType type,
+                             uint32_t count) {
+  NGFX_TODO("implement QueryPool using a query heap");
+  return nullptr;
+}
@@ -57,7 +57,8 @@ enum BufferUsageFlagBits {
   BUFFER_USAGE_UNIFORM_BUFFER_BIT = 4,
   BUFFER_USAGE_STORAGE_BUFFER_BIT = 8,
   BUFFER_USAGE_VERTEX_BUFFER_BIT = 16,
-  BUFFER_USAGE_INDEX_BUFFER_BIT = 32
+  BUFFER_USAGE_INDEX_BUFFER_BIT = 32,
+  BUFFER_USAGE_INDIRECT_BUFFER_BIT = 64
 };
 enum BlendOp {
   BLEND_OP_ADD = D3D12_BLEND_OP_ADD,
@@ -147,7 +148,16 @@ enum PixelFormat {
   PIXELFORMAT_D24_UNORM_S8_UINT = DXGI_FORMAT_D24_UNORM_S8_UINT,
   PIXELFORMAT_D32_SFLOAT = DXGI_FORMAT_D32_FLOAT,
   PIXELFORMAT_D32_SFLOAT_S8_UINT = DXGI_FORMAT_D32_FLOAT_S8X24_UINT,
-  PIXELFORMAT_NV12 = DXGI_FORMAT_NV12
+  PIXELFORMAT_NV12 = DXGI_FORMAT_NV12,
+  // ETC2 and ASTC formats are not supported by DXGI
+  PIXELFORMAT_BC1_RGBA_UNORM = DXGI_FORMAT_BC1_UNORM,
+  PIXELFORMAT_BC2_UNORM = DXGI_FORMAT_BC2_UNORM,
+  PIXELFORMAT_BC3_UNORM = DXGI_FORMAT_BC3_UNORM,
+  PIXELFORMAT_BC4_UNORM = DXGI_FORMAT_BC4_UNORM,
+  PIXELFORMAT_BC5_UNORM = DXGI_FORMAT_BC5_UNORM,
+  PIXELFORMAT_BC6H_UFLOAT = DXGI_FORMAT_BC6H_UF16,
+  PIXELFORMAT_BC6H_SFLOAT = DXGI_FORMAT_BC6H_SF16,
+  PIXELFORMAT_BC7_UNORM = DXGI_FORMAT_BC7_UNORM
 };
 
 enum IndexFormat {
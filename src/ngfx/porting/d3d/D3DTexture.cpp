@@ -9,7 +9,10 @@
 using namespace ngfx;
 using namespace std;
 
-D3DTexture::~D3DTexture() {}
+D3DTexture::~D3DTexture() {
+    if (ctx)
+        ctx->onTextureDestroyed(this);
+}
 
 DXGI_FORMAT D3DTexture::getViewFormat(DXGI_FORMAT resourceFormat, uint32_t planeIndex) {
     DXGI_FORMAT format;
@@ -693,3 +696,12 @@ Texture* Texture::createFromHandle(GraphicsContext* ctx, Graphics* graphics, voi
         textureType, numSamples, d3dSamplerDesc.get());
     return d3dTexture;
 }
+
+Texture* Texture::createFromMipLevels(GraphicsContext* ctx, Graphics* graphics,
+    const std::vector<MipLevelData>& mipLevelData,
+    PixelFormat format, uint32_t w, uint32_t h, uint32_t d,
+    uint32_t arrayLayers, ImageUsageFlags imageUsageFlags,
+    TextureType textureType, SamplerDesc* samplerDesc) {
+    NGFX_TODO("");
+    return nullptr;
+}
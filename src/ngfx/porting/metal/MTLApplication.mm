@@ -60,6 +60,10 @@ void MTLApplication::init() {
 }
 
 void MTLApplication::run() {
+    if (benchmarkOptions.enable) {
+        BaseApplication::run();
+        return;
+    }
     init();
     const char* argv[] = {""};
     NSApplicationMain(1, argv);
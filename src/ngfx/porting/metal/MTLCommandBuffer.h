@@ -28,7 +28,7 @@ namespace ngfx {
 class MTLCommandBuffer : public CommandBuffer {
 public:
   virtual ~MTLCommandBuffer() {}
-  void begin() override {}
+  void begin() override { stats = {}; }
   void end() override {}
   void commit();
   void waitUntilCompleted();
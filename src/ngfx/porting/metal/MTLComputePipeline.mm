@@ -20,6 +20,7 @@
 */
 
 #include "ngfx/porting/metal/MTLComputePipeline.h"
+#include "ngfx/core/DebugUtil.h"
 #include "ngfx/porting/metal/MTLComputeCommandEncoder.h"
 #include "ngfx/porting/metal/MTLCommandBuffer.h"
 #include "ngfx/porting/metal/MTLPipelineUtil.h"
@@ -35,7 +36,9 @@ void MTLComputePipeline::create(ngfx::MTLGraphicsContext *ctx, id<MTLFunction> c
 }
 
 ComputePipeline* ComputePipeline::create(GraphicsContext* graphicsContext,
-         ComputeShaderModule* cs) {
+         ComputeShaderModule* cs, const std::vector<uint32_t>& specializationConstants) {
+    if (!specializationConstants.empty())
+        NGFX_TODO("support specialization constants, using the shader defaults");
     MTLComputePipeline* mtlComputePipeline = new MTLComputePipeline();
 
     auto& descriptorBindings = mtlComputePipeline->descriptorBindings;
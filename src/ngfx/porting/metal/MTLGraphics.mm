@@ -164,6 +164,11 @@ void MTLGraphics::dispatch(CommandBuffer* cmdBuffer, uint32_t groupCountX, uint3
                       threadsPerThreadgroup:MTLSizeMake(threadsPerGroupX, threadsPerGroupY, threadsPerGroupZ)];
 }
 
+void MTLGraphics::computeBarrier(CommandBuffer* cmdBuffer) {
+    auto computeEncoder = (MTLComputeCommandEncoder*)currentCommandEncoder;
+    [computeEncoder->v memoryBarrierWithScope: MTLBarrierScopeBuffers | MTLBarrierScopeTextures];
+}
+
 void MTLGraphics::draw(CommandBuffer* cmdBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
     auto renderEncoder = (MTLRenderCommandEncoder*)currentCommandEncoder;
     [renderEncoder->v drawPrimitives: currentPrimitiveType vertexStart:firstVertex vertexCount:vertexCount
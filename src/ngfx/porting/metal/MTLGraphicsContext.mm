@@ -21,6 +21,7 @@
 
 #include "ngfx/porting/metal/MTLGraphicsContext.h"
 #include "ngfx/porting/metal/MTLSurface.h"
+#include "ngfx/graphics/QueryPool.h"
 #include "ngfx/core/DebugUtil.h"
 #include <Foundation/Foundation.h>
 using namespace ngfx;
@@ -162,3 +163,8 @@ GraphicsContext* GraphicsContext::create(const char* appName, bool enableDepthSt
     mtlGraphicsContext->create(appName, enableDepthStencil, debug);
     return mtlGraphicsContext;
 }
+
+QueryPool* QueryPool::create(GraphicsContext* ctx, QueryType type, uint32_t count) {
+    NGFX_TODO("implement QueryPool using counter sample buffers and visibility result buffers");
+    return nullptr;
+}
@@ -67,7 +67,8 @@ enum BufferUsageFlagBits {
   BUFFER_USAGE_UNIFORM_BUFFER_BIT,
   BUFFER_USAGE_STORAGE_BUFFER_BIT,
   BUFFER_USAGE_VERTEX_BUFFER_BIT,
-  BUFFER_USAGE_INDEX_BUFFER_BIT
+  BUFFER_USAGE_INDEX_BUFFER_BIT,
+  BUFFER_USAGE_INDIRECT_BUFFER_BIT
 };
 enum ColorComponentFlagBits {
   COLOR_COMPONENT_R_BIT = MTLColorWriteMaskRed,
@@ -156,7 +157,22 @@ enum PixelFormat {
   PIXELFORMAT_D24_UNORM = MTLPixelFormatDepth24Unorm_Stencil8,
   PIXELFORMAT_D24_UNORM_S8_UINT = MTLPixelFormatDepth24Unorm_Stencil8,
   PIXELFORMAT_D32_SFLOAT = MTLPixelFormatDepth32Float,
-  PIXELFORMAT_D32_SFLOAT_S8_UINT = MTLPixelFormatDepth32Float_Stencil8
+  PIXELFORMAT_D32_SFLOAT_S8_UINT = MTLPixelFormatDepth32Float_Stencil8,
+  PIXELFORMAT_BC1_RGBA_UNORM = MTLPixelFormatBC1_RGBA,
+  PIXELFORMAT_BC2_UNORM = MTLPixelFormatBC2_RGBA,
+  PIXELFORMAT_BC3_UNORM = MTLPixelFormatBC3_RGBA,
+  PIXELFORMAT_BC4_UNORM = MTLPixelFormatBC4_RUnorm,
+  PIXELFORMAT_BC5_UNORM = MTLPixelFormatBC5_RGUnorm,
+  PIXELFORMAT_BC6H_UFLOAT = MTLPixelFormatBC6H_RGBUfloat,
+  PIXELFORMAT_BC6H_SFLOAT = MTLPixelFormatBC6H_RGBFloat,
+  PIXELFORMAT_BC7_UNORM = MTLPixelFormatBC7_RGBAUnorm,
+  PIXELFORMAT_ETC2_RGB8_UNORM = MTLPixelFormatETC2_RGB8,
+  PIXELFORMAT_ETC2_RGB8A1_UNORM = MTLPixelFormatETC2_RGB8A1,
+  PIXELFORMAT_ETC2_RGBA8_UNORM = MTLPixelFormatEAC_RGBA8,
+  PIXELFORMAT_ASTC_4x4_UNORM = MTLPixelFormatASTC_4x4_LDR,
+  PIXELFORMAT_ASTC_5x5_UNORM = MTLPixelFormatASTC_5x5_LDR,
+  PIXELFORMAT_ASTC_6x6_UNORM = MTLPixelFormatASTC_6x6_LDR,
+  PIXELFORMAT_ASTC_8x8_UNORM = MTLPixelFormatASTC_8x8_LDR
 };
 
 enum IndexFormat {
@@ -87,6 +87,8 @@ void MTLTexture::create(MTLGraphicsContext *ctx, void* data, ::MTLPixelFormat fo
 }
 
 MTLTexture::~MTLTexture() {
+    if (ctx)
+        ctx->onTextureDestroyed(this);
     [v release];
 }
 
@@ -186,3 +188,12 @@ Texture* Texture::create(GraphicsContext* graphicsContext, Graphics* graphics, v
     [mtlSamplerDescriptor release];
     return mtlTexture;
 }
+
+Texture* Texture::createFromMipLevels(GraphicsContext* graphicsContext, Graphics* graphics,
+                         const std::vector<MipLevelData>& mipLevelData,
+                         PixelFormat format, uint32_t w, uint32_t h, uint32_t d,
+                         uint32_t arrayLayers, ImageUsageFlags imageUsageFlags,
+                         TextureType textureType, SamplerDesc* samplerDesc) {
+    NGFX_TODO("");
+    return nullptr;
+}
@@ -22,7 +22,7 @@
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
 using namespace ngfx;
 
-void VKBlit::blitImage(VkCommandBuffer cmdBuffer, VkImage srcImage,
+void VKBlit::blitImage(VKCommandBuffer *cmdBuffer, VkImage srcImage,
                        uint32_t srcLevel, VkImage dstImage, uint32_t dstLevel,
                        Region srcRegion, Region dstRegion,
                        uint32_t srcBaseLayer, uint32_t srcLayerCount,
@@ -34,6 +34,7 @@ void VKBlit::blitImage(VkCommandBuffer cmdBuffer, VkImage srcImage,
       {srcRegion.p0, srcRegion.p1},
       {VK_IMAGE_ASPECT_COLOR_BIT, dstLevel, dstBaseLayer, dstLayerCount},
       {dstRegion.p0, dstRegion.p1}};
-  VK_TRACE(vkCmdBlitImage(cmdBuffer, srcImage, srcImageLayout, dstImage,
+  VK_TRACE(vkCmdBlitImage(cmdBuffer->v, srcImage, srcImageLayout, dstImage,
                           dstImageLayout, 1, &b0, filter));
+  cmdBuffer->stats.numCopies++;
 }
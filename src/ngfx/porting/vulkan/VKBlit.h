@@ -19,6 +19,7 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/porting/vulkan/VKCommandBuffer.h"
 #include <vulkan/vulkan.h>
 
 namespace ngfx {
@@ -27,7 +28,7 @@ struct VKBlit {
     VkOffset3D p0, p1;
   };
   static void
-  blitImage(VkCommandBuffer cmdBuffer, VkImage srcImage, uint32_t srcLevel,
+  blitImage(VKCommandBuffer *cmdBuffer, VkImage srcImage, uint32_t srcLevel,
             VkImage dstImage, uint32_t dstLevel, Region srcRegion,
             Region dstRegion, uint32_t srcBaseLayer = 0,
             uint32_t srcLayerCount = 1, uint32_t dstBaseLayer = 0,
@@ -19,6 +19,7 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKBuffer.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
 #include "ngfx/porting/vulkan/VKGraphicsContext.h"
 #include <cstring>
@@ -75,6 +76,7 @@ void VKBuffer::initDescriptorSet(VkDescriptorPool descriptorPool,
       VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr, descriptorPool,
       1, &descriptorSetLayout};
   V(vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet));
+  ctx->memoryTracker.addDescriptorSets(this, 1);
   VkDescriptorBufferInfo descriptorBufferInfo = {v, 0, size};
   VkWriteDescriptorSet writeDescriptorSet = {
       VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
@@ -93,12 +95,14 @@ void VKBuffer::initDescriptorSet(VkDescriptorPool descriptorPool,
 void VKBuffer::upload(const void *data, uint32_t size, uint32_t offset) {
   if (!data)
     return;
+  NGFX_TRACE_ZONE("transfer", "uploadBuffer");
   uint8_t *dst = (uint8_t *)map();
   memcpy(dst + offset, data, size);
   unmap();
 }
 
 void VKBuffer::download(void *dst, uint32_t size, uint32_t offset) {
+  NGFX_TRACE_ZONE("transfer", "downloadBuffer");
   uint8_t *src = (uint8_t *)map();
   memcpy(dst, src + offset, size);
   unmap();
@@ -108,8 +112,15 @@ VKBuffer::~VKBuffer() {
   auto device = ctx->vkDevice.v;
   if (v)
     VK_TRACE(vkDestroyBuffer(device, v, nullptr));
-  if (memory)
+  if (memory) {
     VK_TRACE(vkFreeMemory(device, memory, nullptr));
+    ctx->memoryTracker.onFree(this);
+  }
+}
+
+void VKBuffer::setName(const std::string &name) {
+  Buffer::setName(name);
+  ctx->memoryTracker.setName(this, name);
 }
 
 void VKBuffer::createBuffer(const void *data, uint32_t size,
@@ -128,6 +139,21 @@ void VKBuffer::createBuffer(const void *data, uint32_t size,
   V(vkCreateBuffer(device, &createInfo, nullptr, &v));
 }
 
+static MemoryCategory getMemoryCategory(VkBufferUsageFlags bufferUsageFlags,
+                                        bool hostVisible) {
+  if (bufferUsageFlags & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+    return MEMORY_CATEGORY_VERTEX;
+  else if (bufferUsageFlags & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+    return MEMORY_CATEGORY_INDEX;
+  else if (bufferUsageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+    return MEMORY_CATEGORY_UNIFORM;
+  else if ((bufferUsageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) ||
+           !hostVisible)
+    return MEMORY_CATEGORY_STORAGE;
+  // Host visible transfer buffers, e.g. for texture upload / download
+  return MEMORY_CATEGORY_STAGING;
+}
+
 void VKBuffer::createMemory(VkMemoryPropertyFlags memoryPropertyFlags) {
   VkResult vkResult;
   auto device = ctx->vkDevice.v;
@@ -140,6 +166,13 @@ void VKBuffer::createMemory(VkMemoryPropertyFlags memoryPropertyFlags) {
                memoryTypeIndex};
   V(vkAllocateMemory(device, &allocInfo, nullptr, &memory));
   V(vkBindBufferMemory(device, v, memory, 0));
+  bool hostVisible = (physicalDevice->deviceMemoryProperties
+                          .memoryTypes[memoryTypeIndex]
+                          .propertyFlags &
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+  ctx->memoryTracker.onAllocate(
+      this, getMemoryCategory(createInfo.usage, hostVisible), memReqs.size,
+      hostVisible, name);
 }
 
 void *VKBuffer::map() {
@@ -38,6 +38,7 @@ public:
   void unmap() override;
   void upload(const void *data, uint32_t size, uint32_t offset = 0) override;
   void download(void *data, uint32_t size, uint32_t offset = 0) override;
+  void setName(const std::string &name) override;
   VkDeviceMemory memory = VK_NULL_HANDLE;
   VkBuffer v = VK_NULL_HANDLE;
   VkBufferCreateInfo createInfo;
@@ -43,6 +43,7 @@ void VKCommandBuffer::begin() {
   VkCommandBufferBeginInfo cmdBufferBeginInfo = {
       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr, 0, nullptr};
   V(vkBeginCommandBuffer(v, &cmdBufferBeginInfo));
+  stats = {};
 }
 void VKCommandBuffer::end() {
   VkResult vkResult;
@@ -19,13 +19,16 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKComputePipeline.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
 using namespace ngfx;
 
 void VKComputePipeline::create(
     VKGraphicsContext *ctx,
     const std::vector<VKPipeline::Descriptor> &descriptors,
-    VkShaderModule shaderModule) {
+    VkShaderModule shaderModule,
+    const std::vector<uint32_t> &specializationConstants) {
+  NGFX_TRACE_ZONE("pipeline", "createComputePipeline");
   VkResult vkResult;
   this->device = ctx->vkDevice.v;
   std::vector<VkDescriptorSetLayout> descriptorSetLayouts(descriptors.size());
@@ -44,13 +47,24 @@ void VKComputePipeline::create(
   V(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr,
                            &pipelineLayout));
 
+  specializationData = specializationConstants;
+  specializationMapEntries.resize(specializationData.size());
+  for (uint32_t j = 0; j < specializationData.size(); j++)
+    specializationMapEntries[j] = {j, uint32_t(j * sizeof(uint32_t)),
+                                   sizeof(uint32_t)};
+  specializationInfo = {uint32_t(specializationMapEntries.size()),
+                        specializationMapEntries.data(),
+                        specializationData.size() * sizeof(uint32_t),
+                        specializationData.data()};
+
   shaderStageCreateInfo = {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                            nullptr,
                            0,
                            VK_SHADER_STAGE_COMPUTE_BIT,
                            shaderModule,
                            "main",
-                           nullptr};
+                           specializationData.empty() ? nullptr
+                                                      : &specializationInfo};
 
   createInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
                 nullptr,
@@ -63,8 +77,9 @@ void VKComputePipeline::create(
                              nullptr, &v));
 }
 
-ComputePipeline *ComputePipeline::create(GraphicsContext *graphicsContext,
-                                         ComputeShaderModule *cs) {
+ComputePipeline *ComputePipeline::create(
+    GraphicsContext *graphicsContext, ComputeShaderModule *cs,
+    const std::vector<uint32_t> &specializationConstants) {
   VKComputePipeline *vkComputePipeline = new VKComputePipeline();
   uint32_t numDescriptors =
       cs->descriptors.empty() ? 0 : cs->descriptors.back().set + 1;
@@ -73,6 +88,7 @@ ComputePipeline *ComputePipeline::create(GraphicsContext *graphicsContext,
   std::vector<VKPipeline::Descriptor> vkDescriptors(numDescriptors);
   VKPipelineUtil::parseDescriptors(cs->descriptors, VK_SHADER_STAGE_COMPUTE_BIT,
                                    vkDescriptors, descriptorBindings);
-  vkComputePipeline->create(vk(graphicsContext), vkDescriptors, vk(cs)->v);
+  vkComputePipeline->create(vk(graphicsContext), vkDescriptors, vk(cs)->v,
+                            specializationConstants);
   return vkComputePipeline;
 }
@@ -28,8 +28,12 @@ class VKComputePipeline : public ComputePipeline, public VKPipeline {
 public:
   void create(VKGraphicsContext *ctx,
               const std::vector<VKPipeline::Descriptor> &descriptors,
-              VkShaderModule shaderModule);
+              VkShaderModule shaderModule,
+              const std::vector<uint32_t> &specializationConstants = {});
   VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo;
+  std::vector<VkSpecializationMapEntry> specializationMapEntries;
+  std::vector<uint32_t> specializationData;
+  VkSpecializationInfo specializationInfo;
   VkPipelineShaderStageCreateInfo shaderStageCreateInfo;
   VkComputePipelineCreateInfo createInfo;
 };
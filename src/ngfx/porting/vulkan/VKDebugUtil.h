@@ -23,8 +23,11 @@
 #include <cassert>
 #include <cstdarg>
 #include <vulkan/vulkan.h>
-/** VK_TRACE all Vulkan calls to log output */
-const int VK_ENABLE_TRACE = 0;
+/** VK_TRACE all Vulkan calls to log output, at the verbose level.
+ *  When disabled, VK_TRACE compiles to the call only */
+#ifndef VK_ENABLE_TRACE
+#define VK_ENABLE_TRACE 0
+#endif
 
 namespace ngfx {
 
@@ -34,17 +37,21 @@ struct VKDebugUtil {
 
 }; // namespace ngfx
 
+#if VK_ENABLE_TRACE
+#define VK_TRACE_CALL(func) NGFX_LOG_VERBOSE("%s", #func)
+#else
+#define VK_TRACE_CALL(func)
+#endif
+
 #define VK_TRACE(func)                                                         \
   {                                                                            \
-    if (VK_ENABLE_TRACE)                                                       \
-      NGFX_LOG("%s", #func);                                                   \
+    VK_TRACE_CALL(func);                                                       \
     func;                                                                      \
   }
 
 #define V(func)                                                                \
   {                                                                            \
-    if (VK_ENABLE_TRACE)                                                       \
-      NGFX_LOG("%s", #func);                                                   \
+    VK_TRACE_CALL(func);                                                       \
     vkResult = func;                                                           \
     if (vkResult != VK_SUCCESS) {                                              \
       NGFX_ERR("%s failed: %s", #func,                                         \
@@ -123,6 +123,27 @@ void VKDevice::getDeviceExtensions() {
     deviceExtensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
     enableDebugMarkers = true;
   }
+  // Enable the memory budget extension if it is present
+  if (vkPhysicalDevice->extensionSupported(
+          VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+    deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    enableMemoryBudget = true;
+  }
+  // Enable the draw indirect count extension if it is present.
+  // The core Vulkan 1.2 command would also require enabling the
+  // drawIndirectCount feature, so always use the extension
+  if (vkPhysicalDevice->extensionSupported(
+          VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+    deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    enableDrawIndirectCount = true;
+  }
+  // Enable the host query reset extension if the feature is supported
+  if (vkPhysicalDevice->extensionSupported(
+          VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME) &&
+      vkPhysicalDevice->hostQueryResetFeatures.hostQueryReset) {
+    deviceExtensions.push_back(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME);
+    enableHostQueryReset = true;
+  }
 }
 void VKDevice::create(VKPhysicalDevice *vkPhysicalDevice) {
   VkResult vkResult;
@@ -136,18 +157,56 @@ void VKDevice::create(VKPhysicalDevice *vkPhysicalDevice) {
       static_cast<uint32_t>(queueCreateInfos.size());
   ;
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
-  createInfo.pEnabledFeatures = nullptr;
+  auto &deviceFeatures = vkPhysicalDevice->deviceFeatures;
+  enabledFeatures.multiDrawIndirect = deviceFeatures.multiDrawIndirect;
+  enabledFeatures.drawIndirectFirstInstance =
+      deviceFeatures.drawIndirectFirstInstance;
+  enabledFeatures.occlusionQueryPrecise = deviceFeatures.occlusionQueryPrecise;
+  enabledFeatures.pipelineStatisticsQuery =
+      deviceFeatures.pipelineStatisticsQuery;
+  createInfo.pEnabledFeatures = &enabledFeatures;
+  if (enableHostQueryReset) {
+    hostQueryResetFeatures.hostQueryReset = VK_TRUE;
+    createInfo.pNext = &hostQueryResetFeatures;
+  }
   createInfo.enabledExtensionCount = (uint32_t)deviceExtensions.size();
   enabledDeviceExtensions.resize(deviceExtensions.size());
   for (uint32_t j = 0; j < deviceExtensions.size(); j++)
     enabledDeviceExtensions[j] = deviceExtensions[j].c_str();
   createInfo.ppEnabledExtensionNames = enabledDeviceExtensions.data();
   V(vkCreateDevice(vkPhysicalDevice->v, &createInfo, nullptr, &v));
+  if (enableDrawIndirectCount)
+    cmdDrawIndexedIndirectCount =
+        (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(
+            v, "vkCmdDrawIndexedIndirectCountKHR");
+  if (enableHostQueryReset)
+    resetQueryPool =
+        (PFN_vkResetQueryPoolEXT)vkGetDeviceProcAddr(v, "vkResetQueryPoolEXT");
 }
 void VKDevice::waitIdle() {
   VkResult vkResult;
   V(vkDeviceWaitIdle(v));
 }
+uint64_t VKDevice::getMemoryBudget() {
+  uint64_t budget, usage;
+  if (!enableMemoryBudget || !vkPhysicalDevice->getMemoryBudget(budget, usage))
+    return 0;
+  return budget;
+}
+uint64_t VKDevice::getMemoryUsage() {
+  uint64_t budget, usage;
+  if (!enableMemoryBudget || !vkPhysicalDevice->getMemoryBudget(budget, usage))
+    return 0;
+  return usage;
+}
+bool VKDevice::supportsSubgroupArithmetic() {
+  auto &subgroupProperties = vkPhysicalDevice->subgroupProperties;
+  return (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+         (subgroupProperties.supportedOperations &
+          VK_SUBGROUP_FEATURE_ARITHMETIC_BIT) &&
+         (subgroupProperties.supportedOperations &
+          VK_SUBGROUP_FEATURE_BASIC_BIT);
+}
 VKDevice::~VKDevice() {
   if (v)
     VK_TRACE(vkDestroyDevice(v, nullptr));
@@ -27,11 +27,19 @@
 #include <vulkan/vulkan.h>
 
 namespace ngfx {
+class MemoryTracker;
+
 class VKDevice : public Device {
 public:
   void create(VKPhysicalDevice *vkPhysicalDevice);
   virtual ~VKDevice();
   void waitIdle();
+  uint64_t getMemoryBudget() override;
+  uint64_t getMemoryUsage() override;
+  bool supportsSubgroupArithmetic() override;
+  bool supportsDrawIndirectCount() override {
+    return cmdDrawIndexedIndirectCount != nullptr;
+  }
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
   struct {
     int32_t graphics = -1;
@@ -40,9 +48,23 @@ public:
   } queueFamilyIndices;
   VkDevice v = VK_NULL_HANDLE;
   bool enableDebugMarkers = false;
+  bool enableMemoryBudget = false;
+  bool enableDrawIndirectCount = false;
+  bool enableHostQueryReset = false;
+  /** The features enabled on the device */
+  VkPhysicalDeviceFeatures enabledFeatures = {};
+  /** vkCmdDrawIndexedIndirectCountKHR, from VK_KHR_draw_indirect_count,
+   *  or nullptr if not supported */
+  PFN_vkCmdDrawIndexedIndirectCountKHR cmdDrawIndexedIndirectCount = nullptr;
+  /** vkResetQueryPoolEXT, from VK_EXT_host_query_reset, or nullptr if not supported */
+  PFN_vkResetQueryPoolEXT resetQueryPool = nullptr;
   std::vector<std::string> deviceExtensions;
   VKPhysicalDevice *vkPhysicalDevice;
+  /** The tracker of the memory allocated on this device, or nullptr */
+  MemoryTracker *memoryTracker = nullptr;
   VkDeviceCreateInfo createInfo;
+  VkPhysicalDeviceHostQueryResetFeaturesEXT hostQueryResetFeatures = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES_EXT};
   std::vector<const char *> enabledDeviceExtensions;
 
 private:
@@ -27,12 +27,37 @@
 #include "ngfx/porting/vulkan/VKGraphicsPipeline.h"
 #include "ngfx/porting/vulkan/VKRenderPass.h"
 #include "ngfx/porting/vulkan/VKTexture.h"
+#include <chrono>
 using namespace ngfx;
 
+namespace {
+// Count a recorded command, and measure the CPU time spent recording it
+class StatsScope {
+public:
+  StatsScope(CommandStats &stats, uint32_t CommandStats::*counter = nullptr,
+             uint32_t count = 1)
+      : stats(stats), t0(std::chrono::steady_clock::now()) {
+    if (counter)
+      stats.*counter += count;
+  }
+  ~StatsScope() {
+    stats.recordingTime += std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - t0)
+                               .count();
+  }
+
+private:
+  CommandStats &stats;
+  std::chrono::steady_clock::time_point t0;
+};
+} // namespace
+
 void VKGraphics::beginRenderPass(CommandBuffer *commandBuffer,
                                  RenderPass *renderPass,
                                  Framebuffer *framebuffer, glm::vec4 clearColor,
                                  float clearDepth, uint32_t clearStencil) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numRenderPasses);
   currentRenderPass = renderPass;
   currentFramebuffer = framebuffer;
   auto &vkCommandBuffer = vk(commandBuffer)->v;
@@ -73,6 +98,7 @@ void VKGraphics::beginRenderPass(CommandBuffer *commandBuffer,
 }
 
 void VKGraphics::endRenderPass(CommandBuffer *commandBuffer) {
+  StatsScope statsScope(getRecordingStats(commandBuffer));
   VK_TRACE(vkCmdEndRenderPass(vk(commandBuffer)->v));
 
   auto vkRenderPass = vk(currentRenderPass);
@@ -109,6 +135,8 @@ uint64_t VKGraphics::endProfile(CommandBuffer *commandBuffer) {
 
 void VKGraphics::bindComputePipeline(CommandBuffer *commandBuffer,
                                      ComputePipeline *computePipeline) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numPipelineBinds);
   VK_TRACE(vkCmdBindPipeline(vk(commandBuffer)->v,
                              VK_PIPELINE_BIND_POINT_COMPUTE,
                              vk(computePipeline)->v));
@@ -117,6 +145,8 @@ void VKGraphics::bindComputePipeline(CommandBuffer *commandBuffer,
 
 void VKGraphics::bindGraphicsPipeline(CommandBuffer *commandBuffer,
                                       GraphicsPipeline *graphicsPipeline) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numPipelineBinds);
   VK_TRACE(vkCmdBindPipeline(vk(commandBuffer)->v,
                              VK_PIPELINE_BIND_POINT_GRAPHICS,
                              vk(graphicsPipeline)->v));
@@ -125,11 +155,13 @@ void VKGraphics::bindGraphicsPipeline(CommandBuffer *commandBuffer,
 
 void VKGraphics::bindTexture(CommandBuffer *commandBuffer, Texture *texture,
                              uint32_t set) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDescriptorSetBinds);
   auto vkTexture = vk(texture);
   VkPipelineLayout pipelineLayout;
   VkPipelineBindPoint pipelineBindPoint;
   VkDescriptorSet descriptorSet;
-  VkCommandBuffer vkCmdBuf = vk(commandBuffer)->v;
+  VKCommandBuffer *vkCmdBuf = vk(commandBuffer);
   if (VKGraphicsPipeline *graphicsPipeline =
           dynamic_cast<VKGraphicsPipeline *>(currentPipeline)) {
     if (!(vkTexture->imageUsageFlags & VK_IMAGE_USAGE_SAMPLED_BIT)) {
@@ -153,14 +185,28 @@ void VKGraphics::bindTexture(CommandBuffer *commandBuffer, Texture *texture,
                                    nullptr));
 }
 
+void VKGraphics::bindTextureAsImage(CommandBuffer *commandBuffer,
+                                    Texture *texture, uint32_t set) {
+  // Textures bound to a compute pipeline are bound as storage images
+  if (!dynamic_cast<VKComputePipeline *>(currentPipeline)) {
+    NGFX_TODO("bind storage images to graphics pipelines");
+    return;
+  }
+  bindTexture(commandBuffer, texture, set);
+}
+
 void VKGraphics::bindVertexBuffer(CommandBuffer *commandBuffer, Buffer *buffer,
                                   uint32_t location, uint32_t stride) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numVertexBufferBinds);
   VkDeviceSize offsets[] = {0};
   VK_TRACE(vkCmdBindVertexBuffers(vk(commandBuffer)->v, location, 1,
                                   &vk(buffer)->v, offsets));
 }
 void VKGraphics::bindIndexBuffer(CommandBuffer *commandBuffer, Buffer *buffer,
                                  IndexFormat indexFormat) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numIndexBufferBinds);
   VkDeviceSize offset = 0;
   VK_TRACE(vkCmdBindIndexBuffer(vk(commandBuffer)->v, vk(buffer)->v, offset,
                                 VkIndexType(indexFormat)));
@@ -188,6 +234,8 @@ static void bindBufferFN0(CommandBuffer *commandBuffer, Buffer *buffer,
 void VKGraphics::bindUniformBuffer(CommandBuffer *commandBuffer, Buffer *buffer,
                                    uint32_t set,
                                    ShaderStageFlags shaderStageFlags) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDescriptorSetBinds);
   bindBufferFN0(commandBuffer, buffer, set, currentPipeline,
                 &vk(buffer)->getUboDescriptorSet(shaderStageFlags));
 }
@@ -195,6 +243,8 @@ void VKGraphics::bindUniformBuffer(CommandBuffer *commandBuffer, Buffer *buffer,
 void VKGraphics::bindStorageBuffer(CommandBuffer *commandBuffer, Buffer *buffer,
                                    uint32_t set,
                                    ShaderStageFlags shaderStageFlags, bool) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDescriptorSetBinds);
   bindBufferFN0(commandBuffer, buffer, set, currentPipeline,
                 &vk(buffer)->getSsboDescriptorSet(shaderStageFlags));
 }
@@ -203,30 +253,178 @@ void VKGraphics::dispatch(CommandBuffer *commandBuffer, uint32_t groupCountX,
                           uint32_t groupCountY, uint32_t groupCountZ,
                           int32_t threadsPerGroupX, int32_t threadsPerGroupY,
                           int32_t threadsPerGroupZ) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDispatches);
   VK_TRACE(vkCmdDispatch(vk(commandBuffer)->v, groupCountX, groupCountY,
                          groupCountZ));
 }
 
+void VKGraphics::dispatchIndirect(CommandBuffer *commandBuffer, Buffer *buffer,
+                                  uint32_t offset, int32_t threadsPerGroupX,
+                                  int32_t threadsPerGroupY,
+                                  int32_t threadsPerGroupZ) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDispatches);
+  VK_TRACE(vkCmdDispatchIndirect(vk(commandBuffer)->v, vk(buffer)->v, offset));
+}
+
+void VKGraphics::computeBarrier(CommandBuffer *commandBuffer) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numBarriers);
+  VkMemoryBarrier memoryBarrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_SHADER_WRITE_BIT,
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+  VK_TRACE(vkCmdPipelineBarrier(vk(commandBuffer)->v,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                                &memoryBarrier, 0, nullptr, 0, nullptr));
+}
+
+void VKGraphics::computeToDrawBarrier(CommandBuffer *commandBuffer) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numBarriers);
+  VkMemoryBarrier memoryBarrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_SHADER_WRITE_BIT,
+      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+          VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT};
+  VK_TRACE(vkCmdPipelineBarrier(
+      vk(commandBuffer)->v, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+          VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+      0, 1, &memoryBarrier, 0, nullptr, 0, nullptr));
+}
+
+void VKGraphics::resourceBarrier(CommandBuffer *commandBuffer,
+                                 const std::vector<ResourceBarrier> &barriers) {
+  if (barriers.empty())
+    return;
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numBarriers);
+  // Only the writes need to be made available, a read after write or a
+  // write after read only needs the execution dependency
+  auto getSrcAccessMask = [](ShaderAccessFlags access) -> VkAccessFlags {
+    return (access & SHADER_ACCESS_WRITE_BIT) ? VK_ACCESS_SHADER_WRITE_BIT : 0;
+  };
+  auto getDstAccessMask = [](ShaderAccessFlags access) -> VkAccessFlags {
+    VkAccessFlags accessMask = 0;
+    if (access & SHADER_ACCESS_READ_BIT)
+      accessMask |= VK_ACCESS_SHADER_READ_BIT;
+    if (access & SHADER_ACCESS_WRITE_BIT)
+      accessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+    return accessMask;
+  };
+  std::vector<VkBufferMemoryBarrier> bufferMemoryBarriers;
+  std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
+  for (const ResourceBarrier &barrier : barriers) {
+    VkAccessFlags srcAccessMask = getSrcAccessMask(barrier.srcAccess),
+                  dstAccessMask = getDstAccessMask(barrier.dstAccess);
+    if (barrier.buffer) {
+      bufferMemoryBarriers.push_back(
+          {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, nullptr, srcAccessMask,
+           dstAccessMask, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+           vk(barrier.buffer)->v, 0, VK_WHOLE_SIZE});
+    } else if (barrier.texture) {
+      auto vkTexture = vk(barrier.texture);
+      auto &vkImage = vkTexture->vkImage;
+      VkImageLayout newLayout = VkImageLayout(barrier.imageLayout);
+      imageMemoryBarriers.push_back(
+          {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+           nullptr,
+           srcAccessMask,
+           dstAccessMask,
+           vkImage.imageLayout[0],
+           newLayout,
+           VK_QUEUE_FAMILY_IGNORED,
+           VK_QUEUE_FAMILY_IGNORED,
+           vkImage.v,
+           {vkTexture->aspectFlags, 0, vkTexture->mipLevels, 0,
+            vkTexture->arrayLayers}});
+      for (uint32_t j = 0; j < vkImage.imageLayout.size(); j++) {
+        vkImage.imageLayout[j] = newLayout;
+        vkImage.accessMask[j] = dstAccessMask;
+        vkImage.stageMask[j] = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+      }
+    }
+  }
+  VK_TRACE(vkCmdPipelineBarrier(
+      vk(commandBuffer)->v, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+      uint32_t(bufferMemoryBarriers.size()), bufferMemoryBarriers.data(),
+      uint32_t(imageMemoryBarriers.size()), imageMemoryBarriers.data()));
+}
+
 void VKGraphics::draw(CommandBuffer *commandBuffer, uint32_t vertexCount,
                       uint32_t instanceCount, uint32_t firstVertex,
                       uint32_t firstInstance) {
+  StatsScope statsScope(getRecordingStats(commandBuffer),
+                        &CommandStats::numDraws);
   VK_TRACE(vkCmdDraw(vk(commandBuffer)->v, vertexCount, instanceCount,
                      firstVertex, firstInstance));
 }
 void VKGraphics::drawIndexed(CommandBuffer *cmdBuffer, uint32_t indexCount,
                              uint32_t instanceCount, uint32_t firstIndex,
                              int32_t vertexOffset, uint32_t firstInstance) {
+  StatsScope statsScope(getRecordingStats(cmdBuffer), &CommandStats::numDraws);
   VK_TRACE(vkCmdDrawIndexed(vk(cmdBuffer)->v, indexCount, instanceCount,
                             firstIndex, vertexOffset, firstInstance));
 }
+void VKGraphics::drawIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                              uint32_t offset, uint32_t drawCount,
+                              uint32_t stride) {
+  StatsScope statsScope(getRecordingStats(cmdBuffer), &CommandStats::numDraws,
+                        drawCount);
+  auto &vkDevice = vk(ctx)->vkDevice;
+  if (drawCount <= 1 || vkDevice.enabledFeatures.multiDrawIndirect) {
+    VK_TRACE(vkCmdDrawIndirect(vk(cmdBuffer)->v, vk(buffer)->v, offset,
+                               drawCount, stride));
+    return;
+  }
+  for (uint32_t j = 0; j < drawCount; j++) {
+    VK_TRACE(vkCmdDrawIndirect(vk(cmdBuffer)->v, vk(buffer)->v,
+                               offset + j * stride, 1, stride));
+  }
+}
+void VKGraphics::drawIndexedIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                     uint32_t offset, uint32_t drawCount,
+                                     uint32_t stride) {
+  StatsScope statsScope(getRecordingStats(cmdBuffer), &CommandStats::numDraws,
+                        drawCount);
+  auto &vkDevice = vk(ctx)->vkDevice;
+  if (drawCount <= 1 || vkDevice.enabledFeatures.multiDrawIndirect) {
+    VK_TRACE(vkCmdDrawIndexedIndirect(vk(cmdBuffer)->v, vk(buffer)->v, offset,
+                                      drawCount, stride));
+    return;
+  }
+  for (uint32_t j = 0; j < drawCount; j++) {
+    VK_TRACE(vkCmdDrawIndexedIndirect(vk(cmdBuffer)->v, vk(buffer)->v,
+                                      offset + j * stride, 1, stride));
+  }
+}
+void VKGraphics::drawIndexedIndirectCount(CommandBuffer *cmdBuffer,
+                                          Buffer *buffer, uint32_t offset,
+                                          Buffer *countBuffer,
+                                          uint32_t countBufferOffset,
+                                          uint32_t maxDrawCount,
+                                          uint32_t stride) {
+  StatsScope statsScope(getRecordingStats(cmdBuffer), &CommandStats::numDraws);
+  auto &vkDevice = vk(ctx)->vkDevice;
+  if (!vkDevice.cmdDrawIndexedIndirectCount)
+    NGFX_ERR("drawIndexedIndirectCount is not supported by the device");
+  VK_TRACE(vkDevice.cmdDrawIndexedIndirectCount(
+      vk(cmdBuffer)->v, vk(buffer)->v, offset, vk(countBuffer)->v,
+      countBufferOffset, maxDrawCount, stride));
+}
 
 void VKGraphics::setViewport(CommandBuffer *commandBuffer, Rect2D r) {
+  StatsScope statsScope(getRecordingStats(commandBuffer));
   viewport = r;
   VkViewport vkViewport = {float(r.x), float(r.y), float(r.w),
                            float(r.h), 0.0f,       1.0f};
   VK_TRACE(vkCmdSetViewport(vk(commandBuffer)->v, 0, 1, &vkViewport));
 }
 void VKGraphics::setScissor(CommandBuffer *commandBuffer, Rect2D r) {
+  StatsScope statsScope(getRecordingStats(commandBuffer));
   scissorRect = r;
 #ifdef ORIGIN_BOTTOM_LEFT
   auto &v = viewport;
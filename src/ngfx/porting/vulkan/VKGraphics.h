@@ -60,13 +60,19 @@ public:
   void bindTexture(CommandBuffer *commandBuffer, Texture *texture,
                    uint32_t set) override;
   void bindTextureAsImage(CommandBuffer* commandBuffer, Texture* texture,
-      uint32_t set) override {
-      NGFX_TODO();
-  }
+      uint32_t set) override;
   void dispatch(CommandBuffer *cmdBuffer, uint32_t groupCountX,
                 uint32_t groupCountY, uint32_t groupCountZ,
                 int32_t threadsPerGroupX, int32_t threadsPerGroupY,
                 int32_t threadsPerGroupZ) override;
+  void dispatchIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                        uint32_t offset, int32_t threadsPerGroupX,
+                        int32_t threadsPerGroupY,
+                        int32_t threadsPerGroupZ) override;
+  void computeBarrier(CommandBuffer *cmdBuffer) override;
+  void computeToDrawBarrier(CommandBuffer *cmdBuffer) override;
+  void resourceBarrier(CommandBuffer *cmdBuffer,
+                       const std::vector<ResourceBarrier> &barriers) override;
   void draw(CommandBuffer *cmdBuffer, uint32_t vertexCount,
             uint32_t instanceCount = 1, uint32_t firstVertex = 0,
             uint32_t firstInstance = 0) override;
@@ -74,6 +80,16 @@ public:
                    uint32_t instanceCount = 1, uint32_t firstIndex = 0,
                    int32_t vertexOffset = 0,
                    uint32_t firstInstance = 0) override;
+  void drawIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                    uint32_t offset = 0, uint32_t drawCount = 1,
+                    uint32_t stride = sizeof(DrawIndirectCommand)) override;
+  void drawIndexedIndirect(CommandBuffer *cmdBuffer, Buffer *buffer,
+                           uint32_t offset = 0, uint32_t drawCount = 1,
+                           uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
+  void drawIndexedIndirectCount(CommandBuffer *cmdBuffer, Buffer *buffer,
+                                uint32_t offset, Buffer *countBuffer,
+                                uint32_t countBufferOffset, uint32_t maxDrawCount,
+                                uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
   void setViewport(CommandBuffer *cmdBuffer, Rect2D rect) override;
   void setScissor(CommandBuffer *cmdBuffer, Rect2D rect) override;
   void waitIdle(CommandBuffer *cmdBuffer) override;
@@ -19,6 +19,7 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKGraphicsContext.h"
+#include "ngfx/graphics/RenderPassUtil.h"
 using namespace ngfx;
 using namespace std;
 #define MAX_DESCRIPTOR_SETS MAX_DESCRIPTORS * 4
@@ -31,8 +32,9 @@ void VKGraphicsContext::create(const char *appName, bool enableDepthStencil,
   auto instance = vkInstance.v;
   if (debug)
     vkDebugMessenger.create(instance);
-  vkPhysicalDevice.create(instance);
+  vkPhysicalDevice.create(instance, vkInstance.appInfo.apiVersion);
   vkDevice.create(&vkPhysicalDevice);
+  vkDevice.memoryTracker = &memoryTracker;
   vkCommandPool.create(vkDevice.v, vkDevice.queueFamilyIndices.graphics);
   vkQueue.create(this, vkDevice.queueFamilyIndices.graphics, 0);
   initDescriptorPool();
@@ -44,6 +46,7 @@ void VKGraphicsContext::create(const char *appName, bool enableDepthStencil,
 }
 
 VKGraphicsContext::~VKGraphicsContext() {
+  framebufferCache.clear();
   VK_TRACE(vkDestroyDescriptorPool(vkDevice.v, vkDescriptorPool, nullptr));
   if (debug)
     vkDebugMessenger.destroy();
@@ -67,17 +70,26 @@ void VKGraphicsContext::initDescriptorPool() {
 };
 
 RenderPass *VKGraphicsContext::getRenderPass(RenderPassConfig config) {
-  for (auto &r : vkRenderPassCache) {
-    if (r->config == config)
-      return &r->vkRenderPass;
+  size_t key = config.key();
+  auto range = vkRenderPassCache.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->config == config)
+      return &it->second->vkRenderPass;
   }
   auto renderPassData = make_unique<VKRenderPassData>();
+  renderPassData->config = config;
   initRenderPass(config, renderPassData->vkRenderPass);
   auto result = &renderPassData->vkRenderPass;
-  vkRenderPassCache.emplace_back(std::move(renderPassData));
+  vkRenderPassCache.emplace(key, std::move(renderPassData));
   return result;
 }
 
+static bool hasStencilComponent(VkFormat format) {
+  return format == VK_FORMAT_S8_UINT || format == VK_FORMAT_D16_UNORM_S8_UINT ||
+         format == VK_FORMAT_D24_UNORM_S8_UINT ||
+         format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
 void VKGraphicsContext::initRenderPass(const RenderPassConfig &config,
                                        VKRenderPass &renderPass) {
   std::vector<VkAttachmentDescription> attachments;
@@ -102,9 +114,11 @@ void VKGraphicsContext::initRenderPass(const RenderPassConfig &config,
              initialLayout, finalLayout
         });
     } else {
+        AttachmentStoreOp multisampleStoreOp =
+            colorAttachmentDesc.multisampleStoreOp.value_or(colorAttachmentDesc.storeOp);
         attachments.push_back({
              0, colorFormat, VkSampleCountFlagBits(config.numSamples),
-             VkAttachmentLoadOp(colorAttachmentDesc.loadOp), VkAttachmentStoreOp(colorAttachmentDesc.storeOp), /* TODO: DONT_CARE? */
+             VkAttachmentLoadOp(colorAttachmentDesc.loadOp), VkAttachmentStoreOp(multisampleStoreOp),
              VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE,
              initialLayout, finalLayout
         });
@@ -129,11 +143,19 @@ void VKGraphicsContext::initRenderPass(const RenderPassConfig &config,
         (depthStencilAttachmentDesc->finalLayout)
             ? VkImageLayout(*depthStencilAttachmentDesc->finalLayout)
             : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    // Depth-only formats don't need any stencil traffic
+    bool hasStencil = hasStencilComponent(depthStencilFormat);
+    VkAttachmentLoadOp stencilLoadOp =
+        hasStencil ? VkAttachmentLoadOp(depthStencilAttachmentDesc->loadOp)
+                   : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    VkAttachmentStoreOp stencilStoreOp =
+        hasStencil ? VkAttachmentStoreOp(depthStencilAttachmentDesc->storeOp)
+                   : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     if (!config.enableDepthStencilResolve) {
         attachments.push_back({
             0, depthStencilFormat, VkSampleCountFlagBits(config.numSamples),
             VkAttachmentLoadOp(depthStencilAttachmentDesc->loadOp),  VkAttachmentStoreOp(depthStencilAttachmentDesc->storeOp),
-            VkAttachmentLoadOp(depthStencilAttachmentDesc->loadOp), VkAttachmentStoreOp(depthStencilAttachmentDesc->storeOp),
+            stencilLoadOp, stencilStoreOp,
             initialLayout, finalLayout
         });
     }
@@ -141,13 +163,13 @@ void VKGraphicsContext::initRenderPass(const RenderPassConfig &config,
         attachments.push_back({
             0, depthStencilFormat, VkSampleCountFlagBits(config.numSamples),
             VkAttachmentLoadOp(depthStencilAttachmentDesc->loadOp),  VK_ATTACHMENT_STORE_OP_DONT_CARE,
-            VkAttachmentLoadOp(depthStencilAttachmentDesc->loadOp),VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            stencilLoadOp, VK_ATTACHMENT_STORE_OP_DONT_CARE,
             initialLayout, finalLayout
         });
         attachments.push_back({
              0, depthStencilFormat, VK_SAMPLE_COUNT_1_BIT,
              VK_ATTACHMENT_LOAD_OP_DONT_CARE, VkAttachmentStoreOp(depthStencilAttachmentDesc->storeOp),
-             VK_ATTACHMENT_LOAD_OP_DONT_CARE, VkAttachmentStoreOp(depthStencilAttachmentDesc->storeOp),
+             VK_ATTACHMENT_LOAD_OP_DONT_CARE, stencilStoreOp,
              initialLayout, finalLayout
         });
     }
@@ -254,13 +276,12 @@ void VKGraphicsContext::setSurface(Surface *surface) {
     msColorImageCreateInfo.samples = VkSampleCountFlagBits(numSamples);
     msColorImageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
                                    VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-    vkMultisampleColorImage.create(&vkDevice,
-                                   msColorImageCreateInfo); // TODO: use
-                                                            // VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
-                                                            // on mobile GPU
+    vkMultisampleColorImage.create(&vkDevice, msColorImageCreateInfo);
     vkMultisampleColorImageView.create(vkDevice.v, vkMultisampleColorImage.v,
                                        VK_IMAGE_VIEW_TYPE_2D,
                                        VkFormat(surfaceFormat));
+    memoryTracker.setName(&vkMultisampleColorImage, "multisampleColorImage");
+    memoryTracker.addImageViews(&vkMultisampleColorImage, 1);
   }
   if (surface && enableDepthStencil) {
     vkDepthStencilImage.create(&vkDevice, {surface->w, surface->h, 1},
@@ -269,6 +290,8 @@ void VKGraphicsContext::setSurface(Surface *surface) {
     vkDepthStencilImageView.create(
         vkDevice.v, vkDepthStencilImage.v, VK_IMAGE_VIEW_TYPE_2D,
         vkPhysicalDevice.depthStencilFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+    memoryTracker.setName(&vkDepthStencilImage, "depthStencilImage");
+    memoryTracker.addImageViews(&vkDepthStencilImage, 1);
     if (numSamples != 1) {
       msDepthImageCreateInfo = {};
       msDepthImageCreateInfo.format = vkPhysicalDevice.depthStencilFormat;
@@ -277,35 +300,42 @@ void VKGraphicsContext::setSurface(Surface *surface) {
       msDepthImageCreateInfo.usage =
           VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
           VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-      vkMultisampleDepthImage.create(&vkDevice,
-                                     msDepthImageCreateInfo); // TODO: use
-                                                              // VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
-                                                              // on mobile GPU
+      vkMultisampleDepthImage.create(&vkDevice, msDepthImageCreateInfo);
       vkMultisampleDepthImageView.create(
           vkDevice.v, vkMultisampleDepthImage.v, VK_IMAGE_VIEW_TYPE_2D,
           vkPhysicalDevice.depthStencilFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+      memoryTracker.setName(&vkMultisampleDepthImage, "multisampleDepthImage");
+      memoryTracker.addImageViews(&vkMultisampleDepthImage, 1);
     }
   }
+  // The default render passes clear the color attachment and keep its contents,
+  // and discard the depth / stencil attachment
+  RenderPassUtil::AttachmentAccess colorAttachmentAccess = { true, true, true },
+                                   depthStencilAttachmentAccess = { true, true, false };
   std::optional<AttachmentDescription> depthStencilAttachmentDescription;
   if (enableDepthStencil)
-    depthStencilAttachmentDescription = { depthStencilFormat, nullopt, nullopt, ATTACHMENT_LOAD_OP_CLEAR, ATTACHMENT_STORE_OP_DONT_CARE };
+    depthStencilAttachmentDescription = AttachmentDescription{ depthStencilFormat, nullopt, nullopt };
   else
     depthStencilAttachmentDescription = nullopt;
   if (surface && !surface->offscreen) {
     RenderPassConfig onscreenRenderPassConfig = {
-        {{surfaceFormat, IMAGE_LAYOUT_UNDEFINED, IMAGE_LAYOUT_PRESENT_SRC, ATTACHMENT_LOAD_OP_CLEAR, ATTACHMENT_STORE_OP_STORE }},
+        {{surfaceFormat, IMAGE_LAYOUT_UNDEFINED, IMAGE_LAYOUT_PRESENT_SRC }},
         depthStencilAttachmentDescription,
         false,
         numSamples};
+    RenderPassUtil::inferLoadStoreOps(onscreenRenderPassConfig, { colorAttachmentAccess },
+                                      depthStencilAttachmentAccess);
     vkDefaultRenderPass =
         (VKRenderPass *)getRenderPass(onscreenRenderPassConfig);
   }
   defaultOffscreenSurfaceFormat = PixelFormat(VK_FORMAT_R8G8B8A8_UNORM);
   RenderPassConfig offscreenRenderPassConfig = {
-      { { defaultOffscreenSurfaceFormat, nullopt, nullopt, ATTACHMENT_LOAD_OP_CLEAR, ATTACHMENT_STORE_OP_DONT_CARE } },
+      { { defaultOffscreenSurfaceFormat, nullopt, nullopt } },
       depthStencilAttachmentDescription,
       false,
       numSamples};
+  RenderPassUtil::inferLoadStoreOps(offscreenRenderPassConfig, { colorAttachmentAccess },
+                                    depthStencilAttachmentAccess);
   vkDefaultOffscreenRenderPass =
       (VKRenderPass *)getRenderPass(offscreenRenderPassConfig);
   vkPipelineCache.create(vkDevice.v);
@@ -68,7 +68,8 @@ public:
     VKRenderPass vkRenderPass;
   };
   RenderPass *getRenderPass(RenderPassConfig config) override;
-  std::vector<std::unique_ptr<VKRenderPassData>> vkRenderPassCache;
+  std::unordered_multimap<size_t, std::unique_ptr<VKRenderPassData>>
+      vkRenderPassCache;
   VKRenderPass *vkDefaultRenderPass = nullptr,
                *vkDefaultOffscreenRenderPass = nullptr;
   VKPipelineCache vkPipelineCache;
@@ -70,7 +70,8 @@ enum BufferUsageFlagBits {
   VK(BUFFER_USAGE_UNIFORM_BUFFER_BIT),
   VK(BUFFER_USAGE_STORAGE_BUFFER_BIT),
   VK(BUFFER_USAGE_VERTEX_BUFFER_BIT),
-  VK(BUFFER_USAGE_INDEX_BUFFER_BIT)
+  VK(BUFFER_USAGE_INDEX_BUFFER_BIT),
+  VK(BUFFER_USAGE_INDIRECT_BUFFER_BIT)
 };
 enum ColorComponentFlagBits {
   VK(COLOR_COMPONENT_R_BIT),
@@ -157,7 +158,22 @@ enum PixelFormat {
   PIXELFORMAT_D24_UNORM = VK_FORMAT_X8_D24_UNORM_PACK32,
   PIXELFORMAT_D24_UNORM_S8_UINT = VK_FORMAT_D24_UNORM_S8_UINT,
   PIXELFORMAT_D32_SFLOAT = VK_FORMAT_D32_SFLOAT,
-  PIXELFORMAT_D32_SFLOAT_S8_UINT = VK_FORMAT_D32_SFLOAT_S8_UINT
+  PIXELFORMAT_D32_SFLOAT_S8_UINT = VK_FORMAT_D32_SFLOAT_S8_UINT,
+  PIXELFORMAT_BC1_RGBA_UNORM = VK_FORMAT_BC1_RGBA_UNORM_BLOCK,
+  PIXELFORMAT_BC2_UNORM = VK_FORMAT_BC2_UNORM_BLOCK,
+  PIXELFORMAT_BC3_UNORM = VK_FORMAT_BC3_UNORM_BLOCK,
+  PIXELFORMAT_BC4_UNORM = VK_FORMAT_BC4_UNORM_BLOCK,
+  PIXELFORMAT_BC5_UNORM = VK_FORMAT_BC5_UNORM_BLOCK,
+  PIXELFORMAT_BC6H_UFLOAT = VK_FORMAT_BC6H_UFLOAT_BLOCK,
+  PIXELFORMAT_BC6H_SFLOAT = VK_FORMAT_BC6H_SFLOAT_BLOCK,
+  PIXELFORMAT_BC7_UNORM = VK_FORMAT_BC7_UNORM_BLOCK,
+  PIXELFORMAT_ETC2_RGB8_UNORM = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+  PIXELFORMAT_ETC2_RGB8A1_UNORM = VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,
+  PIXELFORMAT_ETC2_RGBA8_UNORM = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+  PIXELFORMAT_ASTC_4x4_UNORM = VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+  PIXELFORMAT_ASTC_5x5_UNORM = VK_FORMAT_ASTC_5x5_UNORM_BLOCK,
+  PIXELFORMAT_ASTC_6x6_UNORM = VK_FORMAT_ASTC_6x6_UNORM_BLOCK,
+  PIXELFORMAT_ASTC_8x8_UNORM = VK_FORMAT_ASTC_8x8_UNORM_BLOCK
 };
 
 enum IndexFormat {
@@ -19,6 +19,7 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKGraphicsPipeline.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/graphics/CommandBuffer.h"
 #include "ngfx/graphics/GraphicsContext.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
@@ -34,6 +35,7 @@ void VKGraphicsPipeline::create(
     const std::vector<VkVertexInputAttributeDescription> &vertexInputAttributes,
     const std::vector<VKPipeline::ShaderStage> &shaderStages,
     VkFormat colorFormat) {
+  NGFX_TRACE_ZONE("pipeline", "createGraphicsPipeline");
   this->device = vk(ctx->device)->v;
   VkResult vkResult;
 
@@ -20,6 +20,7 @@
  */
 #include "ngfx/porting/vulkan/VKImage.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
+#include "ngfx/graphics/MemoryTracker.h"
 using namespace ngfx;
 
 void VKImage::create(VKDevice *vkDevice, VkExtent3D extent, VkFormat format,
@@ -58,16 +59,39 @@ void VKImage::create(VKDevice *vkDevice, const VKImageCreateInfo &createInfo,
   VkMemoryRequirements memReqs = {};
   vkGetImageMemoryRequirements(device, v, &memReqs);
 
+  // Transient attachments are never backed by memory on tile-based GPUs,
+  // so use lazily allocated memory when the device exposes it
+  VkMemoryPropertyFlags preferredMemoryPropertyFlags =
+      (createInfo.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+          ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+          : 0;
+  auto vkPhysicalDevice = vkDevice->vkPhysicalDevice;
   VkMemoryAllocateInfo memAllloc = {};
   memAllloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
   memAllloc.allocationSize = memReqs.size;
-  memAllloc.memoryTypeIndex = vkDevice->vkPhysicalDevice->getMemoryType(
-      memReqs.memoryTypeBits, memoryPropertyFlags);
+  memAllloc.memoryTypeIndex = vkPhysicalDevice->getMemoryType(
+      memReqs.memoryTypeBits, memoryPropertyFlags, preferredMemoryPropertyFlags);
+  this->memoryPropertyFlags = vkPhysicalDevice->deviceMemoryProperties
+                                  .memoryTypes[memAllloc.memoryTypeIndex]
+                                  .propertyFlags;
   V(vkAllocateMemory(device, &memAllloc, nullptr, &memory));
   V(vkBindImageMemory(device, v, memory, 0));
+  memoryTracker = vkDevice->memoryTracker;
+  if (memoryTracker) {
+    const VkImageUsageFlags attachmentUsageFlags =
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+        VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    memoryTracker->onAllocate(
+        this,
+        (createInfo.usage & attachmentUsageFlags) ? MEMORY_CATEGORY_ATTACHMENT
+                                                  : MEMORY_CATEGORY_TEXTURE,
+        memReqs.size,
+        (this->memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0);
+  }
 }
 
-void VKImage::changeLayout(VkCommandBuffer commandBuffer,
+void VKImage::changeLayout(VKCommandBuffer *commandBuffer,
                            VkImageLayout newLayout, VkAccessFlags dstAccessMask,
                            VkPipelineStageFlags dstStageMask,
                            VkImageAspectFlags aspectMask, uint32_t baseMipLevel,
@@ -93,8 +117,9 @@ void VKImage::changeLayout(VkCommandBuffer commandBuffer,
       VK_QUEUE_FAMILY_IGNORED,
       v,
       subresourceRange};
-  VK_TRACE(vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0,
-                                nullptr, 0, nullptr, 1, &imageMemoryBarrier));
+  VK_TRACE(vkCmdPipelineBarrier(commandBuffer->v, srcStageMask, dstStageMask, 0,
+                                0, nullptr, 0, nullptr, 1, &imageMemoryBarrier));
+  commandBuffer->stats.numBarriers++;
   for (uint32_t layer = baseArrayLayer; layer < (baseArrayLayer + layerCount);
        layer++) {
     for (uint32_t level = baseMipLevel; level < (baseMipLevel + levelCount);
@@ -112,4 +137,6 @@ VKImage::~VKImage() {
     VK_TRACE(vkDestroyImage(device, v, nullptr));
   if (memory)
     VK_TRACE(vkFreeMemory(device, memory, nullptr));
+  if (memoryTracker)
+    memoryTracker->onFree(this);
 }
@@ -19,6 +19,7 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/porting/vulkan/VKCommandBuffer.h"
 #include "ngfx/porting/vulkan/VKDevice.h"
 #include "ngfx/porting/vulkan/VKImageCreateInfo.h"
 #include <vulkan/vulkan.h>
@@ -37,7 +38,7 @@ public:
   void create(VKDevice *vkDevice, const VKImageCreateInfo &createInfo,
               VkMemoryPropertyFlags memoryPropertyFlags =
                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-  void changeLayout(VkCommandBuffer commandBuffer, VkImageLayout newLayout,
+  void changeLayout(VKCommandBuffer *commandBuffer, VkImageLayout newLayout,
                     VkImageAspectFlags dstAccessMask,
                     VkPipelineStageFlags dstStageMask,
                     VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -46,6 +47,7 @@ public:
   virtual ~VKImage();
   VkImage v = VK_NULL_HANDLE;
   VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkMemoryPropertyFlags memoryPropertyFlags = 0;
   std::vector<VkImageLayout> imageLayout;
   std::vector<VkAccessFlags> accessMask;
   std::vector<VkPipelineStageFlags> stageMask;
@@ -53,5 +55,6 @@ public:
 
 private:
   VkDevice device;
+  MemoryTracker *memoryTracker = nullptr;
 };
 } // namespace ngfx
@@ -34,6 +34,18 @@ void VKInstance::create(const char *appName, const char *engineName,
   appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
   appInfo.pApplicationName = appName;
   appInfo.pEngineName = engineName;
+  if (apiVersion == 0) {
+    // Use Vulkan 1.1 if supported by the loader, for subgroup operations
+    apiVersion = VK_API_VERSION_1_0;
+    auto enumerateInstanceVersion =
+        (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(
+            nullptr, "vkEnumerateInstanceVersion");
+    uint32_t instanceVersion;
+    if (enumerateInstanceVersion &&
+        enumerateInstanceVersion(&instanceVersion) == VK_SUCCESS &&
+        instanceVersion >= VK_API_VERSION_1_1)
+      apiVersion = VK_API_VERSION_1_1;
+  }
   appInfo.apiVersion = apiVersion;
 
   // Get instance layer properties
@@ -43,6 +55,14 @@ void VKInstance::create(const char *appName, const char *engineName,
   vkEnumerateInstanceLayerProperties(&instanceLayerCount,
                                      instanceLayerProperties.data());
 
+  // Get instance extension properties
+  uint32_t instanceExtensionCount;
+  vkEnumerateInstanceExtensionProperties(nullptr, &instanceExtensionCount,
+                                         nullptr);
+  instanceExtensionProperties.resize(instanceExtensionCount);
+  vkEnumerateInstanceExtensionProperties(nullptr, &instanceExtensionCount,
+                                         instanceExtensionProperties.data());
+
   // Set instance layers
   if (settings.enableValidation) {
     const char *validationLayerName = "VK_LAYER_KHRONOS_validation";
@@ -66,6 +86,11 @@ void VKInstance::create(const char *appName, const char *engineName,
       instanceExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
   }
+  // Required by VK_EXT_memory_budget on Vulkan 1.0
+  if (hasInstanceExtension(
+          VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+    instanceExtensions.push_back(
+        VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
   createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -88,6 +113,15 @@ bool VKInstance::hasInstanceLayer(const char *name) {
   return false;
 }
 
+bool VKInstance::hasInstanceExtension(const char *name) {
+  for (VkExtensionProperties &props : instanceExtensionProperties) {
+    if (strcmp(props.extensionName, name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 VKInstance::~VKInstance() {
   if (v)
     VK_TRACE(vkDestroyInstance(v, nullptr));
@@ -26,16 +26,22 @@
 namespace ngfx {
 class VKInstance {
 public:
+  /** Create the instance
+   *  @param apiVersion The Vulkan API version, or 0 to use the highest
+   *  version supported by the loader, up to Vulkan 1.1
+   */
   void create(const char *appName, const char *engineName, uint32_t apiVersion,
               bool enableValidation);
   virtual ~VKInstance();
   bool hasInstanceLayer(const char *name);
+  bool hasInstanceExtension(const char *name);
   struct {
     bool enableValidation = false;
   } settings;
   std::vector<const char *> instanceExtensions;
   std::vector<const char *> instanceLayers;
   std::vector<VkLayerProperties> instanceLayerProperties;
+  std::vector<VkExtensionProperties> instanceExtensionProperties;
   VkInstance v = VK_NULL_HANDLE;
   VkInstanceCreateInfo createInfo;
   VkApplicationInfo appInfo;
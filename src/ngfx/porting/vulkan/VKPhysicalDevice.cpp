@@ -122,24 +122,106 @@ void VKPhysicalDevice::chooseDepthFormat() {
 
 uint32_t
 VKPhysicalDevice::getMemoryType(uint32_t type,
-                                VkMemoryPropertyFlags memoryPropertyFlags) {
-  for (uint32_t i = 0; i < deviceMemoryProperties.memoryTypeCount; i++) {
-    if ((type & 1) == 1) {
-      auto &memoryType = deviceMemoryProperties.memoryTypes[i];
-      if ((memoryType.propertyFlags & memoryPropertyFlags) ==
-          memoryPropertyFlags) {
-        return i;
+                                VkMemoryPropertyFlags memoryPropertyFlags,
+                                VkMemoryPropertyFlags preferredMemoryPropertyFlags) {
+  int32_t index = findMemoryType(deviceMemoryProperties, type,
+                                 memoryPropertyFlags, preferredMemoryPropertyFlags);
+  if (index == -1)
+    NGFX_ERR("Could not find a matching memory type");
+  return uint32_t(index);
+}
+
+int32_t VKPhysicalDevice::findMemoryType(
+    const VkPhysicalDeviceMemoryProperties &memoryProperties, uint32_t type,
+    VkMemoryPropertyFlags memoryPropertyFlags,
+    VkMemoryPropertyFlags preferredMemoryPropertyFlags) {
+  auto findMatch = [&](VkMemoryPropertyFlags flags) -> int32_t {
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+      if ((type >> i) & 1) {
+        auto &memoryType = memoryProperties.memoryTypes[i];
+        if ((memoryType.propertyFlags & flags) == flags)
+          return int32_t(i);
       }
     }
-    type >>= 1;
+    return -1;
+  };
+  int32_t index = -1;
+  if (preferredMemoryPropertyFlags)
+    index = findMatch(memoryPropertyFlags | preferredMemoryPropertyFlags);
+  if (index == -1)
+    index = findMatch(memoryPropertyFlags);
+  return index;
+}
+
+bool VKPhysicalDevice::getMemoryBudget(uint64_t &budget, uint64_t &usage) {
+  if (!getPhysicalDeviceMemoryProperties2)
+    return false;
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+  VkPhysicalDeviceMemoryProperties2KHR memoryProperties2 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR,
+      &memoryBudgetProperties};
+  getPhysicalDeviceMemoryProperties2(v, &memoryProperties2);
+  budget = 0;
+  usage = 0;
+  auto &memoryProperties = memoryProperties2.memoryProperties;
+  for (uint32_t j = 0; j < memoryProperties.memoryHeapCount; j++) {
+    if (!(memoryProperties.memoryHeaps[j].flags &
+          VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+      continue;
+    budget += memoryBudgetProperties.heapBudget[j];
+    usage += memoryBudgetProperties.heapUsage[j];
   }
-  NGFX_ERR("Could not find a matching memory type");
-  return 0;
+  return true;
+}
+
+void VKPhysicalDevice::getSubgroupProperties() {
+  apiVersion = std::min(apiVersion, deviceProperties.apiVersion);
+  if (apiVersion < VK_API_VERSION_1_1)
+    return;
+  auto getPhysicalDeviceProperties2 =
+      (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(
+          instance, "vkGetPhysicalDeviceProperties2");
+  if (!getPhysicalDeviceProperties2)
+    return;
+  VkPhysicalDeviceProperties2 deviceProperties2 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &subgroupProperties};
+  getPhysicalDeviceProperties2(v, &deviceProperties2);
+}
+
+void VKPhysicalDevice::getHostQueryResetFeatures() {
+  if (apiVersion < VK_API_VERSION_1_1 ||
+      !extensionSupported(VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME))
+    return;
+  auto getPhysicalDeviceFeatures2 =
+      (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(
+          instance, "vkGetPhysicalDeviceFeatures2");
+  if (!getPhysicalDeviceFeatures2)
+    return;
+  VkPhysicalDeviceFeatures2 deviceFeatures2 = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &hostQueryResetFeatures};
+  getPhysicalDeviceFeatures2(v, &deviceFeatures2);
+}
+
+void VKPhysicalDevice::getMemoryBudgetFunction() {
+  if (!extensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    return;
+  // The function is core in Vulkan 1.1
+  getPhysicalDeviceMemoryProperties2 =
+      (PFN_vkGetPhysicalDeviceMemoryProperties2KHR)vkGetInstanceProcAddr(
+          instance, apiVersion >= VK_API_VERSION_1_1
+                        ? "vkGetPhysicalDeviceMemoryProperties2"
+                        : "vkGetPhysicalDeviceMemoryProperties2KHR");
 }
 
-void VKPhysicalDevice::create(VkInstance instance) {
+void VKPhysicalDevice::create(VkInstance instance, uint32_t apiVersion) {
+  this->instance = instance;
+  this->apiVersion = apiVersion;
   selectDevice(instance);
   getProperties();
+  getSubgroupProperties();
+  getHostQueryResetFeatures();
+  getMemoryBudgetFunction();
   chooseDepthFormat();
   chooseDepthStencilFormat();
 }
@@ -25,11 +25,32 @@
 namespace ngfx {
 class VKPhysicalDevice {
 public:
-  void create(VkInstance instance);
+  void create(VkInstance instance, uint32_t apiVersion = VK_API_VERSION_1_0);
   virtual ~VKPhysicalDevice();
   bool extensionSupported(std::string extension);
   uint32_t getMemoryType(uint32_t typeBits,
-                         VkMemoryPropertyFlags memoryPropertyFlags);
+                         VkMemoryPropertyFlags memoryPropertyFlags,
+                         VkMemoryPropertyFlags preferredMemoryPropertyFlags = 0);
+  /** Find a memory type allowed by typeBits with all the required flags,
+   *  preferring a type that also has all the preferred flags.
+   *  Returns -1 if there's no matching memory type */
+  static int32_t
+  findMemoryType(const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                 uint32_t typeBits, VkMemoryPropertyFlags memoryPropertyFlags,
+                 VkMemoryPropertyFlags preferredMemoryPropertyFlags = 0);
+  /** Query the memory budget and usage of the device local heaps.
+   *  Requires VK_EXT_memory_budget.  Returns false if the query is not supported */
+  bool getMemoryBudget(uint64_t &budget, uint64_t &usage);
+  VkInstance instance = VK_NULL_HANDLE;
+  /** The API version supported by both the instance and the device */
+  uint32_t apiVersion = VK_API_VERSION_1_0;
+  /** The subgroup properties, if the API version is at least Vulkan 1.1 */
+  VkPhysicalDeviceSubgroupProperties subgroupProperties = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES};
+  /** The host query reset features, if the API version is at least Vulkan 1.1
+   *  and VK_EXT_host_query_reset is supported */
+  VkPhysicalDeviceHostQueryResetFeaturesEXT hostQueryResetFeatures = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES_EXT};
   VkPhysicalDevice v = VK_NULL_HANDLE;
   VkPhysicalDeviceProperties deviceProperties;
   VkPhysicalDeviceFeatures deviceFeatures;
@@ -43,5 +64,11 @@ private:
   void chooseDepthStencilFormat();
   void selectDevice(VkInstance instance);
   void getProperties();
+  void getSubgroupProperties();
+  void getHostQueryResetFeatures();
+  void getMemoryBudgetFunction();
+  /** Resolved in create if VK_EXT_memory_budget is supported */
+  PFN_vkGetPhysicalDeviceMemoryProperties2KHR
+      getPhysicalDeviceMemoryProperties2 = nullptr;
 };
 }; // namespace ngfx
@@ -19,20 +19,126 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKQueryPool.h"
+#include "ngfx/porting/vulkan/VKCommandBuffer.h"
 #include "ngfx/porting/vulkan/VKGraphicsContext.h"
 using namespace ngfx;
 
-void VKQueryPool::create(VkDevice device, VkQueryType queryType, uint32_t queryCount) {
-    VkResult vkResult;
-    this->device = device;
-    const VkQueryPoolCreateInfo createInfo = {
-        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0,
-        queryType, queryCount, 0
-    };
-    V(vkCreateQueryPool(device, &createInfo, nullptr, &v));
+// The counters of PipelineStatistics, in the order of the flag bits
+static const VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+void VKQueryPool::create(VKGraphicsContext *ctx, QueryType queryType,
+                         uint32_t queryCount) {
+  auto &physicalDevice = ctx->vkPhysicalDevice;
+  type = queryType;
+  resetQueryPool = ctx->vkDevice.resetQueryPool;
+  if (queryType == QUERY_TYPE_TIMESTAMP) {
+    create(ctx->vkDevice.v, VK_QUERY_TYPE_TIMESTAMP, queryCount);
+    timestampPeriod = physicalDevice.deviceProperties.limits.timestampPeriod;
+    uint32_t validBits =
+        physicalDevice
+            .queueFamilyProperties[ctx->vkDevice.queueFamilyIndices.graphics]
+            .timestampValidBits;
+    if (validBits != 0 && validBits < 64)
+      timestampMask = (1ull << validBits) - 1;
+  } else if (queryType == QUERY_TYPE_OCCLUSION) {
+    create(ctx->vkDevice.v, VK_QUERY_TYPE_OCCLUSION, queryCount);
+    occlusionQueryPrecise = ctx->vkDevice.enabledFeatures.occlusionQueryPrecise;
+  } else {
+    create(ctx->vkDevice.v, VK_QUERY_TYPE_PIPELINE_STATISTICS, queryCount,
+           PIPELINE_STATISTICS);
+  }
+}
+
+void VKQueryPool::create(VkDevice device, VkQueryType queryType,
+                         uint32_t queryCount,
+                         VkQueryPipelineStatisticFlags pipelineStatistics) {
+  VkResult vkResult;
+  this->device = device;
+  this->count = queryCount;
+  const VkQueryPoolCreateInfo createInfo = {
+      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0,
+      queryType, queryCount, pipelineStatistics};
+  V(vkCreateQueryPool(device, &createInfo, nullptr, &v));
 }
 
 VKQueryPool::~VKQueryPool() {
-    vkDestroyQueryPool(device, v, nullptr);
+  if (v)
+    VK_TRACE(vkDestroyQueryPool(device, v, nullptr));
+}
+
+void VKQueryPool::reset(CommandBuffer *commandBuffer, uint32_t first,
+                        uint32_t count) {
+  if (count == 0)
+    count = this->count - first;
+  VK_TRACE(vkCmdResetQueryPool(vk(commandBuffer)->v, v, first, count));
+}
+
+bool VKQueryPool::hostReset(uint32_t first, uint32_t count) {
+  if (!resetQueryPool)
+    return false;
+  if (count == 0)
+    count = this->count - first;
+  VK_TRACE(resetQueryPool(device, v, first, count));
+  return true;
+}
+
+void VKQueryPool::writeTimestamp(CommandBuffer *commandBuffer, uint32_t query) {
+  VK_TRACE(vkCmdWriteTimestamp(vk(commandBuffer)->v,
+                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, v, query));
+}
+
+void VKQueryPool::begin(CommandBuffer *commandBuffer, uint32_t query,
+                        bool precise) {
+  // Without the occlusionQueryPrecise feature, the result is only zero or non-zero
+  VkQueryControlFlags flags = (precise && occlusionQueryPrecise)
+                                  ? VK_QUERY_CONTROL_PRECISE_BIT
+                                  : 0;
+  VK_TRACE(vkCmdBeginQuery(vk(commandBuffer)->v, v, query, flags));
+}
+
+void VKQueryPool::end(CommandBuffer *commandBuffer, uint32_t query) {
+  VK_TRACE(vkCmdEndQuery(vk(commandBuffer)->v, v, query));
+}
+
+bool VKQueryPool::getResults(uint32_t first, uint32_t count,
+                             uint64_t *results, bool wait) {
+  // Without VK_QUERY_RESULT_WAIT_BIT, VK_NOT_READY is returned until all the
+  // queries are available
+  VkDeviceSize stride = getNumValues() * sizeof(uint64_t);
+  VkResult vkResult = vkGetQueryPoolResults(
+      device, v, first, count, count * stride, results, stride,
+      VK_QUERY_RESULT_64_BIT | (wait ? VK_QUERY_RESULT_WAIT_BIT : 0));
+  if (vkResult == VK_NOT_READY)
+    return false;
+  if (vkResult != VK_SUCCESS)
+    NGFX_ERR("vkGetQueryPoolResults failed: %d", vkResult);
+  return true;
 }
 
+QueryPool *QueryPool::create(GraphicsContext *ctx, QueryType type,
+                             uint32_t count) {
+  auto vkCtx = vk(ctx);
+  auto &deviceFeatures = vkCtx->vkDevice.enabledFeatures;
+  if (type == QUERY_TYPE_PIPELINE_STATISTICS &&
+      !deviceFeatures.pipelineStatisticsQuery) {
+    NGFX_LOG("pipeline statistics queries are not supported by the device");
+    return nullptr;
+  }
+  if (type == QUERY_TYPE_TIMESTAMP &&
+      vkCtx->vkPhysicalDevice
+              .queueFamilyProperties[vkCtx->vkDevice.queueFamilyIndices.graphics]
+              .timestampValidBits == 0) {
+    NGFX_LOG("the graphics queue doesn't support timestamps");
+    return nullptr;
+  }
+  auto vkQueryPool = new VKQueryPool();
+  vkQueryPool->create(vkCtx, type, count);
+  return vkQueryPool;
+}
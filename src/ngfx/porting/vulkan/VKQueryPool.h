@@ -19,16 +19,35 @@
  * under the License.
  */
 #pragma once
+#include "ngfx/graphics/QueryPool.h"
+#include "ngfx/porting/vulkan/VKUtil.h"
 #include <vulkan/vulkan.h>
 
 namespace ngfx {
 class VKGraphicsContext;
-class VKQueryPool {
+class VKQueryPool : public QueryPool {
 public:
-    void create(VkDevice device, VkQueryType queryType, uint32_t queryCount);
+  void create(VKGraphicsContext *ctx, QueryType queryType, uint32_t queryCount);
+  void create(VkDevice device, VkQueryType queryType, uint32_t queryCount,
+              VkQueryPipelineStatisticFlags pipelineStatistics = 0);
   virtual ~VKQueryPool();
+  void reset(CommandBuffer *commandBuffer, uint32_t first = 0,
+             uint32_t count = 0) override;
+  bool hostReset(uint32_t first = 0, uint32_t count = 0) override;
+  void writeTimestamp(CommandBuffer *commandBuffer, uint32_t query) override;
+  void begin(CommandBuffer *commandBuffer, uint32_t query,
+             bool precise = false) override;
+  void end(CommandBuffer *commandBuffer, uint32_t query) override;
+  bool getResults(uint32_t first, uint32_t count, uint64_t *results,
+                  bool wait = false) override;
+  using QueryPool::getResults;
   VkQueryPool v = VK_NULL_HANDLE;
+
 private:
   VkDevice device;
+  bool occlusionQueryPrecise = false;
+  /** vkResetQueryPoolEXT, or nullptr if the device doesn't support it */
+  PFN_vkResetQueryPoolEXT resetQueryPool = nullptr;
 };
+VK_CAST(QueryPool);
 } // namespace ngfx
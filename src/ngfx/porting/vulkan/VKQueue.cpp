@@ -19,6 +19,7 @@
  * under the License.
  */
 #include "ngfx/porting/vulkan/VKQueue.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/porting/vulkan/VKCommandBuffer.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
 #include "ngfx/porting/vulkan/VKFence.h"
@@ -35,6 +36,7 @@ void VKQueue::create(VKGraphicsContext *ctx, int queueFamilyIndex,
 VKQueue::~VKQueue() {}
 
 void VKQueue::present() {
+  NGFX_TRACE_ZONE("submit", "present");
   VkResult vkResult;
   Swapchain *swapChain = ctx->swapchain;
   uint32_t currentImageIndex = ctx->currentImageIndex;
@@ -70,6 +72,7 @@ void VKQueue::submit(CommandBuffer *commandBuffer,
                      const std::vector<Semaphore *> &waitSemaphores,
                      const std::vector<Semaphore *> &signalSemaphores,
                      Fence *waitFence) {
+  NGFX_TRACE_ZONE("submit", "submit");
   VkResult vkResult;
   std::vector<VkSemaphore> vkWaitSemaphores(waitSemaphores.size());
   for (size_t j = 0; j < waitSemaphores.size(); j++)
@@ -91,6 +94,7 @@ void VKQueue::submit(CommandBuffer *commandBuffer,
 }
 
 void VKQueue::waitIdle() {
+  NGFX_TRACE_ZONE("submit", "waitIdle");
   VkResult vkResult;
   V(vkQueueWaitIdle(v));
 }
@@ -20,6 +20,7 @@
  */
 #include "ngfx/porting/vulkan/VKShaderModule.h"
 #include "ngfx/core/File.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/graphics/Config.h"
 #include "ngfx/porting/vulkan/VKDebugUtil.h"
 #include "ngfx/porting/vulkan/VKDevice.h"
@@ -41,6 +42,7 @@ bool VKShaderModule::initFromFile(VkDevice device,
 }
 void VKShaderModule::initFromByteCode(VkDevice device, void *data,
                                       uint32_t size) {
+  NGFX_TRACE_ZONE("shader", "createShaderModule");
   this->device = device;
   VkResult vkResult;
   VkShaderModuleCreateInfo moduleCreateInfo = {
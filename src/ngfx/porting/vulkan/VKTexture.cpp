@@ -25,6 +25,8 @@
 #include "ngfx/porting/vulkan/VKComputePipeline.h"
 #include "ngfx/porting/vulkan/VKGraphicsPipeline.h"
 #include "ngfx/porting/vulkan/VKQueue.h"
+#include "ngfx/core/HashUtil.h"
+#include "ngfx/core/Trace.h"
 #include "ngfx/graphics/FormatUtil.h"
 #include <algorithm>
 using namespace ngfx;
@@ -34,7 +36,7 @@ void VKTexture::create(VKGraphicsContext *ctx, void *data, uint32_t size,
                        VkImageUsageFlags imageUsageFlags,
                        VkImageViewType imageViewType, bool genMipmaps,
                        VKSamplerCreateInfo *pSamplerCreateInfo,
-                       uint32_t numSamples) {
+                       uint32_t numSamples, uint32_t numMipLevels) {
   this->ctx = ctx;
   this->w = extent.width;
   this->h = extent.height;
@@ -42,6 +44,7 @@ void VKTexture::create(VKGraphicsContext *ctx, void *data, uint32_t size,
   this->arrayLayers = arrayLayers;
   this->numSamples = numSamples;
   this->vkFormat = format;
+  this->format = PixelFormat(format);
   this->imageUsageFlags = imageUsageFlags;
   this->genMipmaps = genMipmaps;
   this->samplerCreateInfo.reset(pSamplerCreateInfo);
@@ -57,9 +60,14 @@ void VKTexture::create(VKGraphicsContext *ctx, void *data, uint32_t size,
     imageType = VK_IMAGE_TYPE_2D;
   else
     imageType = VK_IMAGE_TYPE_3D;
-  this->mipLevels =
-      genMipmaps ? floor(log2(float(glm::min(extent.width, extent.height)))) + 1
-                 : 1;
+  if (genMipmaps && FormatUtil::isCompressed(this->format))
+    NGFX_ERR("cannot generate mipmaps for block-compressed format: %d", format);
+  if (numMipLevels)
+    this->mipLevels = numMipLevels;
+  else
+    this->mipLevels =
+        genMipmaps ? floor(log2(float(glm::min(extent.width, extent.height)))) + 1
+                   : 1;
   vkImage.create(&ctx->vkDevice, extent, format, imageUsageFlags, imageType,
                  mipLevels, arrayLayers, numSamples,
                  (imageViewType == VK_IMAGE_VIEW_TYPE_CUBE)
@@ -73,43 +81,49 @@ void VKTexture::create(VKGraphicsContext *ctx, void *data, uint32_t size,
     stagingBuffer->create(ctx, data, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
   }
   copyCommandBuffer.begin();
-  uploadFn(copyCommandBuffer.v, data, size, stagingBuffer.get());
+  // Include the copies and barriers in Graphics::getStats
+  ctx->getRecordingStats(&copyCommandBuffer);
+  uploadFn(&copyCommandBuffer, data, size, stagingBuffer.get());
 
   if (imageUsageFlags & IMAGE_USAGE_SAMPLED_BIT) {
-    if (genMipmaps)
+    if (mipLevels > 1)
       samplerCreateInfo->maxLod = mipLevels;
     if (!sampler)
         initSampler();
   }
 
+  setDefaultLayout(&copyCommandBuffer);
+  copyCommandBuffer.end();
+  vk(ctx->queue)->submit(&copyCommandBuffer, 0, {}, {}, nullptr);
+  ctx->queue->waitIdle();
+}
+
+void VKTexture::setDefaultLayout(VKCommandBuffer *cmdBuffer) {
   if (imageUsageFlags & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
     vkImage.changeLayout(
-        copyCommandBuffer.v, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        cmdBuffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, aspectFlags);
   } else if (imageUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) {
-    vkImage.changeLayout(copyCommandBuffer.v, VK_IMAGE_LAYOUT_GENERAL,
+    vkImage.changeLayout(cmdBuffer, VK_IMAGE_LAYOUT_GENERAL,
                          VK_ACCESS_SHADER_READ_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, aspectFlags, 0,
                          mipLevels, 0, this->arrayLayers);
   } else if (imageUsageFlags & VK_IMAGE_USAGE_SAMPLED_BIT) {
     vkImage.changeLayout(
-        copyCommandBuffer.v, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         aspectFlags, 0, mipLevels, 0, this->arrayLayers);
   }
-  copyCommandBuffer.end();
-  vk(ctx->queue)->submit(&copyCommandBuffer, 0, {}, {}, nullptr);
-  ctx->queue->waitIdle();
 }
 
-VkDescriptorSet VKTexture::getSamplerDescriptorSet(VkCommandBuffer cmdBuffer) {
+VkDescriptorSet VKTexture::getSamplerDescriptorSet(VKCommandBuffer *cmdBuffer) {
     if (!samplerDescriptorSet)
         initSamplerDescriptorSet(cmdBuffer);
     return samplerDescriptorSet;
 }
 
-VkDescriptorSet VKTexture::getStorageImageDescriptorSet(VkCommandBuffer cmdBuffer) {
+VkDescriptorSet VKTexture::getStorageImageDescriptorSet(VKCommandBuffer *cmdBuffer) {
     if (!storageImageDescriptorSet)
         initStorageImageDescriptorSet(cmdBuffer);
     return storageImageDescriptorSet;
@@ -130,10 +144,11 @@ VkImageAspectFlags VKTexture::getImageAspectFlags(VkFormat format) {
 }
 
 void VKTexture::generateMipmaps(CommandBuffer *commandBuffer) {
-  generateMipmapsFn(vk(commandBuffer)->v);
+  ctx->getRecordingStats(commandBuffer);
+  generateMipmapsFn(vk(commandBuffer));
 }
 
-void VKTexture::generateMipmapsFn(VkCommandBuffer cmdBuffer) {
+void VKTexture::generateMipmapsFn(VKCommandBuffer *cmdBuffer) {
   vkImage.changeLayout(cmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                        VK_ACCESS_TRANSFER_READ_BIT,
                        VK_PIPELINE_STAGE_TRANSFER_BIT, aspectFlags, 0, 1, 0,
@@ -165,6 +180,7 @@ void VKTexture::upload(void *data, uint32_t size, uint32_t x, uint32_t y,
                        uint32_t z, int32_t w, int32_t h, int32_t d,
                        int32_t arrayLayers, int32_t numPlanes /* TODO */,
                        int32_t dataPitch /* TODO */) {
+  NGFX_TRACE_ZONE("transfer", "uploadTexture");
   auto &copyCommandBuffer = ctx->vkCopyCommandBuffer;
   std::unique_ptr<VKBuffer> stagingBuffer;
   if (data) {
@@ -172,30 +188,57 @@ void VKTexture::upload(void *data, uint32_t size, uint32_t x, uint32_t y,
     stagingBuffer->create(ctx, data, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
   }
   copyCommandBuffer.begin();
-  uploadFn(copyCommandBuffer.v, data, size, stagingBuffer.get(), x, y, z, w, h,
+  ctx->getRecordingStats(&copyCommandBuffer);
+  uploadFn(&copyCommandBuffer, data, size, stagingBuffer.get(), x, y, z, w, h,
            d, arrayLayers, numPlanes, dataPitch);
-  if (imageUsageFlags & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
-    vkImage.changeLayout(
-        copyCommandBuffer.v, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
-        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, aspectFlags);
-  } else if (imageUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) {
-    vkImage.changeLayout(copyCommandBuffer.v, VK_IMAGE_LAYOUT_GENERAL,
-                         VK_ACCESS_SHADER_READ_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, aspectFlags, 0,
-                         mipLevels, 0, this->arrayLayers);
-  } else if (imageUsageFlags & VK_IMAGE_USAGE_SAMPLED_BIT) {
-    vkImage.changeLayout(
-        copyCommandBuffer.v, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        aspectFlags, 0, mipLevels, 0, this->arrayLayers);
+  setDefaultLayout(&copyCommandBuffer);
+  copyCommandBuffer.end();
+  vk(ctx->queue)->submit(&copyCommandBuffer, 0, {}, {}, nullptr);
+  ctx->queue->waitIdle();
+}
+
+void VKTexture::uploadMipLevels(const std::vector<MipLevelData> &mipLevelData) {
+  NGFX_TRACE_ZONE("transfer", "uploadTexture");
+  // Each region's buffer offset must be a multiple of the texel block size
+  const uint32_t alignment = 16;
+  std::vector<uint32_t> offsets(mipLevelData.size());
+  uint32_t stagingBufferSize = 0;
+  for (uint32_t j = 0; j < mipLevelData.size(); j++) {
+    offsets[j] = stagingBufferSize;
+    stagingBufferSize += (mipLevelData[j].size + alignment - 1) / alignment * alignment;
+  }
+  std::unique_ptr<VKBuffer> stagingBuffer(new VKBuffer());
+  stagingBuffer->create(ctx, nullptr, stagingBufferSize,
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  std::vector<VkBufferImageCopy> bufferCopyRegions(mipLevelData.size());
+  for (uint32_t j = 0; j < mipLevelData.size(); j++) {
+    stagingBuffer->upload(mipLevelData[j].data, mipLevelData[j].size, offsets[j]);
+    bufferCopyRegions[j] = {
+        offsets[j],
+        0,
+        0,
+        {aspectFlags, j, 0, arrayLayers},
+        {0, 0, 0},
+        {glm::max(w >> j, 1u), glm::max(h >> j, 1u), glm::max(d >> j, 1u)}};
   }
+  auto &copyCommandBuffer = ctx->vkCopyCommandBuffer;
+  copyCommandBuffer.begin();
+  ctx->getRecordingStats(&copyCommandBuffer);
+  vkImage.changeLayout(&copyCommandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, aspectFlags, 0,
+                       uint32_t(mipLevelData.size()), 0, arrayLayers);
+  VK_TRACE(vkCmdCopyBufferToImage(
+      copyCommandBuffer.v, stagingBuffer->v, vkImage.v, vkImage.imageLayout[0],
+      uint32_t(bufferCopyRegions.size()), bufferCopyRegions.data()));
+  copyCommandBuffer.stats.numCopies++;
+  setDefaultLayout(&copyCommandBuffer);
   copyCommandBuffer.end();
   vk(ctx->queue)->submit(&copyCommandBuffer, 0, {}, {}, nullptr);
   ctx->queue->waitIdle();
 }
 
-void VKTexture::uploadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
+void VKTexture::uploadFn(VKCommandBuffer *cmdBuffer, void *data, uint32_t size,
                          VKBuffer *stagingBuffer, uint32_t x, uint32_t y,
                          uint32_t z, int32_t w, int32_t h, int32_t d,
                          int32_t arrayLayers, int32_t numPlanes, int32_t dataPitch) {
@@ -210,21 +253,25 @@ void VKTexture::uploadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
       arrayLayers = this->arrayLayers;
     if (numPlanes == -1)
       numPlanes = this->numPlanes;
-    uint32_t bpp = FormatUtil::getBytesPerPixel(format);
+    auto blockInfo = FormatUtil::getBlockInfo(format);
+    if ((x % blockInfo.w) || (y % blockInfo.h))
+      NGFX_ERR("upload offset: (%d, %d) is not aligned to the %dx%d block size",
+               x, y, blockInfo.w, blockInfo.h);
     vkImage.changeLayout(cmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                          VK_ACCESS_TRANSFER_WRITE_BIT,
                          VK_PIPELINE_STAGE_TRANSFER_BIT, aspectFlags, 0, 1, 0,
                          arrayLayers);
     std::vector<VkBufferImageCopy> bufferCopyRegions = {
         {0,
-         dataPitch == -1 ? 0 : uint32_t(dataPitch / bpp),
+         dataPitch == -1 ? 0 : uint32_t(dataPitch) / blockInfo.size * blockInfo.w,
          0,
          {aspectFlags, 0, 0, uint32_t(arrayLayers)},
          {int32_t(x), int32_t(y), int32_t(z)},
          {uint32_t(w), uint32_t(h), uint32_t(d)}}};
     VK_TRACE(vkCmdCopyBufferToImage(
-        cmdBuffer, stagingBuffer->v, vkImage.v, vkImage.imageLayout[0],
+        cmdBuffer->v, stagingBuffer->v, vkImage.v, vkImage.imageLayout[0],
         uint32_t(bufferCopyRegions.size()), bufferCopyRegions.data()));
+    cmdBuffer->stats.numCopies++;
   }
   if (data && mipLevels != 1)
     generateMipmapsFn(cmdBuffer);
@@ -233,13 +280,15 @@ void VKTexture::uploadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
 void VKTexture::download(void *data, uint32_t size, uint32_t x, uint32_t y,
                          uint32_t z, int32_t w, int32_t h, int32_t d,
                          int32_t arrayLayers, int32_t numPlanes /* TODO */) {
+  NGFX_TRACE_ZONE("transfer", "downloadTexture");
   auto &copyCommandBuffer = ctx->vkCopyCommandBuffer;
   std::unique_ptr<VKBuffer> stagingBuffer;
   stagingBuffer.reset(new VKBuffer());
   stagingBuffer->create(ctx, nullptr, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
 
   copyCommandBuffer.begin();
-  downloadFn(copyCommandBuffer.v, data, size, stagingBuffer.get(), x, y, z, w,
+  ctx->getRecordingStats(&copyCommandBuffer);
+  downloadFn(&copyCommandBuffer, data, size, stagingBuffer.get(), x, y, z, w,
              h, d, arrayLayers);
   copyCommandBuffer.end();
   vk(ctx->queue)->submit(&copyCommandBuffer, 0, {}, {}, nullptr);
@@ -247,7 +296,7 @@ void VKTexture::download(void *data, uint32_t size, uint32_t x, uint32_t y,
   stagingBuffer->download(data, size);
 }
 
-void VKTexture::downloadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
+void VKTexture::downloadFn(VKCommandBuffer *cmdBuffer, void *data, uint32_t size,
                            VKBuffer *stagingBuffer, uint32_t x, uint32_t y,
                            uint32_t z, int32_t w, int32_t h, int32_t d,
                            int32_t arrayLayers) {
@@ -271,22 +320,30 @@ void VKTexture::downloadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
        {int32_t(x), int32_t(y), int32_t(z)},
        {uint32_t(w), uint32_t(h), uint32_t(d)}}};
   VK_TRACE(vkCmdCopyImageToBuffer(
-      cmdBuffer, vkImage.v, vkImage.imageLayout[0], stagingBuffer->v,
+      cmdBuffer->v, vkImage.v, vkImage.imageLayout[0], stagingBuffer->v,
       uint32_t(bufferCopyRegions.size()), bufferCopyRegions.data()));
+  cmdBuffer->stats.numCopies++;
 }
 
 VKTexture::~VKTexture() {
+  if (ctx)
+    ctx->onTextureDestroyed(this);
   if (sampler)
     VK_TRACE(vkDestroySampler(ctx->vkDevice.v, sampler, nullptr));
 }
 
+void VKTexture::setName(const std::string &name) {
+  Texture::setName(name);
+  ctx->memoryTracker.setName(&vkImage, name);
+}
+
 void VKTexture::initSampler() {
   VkResult vkResult;
   V(vkCreateSampler(ctx->vkDevice.v, samplerCreateInfo.get(), nullptr,
                     &sampler));
 }
 
-void VKTexture::initSamplerDescriptorSet(VkCommandBuffer cmdBuffer) {
+void VKTexture::initSamplerDescriptorSet(VKCommandBuffer *cmdBuffer) {
   VkResult vkResult;
 
   vkImage.changeLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -303,6 +360,7 @@ void VKTexture::initSamplerDescriptorSet(VkCommandBuffer cmdBuffer) {
       1, &descriptorSetLayout};
   V(vkAllocateDescriptorSets(ctx->vkDevice.v, &allocInfo,
                              &samplerDescriptorSet));
+  ctx->memoryTracker.addDescriptorSets(&vkImage, 1);
   VkDescriptorImageInfo descriptorImageInfo = {sampler, vkDefaultImageView->v,
                                                vkImage.imageLayout[0]};
   VkWriteDescriptorSet writeDescriptorSet = {
@@ -320,7 +378,7 @@ void VKTexture::initSamplerDescriptorSet(VkCommandBuffer cmdBuffer) {
                                   nullptr));
 }
 
-void VKTexture::initStorageImageDescriptorSet(VkCommandBuffer cmdBuffer) {
+void VKTexture::initStorageImageDescriptorSet(VKCommandBuffer *cmdBuffer) {
   VkResult vkResult;
   vkImage.changeLayout(cmdBuffer, VK_IMAGE_LAYOUT_GENERAL,
                        VK_ACCESS_SHADER_READ_BIT,
@@ -334,6 +392,7 @@ void VKTexture::initStorageImageDescriptorSet(VkCommandBuffer cmdBuffer) {
       1, &descriptorSetLayout};
   V(vkAllocateDescriptorSets(ctx->vkDevice.v, &allocInfo,
                              &storageImageDescriptorSet));
+  ctx->memoryTracker.addDescriptorSets(&vkImage, 1);
   VkDescriptorImageInfo descriptorImageInfo = {sampler, vkDefaultImageView->v,
                                                vkImage.imageLayout[0]};
   VkWriteDescriptorSet writeDescriptorSet = {
@@ -353,24 +412,25 @@ void VKTexture::initStorageImageDescriptorSet(VkCommandBuffer cmdBuffer) {
 
 void VKTexture::changeLayout(CommandBuffer *commandBuffer,
                              ImageLayout imageLayout) {
+  ctx->getRecordingStats(commandBuffer);
   if (imageLayout == IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
-    vkImage.changeLayout(vk(commandBuffer)->v, VkImageLayout(imageLayout),
+    vkImage.changeLayout(vk(commandBuffer), VkImageLayout(imageLayout),
                          VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
                              VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
                          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
                          aspectFlags, 0, mipLevels, 0, arrayLayers);
   } else if (imageLayout == IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-    vkImage.changeLayout(vk(commandBuffer)->v, VkImageLayout(imageLayout),
+    vkImage.changeLayout(vk(commandBuffer), VkImageLayout(imageLayout),
                          VK_ACCESS_SHADER_READ_BIT,
                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, aspectFlags, 0,
                          mipLevels, 0, arrayLayers);
   } else if (imageLayout == IMAGE_LAYOUT_GENERAL) {
-    vkImage.changeLayout(vk(commandBuffer)->v, VkImageLayout(imageLayout),
+    vkImage.changeLayout(vk(commandBuffer), VkImageLayout(imageLayout),
                          VK_ACCESS_SHADER_READ_BIT,
                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, aspectFlags, 0,
                          mipLevels, 0, arrayLayers);
   } else if (imageLayout == IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-    vkImage.changeLayout(vk(commandBuffer)->v, VkImageLayout(imageLayout),
+    vkImage.changeLayout(vk(commandBuffer), VkImageLayout(imageLayout),
                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
                              VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
@@ -386,15 +446,19 @@ VKImageView *VKTexture::getImageView(VkImageViewType imageViewType,
   VKImageViewCreateInfo imageViewCreateInfo(vkImage.v, imageViewType, vkFormat,
                                             aspectFlags, mipLevels, arrayLayers,
                                             baseMipLevel, baseArrayLayer);
-  for (auto &imageView : vkImageViewCache) {
-    if (imageView->createInfo == imageViewCreateInfo) {
-      return imageView.get();
+  size_t key = HashUtil::combine(imageViewType, mipLevels, arrayLayers,
+                                 baseMipLevel, baseArrayLayer);
+  auto range = vkImageViewCache.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->createInfo == imageViewCreateInfo) {
+      return it->second.get();
     }
   }
   auto vkImageView = std::make_unique<VKImageView>();
   vkImageView->create(ctx->vkDevice.v, imageViewCreateInfo);
+  ctx->memoryTracker.addImageViews(&vkImage, 1);
   auto result = vkImageView.get();
-  vkImageViewCache.push_back(std::move(vkImageView));
+  vkImageViewCache.emplace(key, std::move(vkImageView));
   return result;
 }
 
@@ -421,3 +485,32 @@ Texture *Texture::create(GraphicsContext* graphicsContext, Graphics* graphics, v
   vkTexture->format = format;
   return vkTexture;
 }
+
+Texture *Texture::createFromMipLevels(GraphicsContext* graphicsContext, Graphics* graphics,
+    const std::vector<MipLevelData> &mipLevelData,
+    PixelFormat format, uint32_t w, uint32_t h, uint32_t d,
+    uint32_t arrayLayers, ImageUsageFlags imageUsageFlags,
+    TextureType textureType, SamplerDesc* samplerDesc) {
+  uint32_t maxMipLevels = getMaxMipLevels(w, h, d);
+  if (mipLevelData.empty() || mipLevelData.size() > maxMipLevels)
+    NGFX_ERR("number of mip levels: %d exceeds the full mip chain: %d",
+             int(mipLevelData.size()), maxMipLevels);
+  VKTexture *vkTexture = new VKTexture();
+  VKSamplerCreateInfo *samplerCreateInfo = nullptr;
+  if (imageUsageFlags & IMAGE_USAGE_SAMPLED_BIT) {
+    samplerCreateInfo = new VKSamplerCreateInfo;
+    if (samplerDesc) {
+      samplerCreateInfo->minFilter = VkFilter(samplerDesc->minFilter);
+      samplerCreateInfo->magFilter = VkFilter(samplerDesc->magFilter);
+      samplerCreateInfo->mipmapMode = (samplerDesc->mipFilter == FILTER_LINEAR)
+                                          ? VK_SAMPLER_MIPMAP_MODE_LINEAR
+                                          : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    }
+  }
+  vkTexture->create(vk(graphicsContext), nullptr, 0, {w, h, d}, arrayLayers,
+                    VkFormat(format), imageUsageFlags,
+                    VkImageViewType(textureType), false, samplerCreateInfo,
+                    1, uint32_t(mipLevelData.size()));
+  vkTexture->uploadMipLevels(mipLevelData);
+  return vkTexture;
+}
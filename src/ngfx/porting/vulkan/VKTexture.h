@@ -33,12 +33,13 @@ public:
               VkExtent3D extent, uint32_t arrayLayers, VkFormat format,
               VkImageUsageFlags imageUsageFlags, VkImageViewType imageViewType,
               bool genMipmaps, VKSamplerCreateInfo *pSamplerCreateInfo,
-              uint32_t numSamples = 1);
+              uint32_t numSamples = 1, uint32_t numMipLevels = 0);
   virtual ~VKTexture();
   void upload(void *data, uint32_t size, uint32_t x = 0, uint32_t y = 0,
               uint32_t z = 0, int32_t w = -1, int32_t h = -1, int32_t d = -1,
               int32_t arrayLayers = -1, int32_t numPlanes = -1,
               int32_t dataPitch = -1) override;
+  void uploadMipLevels(const std::vector<MipLevelData> &mipLevelData);
   void download(void *data, uint32_t size, uint32_t x = 0, uint32_t y = 0,
                 uint32_t z = 0, int32_t w = -1, int32_t h = -1, int32_t d = -1,
                 int32_t arrayLayers = -1, int32_t numPlanes = -1) override;
@@ -48,36 +49,38 @@ public:
   void changeLayout(CommandBuffer *commandBuffer,
                     ImageLayout imageLayout) override;
   void generateMipmaps(CommandBuffer *commandBuffer) override;
+  void setName(const std::string &name) override;
   VKImageView *getImageView(VkImageViewType imageViewType, uint32_t mipLevels,
                             uint32_t arrayLayers, uint32_t baseMipLevel = 0,
                             uint32_t baseArrayLayer = 0);
   VkFormat vkFormat;
   VKImage vkImage;
-  std::vector<std::unique_ptr<VKImageView>> vkImageViewCache;
+  std::unordered_multimap<size_t, std::unique_ptr<VKImageView>> vkImageViewCache;
   VKImageView *vkDefaultImageView = nullptr;
   VkSampler sampler = 0;
   VkImageAspectFlags aspectFlags;
   bool genMipmaps = false;
   std::unique_ptr<VKSamplerCreateInfo> samplerCreateInfo;
   uint32_t numPlanes = 1;
-  VkDescriptorSet getSamplerDescriptorSet(VkCommandBuffer cmdBuffer);
-  VkDescriptorSet getStorageImageDescriptorSet(VkCommandBuffer cmdBuffer);
+  VkDescriptorSet getSamplerDescriptorSet(VKCommandBuffer *cmdBuffer);
+  VkDescriptorSet getStorageImageDescriptorSet(VKCommandBuffer *cmdBuffer);
 private:
-  void initSamplerDescriptorSet(VkCommandBuffer cmdBuffer);
-  void initStorageImageDescriptorSet(VkCommandBuffer cmdBuffer);
+  void initSamplerDescriptorSet(VKCommandBuffer *cmdBuffer);
+  void initStorageImageDescriptorSet(VKCommandBuffer *cmdBuffer);
   void initSampler();
-  void uploadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
+  void uploadFn(VKCommandBuffer *cmdBuffer, void *data, uint32_t size,
                 VKBuffer *stagingBuffer, uint32_t x = 0, uint32_t y = 0,
                 uint32_t z = 0, int32_t w = -1, int32_t h = -1, int32_t d = -1,
                 int32_t arrayLayers = -1, int32_t numPlanes = -1, int32_t dataPitch = -1);
-  void downloadFn(VkCommandBuffer cmdBuffer, void *data, uint32_t size,
+  void downloadFn(VKCommandBuffer *cmdBuffer, void *data, uint32_t size,
                   VKBuffer *stagingBuffer, uint32_t x = 0, uint32_t y = 0,
                   uint32_t z = 0, int32_t w = -1, int32_t h = -1,
                   int32_t d = -1, int32_t arrayLayers = -1);
-  void generateMipmapsFn(VkCommandBuffer cmdBuffer);
+  void generateMipmapsFn(VKCommandBuffer *cmdBuffer);
+  void setDefaultLayout(VKCommandBuffer *cmdBuffer);
   VkImageAspectFlags getImageAspectFlags(VkFormat format);
   VkDescriptorSet samplerDescriptorSet = 0, storageImageDescriptorSet = 0;
-  VKGraphicsContext *ctx;
+  VKGraphicsContext *ctx = nullptr;
 };
 VK_CAST(Texture);
 } // namespace ngfx
@@ -24,18 +24,27 @@
 #include <math.h>
 #include <vector>
 #include "test/common/UnitTest.h"
+#include "ngfx/core/DebugUtil.h"
 #include "ngfx/graphics/BufferUtil.h"
 #include "ngfx/drawOps/DrawColorOp.h"
 #include "ngfx/graphics/Colors.h"
+#include "ngfx/graphics/TextureUtil.h"
+#ifdef NGFX_GRAPHICS_BACKEND_VULKAN
+#include "ngfx/porting/vulkan/VKDevice.h"
+#endif
 using namespace std;
 using namespace ngfx;
 using namespace glm;
 
 enum BufferTestMode { VERTEX, INDEX, UNIFORM, STORAGE, INSTANCING,
-    UPLOAD, UPLOAD_SUBREGION, DOWNLOAD, DOWNLOAD_SUBREGION, MAP
+    UPLOAD, UPLOAD_SUBREGION, DOWNLOAD, DOWNLOAD_SUBREGION, MAP,
+    DRAW_INDIRECT, DRAW_INDEXED_INDIRECT, DRAW_INDIRECT_SPLIT, DRAW_INDEXED_INDIRECT_SPLIT,
+    DRAW_INDEXED_INDIRECT_COUNT
 };
 const vector<string> BufferTestModeStr = { "vertex", "index", "uniform", "storage",
-    "instancing", "upload", "upload_subregion", "download", "download_subregion", "map" };
+    "instancing", "upload", "upload_subregion", "download", "download_subregion", "map",
+    "draw_indirect", "draw_indexed_indirect", "draw_indirect_split", "draw_indexed_indirect_split",
+    "draw_indexed_indirect_count" };
 
 static string toString(BufferTestMode mode) {
     return BufferTestModeStr[mode];
@@ -237,6 +246,90 @@ public:
     uint32_t B_POS, B_TRANSLATE;
     int numVerts, numInstances;
 };
+// DrawColorOp, recording the draw commands separately
+class IndirectDrawColorOp : public DrawColorOp {
+public:
+    using DrawColorOp::DrawColorOp;
+    void bind(CommandBuffer* commandBuffer, Graphics* graphics) {
+        graphics->bindGraphicsPipeline(commandBuffer, graphicsPipeline);
+        graphics->bindVertexBuffer(commandBuffer, bPos.get(), B_POS, sizeof(vec2));
+        if (bIndex)
+            graphics->bindIndexBuffer(commandBuffer, bIndex.get());
+        graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_UBO,
+            SHADER_STAGE_FRAGMENT_BIT);
+    }
+};
+// Draw a row of squares, with one draw command per square.
+// The reference records the draws directly, otherwise the draws are read from an indirect buffer
+class IndirectDrawTestOp : public FilterOp {
+public:
+    static constexpr uint32_t NUM_DRAWS = 4;
+    IndirectDrawTestOp(GraphicsContext* ctx, Graphics* graphics, int w, int h, BufferTestMode mode, bool reference)
+        : FilterOp(ctx, graphics, w, h), mode(mode), reference(reference) {
+        indexed = (mode != DRAW_INDIRECT && mode != DRAW_INDIRECT_SPLIT);
+        vector<vec2> pos;
+        vector<i32> index;
+        // The last command covers the whole output: it's only drawn if
+        // drawIndexedIndirectCount ignores the draw count in the count buffer
+        for (uint32_t j = 0; j <= NUM_DRAWS; j++) {
+            vec2 p0 = (j == NUM_DRAWS) ? vec2(-1.0f) : vec2(-0.9f + 0.45f * j, -0.5f);
+            vec2 p1 = (j == NUM_DRAWS) ? vec2(1.0f) : p0 + vec2(0.35f, 1.0f);
+            vector<vec2> corners = { p0, vec2(p1.x, p0.y), vec2(p0.x, p1.y), p1 };
+            if (indexed) {
+                pos.insert(pos.end(), corners.begin(), corners.end());
+                index.insert(index.end(), { 0, 1, 2, 2, 1, 3 });
+                drawIndexedCommands.push_back({ 6, 1, 6 * j, int32_t(4 * j), 0 });
+            }
+            else {
+                for (int k : { 0, 1, 2, 2, 1, 3 })
+                    pos.push_back(corners[k]);
+                drawCommands.push_back({ 6, 1, 6 * j, 0 });
+            }
+        }
+        op = make_unique<IndirectDrawColorOp>(ctx, pos, Color::Green,
+            [&](GraphicsPipeline::State& state) {
+                state.primitiveTopology = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            }, index);
+        if (indexed)
+            bIndirect.reset(createIndirectBuffer(ctx, drawIndexedCommands.data(),
+                uint32_t(drawIndexedCommands.size() * sizeof(DrawIndexedIndirectCommand))));
+        else
+            bIndirect.reset(createIndirectBuffer(ctx, drawCommands.data(),
+                uint32_t(drawCommands.size() * sizeof(DrawIndirectCommand))));
+        if (mode == DRAW_INDEXED_INDIRECT_COUNT)
+            bCount.reset(createIndirectBuffer(ctx, &NUM_DRAWS, sizeof(NUM_DRAWS)));
+    }
+    void draw(CommandBuffer* commandBuffer, Graphics* graphics) override {
+        op->bind(commandBuffer, graphics);
+        if (reference) {
+            for (uint32_t j = 0; j < NUM_DRAWS; j++) {
+                if (indexed) {
+                    auto& c = drawIndexedCommands[j];
+                    graphics->drawIndexed(commandBuffer, c.indexCount, c.instanceCount,
+                        c.firstIndex, c.vertexOffset, c.firstInstance);
+                }
+                else {
+                    auto& c = drawCommands[j];
+                    graphics->draw(commandBuffer, c.vertexCount, c.instanceCount,
+                        c.firstVertex, c.firstInstance);
+                }
+            }
+        }
+        else if (mode == DRAW_INDEXED_INDIRECT_COUNT)
+            graphics->drawIndexedIndirectCount(commandBuffer, bIndirect.get(), 0,
+                bCount.get(), 0, NUM_DRAWS + 1);
+        else if (indexed)
+            graphics->drawIndexedIndirect(commandBuffer, bIndirect.get(), 0, NUM_DRAWS);
+        else
+            graphics->drawIndirect(commandBuffer, bIndirect.get(), 0, NUM_DRAWS);
+    }
+    BufferTestMode mode;
+    bool reference, indexed;
+    vector<DrawIndirectCommand> drawCommands;
+    vector<DrawIndexedIndirectCommand> drawIndexedCommands;
+    unique_ptr<IndirectDrawColorOp> op;
+    unique_ptr<Buffer> bIndirect, bCount;
+};
 class BufferUploadTestOp : public FilterOp {
 
 };
@@ -255,7 +348,42 @@ case p0: \
 test.op = make_unique<p1##TestOp>(test.ctx.get(), test.graphics.get(), test.outputWidth, test.outputHeight); \
 break
 
+// Compare the indirect draws with the same draws recorded directly
+int runIndirectDraw(BufferTestMode mode) {
+    UnitTest test("buffer_" + toString(mode));
+    if (mode == DRAW_INDEXED_INDIRECT_COUNT && !test.ctx->device->supportsDrawIndirectCount()) {
+        NGFX_LOG("%s: drawIndexedIndirectCount is not supported, skipping", test.testName.c_str());
+        return 0;
+    }
+#ifdef NGFX_GRAPHICS_BACKEND_VULKAN
+    // Test the fallback to one draw per command
+    if (mode == DRAW_INDIRECT_SPLIT || mode == DRAW_INDEXED_INDIRECT_SPLIT)
+        vk(test.ctx->device)->enabledFeatures.multiDrawIndirect = VK_FALSE;
+#endif
+    ImageData textureData[2];
+    for (int j = 0; j < 2; j++) {
+        bool reference = (j == 0);
+        test.op = make_unique<IndirectDrawTestOp>(test.ctx.get(), test.graphics.get(),
+            test.outputWidth, test.outputHeight, mode, reference);
+        auto commandBuffer = test.ctx->drawCommandBuffer();
+        commandBuffer->begin();
+        test.op->apply(test.ctx.get(), commandBuffer, test.graphics.get());
+        commandBuffer->end();
+        test.ctx->queue->submit(commandBuffer);
+        test.ctx->queue->waitIdle();
+        TextureUtil::download(test.op->outputTexture, textureData[j]);
+    }
+    auto result = ImageCompare::compare(textureData[1], textureData[0]);
+    if (!result.passed) {
+        NGFX_LOG_WARNING("%s: %s", test.testName.c_str(), result.toString().c_str());
+        return 1;
+    }
+    return 0;
+}
+
 int run(BufferTestMode mode) {
+    if (mode >= DRAW_INDIRECT)
+        return runIndirectDraw(mode);
     UnitTest test("buffer_" + toString(mode));
     switch (mode) {
         CASE(VERTEX, VertexBuffer);
@@ -276,6 +404,8 @@ int main(int argc, char** argv) {
         vector<BufferTestMode> testModes = {
             VERTEX, INDEX, UNIFORM, STORAGE, INSTANCING, /*
             UPLOAD, UPLOAD_SUBREGION, DOWNLOAD, DOWNLOAD_SUBREGION, MAP */
+            DRAW_INDIRECT, DRAW_INDEXED_INDIRECT, DRAW_INDIRECT_SPLIT, DRAW_INDEXED_INDIRECT_SPLIT,
+            DRAW_INDEXED_INDIRECT_COUNT
         };
         int r = 0;
         for (BufferTestMode m : testModes)
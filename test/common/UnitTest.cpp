@@ -1,4 +1,5 @@
 #include "UnitTest.h"
+#include "ngfx/core/DebugUtil.h"
 #include "ngfx/graphics/ImageUtil.h"
 #include "ngfx/graphics/TextureUtil.h"
 #include "ngfx/core/FileUtil.h"
@@ -14,6 +15,8 @@ UnitTest::UnitTest(std::string testName, int outputWidth, int outputHeight, bool
 	graphics.reset(Graphics::create(ctx.get()));
 	ctx->setSurface(surface.get());
 	genRefs = getenv("GEN_REFS") ? true : false;
+	//tolerate small rounding differences between drivers
+	compareOptions.setTolerance(2);
 }
 int UnitTest::run() {
 	auto commandBuffer = ctx->drawCommandBuffer();
@@ -27,14 +30,17 @@ int UnitTest::run() {
 		TextureUtil::storePNG(refFilePath.string(), op->outputTexture);
 		return 0;
 	}
-	fs::path filePath = "out/" + testName + ".png";
-	TextureUtil::storePNG(filePath.string(), op->outputTexture);
 	ImageData textureData;
 	TextureUtil::download(op->outputTexture, textureData);
+	ImageUtil::storePNG("out/" + testName + ".png", textureData);
 	ImageData refImageData;
 	ImageUtil::load(refFilePath.string(), refImageData);
-	if (textureData.size != refImageData.size) {
+	auto result = ImageCompare::compare(textureData, refImageData, compareOptions);
+	if (!result.passed) {
+		NGFX_LOG_WARNING("%s: %s", testName.c_str(), result.toString().c_str());
+		if (!result.sizeMismatch)
+			ImageCompare::storeDiffHeatmap("out/" + testName + "_diff.png", textureData, refImageData, compareOptions);
 		return 1;
 	}
-	return memcmp(textureData.data, refImageData.data, refImageData.size);
+	return 0;
 }
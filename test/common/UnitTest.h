@@ -1,6 +1,7 @@
 #pragma once
 #include "ngfx/graphics/GraphicsContext.h"
 #include "ngfx/graphics/FilterOp.h"
+#include "ngfx/graphics/ImageCompare.h"
 #include "test/common/UnitTest.h"
 
 namespace ngfx {
@@ -16,5 +17,6 @@ namespace ngfx {
 		std::string testName;
 		int outputWidth = 0, outputHeight = 0;
 		bool genRefs = false;
+		ImageCompare::Options compareOptions;
 	};
 }
\ No newline at end of file
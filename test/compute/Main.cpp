@@ -2,28 +2,53 @@
 #include "ngfx/graphics/GraphicsContext.h"
 #include "ngfx/computeOps/MatrixMultiplyGPUOp.h"
 #include "ngfx/computeOps/MatrixMultiplyCPUOp.h"
+#include "ngfx/computeOps/ColorspaceConversionGPUOp.h"
 #include "ngfx/computeOps/ConvolveGPUOp.h"
+#include "ngfx/computeOps/HistogramGPUOp.h"
+#include "ngfx/computeOps/LensCorrectionGPUOp.h"
+#include "ngfx/computeOps/ParticlesGPUOp.h"
+#include "ngfx/computeOps/ReduceGPUOp.h"
+#include "ngfx/computeOps/ScanGPUOp.h"
 #include "test/common/UnitTest.h"
 #include "ngfx/graphics/BufferUtil.h"
+#include "ngfx/graphics/ImageCompare.h"
 #include "ngfx/graphics/ImageData.h"
 #include "ngfx/graphics/ImageUtil.h"
 #include "ngfx/graphics/FilterUtil.h"
+#include "ngfx/compute/ComputeGraph.h"
 #include "ngfx/compute/ComputeUtil.h"
 #include "ngfx/graphics/TextureUtil.h"
+#include "ngfx/core/Timer.h"
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <numeric>
 using namespace ngfx;
 using namespace ngfx::ComputeUtil;
 using namespace ngfx::FilterUtil;
 using namespace std;
 using namespace glm;
 
-enum ComputeTest { MATRIX_MULTIPLY, GAUSSIAN, SUM, PARTICLES, COLORSPACE_CONVERSION, LENS_CORRECTION };
+enum ComputeTest { MATRIX_MULTIPLY, MATRIX_MULTIPLY_CPU, MATRIX_MULTIPLY_BENCHMARK, GAUSSIAN, CONVOLVE_SEPARABLE, CONVOLVE_GPU, CONVOLVE_CPU, CONVOLVE_BENCHMARK, SUM, REDUCE_MIN_MAX, SCAN, HISTOGRAM, COMPUTE_GRAPH, COMPUTE_GRAPH_GPU, DISPATCH_INDIRECT, PARTICLES, PARTICLES_DRAW, COLORSPACE_CONVERSION, LENS_CORRECTION };
 
 static const map<string, ComputeTest> computeTestMap = {
         { "matrix_multiply", MATRIX_MULTIPLY },
+        { "matrix_multiply_cpu", MATRIX_MULTIPLY_CPU },
+        { "matrix_multiply_benchmark", MATRIX_MULTIPLY_BENCHMARK },
         { "gaussian", GAUSSIAN },
+        { "convolve_separable", CONVOLVE_SEPARABLE },
+        { "convolve_gpu", CONVOLVE_GPU },
+        { "convolve_cpu", CONVOLVE_CPU },
+        { "convolve_benchmark", CONVOLVE_BENCHMARK },
         { "sum", SUM },
+        { "reduce_min_max", REDUCE_MIN_MAX },
+        { "scan", SCAN },
+        { "histogram", HISTOGRAM },
+        { "compute_graph", COMPUTE_GRAPH },
+        { "compute_graph_gpu", COMPUTE_GRAPH_GPU },
+        { "dispatch_indirect", DISPATCH_INDIRECT },
         { "particles", PARTICLES },
+        { "particles_draw", PARTICLES_DRAW },
         { "colorspace_conversion", COLORSPACE_CONVERSION },
         { "lens_correction", LENS_CORRECTION }
 };
@@ -37,9 +62,9 @@ static string toString(ComputeTest computeTest) {
     return "";
 }
 
-static int compareData(float* v0, float* v1, int size) {
+static int compareData(float* v0, float* v1, int size, float epsilon = FLT_EPSILON) {
     for (int j = 0; j < size; j++) {
-        if (abs(v0[j] - v1[j]) > FLT_EPSILON)
+        if (abs(v0[j] - v1[j]) > epsilon)
             return 1;
     }
     return 0;
@@ -52,35 +77,153 @@ static int testMatrixMultiply() {
     unique_ptr<Graphics> graphics;
     graphics.reset(Graphics::create(ctx.get()));
     using MatrixParam = MatrixMultiplyOp::MatrixParam;
-    const int DIM = 16;
+    //the dimensions are not a multiple of the tile size
+    uint32_t M = 33, N = 47, K = 20;
     vector<float> srcData[2], dstData[2];
+    MatrixParam src0, src1;
+    auto initData = [&]() {
+        srcData[0].resize(M * K);
+        srcData[1].resize(K * N);
+        for (int j = 0; j < 2; j++) {
+            for (float& v : srcData[j])
+                v = (rand() % 1024) / 1024.0f;
+            dstData[j].resize(M * N);
+        }
+        src0 = { K, M, srcData[0].data() };
+        src1 = { N, K, srcData[1].data() };
+    };
+    initData();
+    MatrixParam dst0 = { N, M, nullptr };
+    //test matrix multiply on GPU
+    auto op = make_unique<MatrixMultiplyGPUOp>(ctx.get(),
+        src0, src1, dst0, graphics.get());
+    auto runGPU = [&]() {
+        auto commandBuffer = ctx->computeCommandBuffer();
+        commandBuffer->begin();
+        op->apply(commandBuffer, graphics.get());
+        commandBuffer->end();
+        ctx->submit(commandBuffer);
+        ctx->queue->waitIdle();
+        op->bDst->download(dstData[0].data(), dstData[0].size() * sizeof(dstData[0][0]));
+    };
+    //compare against CPU
+    auto runCPU = [&]() {
+        MatrixParam dst1 = { N, M, dstData[1].data() };
+        auto cpuOp = make_unique<MatrixMultiplyCPUOp>(src0, src1, dst1);
+        cpuOp->apply();
+    };
+    //the summation order differs between the GPU and the CPU
+    auto compareAll = [&]() {
+        return compareData(dstData[0].data(), dstData[1].data(), M * N, K * 1e-6f);
+    };
+    runGPU();
+    runCPU();
+    if (compareAll())
+        return 1;
+
+    //test each candidate tile configuration
+    auto tunedTileConfig = op->tileConfig;
+    for (auto& tileConfig : MatrixMultiplyGPUOp::TILE_CONFIG_CANDIDATES) {
+        op->setTileConfig(tileConfig);
+        std::fill(dstData[0].begin(), dstData[0].end(), 0.0f);
+        runGPU();
+        if (compareAll()) {
+            NGFX_LOG("tile config failed: workgroup %dx%d, tileK: %d, thread tile: %dx%d",
+                     tileConfig.wgX, tileConfig.wgY, tileConfig.tileK,
+                     tileConfig.threadM, tileConfig.threadN);
+            return 1;
+        }
+    }
+    op->setTileConfig(tunedTileConfig);
+
+    //update the persistent buffers in place
+    initData();
+    op->update(src0, src1);
+    runGPU();
+    runCPU();
+    if (compareAll())
+        return 1;
+
+    //change the dimensions, the buffers are reallocated
+    M = 70; N = 19; K = 45;
+    initData();
+    op->update(src0, src1);
+    if (op->bDst->size != M * N * sizeof(float))
+        return 1;
+    runGPU();
+    runCPU();
+    return compareAll();
+}
+
+static int testMatrixMultiplyCPU() {
+    using MatrixParam = MatrixMultiplyOp::MatrixParam;
+    //include sizes that are not a multiple of the SIMD tile size or the cache blocks
+    const vector<array<uint32_t, 3>> sizes = {
+        { 1, 1, 1 }, { 3, 5, 7 }, { 17, 33, 9 }, { 64, 64, 64 }, { 130, 513, 300 }
+    };
+    for (auto& size : sizes) {
+        uint32_t M = size[0], N = size[1], K = size[2];
+        vector<float> src0Data(M * K), src1Data(K * N), dstData(M * N), refData(M * N);
+        for (float& v : src0Data)
+            v = (rand() % 1024) / 1024.0f;
+        for (float& v : src1Data)
+            v = (rand() % 1024) / 1024.0f;
+        MatrixParam src0 = { K, M, src0Data.data() }, src1 = { N, K, src1Data.data() };
+        MatrixParam dst = { N, M, dstData.data() }, ref = { N, M, refData.data() };
+        MatrixMultiplyCPUOp::matrixMultiplyReference(src0, src1, ref);
+        //with the default thread pool, and serially without a thread pool
+        for (ThreadPool* threadPool : { ThreadPool::getDefault(), (ThreadPool*)nullptr }) {
+            std::fill(dstData.begin(), dstData.end(), 0.0f);
+            auto op = make_unique<MatrixMultiplyCPUOp>(src0, src1, dst, threadPool);
+            op->apply();
+            if (compareData(dstData.data(), refData.data(), M * N, K * 1e-6f))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static int testMatrixMultiplyBenchmark() {
+    using MatrixParam = MatrixMultiplyOp::MatrixParam;
+    const uint32_t DIM = 1024, NUM_ITERATIONS = 5;
+    const double numOps = 2.0 * DIM * DIM * DIM;
+    vector<float> srcData[2], dstData(DIM * DIM);
     for (int j = 0; j < 2; j++) {
         srcData[j] = vector<float>(DIM * DIM);
-        dstData[j] = vector<float>(DIM * DIM);
-    }
-    for (int j = 0; j < (DIM * DIM); j++) {
-        srcData[0][j] = (rand() % 1024) / 1024.0f;
-        srcData[1][j] = (rand() % 1024) / 1024.0f;
+        for (float& v : srcData[j])
+            v = (rand() % 1024) / 1024.0f;
     }
     MatrixParam src0 = { DIM, DIM, srcData[0].data() };
     MatrixParam src1 = { DIM, DIM, srcData[1].data() };
-    MatrixParam dst0 = { DIM, DIM, nullptr };
-    //test matrix multiply on GPU
-    auto op = make_unique<MatrixMultiplyGPUOp>(ctx.get(),
-        src0, src1, dst0);
-    auto commandBuffer = ctx->computeCommandBuffer();
-    commandBuffer->begin();
-    op->apply(commandBuffer, graphics.get());
-    commandBuffer->end();
-    ctx->submit(commandBuffer);
-    ctx->queue->waitIdle();
-    op->bDst->download(dstData[0].data(), dstData[0].size() * sizeof(dstData[0][0]));
+    MatrixParam dst = { DIM, DIM, dstData.data() };
+    auto benchmark = [&](const char* name, function<void()> fn) {
+        fn(); //warm up
+        Timer timer;
+        for (uint32_t j = 0; j < NUM_ITERATIONS; j++)
+            fn();
+        timer.update();
+        NGFX_LOG("%s: %.2f GFLOP/s", name, numOps * NUM_ITERATIONS / timer.elapsed / 1e9);
+    };
+    benchmark("CPU reference", [&]() { MatrixMultiplyCPUOp::matrixMultiplyReference(src0, src1, dst); });
+    auto cpuOp = make_unique<MatrixMultiplyCPUOp>(src0, src1, dst);
+    benchmark("CPU", [&]() { cpuOp->apply(); });
 
-    //compare against CPU
-    MatrixParam dst1 = { DIM, DIM, dstData[1].data() };
-    auto cpuOp = make_unique<MatrixMultiplyCPUOp>(src0, src1, dst1);
-    cpuOp->apply();
-    return compareData(dstData[0].data(), dstData[1].data(), DIM * DIM);
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_matrix_multiply_benchmark", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    auto gpuOp = make_unique<MatrixMultiplyGPUOp>(ctx.get(), src0, src1, MatrixParam{ DIM, DIM, nullptr }, graphics.get());
+    //includes the submission and synchronization overhead
+    benchmark("GPU", [&]() {
+        auto commandBuffer = ctx->computeCommandBuffer();
+        commandBuffer->begin();
+        gpuOp->apply(commandBuffer, graphics.get());
+        commandBuffer->end();
+        ctx->submit(commandBuffer);
+        ctx->queue->waitIdle();
+    });
+    return 0;
 }
 
 class GaussianOp : public ComputeOp {
@@ -106,25 +249,22 @@ public:
         setRadius(radius);
         this->srcTexture = srcTexture;
         this->dstTexture = dstTexture;
-        convolveGPUOp[0] = make_unique<ConvolveGPUOp>(ctx, graphics);
-        convolveGPUOp[1] = make_unique<ConvolveGPUOp>(ctx, graphics);
-        int w = srcTexture->w, h = srcTexture->h;
-        tex0.reset(Texture::create(ctx, graphics, nullptr, PIXELFORMAT_RGBA8_UNORM, w * h * 4, w, h,
-            1, 1, IMAGE_USAGE_STORAGE_BIT));
-        vector<float> kernelData(radius * 2 + 1);
-        for (int j = 0; j < kernelData.size(); j++) {
-            kernelData[j] = gaussianData[abs(j - radius)];
+        convolveGPUOp = make_unique<ConvolveGPUOp>(ctx, graphics);
+        //the 2D kernel is detected as separable and applied in two passes
+        int kernelSize = radius * 2 + 1;
+        vector<float> kernelData(kernelSize * kernelSize);
+        for (int j = 0; j < kernelSize; j++) {
+            for (int k = 0; k < kernelSize; k++) {
+                kernelData[j * kernelSize + k] = gaussianData[abs(j - radius)] * gaussianData[abs(k - radius)];
+            }
         }
-        kernel_t kernel0 = { kernelData.data(), radius * 2 + 1, 1 };
-        kernel_t kernel1 = { kernelData.data(), 1, radius * 2 + 1 };
-        convolveGPUOp[0]->update(srcTexture, tex0.get(), kernel0);
-        convolveGPUOp[1]->update(dstTexture, tex0.get(), kernel1);
+        kernel_t kernel = { kernelData.data(), kernelSize, kernelSize };
+        convolveGPUOp->update(srcTexture, dstTexture, kernel);
     }
     virtual ~GaussianGPUOp() {}
     void apply(CommandBuffer* commandBuffer = nullptr,
             Graphics* graphics = nullptr) override {
-        convolveGPUOp[0]->apply(commandBuffer, graphics);
-        convolveGPUOp[1]->apply(commandBuffer, graphics);
+        convolveGPUOp->apply(commandBuffer, graphics);
     }
     void setRadius(int radius) override {
         GaussianOp::setRadius(radius);
@@ -132,8 +272,7 @@ public:
     }
     Texture* srcTexture = nullptr;
     Texture* dstTexture = nullptr;
-    std::unique_ptr<Texture> tex0;
-    std::unique_ptr<ConvolveGPUOp> convolveGPUOp[2];
+    std::unique_ptr<ConvolveGPUOp> convolveGPUOp;
 
 protected:
     ComputePipeline* computePipeline;
@@ -177,69 +316,211 @@ static int testGaussian() {
     //test gaussian on GPU
     unique_ptr<Texture> srcTexture(TextureUtil::load(ctx.get(), graphics.get(), srcImage, IMAGE_USAGE_STORAGE_BIT));
     unique_ptr<Texture> dstTexture(Texture::create(ctx.get(), graphics.get(), nullptr, PIXELFORMAT_RGBA8_UNORM,
-        srcTexture->size, srcTexture->w, srcTexture->h, 1, 1, IMAGE_USAGE_STORAGE_BIT));
+        srcTexture->size, srcTexture->w, srcTexture->h, 1, 1,
+        ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT)));
     auto gpuOp = make_unique<GaussianGPUOp>(ctx.get(), graphics.get(), srcTexture.get(), dstTexture.get(), 3);
+    if (!gpuOp->convolveGPUOp->separable)
+        return 1;
     auto commandBuffer = ctx->computeCommandBuffer();
     commandBuffer->begin();
     gpuOp->apply(commandBuffer, graphics.get());
     commandBuffer->end();
     ctx->submit(commandBuffer);
     ctx->queue->waitIdle();
-    TextureUtil::storePNG("tmp_gpu.png", dstTexture.get());
+    ImageData gpuImage(srcImage.w, srcImage.h);
+    dstTexture->download(gpuImage.data, gpuImage.size);
     //compare against CPU
     ImageData dstImage(srcImage.w, srcImage.h);
     auto op = make_unique<GaussianCPUOp>(&srcImage, &dstImage, 3);
     op->apply(nullptr, nullptr);
-    ImageUtil::storePNG("tmp.png", dstImage);
-    return 1;
+    //the GPU rounds the intermediate and the final values, while the CPU truncates
+    ImageCompare::Options options;
+    options.setTolerance(2);
+    options.computePerceptualMetrics = false;
+    return ImageCompare::compare(gpuImage, dstImage, options).passed ? 0 : 1;
 }
 
-class SumGPUOp : public ComputeOp {
-public:
-    SumGPUOp(GraphicsContext* ctx) : ComputeOp(ctx) {}
-    SumGPUOp(GraphicsContext* ctx, const std::vector<float>& data) : SumGPUOp(ctx) {
-        update(data);
-        createPipeline();
-        computePipeline->getBindings({ &U_UBO, &SSBO_SRC, &SSBO_DST });
+static int testConvolveSeparable() {
+    auto testKernel = [](vector<float> kernelData, int w, int h, bool expected) {
+        vector<float> kernelX, kernelY;
+        kernel_t kernel = { kernelData.data(), w, h };
+        if (separateKernel(kernel, kernelX, kernelY) != expected)
+            return 1;
+        if (!expected)
+            return 0;
+        for (int j = 0; j < h; j++) {
+            for (int k = 0; k < w; k++) {
+                if (fabs(kernelX[k] * kernelY[j] - kernelData[j * w + k]) > 1e-5f)
+                    return 1;
+            }
+        }
+        return 0;
+    };
+    int r = 0;
+    //gaussian
+    r |= testKernel({ 1 / 16.0f, 2 / 16.0f, 1 / 16.0f, 2 / 16.0f, 4 / 16.0f, 2 / 16.0f,
+        1 / 16.0f, 2 / 16.0f, 1 / 16.0f }, 3, 3, true);
+    //box
+    r |= testKernel(vector<float>(15, 1 / 15.0f), 5, 3, true);
+    //sobel
+    r |= testKernel({ -1, 0, 1, -2, 0, 2, -1, 0, 1 }, 3, 3, true);
+    //laplacian
+    r |= testKernel({ 0, 1, 0, 1, -4, 1, 0, 1, 0 }, 3, 3, false);
+    //zero
+    r |= testKernel(vector<float>(9, 0.0f), 3, 3, false);
+    return r;
+}
+
+static vector<float> gaussianKernel(int radius) {
+    int kernelSize = radius * 2 + 1;
+    vector<float> kernelData(kernelSize * kernelSize);
+    for (int j = 0; j < kernelSize; j++) {
+        for (int k = 0; k < kernelSize; k++) {
+            kernelData[j * kernelSize + k] = gaussian(j - radius) * gaussian(k - radius);
+        }
     }
-    virtual ~SumGPUOp() {}
-    void apply(CommandBuffer* commandBuffer = nullptr,
-        Graphics* graphics = nullptr) override {
-        graphics->bindComputePipeline(commandBuffer, computePipeline);
-        graphics->bindUniformBuffer(commandBuffer, bUbo.get(), U_UBO,
-            SHADER_STAGE_COMPUTE_BIT);
-        graphics->bindStorageBuffer(commandBuffer, bSrc.get(), SSBO_SRC,
-            SHADER_STAGE_COMPUTE_BIT, true);
-        graphics->bindStorageBuffer(commandBuffer, bDst.get(), SSBO_DST,
-            SHADER_STAGE_COMPUTE_BIT, false);
-        graphics->dispatch(commandBuffer, 1, uboData.src_h, 1);
-    }
-    virtual void update(const std::vector<float>& data) {
-        const int src_w = 1024;
-        int src_h = (data.size() + src_w - 1) / src_w;
-        int dst_w = 1, dst_h = src_h;
-        uboData = { src_w, src_h };
-        bUbo.reset(createUniformBuffer(ctx, &uboData, sizeof(uboData)));
-        bSrc.reset(createStorageBuffer(ctx, data.data(), src_w * src_h * sizeof(float)));
-        bDst.reset(createStorageBuffer(ctx, nullptr, dst_w * dst_h * sizeof(float)));
-    }
-    std::unique_ptr<Buffer> bUbo;
-    std::unique_ptr<Buffer> bSrc, bDst;
+    return kernelData;
+}
 
-protected:
-    struct UboData {
-        int32_t src_w, src_h;
+static int testConvolveCPU() {
+    //include sizes that are not a multiple of the SIMD width or the transpose block size
+    const vector<array<int, 2>> sizes = { { 1, 1 }, { 37, 23 }, { 64, 64 }, { 123, 77 } };
+    vector<float> gaussianData = gaussianKernel(3), boxData(9, 1.0f / 9.0f);
+    vector<float> laplacianData = { 0.0f, 0.25f, 0.0f, 0.25f, 0.0f, 0.25f, 0.0f, 0.25f, 0.0f };
+    const vector<kernel_t> kernels = {
+        { gaussianData.data(), 7, 7 }, { boxData.data(), 9, 1 }, { boxData.data(), 1, 9 },
+        { laplacianData.data(), 3, 3 }
     };
-    UboData uboData;
-    void createPipeline() {
-        const std::string key = "sumGPUOp";
-        computePipeline = ComputePipeline::create(
-            ctx,
-            ComputeShaderModule::create(ctx->device, NGFX_TEST_DATA_DIR "/shaders/testComputeSum.comp").get());
+    for (auto& size : sizes) {
+        int w = size[0], h = size[1];
+        vector<u8vec4> srcData(w * h), dstData(w * h), refData(w * h);
+        for (u8vec4& v : srcData)
+            v = u8vec4(rand() % 256, rand() % 256, rand() % 256, rand() % 256);
+        image_t src = { srcData.data(), w, h };
+        for (auto& kernel : kernels) {
+            convolve(src, { dstData.data(), w, h }, kernel);
+            convolveReference(src, { refData.data(), w, h }, kernel);
+            //the summation order differs, which can change the truncated value by 1
+            for (int j = 0; j < w * h; j++) {
+                ivec4 d = abs(ivec4(dstData[j]) - ivec4(refData[j]));
+                if (d.x > 1 || d.y > 1 || d.z > 1 || d.w > 1)
+                    return 1;
+            }
+        }
+        //transpose
+        transpose(src, { dstData.data(), h, w });
+        transposeReference(src, { refData.data(), h, w });
+        if (memcmp(dstData.data(), refData.data(), w * h * sizeof(u8vec4)))
+            return 1;
     }
-    ComputePipeline* computePipeline;
-    uint32_t U_UBO = 0, SSBO_SRC = 1, SSBO_DST = 2;
-};
+    return 0;
+}
+
+static int testConvolveBenchmark() {
+    const uint32_t NUM_ITERATIONS = 5;
+    ImageData birdImage;
+    ImageUtil::load(NGFX_TEST_DATA_DIR "/images/bird.jpg", birdImage);
+    ImageData image4K(3840, 2160);
+    for (int j = 0; j < image4K.w * image4K.h; j++)
+        ((u8vec4*)image4K.data)[j] = u8vec4(rand() % 256, rand() % 256, rand() % 256, 255);
+    vector<float> gaussianData = gaussianKernel(7);
+    vector<float> laplacianData = { 0.0f, 0.25f, 0.0f, 0.25f, 0.0f, 0.25f, 0.0f, 0.25f, 0.0f };
+    for (const ImageData* image : { &birdImage, &image4K }) {
+        ImageData dstImage(image->w, image->h);
+        image_t src = TO_IMG((*image)), dst = TO_IMG(dstImage);
+        auto benchmark = [&](const char* name, uint32_t numIterations, function<void()> fn) {
+            Timer timer;
+            for (uint32_t j = 0; j < numIterations; j++)
+                fn();
+            timer.update();
+            NGFX_LOG("%dx%d %s: %.2f ms", image->w, image->h, name, timer.elapsed * 1000.0 / numIterations);
+        };
+        kernel_t blur = { gaussianData.data(), 15, 15 }, laplacian = { laplacianData.data(), 3, 3 };
+        benchmark("gaussian 15x15 reference", 1, [&]() { convolveReference(src, dst, blur); });
+        benchmark("gaussian 15x15 single thread", NUM_ITERATIONS, [&]() { convolve(src, dst, blur, nullptr); });
+        benchmark("gaussian 15x15", NUM_ITERATIONS, [&]() { convolve(src, dst, blur); });
+        benchmark("laplacian 3x3 reference", 1, [&]() { convolveReference(src, dst, laplacian); });
+        benchmark("laplacian 3x3 single thread", NUM_ITERATIONS, [&]() { convolve(src, dst, laplacian, nullptr); });
+        benchmark("laplacian 3x3", NUM_ITERATIONS, [&]() { convolve(src, dst, laplacian); });
+        image_t dstT = { dst.data, dst.h, dst.w };
+        benchmark("transpose reference", NUM_ITERATIONS, [&]() { transposeReference(src, dstT); });
+        benchmark("transpose single thread", NUM_ITERATIONS, [&]() { transpose(src, dstT, nullptr); });
+        benchmark("transpose", NUM_ITERATIONS, [&]() { transpose(src, dstT); });
+    }
+    return 0;
+}
+
+static void applyGPU(GraphicsContext* ctx, Graphics* graphics, ComputeOp* op) {
+    auto commandBuffer = ctx->computeCommandBuffer();
+    commandBuffer->begin();
+    op->apply(commandBuffer, graphics);
+    commandBuffer->end();
+    ctx->submit(commandBuffer);
+    ctx->queue->waitIdle();
+}
+
+static int testConvolveGPU() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_convolve_gpu", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    //the size is not a multiple of the workgroup size of either pipeline
+    const int w = 123, h = 77;
+    ImageData srcImage(w, h), dstImage(w, h), refImage(w, h);
+    u8vec4* srcData = (u8vec4*)srcImage.data;
+    for (int j = 0; j < w * h; j++)
+        srcData[j] = u8vec4(rand() % 256, rand() % 256, rand() % 256, rand() % 256);
+    unique_ptr<Texture> srcTexture(TextureUtil::load(ctx.get(), graphics.get(), srcImage, IMAGE_USAGE_STORAGE_BIT));
+    unique_ptr<Texture> dstTexture(Texture::create(ctx.get(), graphics.get(), nullptr, PIXELFORMAT_RGBA8_UNORM,
+        srcTexture->size, w, h, 1, 1, ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT)));
+    //a non-separable kernel, with more taps than a 16x16 block along x
+    const int nw = 37, nh = 5;
+    vector<float> nonSeparableData(nw * nh);
+    float sum = 0.0f;
+    for (int j = 0; j < nw * nh; j++)
+        sum += (nonSeparableData[j] = float(1 + (j * 7 + (j / nw) * 3) % 5));
+    for (float& v : nonSeparableData)
+        v /= sum;
+    vector<float> gaussianData = gaussianKernel(3);
+    float gaussianSum = accumulate(gaussianData.begin(), gaussianData.end(), 0.0f);
+    for (float& v : gaussianData)
+        v /= gaussianSum;
+    //the 1D kernels need several blocks of 64 taps
+    vector<float> boxData(131, 1.0f / 131.0f), box2DData(67 * 67, 1.0f / (67 * 67));
+    struct TestCase { kernel_t kernel; bool separable; };
+    const vector<TestCase> testCases = {
+        { { nonSeparableData.data(), nw, nh }, false },
+        { { gaussianData.data(), 7, 7 }, true },
+        { { boxData.data(), 131, 1 }, true },
+        { { boxData.data(), 1, 131 }, true },
+        { { box2DData.data(), 67, 67 }, true },
+        { { boxData.data(), 9, 1 }, true }
+    };
+    //setting the kernel before the textures doesn't allocate the intermediate texture
+    auto op = make_unique<ConvolveGPUOp>(ctx.get(), graphics.get());
+    op->setKernel(testCases[1].kernel);
+    if (op->tmpTexture)
+        return 1;
+    for (const TestCase& testCase : testCases) {
+        op->update(srcTexture.get(), dstTexture.get(), testCase.kernel);
+        if (op->separable != testCase.separable)
+            return 1;
+        applyGPU(ctx.get(), graphics.get(), op.get());
+        dstTexture->download(dstImage.data, dstImage.size);
+        convolve(TO_IMG(srcImage), TO_IMG(refImage), testCase.kernel);
+        //the GPU rounds the intermediate and the final values, while the CPU truncates
+        ImageCompare::Options options;
+        options.setTolerance(testCase.separable ? 2 : 1);
+        options.computePerceptualMetrics = false;
+        auto result = ImageCompare::compare(dstImage, refImage, options);
+        if (!result.passed) {
+            NGFX_LOG("kernel %dx%d: %s", testCase.kernel.w, testCase.kernel.h, result.toString().c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
 
 static int testSum() {
     unique_ptr<GraphicsContext> ctx;
@@ -247,23 +528,17 @@ static int testSum() {
     ctx->setSurface(nullptr);
     unique_ptr<Graphics> graphics;
     graphics.reset(Graphics::create(ctx.get()));
-    vector<float> src(1024 * 1024);
+    //the partial sums are small integers, so the result is exact
+    vector<float> src(1024 * 1024 + 37);
     for (int j = 0; j < src.size(); j++) {
-        src[j] = (j % 123) * (j % 2 == 0) ? -1 : 1;
+        src[j] = float((j % 123) - 61);
     }
-    //test sum on GPU
-    auto op = make_unique<SumGPUOp>(ctx.get(), src);
-    auto commandBuffer = ctx->computeCommandBuffer();
-    commandBuffer->begin();
-    op->apply(commandBuffer, graphics.get());
-    commandBuffer->end();
-    ctx->submit(commandBuffer);
-    ctx->queue->waitIdle();
-    vector<float> dst(1024);
-    op->bDst->download(dst.data(), dst.size() * sizeof(dst[0]));
+    unique_ptr<Buffer> bSrc(createStorageBuffer(ctx.get(), src.data(), uint32_t(src.size() * sizeof(float))));
+    //test sum on GPU, the result stays on the GPU until downloaded
+    auto op = make_unique<ReduceGPUOp>(ctx.get(), ReduceGPUOp::OPERATION_SUM, bSrc.get(), uint32_t(src.size()));
+    applyGPU(ctx.get(), graphics.get(), op.get());
     float sum = 0.0f;
-    for (const float &v : dst)
-        sum += v;
+    op->bDst->download(&sum, sizeof(sum));
     //compare against CPU
     float sum1 = 0.0f;
     for (const float& v : src) {
@@ -272,19 +547,580 @@ static int testSum() {
     return compareData(&sum, &sum1, 1);
 }
 
+static int testReduceMinMax() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_reduce_min_max", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    //include sizes that need a single pass and multiple passes
+    for (uint32_t count : { 1u, 1000u, 1025u, 300000u, 1100000u }) {
+        vector<float> src(count);
+        for (float& v : src)
+            v = (rand() % 65536) / 256.0f - 128.0f;
+        unique_ptr<Buffer> bSrc(createStorageBuffer(ctx.get(), src.data(), count * sizeof(float)));
+        for (auto operation : { ReduceGPUOp::OPERATION_MIN, ReduceGPUOp::OPERATION_MAX }) {
+            auto op = make_unique<ReduceGPUOp>(ctx.get(), operation, bSrc.get(), count);
+            applyGPU(ctx.get(), graphics.get(), op.get());
+            float result = 0.0f;
+            op->bDst->download(&result, sizeof(result));
+            float expected = (operation == ReduceGPUOp::OPERATION_MIN) ?
+                *min_element(src.begin(), src.end()) : *max_element(src.begin(), src.end());
+            if (compareData(&result, &expected, 1))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static int testScan() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_scan", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    //include sizes that need one, two and three levels
+    for (uint32_t count : { 5u, 1024u, 3000u, 1100000u }) {
+        //the prefix sums are integers below 2^24, so the result is exact
+        vector<float> src(count), dst(count);
+        for (float& v : src)
+            v = float(rand() % 4);
+        unique_ptr<Buffer> bSrc(createStorageBuffer(ctx.get(), src.data(), count * sizeof(float)));
+        for (bool exclusive : { false, true }) {
+            auto op = make_unique<ScanGPUOp>(ctx.get(), bSrc.get(), count, exclusive);
+            applyGPU(ctx.get(), graphics.get(), op.get());
+            op->bDst->download(dst.data(), count * sizeof(float));
+            float sum = 0.0f;
+            for (uint32_t j = 0; j < count; j++) {
+                float expected = exclusive ? sum : sum + src[j];
+                sum += src[j];
+                if (dst[j] != expected)
+                    return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int testHistogram() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_histogram", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    ImageData srcImage;
+    ImageUtil::load(NGFX_TEST_DATA_DIR "/images/bird.jpg", srcImage);
+    unique_ptr<Texture> srcTexture(TextureUtil::load(ctx.get(), graphics.get(), srcImage, IMAGE_USAGE_STORAGE_BIT));
+    auto op = make_unique<HistogramGPUOp>(ctx.get(), srcTexture.get());
+    applyGPU(ctx.get(), graphics.get(), op.get());
+    vector<uint32_t> histogram(HistogramGPUOp::NUM_BINS);
+    op->bDst->download(histogram.data(), HistogramGPUOp::NUM_BINS * sizeof(uint32_t));
+    //compare against CPU
+    vector<uint32_t> expected(HistogramGPUOp::NUM_BINS);
+    const u8vec4* srcData = (const u8vec4*)srcImage.data;
+    for (int j = 0; j < srcImage.w * srcImage.h; j++) {
+        float luminance = dot(vec3(srcData[j]) / 255.0f, vec3(0.2126f, 0.7152f, 0.0722f));
+        expected[clamp(int(luminance * 256.0f), 0, 255)]++;
+    }
+    //pixels on a bin boundary may be counted in the neighboring bin due to rounding
+    uint32_t total = 0, diff = 0;
+    for (uint32_t j = 0; j < HistogramGPUOp::NUM_BINS; j++) {
+        total += histogram[j];
+        diff += uint32_t(abs(int(histogram[j]) - int(expected[j])));
+    }
+    uint32_t numPixels = uint32_t(srcImage.w * srcImage.h);
+    return (total != numPixels || diff > numPixels / 1000) ? 1 : 0;
+}
+
+class NullOp : public ComputeOp {
+public:
+    NullOp() : ComputeOp(nullptr) {}
+    void apply(CommandBuffer* commandBuffer, Graphics* graphics) override {}
+};
+
+static int testComputeGraph() {
+    //the graph only compares resource handles, so placeholder handles are sufficient
+    uint8_t handles[6];
+    auto buffer = [&](int j) { return reinterpret_cast<Buffer*>(&handles[j]); };
+    auto texture = [&](int j) { return reinterpret_cast<Texture*>(&handles[j]); };
+    NullOp ops[6];
+    ComputeGraph graph(nullptr);
+    graph.addNode(&ops[0], { buffer(0) }, { buffer(1) });
+    graph.addNode(&ops[1], { texture(4) }, { texture(5) });   //independent branch
+    graph.addNode(&ops[2], { buffer(1) }, { buffer(2) });     //read after write
+    graph.addNode(&ops[3], { buffer(1) }, { buffer(3) });     //read after write
+    graph.addNode(&ops[4], { buffer(2), buffer(3) }, { buffer(0) }); //joins both reads
+    graph.addNode(&ops[5], {}, { buffer(1) });                //write after read
+    if (graph.getNumBranches() != 2)
+        return 1;
+    //independent nodes are recorded back to back, and each level only has barriers
+    //on the resources with a pending hazard
+    const uint32_t R = SHADER_ACCESS_READ_BIT, W = SHADER_ACCESS_WRITE_BIT;
+    struct ExpectedBarrier { const void* handle; ShaderAccessFlags srcAccess, dstAccess; };
+    const vector<pair<uint32_t, vector<ExpectedBarrier>>> expected = {
+        { 0, {} }, { 1, {} },
+        { 2, { { buffer(1), W, R } } }, { 3, {} },
+        { 4, { { buffer(2), W, R }, { buffer(3), W, R }, { buffer(0), R, W }, { buffer(1), R, W } } },
+        { 5, {} } };
+    auto schedule = graph.getSchedule();
+    if (schedule.size() != expected.size())
+        return 1;
+    for (uint32_t j = 0; j < expected.size(); j++) {
+        auto& barriers = schedule[j].barriers;
+        if (schedule[j].node != expected[j].first || barriers.size() != expected[j].second.size())
+            return 1;
+        for (uint32_t k = 0; k < barriers.size(); k++) {
+            auto& e = expected[j].second[k];
+            if (barriers[k].buffer != e.handle || barriers[k].texture ||
+                barriers[k].srcAccess != e.srcAccess || barriers[k].dstAccess != e.dstAccess)
+                return 1;
+        }
+    }
+    //a single branch has no dependencies on the other branches
+    schedule = graph.getSchedule(1);
+    if (schedule.size() != 1 || schedule[0].node != 1 || !schedule[0].barriers.empty())
+        return 1;
+    return 0;
+}
+
+//dst = src + 1, on buffers or storage images
+class IncrementOp : public ComputeOp {
+public:
+    IncrementOp(GraphicsContext* ctx, Buffer* src, Buffer* dst, uint32_t size)
+            : ComputeOp(ctx), bSrc(src), bDst(dst), size(size) {
+        computePipeline.reset(ComputePipeline::create(ctx,
+            ComputeShaderModule::create(ctx->device, NGFX_TEST_DATA_DIR "/shaders/testComputeGraph.comp").get()));
+        computePipeline->getBindings({ &U_SRC, &U_DST });
+    }
+    IncrementOp(GraphicsContext* ctx, Texture* src, Texture* dst)
+            : ComputeOp(ctx), srcTexture(src), dstTexture(dst) {
+        computePipeline.reset(ComputePipeline::create(ctx,
+            ComputeShaderModule::create(ctx->device, NGFX_TEST_DATA_DIR "/shaders/testComputeGraphImage.comp").get()));
+        computePipeline->getBindings({ &U_SRC, &U_DST });
+    }
+    void apply(CommandBuffer* commandBuffer, Graphics* graphics) override {
+        graphics->bindComputePipeline(commandBuffer, computePipeline.get());
+        if (srcTexture) {
+            graphics->bindTextureAsImage(commandBuffer, srcTexture, U_SRC);
+            graphics->bindTextureAsImage(commandBuffer, dstTexture, U_DST);
+            graphics->dispatch(commandBuffer, (dstTexture->w + 7) / 8, (dstTexture->h + 7) / 8, 1, 8, 8, 1);
+        }
+        else {
+            graphics->bindStorageBuffer(commandBuffer, bSrc, U_SRC, SHADER_STAGE_COMPUTE_BIT, true);
+            graphics->bindStorageBuffer(commandBuffer, bDst, U_DST, SHADER_STAGE_COMPUTE_BIT, false);
+            graphics->dispatch(commandBuffer, size / 64, 1, 1, 64, 1, 1);
+        }
+    }
+    Buffer *bSrc = nullptr, *bDst = nullptr;
+    Texture *srcTexture = nullptr, *dstTexture = nullptr;
+    uint32_t size = 0;
+    unique_ptr<ComputePipeline> computePipeline;
+    uint32_t U_SRC = 0, U_DST = 1;
+};
+
+static int testComputeGraphGPU() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_graph_gpu", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    //large enough that a missing barrier is likely to be observed
+    const uint32_t SIZE = 1 << 20, W = 256, H = 256;
+    vector<uint32_t> data(SIZE);
+    iota(data.begin(), data.end(), 0);
+    unique_ptr<Buffer> b[4];
+    for (auto& buffer : b)
+        buffer.reset(createStorageBuffer(ctx.get(), data.data(), SIZE * sizeof(uint32_t)));
+    vector<vec4> imageData(W * H);
+    for (uint32_t j = 0; j < imageData.size(); j++)
+        imageData[j] = vec4(float(j % 1000));
+    const uint32_t imageSize = uint32_t(imageData.size() * sizeof(vec4));
+    unique_ptr<Texture> t[3];
+    for (auto& texture : t)
+        texture.reset(Texture::create(ctx.get(), graphics.get(), imageData.data(), PIXELFORMAT_RGBA32_SFLOAT,
+            imageSize, W, H, 1, 1,
+            ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT | IMAGE_USAGE_TRANSFER_DST_BIT)));
+    IncrementOp ops[] = {
+        { ctx.get(), b[0].get(), b[1].get(), SIZE },
+        { ctx.get(), b[1].get(), b[2].get(), SIZE },   //read after write
+        { ctx.get(), b[1].get(), b[3].get(), SIZE },   //read after write
+        { ctx.get(), b[3].get(), b[1].get(), SIZE },   //write after read, read after write
+        { ctx.get(), t[0].get(), t[1].get() },
+        { ctx.get(), t[1].get(), t[2].get() },         //read after write
+        { ctx.get(), t[2].get(), t[1].get() },         //write after read, read after write
+    };
+    ComputeGraph graph(ctx.get());
+    graph.addNode(&ops[0], { b[0].get() }, { b[1].get() });
+    graph.addNode(&ops[1], { b[1].get() }, { b[2].get() });
+    graph.addNode(&ops[2], { b[1].get() }, { b[3].get() });
+    graph.addNode(&ops[3], { b[3].get() }, { b[1].get() });
+    graph.addNode(&ops[4], { t[0].get() }, { t[1].get() });
+    graph.addNode(&ops[5], { t[1].get() }, { t[2].get() });
+    graph.addNode(&ops[6], { t[2].get() }, { t[1].get() });
+    if (graph.getNumBranches() != 2)
+        return 1;
+    //the branches share the levels, and each level has a single barrier call
+    graph.apply(graphics.get());
+    //b1 = b0 + 1, then b2 = b3 = b0 + 2, then b1 = b0 + 3
+    const uint32_t offsets[4] = { 0, 3, 2, 2 };
+    vector<uint32_t> result(SIZE);
+    for (uint32_t k = 0; k < 4; k++) {
+        b[k]->download(result.data(), SIZE * sizeof(uint32_t));
+        for (uint32_t j = 0; j < SIZE; j++) {
+            if (result[j] != data[j] + offsets[k])
+                return 1;
+        }
+    }
+    //t1 = t0 + 1, then t2 = t0 + 2, then t1 = t0 + 3
+    const float imageOffsets[3] = { 0.0f, 3.0f, 2.0f };
+    vector<vec4> imageResult(W * H);
+    for (uint32_t k = 0; k < 3; k++) {
+        t[k]->download(imageResult.data(), imageSize);
+        for (uint32_t j = 0; j < imageResult.size(); j++) {
+            if (imageResult[j] != imageData[j] + imageOffsets[k])
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static int testDispatchIndirect() {
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_dispatch_indirect", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    const uint32_t THREADS_PER_GROUP = 64, NUM_GROUPS = 5, MAX_GROUPS = 8;
+    DispatchIndirectCommand dispatchArgs = { NUM_GROUPS, 1, 1 };
+    unique_ptr<Buffer> bIndirect(createIndirectBuffer(ctx.get(), &dispatchArgs, sizeof(dispatchArgs)));
+    vector<uint32_t> dst(MAX_GROUPS * THREADS_PER_GROUP, 0);
+    unique_ptr<Buffer> bDst(createStorageBuffer(ctx.get(), dst.data(), uint32_t(dst.size() * sizeof(dst[0]))));
+    unique_ptr<ComputePipeline> computePipeline(ComputePipeline::create(ctx.get(),
+        ComputeShaderModule::create(ctx->device, NGFX_TEST_DATA_DIR "/shaders/testDispatchIndirect.comp").get()));
+    uint32_t SSBO_DST = 0;
+    computePipeline->getBindings({ &SSBO_DST });
+    auto commandBuffer = ctx->computeCommandBuffer();
+    commandBuffer->begin();
+    graphics->bindComputePipeline(commandBuffer, computePipeline.get());
+    graphics->bindStorageBuffer(commandBuffer, bDst.get(), SSBO_DST, SHADER_STAGE_COMPUTE_BIT, false);
+    graphics->dispatchIndirect(commandBuffer, bIndirect.get(), 0, THREADS_PER_GROUP, 1, 1);
+    commandBuffer->end();
+    ctx->submit(commandBuffer);
+    ctx->queue->waitIdle();
+    bDst->download(dst.data(), uint32_t(dst.size() * sizeof(dst[0])));
+    //only the groups specified in the indirect buffer are dispatched
+    for (uint32_t j = 0; j < dst.size(); j++) {
+        uint32_t expected = (j < NUM_GROUPS * THREADS_PER_GROUP) ? j + 1 : 0;
+        if (dst[j] != expected)
+            return 1;
+    }
+    return 0;
+}
+
+static uint32_t particleHash(uint32_t v) {
+    uint32_t s = v * 747796405u + 2891336453u;
+    uint32_t word = ((s >> ((s >> 28u) + 4u)) ^ s) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+static float particleRandom(uint32_t& h) {
+    h = particleHash(h);
+    return float(h >> 8u) * (1.0f / 16777216.0f);
+}
+
+//CPU reference of ParticlesGPUOp
+static vector<ParticlesGPUOp::Particle> simulateParticles(const ParticlesGPUOp::Params& params,
+        uint32_t maxParticles, uint32_t numFrames) {
+    vector<ParticlesGPUOp::Particle> particles;
+    for (uint32_t frame = 1; frame <= numFrames; frame++) {
+        vector<ParticlesGPUOp::Particle> alive;
+        for (const auto& p : particles) {
+            float age = p.position.w + params.dt;
+            if (age >= p.velocity.w)
+                continue;
+            vec3 velocity = vec3(p.velocity) + vec3(params.gravity) * params.dt;
+            vec3 position = vec3(p.position) + velocity * params.dt;
+            alive.push_back({ vec4(position, age), vec4(velocity, p.velocity.w) });
+        }
+        uint32_t aliveCount = uint32_t(alive.size());
+        uint32_t newCount = std::min(aliveCount + params.emitCount, maxParticles);
+        for (uint32_t j = 0; aliveCount + j < newCount; j++) {
+            uint32_t h = particleHash(particleHash(params.seed ^ frame) + j);
+            float r0 = particleRandom(h), r1 = particleRandom(h), r2 = particleRandom(h);
+            vec3 velocity = vec3(r0 * 2.0f - 1.0f, 1.0f, r1 * 2.0f - 1.0f) * params.speed;
+            float lifetime = params.minLifetime + r2 * (params.maxLifetime - params.minLifetime);
+            alive.push_back({ vec4(vec3(params.emitterPosition), 0.0f), vec4(velocity, lifetime) });
+        }
+        particles = std::move(alive);
+    }
+    return particles;
+}
+
 static int testParticles() {
-    //TODO
-    return 1;
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_particles", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    //the emission rate exceeds the capacity, so the particle buffer fills up
+    const uint32_t MAX_PARTICLES = 2048, NUM_FRAMES = 64;
+    ParticlesGPUOp::Params params;
+    params.emitterPosition = vec4(1.0f, 2.0f, 3.0f, 0.0f);
+    params.emitCount = 100;
+    params.minLifetime = 0.25f;
+    params.maxLifetime = 0.5f;
+    params.seed = 1234;
+    //capacities beyond the exact range of the float scan are rejected
+    try {
+        ParticlesGPUOp(ctx.get(), ParticlesGPUOp::MAX_PARTICLES + 1, params);
+        return 1;
+    } catch (std::runtime_error&) {
+    }
+    auto op = make_unique<ParticlesGPUOp>(ctx.get(), MAX_PARTICLES, params);
+    auto simulate = [&](vector<ParticlesGPUOp::Particle>& particles) {
+        op->reset();
+        for (uint32_t j = 0; j < NUM_FRAMES; j++)
+            applyGPU(ctx.get(), graphics.get(), op.get());
+        ParticlesGPUOp::State state;
+        op->bState->download(&state, sizeof(state));
+        DrawIndirectCommand drawArgs;
+        op->bDrawArgs->download(&drawArgs, sizeof(drawArgs));
+        if (state.frame != NUM_FRAMES || drawArgs.vertexCount != state.count)
+            return 1;
+        particles.resize(state.count);
+        if (state.count > 0)
+            op->bParticles->download(particles.data(), state.count * sizeof(particles[0]));
+        return 0;
+    };
+    vector<ParticlesGPUOp::Particle> particles[2];
+    if (simulate(particles[0]) || simulate(particles[1]))
+        return 1;
+    //the simulation is deterministic across runs
+    if (particles[0].size() != particles[1].size() ||
+        memcmp(particles[0].data(), particles[1].data(), particles[0].size() * sizeof(particles[0][0])))
+        return 1;
+    //compare against CPU, including the particle order
+    auto refParticles = simulateParticles(params, MAX_PARTICLES, NUM_FRAMES);
+    if (particles[0].size() != refParticles.size())
+        return 1;
+    return compareData(&particles[0][0].position.x, &refParticles[0].position.x,
+        int(refParticles.size() * 8), 1e-5f);
+}
+
+// Draw the particles as points, from an indirect draw reading bDrawArgs, or from a direct draw
+class ParticlesDrawTestOp : public FilterOp {
+public:
+    ParticlesDrawTestOp(GraphicsContext* ctx, Graphics* graphics, int w, int h, ParticlesGPUOp* particlesOp)
+        : FilterOp(ctx, graphics, w, h), particlesOp(particlesOp) {
+        GraphicsPipeline::State state;
+        state.primitiveTopology = PRIMITIVE_TOPOLOGY_POINT_LIST;
+        auto device = ctx->device;
+        graphicsPipeline.reset(GraphicsPipeline::create(
+            ctx, state,
+            VertexShaderModule::create(device, NGFX_TEST_DATA_DIR "/shaders/testParticles.vert").get(),
+            FragmentShaderModule::create(device, NGFX_TEST_DATA_DIR "/shaders/testParticles.frag").get(),
+            ctx->surfaceFormat, ctx->depthStencilFormat));
+        graphicsPipeline->getBindings({}, { &B_POS });
+    }
+    void draw(CommandBuffer* commandBuffer, Graphics* graphics) override {
+        graphics->bindGraphicsPipeline(commandBuffer, graphicsPipeline.get());
+        graphics->bindVertexBuffer(commandBuffer, particlesOp->bParticles.get(), B_POS,
+            sizeof(ParticlesGPUOp::Particle));
+        if (vertexCount < 0)
+            graphics->drawIndirect(commandBuffer, particlesOp->bDrawArgs.get());
+        else
+            graphics->draw(commandBuffer, uint32_t(vertexCount));
+    }
+    ParticlesGPUOp* particlesOp;
+    unique_ptr<GraphicsPipeline> graphicsPipeline;
+    uint32_t B_POS;
+    //the number of vertices of a direct draw, or -1 to draw from bDrawArgs
+    int32_t vertexCount = -1;
+};
+
+static int testParticlesDraw() {
+    UnitTest test("compute_particles_draw");
+    const uint32_t MAX_PARTICLES = 4096, NUM_FRAMES = 32;
+    ParticlesGPUOp::Params params;
+    params.emitterPosition = vec4(0.0f, -0.5f, 0.0f, 0.0f);
+    params.gravity = vec4(0.0f, -1.0f, 0.0f, 0.0f);
+    params.speed = 0.5f;
+    params.seed = 5678;
+    ParticlesGPUOp particlesOp(test.ctx.get(), MAX_PARTICLES, params);
+    auto drawOp = make_unique<ParticlesDrawTestOp>(test.ctx.get(), test.graphics.get(),
+        test.outputWidth, test.outputHeight, &particlesOp);
+    auto render = [&](bool simulate, ImageData& image) {
+        auto commandBuffer = test.ctx->drawCommandBuffer();
+        commandBuffer->begin();
+        for (uint32_t j = 0; simulate && j < NUM_FRAMES; j++)
+            particlesOp.apply(commandBuffer, test.graphics.get());
+        drawOp->apply(test.ctx.get(), commandBuffer, test.graphics.get());
+        commandBuffer->end();
+        test.ctx->queue->submit(commandBuffer);
+        test.ctx->queue->waitIdle();
+        TextureUtil::download(drawOp->outputTexture, image);
+    };
+    //simulate the frames back to back and draw the particles in the same command buffer
+    ImageData images[2];
+    render(true, images[0]);
+    ParticlesGPUOp::State state;
+    particlesOp.bState->download(&state, sizeof(state));
+    auto refParticles = simulateParticles(params, MAX_PARTICLES, NUM_FRAMES);
+    if (state.frame != NUM_FRAMES || state.count == 0 || state.count != refParticles.size())
+        return 1;
+    vector<ParticlesGPUOp::Particle> particles(state.count);
+    particlesOp.bParticles->download(particles.data(), state.count * sizeof(particles[0]));
+    if (compareData(&particles[0].position.x, &refParticles[0].position.x,
+            int(refParticles.size() * 8), 1e-5f))
+        return 1;
+    //the indirect draw matches a direct draw of the particle count read back
+    drawOp->vertexCount = int32_t(state.count);
+    render(false, images[1]);
+    auto result = ImageCompare::compare(images[0], images[1]);
+    if (!result.passed) {
+        NGFX_LOG_WARNING("%s: %s", test.testName.c_str(), result.toString().c_str());
+        return 1;
+    }
+    const uint8_t* pixels = (const uint8_t*)images[0].data;
+    if (all_of(pixels, pixels + images[0].size, [](uint8_t v) { return v == 0; }))
+        return 1;
+    return 0;
 }
 
 static int testColorspaceConversion() {
-    //TODO
-    return 1;
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_colorspace_conversion", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    const int w = 256, h = 128;
+    vector<vec4> rgb(w * h);
+    for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++)
+            rgb[j * w + k] = vec4(float(k) / w, float(j) / h, float((k * 7 + j * 3) % 17) / 16.0f, 1.0f);
+    }
+    unique_ptr<Buffer> bRGB(createStorageBuffer(ctx.get(), rgb.data(), uint32_t(rgb.size() * sizeof(rgb[0]))));
+    const vector<colorspace_t> colorspaces = {
+        { YUV_LAYOUT_I420, 8, COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED, TRANSFER_FUNCTION_NONE },
+        { YUV_LAYOUT_NV12, 8, COLOR_MATRIX_BT709, COLOR_RANGE_FULL, TRANSFER_FUNCTION_NONE },
+        { YUV_LAYOUT_NV12, 16, COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED, TRANSFER_FUNCTION_PQ },
+        { YUV_LAYOUT_I420, 10, COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED, TRANSFER_FUNCTION_HLG },
+        { YUV_LAYOUT_YUV444, 12, COLOR_MATRIX_BT709, COLOR_RANGE_FULL, TRANSFER_FUNCTION_NONE }
+    };
+    for (const auto& colorspace : colorspaces) {
+        uint32_t yuvSize = getYUVImageSize(w, h, colorspace);
+        //RGB to YUV: the samples may differ by 1 due to rounding
+        vector<uint8_t> yuv(yuvSize), yuvRef(yuvSize);
+        convertRGBToYUV({ rgb.data(), w, h }, { yuvRef.data(), w, h }, colorspace);
+        auto rgbToYUVOp = make_unique<ColorspaceConversionGPUOp>(ctx.get(),
+            ColorspaceConversionGPUOp::DIRECTION_RGB_TO_YUV, bRGB.get(), w, h, colorspace);
+        applyGPU(ctx.get(), graphics.get(), rgbToYUVOp.get());
+        rgbToYUVOp->bDst->download(yuv.data(), yuvSize);
+        bool highBitDepth = colorspace.bitDepth > 8;
+        uint32_t numSamples = highBitDepth ? yuvSize / 2 : yuvSize;
+        for (uint32_t j = 0; j < numSamples; j++) {
+            int v0 = highBitDepth ? ((uint16_t*)yuv.data())[j] : yuv[j];
+            int v1 = highBitDepth ? ((uint16_t*)yuvRef.data())[j] : yuvRef[j];
+            if (abs(v0 - v1) > 1)
+                return 1;
+        }
+        //YUV to RGB
+        vector<vec4> rgbOut(w * h), rgbRef(w * h);
+        convertYUVToRGB({ yuvRef.data(), w, h }, { rgbRef.data(), w, h }, colorspace);
+        unique_ptr<Buffer> bYUV(createStorageBuffer(ctx.get(), yuvRef.data(), yuvSize));
+        auto yuvToRGBOp = make_unique<ColorspaceConversionGPUOp>(ctx.get(),
+            ColorspaceConversionGPUOp::DIRECTION_YUV_TO_RGB, bYUV.get(), w, h, colorspace);
+        applyGPU(ctx.get(), graphics.get(), yuvToRGBOp.get());
+        yuvToRGBOp->bDst->download(rgbOut.data(), uint32_t(rgbOut.size() * sizeof(rgbOut[0])));
+        float epsilon = (colorspace.transfer == TRANSFER_FUNCTION_NONE) ? 1e-4f : 1e-3f;
+        if (compareData(&rgbOut[0].x, &rgbRef[0].x, w * h * 4, epsilon))
+            return 1;
+    }
+    return 0;
 }
 
 static int testLensCorrection() {
-    //TODO
-    return 1;
+    const int w = 320, h = 240;
+    ImageData srcImage(w, h);
+    u8vec4* srcData = (u8vec4*)srcImage.data;
+    for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++)
+            srcData[j * w + k] = ((j / 16 + k / 16) % 2) ? u8vec4(k * 255 / w, j * 255 / h, 64, 255)
+                                                          : u8vec4(255, 255 - k * 255 / w, 192, 255);
+    }
+    image_t src = TO_IMG(srcImage);
+    vector<vec2> lut(w * h);
+    vector<u8vec4> dstData(w * h), refData(w * h);
+    //without distortion, the LUT maps each pixel to itself
+    lens_t identity = { LENS_MODEL_BROWN_CONRADY, 300.0f, 300.0f, (w - 1) * 0.5f, (h - 1) * 0.5f,
+        { 0.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }, 1.0f };
+    computeLensLUT(identity, w, h, w, h, lut.data());
+    for (int j = 0; j < w * h; j++) {
+        if (length(lut[j] - vec2(j % w, j / w)) > 1e-3f)
+            return 1;
+    }
+    remap(src, { refData.data(), w, h }, lut.data(), REMAP_FILTER_BICUBIC);
+    for (int j = 0; j < w * h; j++) {
+        ivec4 d = abs(ivec4(refData[j]) - ivec4(srcData[j]));
+        if (d.x > 1 || d.y > 1 || d.z > 1 || d.w > 1)
+            return 1;
+    }
+    //the bicubic filter doesn't overshoot the range of the 4x4 neighborhood at the edges
+    for (int j = 0; j < w * h; j++)
+        lut[j] = vec2(j % w + 0.5f, j / w + 0.3f);
+    remap(src, { refData.data(), w, h }, lut.data(), REMAP_FILTER_BICUBIC);
+    for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++) {
+            ivec4 cMin(255), cMax(0);
+            for (int y = j - 1; y <= j + 2; y++) {
+                for (int x = k - 1; x <= k + 2; x++) {
+                    ivec4 v(srcData[clamp(y, 0, h - 1) * w + clamp(x, 0, w - 1)]);
+                    cMin = min(cMin, v);
+                    cMax = max(cMax, v);
+                }
+            }
+            //the CPU reference truncates
+            ivec4 c(refData[j * w + k]);
+            if (any(lessThan(c, cMin - 1)) || any(greaterThan(c, cMax)))
+                return 1;
+        }
+    }
+    //compare against CPU
+    unique_ptr<GraphicsContext> ctx;
+    ctx.reset(GraphicsContext::create("compute_lens_correction", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics;
+    graphics.reset(Graphics::create(ctx.get()));
+    unique_ptr<Texture> srcTexture(TextureUtil::load(ctx.get(), graphics.get(), srcImage, IMAGE_USAGE_STORAGE_BIT));
+    unique_ptr<Texture> dstTexture(Texture::create(ctx.get(), graphics.get(), nullptr, PIXELFORMAT_RGBA8_UNORM,
+        srcTexture->size, w, h, 1, 1, ImageUsageFlags(IMAGE_USAGE_STORAGE_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT)));
+    const vector<lens_t> lenses = {
+        { LENS_MODEL_BROWN_CONRADY, 300.0f, 300.0f, 161.0f, 118.0f,
+            { -0.28f, 0.07f, 0.0f, 0.0f }, { 0.001f, -0.0005f }, 1.0f },
+        { LENS_MODEL_FISHEYE, 160.0f, 160.0f, 159.5f, 119.5f,
+            { 0.05f, -0.01f, 0.002f, 0.0f }, { 0.0f, 0.0f }, 0.6f }
+    };
+    unique_ptr<LensCorrectionGPUOp> op;
+    for (const lens_t& lens : lenses) {
+        computeLensLUT(lens, w, h, w, h, lut.data());
+        for (RemapFilter filter : { REMAP_FILTER_BILINEAR, REMAP_FILTER_BICUBIC }) {
+            if (!op)
+                op = make_unique<LensCorrectionGPUOp>(ctx.get(), graphics.get(), srcTexture.get(),
+                    dstTexture.get(), lens, filter);
+            else
+                op->update(srcTexture.get(), dstTexture.get(), lens, filter);
+            applyGPU(ctx.get(), graphics.get(), op.get());
+            dstTexture->download(dstData.data(), dstTexture->size);
+            remap(src, { refData.data(), w, h }, lut.data(), filter);
+            //imageStore rounds while the CPU reference truncates
+            for (int j = 0; j < w * h; j++) {
+                ivec4 d = abs(ivec4(dstData[j]) - ivec4(refData[j]));
+                if (d.x > 1 || d.y > 1 || d.z > 1 || d.w > 1)
+                    return 1;
+            }
+        }
+    }
+    return 0;
 }
 
 
@@ -293,15 +1129,54 @@ static int run(ComputeTest computeTest) {
     case MATRIX_MULTIPLY:
         return testMatrixMultiply();
         break;
+    case MATRIX_MULTIPLY_CPU:
+        return testMatrixMultiplyCPU();
+        break;
+    case MATRIX_MULTIPLY_BENCHMARK:
+        return testMatrixMultiplyBenchmark();
+        break;
     case GAUSSIAN:
         return testGaussian();
         break;
+    case CONVOLVE_SEPARABLE:
+        return testConvolveSeparable();
+        break;
+    case CONVOLVE_GPU:
+        return testConvolveGPU();
+        break;
+    case CONVOLVE_CPU:
+        return testConvolveCPU();
+        break;
+    case CONVOLVE_BENCHMARK:
+        return testConvolveBenchmark();
+        break;
     case SUM:
         return testSum();
         break;
+    case REDUCE_MIN_MAX:
+        return testReduceMinMax();
+        break;
+    case SCAN:
+        return testScan();
+        break;
+    case HISTOGRAM:
+        return testHistogram();
+        break;
+    case COMPUTE_GRAPH:
+        return testComputeGraph();
+        break;
+    case COMPUTE_GRAPH_GPU:
+        return testComputeGraphGPU();
+        break;
+    case DISPATCH_INDIRECT:
+        return testDispatchIndirect();
+        break;
     case PARTICLES:
         return testParticles();
         break;
+    case PARTICLES_DRAW:
+        return testParticlesDraw();
+        break;
     case COLORSPACE_CONVERSION:
         return testColorspaceConversion();
         break;
@@ -316,9 +1191,17 @@ int main(int argc, char** argv) {
     if (argc < 2) {
         vector<ComputeTest> computeTests = {
             MATRIX_MULTIPLY,
+            MATRIX_MULTIPLY_CPU,
             GAUSSIAN,
+            CONVOLVE_SEPARABLE,
+            CONVOLVE_GPU,
+            CONVOLVE_CPU,
             SUM,
+            REDUCE_MIN_MAX,
+            SCAN,
+            HISTOGRAM,
             PARTICLES,
+            PARTICLES_DRAW,
             COLORSPACE_CONVERSION,
             LENS_CORRECTION,
         };
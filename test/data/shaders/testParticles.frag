@@ -0,0 +1,7 @@
+#version 320 es
+precision highp float;
+layout (location = 0) out vec4 fragColor;
+
+void main() {
+    fragColor = vec4(1,1,1,1);
+}
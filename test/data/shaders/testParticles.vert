@@ -0,0 +1,11 @@
+#version 450
+layout(location = 0) in vec4 pos;
+out gl_PerVertex {
+	vec4 gl_Position;
+	float gl_PointSize;
+};
+
+void main() {
+	gl_Position = vec4(pos.xy, 0.5, 1.0);
+	gl_PointSize = 1.0;
+}
@@ -1,5 +1,241 @@
 #include <iostream>
+#include <map>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include "ngfx/graphics/RenderPassUtil.h"
+#ifdef NGFX_GRAPHICS_BACKEND_VULKAN
+#include "ngfx/porting/vulkan/VKPhysicalDevice.h"
+#endif
+using namespace std;
 
-int main() {
-	return 0;
+enum MSAATest { TRANSIENT_MEMORY_TYPE, LOAD_STORE_OPS, BANDWIDTH_ESTIMATE };
+
+static const map<string, MSAATest> msaaTestMap = {
+    { "transient_memory_type", TRANSIENT_MEMORY_TYPE },
+    { "load_store_ops", LOAD_STORE_OPS },
+    { "bandwidth_estimate", BANDWIDTH_ESTIMATE }
+};
+
+#ifdef NGFX_GRAPHICS_BACKEND_VULKAN
+using namespace ngfx;
+
+static VkPhysicalDeviceMemoryProperties
+createMemoryProperties(const vector<VkMemoryPropertyFlags> &memoryTypeFlags) {
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    memoryProperties.memoryTypeCount = uint32_t(memoryTypeFlags.size());
+    for (uint32_t j = 0; j < memoryTypeFlags.size(); j++)
+        memoryProperties.memoryTypes[j] = { memoryTypeFlags[j], 0 };
+    return memoryProperties;
+}
+
+static int testTransientMemoryType() {
+    const VkMemoryPropertyFlags DEVICE_LOCAL = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        HOST_VISIBLE = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        LAZILY_ALLOCATED = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    // Tile-based GPU: transient attachments should use lazily allocated memory
+    auto tiledMemoryProperties = createMemoryProperties({
+        DEVICE_LOCAL, DEVICE_LOCAL | HOST_VISIBLE, DEVICE_LOCAL | LAZILY_ALLOCATED });
+    if (VKPhysicalDevice::findMemoryType(tiledMemoryProperties, 0x7,
+            DEVICE_LOCAL, LAZILY_ALLOCATED) != 2)
+        return 1;
+    // Regular allocations should not be affected
+    if (VKPhysicalDevice::findMemoryType(tiledMemoryProperties, 0x7, DEVICE_LOCAL) != 0)
+        return 1;
+    // Memory types not allowed by the resource are skipped
+    if (VKPhysicalDevice::findMemoryType(tiledMemoryProperties, 0x3,
+            DEVICE_LOCAL, LAZILY_ALLOCATED) != 0)
+        return 1;
+    // Desktop GPU: fall back to device local memory
+    auto desktopMemoryProperties = createMemoryProperties({
+        HOST_VISIBLE, DEVICE_LOCAL });
+    if (VKPhysicalDevice::findMemoryType(desktopMemoryProperties, 0x3,
+            DEVICE_LOCAL, LAZILY_ALLOCATED) != 1)
+        return 1;
+    // No match
+    if (VKPhysicalDevice::findMemoryType(desktopMemoryProperties, 0x1,
+            DEVICE_LOCAL, LAZILY_ALLOCATED) != -1)
+        return 1;
+    return 0;
+}
+#else
+static int testTransientMemoryType() {
+    return 0;
+}
+#endif
+
+using AttachmentAccess = ngfx::RenderPassUtil::AttachmentAccess;
+
+static AttachmentAccess createAccess(bool clear, bool fullyOverwritten, bool readAfterPass,
+        bool multisampleReadAfterPass = false) {
+    AttachmentAccess access;
+    access.clear = clear;
+    access.fullyOverwritten = fullyOverwritten;
+    access.readAfterPass = readAfterPass;
+    access.multisampleReadAfterPass = multisampleReadAfterPass;
+    return access;
+}
+
+static ngfx::GraphicsContext::AttachmentDescription createAttachment(ngfx::PixelFormat format,
+        ngfx::AttachmentLoadOp loadOp, ngfx::AttachmentStoreOp storeOp,
+        optional<ngfx::AttachmentStoreOp> multisampleStoreOp = nullopt) {
+    ngfx::GraphicsContext::AttachmentDescription desc;
+    desc.format = format;
+    desc.loadOp = loadOp;
+    desc.storeOp = storeOp;
+    desc.multisampleStoreOp = multisampleStoreOp;
+    return desc;
+}
+
+static int testLoadStoreOps() {
+    using namespace ngfx;
+    const AttachmentLoadOp LOAD = ATTACHMENT_LOAD_OP_LOAD, CLEAR = ATTACHMENT_LOAD_OP_CLEAR,
+        LOAD_DONT_CARE = ATTACHMENT_LOAD_OP_DONT_CARE;
+    const AttachmentStoreOp STORE = ATTACHMENT_STORE_OP_STORE, DONT_CARE = ATTACHMENT_STORE_OP_DONT_CARE;
+    struct TestCase {
+        string name;
+        uint32_t numSamples;
+        AttachmentAccess access;
+        AttachmentLoadOp loadOp;
+        AttachmentStoreOp storeOp;
+        optional<AttachmentStoreOp> multisampleStoreOp;
+    };
+    const vector<TestCase> testCases = {
+        { "clear", 1, createAccess(true, false, true), CLEAR, STORE, nullopt },
+        { "load", 1, createAccess(false, false, true), LOAD, STORE, nullopt },
+        { "dont_care", 1, createAccess(false, true, true), LOAD_DONT_CARE, STORE, nullopt },
+        { "clear_fully_overwritten", 1, createAccess(true, true, true), CLEAR, STORE, nullopt },
+        { "transient", 1, createAccess(true, false, false), CLEAR, DONT_CARE, nullopt },
+        { "msaa_resolve", 4, createAccess(true, false, true), CLEAR, STORE, DONT_CARE },
+        { "msaa_read_after_pass", 4, createAccess(false, false, true, true), LOAD, STORE, STORE },
+        { "msaa_transient", 4, createAccess(true, true, false), CLEAR, DONT_CARE, DONT_CARE },
+    };
+    for (const TestCase& testCase : testCases) {
+        GraphicsContext::RenderPassConfig config;
+        config.numSamples = testCase.numSamples;
+        config.colorAttachmentDescriptions = { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE, STORE) };
+        RenderPassUtil::inferLoadStoreOps(config, { testCase.access });
+        auto& desc = config.colorAttachmentDescriptions[0];
+        if (desc.loadOp != testCase.loadOp || desc.storeOp != testCase.storeOp ||
+                desc.multisampleStoreOp != testCase.multisampleStoreOp) {
+            cerr << "load_store_ops: " << testCase.name << " failed" << endl;
+            return 1;
+        }
+    }
+    // The depth stencil attachment is only set if its access is given
+    GraphicsContext::RenderPassConfig config;
+    config.colorAttachmentDescriptions = { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE) };
+    config.depthStencilAttachmentDescription = createAttachment(PIXELFORMAT_D32_SFLOAT, LOAD, STORE);
+    RenderPassUtil::inferLoadStoreOps(config, { createAccess(true, false, true) });
+    if (config.depthStencilAttachmentDescription->loadOp != LOAD ||
+            config.depthStencilAttachmentDescription->storeOp != STORE)
+        return 1;
+    RenderPassUtil::inferLoadStoreOps(config, { createAccess(true, false, true) },
+        createAccess(true, false, false));
+    if (config.depthStencilAttachmentDescription->loadOp != CLEAR ||
+            config.depthStencilAttachmentDescription->storeOp != DONT_CARE)
+        return 1;
+    // Each color attachment needs an access
+    try {
+        RenderPassUtil::inferLoadStoreOps(config, {});
+        return 1;
+    }
+    catch (const std::runtime_error&) {}
+    return 0;
+}
+
+static int testBandwidthEstimate() {
+    using namespace ngfx;
+    const AttachmentLoadOp LOAD = ATTACHMENT_LOAD_OP_LOAD, CLEAR = ATTACHMENT_LOAD_OP_CLEAR;
+    const AttachmentStoreOp STORE = ATTACHMENT_STORE_OP_STORE, DONT_CARE = ATTACHMENT_STORE_OP_DONT_CARE;
+    // 16x16 pixels, with 4 bytes per pixel
+    const uint32_t W = 16, H = 16;
+    const uint64_t SIZE = W * H * 4;
+    using AttachmentDescription = GraphicsContext::AttachmentDescription;
+    struct TestCase {
+        string name;
+        uint32_t numSamples, layers;
+        vector<AttachmentDescription> color;
+        optional<AttachmentDescription> depthStencil;
+        bool enableDepthStencilResolve;
+        uint64_t loadBytes, storeBytes, resolveBytes;
+    };
+    const vector<TestCase> testCases = {
+        { "load_store", 1, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE) }, nullopt, false,
+            SIZE, SIZE, 0 },
+        { "transient", 1, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, CLEAR, DONT_CARE) }, nullopt, false,
+            0, 0, 0 },
+        { "layers", 1, 2, { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE) }, nullopt, false,
+            2 * SIZE, 2 * SIZE, 0 },
+        { "msaa_resolve", 4, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, CLEAR, STORE, DONT_CARE) }, nullopt, false,
+            0, 0, SIZE },
+        { "msaa_store_samples", 4, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE, STORE) }, nullopt, false,
+            4 * SIZE, 4 * SIZE, SIZE },
+        { "msaa_default_store", 4, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, CLEAR, STORE) }, nullopt, false,
+            0, 4 * SIZE, SIZE },
+        { "msaa_transient", 4, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, CLEAR, DONT_CARE) }, nullopt, false,
+            0, 0, 0 },
+        { "msaa_samples_only", 4, 1, { createAttachment(PIXELFORMAT_RGBA8_UNORM, CLEAR, DONT_CARE, STORE) }, nullopt, false,
+            0, 4 * SIZE, 0 },
+        { "depth_load_store", 1, 1, {}, createAttachment(PIXELFORMAT_D32_SFLOAT, LOAD, STORE), false,
+            SIZE, SIZE, 0 },
+        { "depth_msaa_store", 4, 1, {}, createAttachment(PIXELFORMAT_D32_SFLOAT, CLEAR, STORE), false,
+            0, 4 * SIZE, 0 },
+        { "depth_msaa_resolve", 4, 1, {}, createAttachment(PIXELFORMAT_D32_SFLOAT, CLEAR, STORE), true,
+            0, 0, SIZE },
+        { "color_depth", 1, 1, { createAttachment(PIXELFORMAT_RGBA16_SFLOAT, LOAD, STORE) },
+            createAttachment(PIXELFORMAT_D16_UNORM, CLEAR, DONT_CARE), false,
+            2 * SIZE, 2 * SIZE, 0 },
+    };
+    for (const TestCase& testCase : testCases) {
+        GraphicsContext::RenderPassConfig config;
+        config.numSamples = testCase.numSamples;
+        config.colorAttachmentDescriptions = testCase.color;
+        config.depthStencilAttachmentDescription = testCase.depthStencil;
+        config.enableDepthStencilResolve = testCase.enableDepthStencilResolve;
+        auto estimate = RenderPassUtil::estimateBandwidth(config, W, H, testCase.layers);
+        if (estimate.loadBytes != testCase.loadBytes || estimate.storeBytes != testCase.storeBytes ||
+                estimate.resolveBytes != testCase.resolveBytes ||
+                estimate.total() != testCase.loadBytes + testCase.storeBytes + testCase.resolveBytes) {
+            cerr << "bandwidth_estimate: " << testCase.name << " failed" << endl;
+            return 1;
+        }
+    }
+    // Keeping the multisample contents after the pass stores every sample
+    GraphicsContext::RenderPassConfig config;
+    config.numSamples = 4;
+    config.colorAttachmentDescriptions = { createAttachment(PIXELFORMAT_RGBA8_UNORM, LOAD, STORE) };
+    RenderPassUtil::inferLoadStoreOps(config, { createAccess(true, false, true) });
+    if (RenderPassUtil::estimateBandwidth(config, W, H).total() != SIZE)
+        return 1;
+    RenderPassUtil::inferLoadStoreOps(config, { createAccess(true, false, true, true) });
+    if (RenderPassUtil::estimateBandwidth(config, W, H).total() != 5 * SIZE)
+        return 1;
+    return 0;
+}
+
+static int run(MSAATest msaaTest) {
+    switch (msaaTest) {
+    case TRANSIENT_MEMORY_TYPE:
+        return testTransientMemoryType();
+        break;
+    case LOAD_STORE_OPS:
+        return testLoadStoreOps();
+        break;
+    case BANDWIDTH_ESTIMATE:
+        return testBandwidthEstimate();
+        break;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        int r = 0;
+        for (auto& p : msaaTestMap)
+            r |= run(p.second);
+        return r;
+    }
+    string msaaTestStr = argv[1];
+    return run(msaaTestMap.at(msaaTestStr));
 }
@@ -0,0 +1,856 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "ngfx/core/BaseApplication.h"
+#include "ngfx/core/FileUtil.h"
+#include "ngfx/core/FrameStats.h"
+#include "ngfx/core/Log.h"
+#include "ngfx/core/Trace.h"
+#include "ngfx/drawOps/DrawColorOp.h"
+#include "ngfx/graphics/Colors.h"
+#include "ngfx/graphics/GPUProfiler.h"
+#include "ngfx/graphics/ImageCompare.h"
+#include "ngfx/graphics/MemoryTracker.h"
+#include "test/common/UnitTest.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <json.hpp>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace ngfx;
+using namespace std;
+using json = nlohmann::json;
+
+enum ProfileTest { GPU_PROFILER, PIPELINE_STATISTICS, TRACE, FRAME_STATS, MEMORY_TRACKER, LOG, IMAGE_COMPARE, COMMAND_STATS, BENCHMARK };
+
+static const map<string, ProfileTest> profileTestMap = {
+    { "gpu_profiler", GPU_PROFILER },
+    { "pipeline_statistics", PIPELINE_STATISTICS },
+    { "trace", TRACE },
+    { "frame_stats", FRAME_STATS },
+    { "memory_tracker", MEMORY_TRACKER },
+    { "log", LOG },
+    { "image_compare", IMAGE_COMPARE },
+    { "command_stats", COMMAND_STATS },
+    { "benchmark", BENCHMARK }
+};
+
+// Simulate the queries: each timestamp advances the GPU clock by 10 ticks, and a pipeline
+// statistics query counts the fragments drawn between begin and end.  The recorded commands,
+// including resets, are executed when the test marks the query pool as completed: until then,
+// the results of the previously executed commands remain available, as on a GPU running behind
+class TestQueryPool : public QueryPool {
+public:
+    TestQueryPool(QueryType type, uint32_t count, uint64_t& clock, uint64_t& fragments)
+            : clock(clock), fragments(fragments) {
+        this->type = type;
+        this->count = count;
+        timestampPeriod = 2.0;
+        timestampMask = 0xffffffffull;
+        timestamps.resize(count);
+        statistics.resize(count);
+        recordedTimestamps.resize(count);
+        recordedStatistics.resize(count);
+    }
+    void reset(CommandBuffer*, uint32_t, uint32_t) override {
+        recorded = true;
+    }
+    bool hostReset(uint32_t, uint32_t) override {
+        if (recorded)
+            resetInUse = true;
+        available = false;
+        return true;
+    }
+    void writeTimestamp(CommandBuffer*, uint32_t query) override {
+        clock = (clock + 10) & timestampMask;
+        recordedTimestamps[query] = clock;
+        recorded = true;
+    }
+    void begin(CommandBuffer*, uint32_t query, bool) override {
+        recordedStatistics[query].fragmentShaderInvocations = fragments;
+        recorded = true;
+    }
+    void end(CommandBuffer*, uint32_t query) override {
+        recordedStatistics[query].fragmentShaderInvocations = fragments - recordedStatistics[query].fragmentShaderInvocations;
+    }
+    void complete() {
+        if (!recorded)
+            return;
+        timestamps = recordedTimestamps;
+        statistics = recordedStatistics;
+        available = true;
+        recorded = false;
+    }
+    bool getResults(uint32_t first, uint32_t count, uint64_t* results, bool) override {
+        if (!available)
+            return false;
+        if (type == QUERY_TYPE_PIPELINE_STATISTICS)
+            copy(&statistics[first], &statistics[first] + count, (PipelineStatistics*)results);
+        else
+            copy(&timestamps[first], &timestamps[first] + count, results);
+        return true;
+    }
+    using QueryPool::getResults;
+    vector<uint64_t> timestamps, recordedTimestamps;
+    vector<PipelineStatistics> statistics, recordedStatistics;
+    bool recorded = false, available = false;
+    /** The queries were reset from the host while still in use by the GPU */
+    bool resetInUse = false;
+    uint64_t &clock, &fragments;
+};
+
+class TestGPUProfiler : public GPUProfiler {
+public:
+    TestGPUProfiler(uint32_t numFrames, uint32_t maxScopes, bool pipelineStatistics = true,
+                    uint32_t statsWindow = 120)
+            : pipelineStatistics(pipelineStatistics) {
+        init(nullptr, numFrames, maxScopes, statsWindow);
+    }
+    QueryPool* createQueryPool(QueryType type, uint32_t count) override {
+        if (type == QUERY_TYPE_PIPELINE_STATISTICS && !pipelineStatistics)
+            return nullptr;
+        auto queryPool = new TestQueryPool(type, count, clock, fragments);
+        queryPools[type].push_back(queryPool);
+        return queryPool;
+    }
+    void complete(uint32_t pool) {
+        for (auto& it : queryPools)
+            it.second[pool]->complete();
+    }
+    bool resetInUse() {
+        for (auto& it : queryPools) {
+            for (auto queryPool : it.second) {
+                if (queryPool->resetInUse)
+                    return true;
+            }
+        }
+        return false;
+    }
+    bool pipelineStatistics;
+    map<QueryType, vector<TestQueryPool*>> queryPools;
+    uint64_t clock = 0xffffffe0ull, fragments = 0;
+};
+
+static int testGPUProfiler() {
+    const uint32_t NUM_FRAMES = 3;
+    TestGPUProfiler profiler(NUM_FRAMES, 4);
+    auto recordFrame = [&](uint32_t numDraws) {
+        profiler.beginFrame(nullptr);
+        profiler.beginScope(nullptr, "frame");
+        profiler.beginScope(nullptr, "shadows");
+        profiler.endScope(nullptr);
+        profiler.beginScope(nullptr, "main");
+        for (uint32_t j = 0; j < numDraws; j++) {
+            profiler.beginScope(nullptr, "draw");
+            profiler.endScope(nullptr);
+        }
+        profiler.endScope(nullptr);
+        profiler.endScope(nullptr);
+        profiler.endFrame();
+    };
+    //the results are not available until the GPU completes the frame
+    recordFrame(1);
+    profiler.resolve();
+    if (profiler.resolvedFrame != -1)
+        return 1;
+    profiler.complete(0);
+    recordFrame(1);
+    if (profiler.resolvedFrame != 0)
+        return 1;
+    //the timestamps wrap around the valid bits: frame 0 starts at 0xfffffff0
+    const vector<GPUProfiler::ScopeTiming>& timings = profiler.getTimings();
+    const vector<string> paths = { "frame", "frame/shadows", "frame/main", "frame/main/draw" };
+    const vector<int32_t> parents = { -1, 0, 0, 2 };
+    const vector<double> durations = { 140, 20, 60, 20 }, begins = { 0, 20, 60, 80 };
+    if (timings.size() != paths.size())
+        return 1;
+    for (size_t j = 0; j < timings.size(); j++) {
+        if (timings[j].path != paths[j] || timings[j].parent != parents[j] ||
+            timings[j].depth != uint32_t(count(paths[j].begin(), paths[j].end(), '/')) ||
+            timings[j].duration != durations[j] || timings[j].begin != begins[j])
+            return 1;
+    }
+    recordFrame(1);
+    profiler.complete(1);
+    profiler.complete(2);
+    recordFrame(1);
+    if (profiler.resolvedFrame != 2 || profiler.numDroppedFrames != 0)
+        return 1;
+    //frame 3 reuses the query pool of frame 0: the results of frame 0 are not
+    //mistaken for those of frame 3 while the GPU hasn't executed frame 3
+    profiler.resolve();
+    if (profiler.resolvedFrame != 2)
+        return 1;
+    //frame 3 still uses its query pool, so frame 6 is dropped instead of waiting
+    recordFrame(1);
+    recordFrame(1);
+    recordFrame(1);
+    if (profiler.numDroppedFrames != 1 || profiler.resolvedFrame != 2)
+        return 1;
+    //the completed frames are resolved in order
+    profiler.complete(1);
+    profiler.complete(2);
+    profiler.resolve();
+    if (profiler.resolvedFrame != 2)
+        return 1;
+    profiler.complete(0);
+    recordFrame(1);
+    if (profiler.resolvedFrame != 5 || profiler.getStats()["frame/main/draw"].numSamples != 6)
+        return 1;
+    //scopes beyond maxScopes are not measured
+    recordFrame(4);
+    if (profiler.resolvedFrame != 5)
+        return 1;
+    profiler.complete(1);
+    profiler.complete(2);
+    recordFrame(1);
+    auto stats = profiler.getStats();
+    if (profiler.resolvedFrame != 8 || profiler.getTimings().size() != 4 ||
+        stats["frame/main/draw"].numSamples != 8 || stats["frame/main/draw"].max != 20.0 ||
+        stats["frame"].avg != 140.0 || stats["frame/shadows"].last != 20.0)
+        return 1;
+    if (profiler.numDroppedFrames != 1 || profiler.resetInUse())
+        return 1;
+    //the rolling statistics cover the last statsWindow resolved frames
+    TestGPUProfiler windowProfiler(2, 8, true, 2);
+    for (uint32_t numDraws = 1; numDraws <= 3; numDraws++) {
+        windowProfiler.beginFrame(nullptr);
+        windowProfiler.beginScope(nullptr, "frame");
+        for (uint32_t j = 0; j < numDraws; j++) {
+            windowProfiler.beginScope(nullptr, "draw");
+            windowProfiler.endScope(nullptr);
+        }
+        windowProfiler.endScope(nullptr);
+        windowProfiler.endFrame();
+        windowProfiler.complete((numDraws - 1) % 2);
+        windowProfiler.resolve();
+    }
+    auto windowStats = windowProfiler.getStats()["frame"];
+    if (windowProfiler.getStatsWindow() != 2 || windowStats.numSamples != 2 ||
+        windowStats.last != 140.0 || windowStats.min != 100.0 || windowStats.avg != 120.0)
+        return 1;
+    return 0;
+}
+
+static int testPipelineStatistics() {
+    TestGPUProfiler profiler(2, 8);
+    if (!profiler.supportsPipelineStatistics())
+        return 1;
+    auto draw = [&](const string& name, uint64_t numFragments) {
+        profiler.beginScope(nullptr, name, true);
+        profiler.fragments += numFragments;
+        profiler.endScope(nullptr);
+    };
+    profiler.beginFrame(nullptr);
+    profiler.beginScope(nullptr, "frame");
+    draw("background", 1000);
+    draw("sprite", 50);
+    draw("sprite", 70);
+    //only one scope collects pipeline statistics at a time
+    profiler.beginScope(nullptr, "overlay", true);
+    profiler.fragments += 200;
+    draw("text", 30);
+    profiler.endScope(nullptr);
+    profiler.endScope(nullptr);
+    profiler.endFrame();
+    profiler.complete(0);
+    profiler.resolve();
+    const vector<GPUProfiler::ScopeTiming>& timings = profiler.getTimings();
+    const vector<bool> hasPipelineStatistics = { false, true, true, true, true, false };
+    const vector<uint64_t> numFragments = { 0, 1000, 50, 70, 230, 0 };
+    if (timings.size() != hasPipelineStatistics.size())
+        return 1;
+    for (size_t j = 0; j < timings.size(); j++) {
+        if (timings[j].hasPipelineStatistics != hasPipelineStatistics[j] ||
+            timings[j].pipelineStatistics.fragmentShaderInvocations != numFragments[j])
+            return 1;
+    }
+    //the statistics of a scope drawn several times are summed
+    auto stats = profiler.getStats();
+    if (stats["frame"].hasPipelineStatistics || !stats["frame/sprite"].hasPipelineStatistics ||
+        stats["frame/sprite"].pipelineStatistics.fragmentShaderInvocations != 120 ||
+        stats["frame/background"].pipelineStatistics.fragmentShaderInvocations != 1000)
+        return 1;
+    //without device support, the scopes are only timed
+    TestGPUProfiler timestampProfiler(2, 8, false);
+    if (timestampProfiler.supportsPipelineStatistics())
+        return 1;
+    timestampProfiler.beginFrame(nullptr);
+    timestampProfiler.beginScope(nullptr, "background", true);
+    timestampProfiler.endScope(nullptr);
+    timestampProfiler.endFrame();
+    timestampProfiler.complete(0);
+    timestampProfiler.resolve();
+    if (timestampProfiler.getTimings().size() != 1 ||
+        timestampProfiler.getTimings()[0].hasPipelineStatistics ||
+        timestampProfiler.getTimings()[0].duration != 20.0)
+        return 1;
+    return 0;
+}
+
+static int testTrace() {
+#ifdef NGFX_ENABLE_TRACE
+    //zones outside start/stop are not recorded
+    { NGFX_TRACE_ZONE("test", "disabled"); }
+    Trace::start();
+    Trace::setThreadName("main");
+    {
+        NGFX_TRACE_ZONE("test", "outer");
+        NGFX_TRACE_ZONE("test", "inner \"quoted\"");
+    }
+    thread worker([]() {
+        for (int j = 0; j < 3; j++) {
+            NGFX_TRACE_ZONE("test", "task");
+        }
+    });
+    worker.join();
+    //the GPU profiler adds its resolved scopes to the GPU track
+    TestGPUProfiler profiler(2, 4);
+    profiler.beginFrame(nullptr);
+    profiler.beginScope(nullptr, "frame");
+    profiler.endScope(nullptr);
+    profiler.endFrame();
+    profiler.complete(0);
+    profiler.resolve();
+    Trace::stop();
+    { NGFX_TRACE_ZONE("test", "disabled"); }
+    const string filename = "tmp_trace.json";
+    if (!Trace::writeJSON(filename))
+        return 1;
+    json trace = json::parse(FileUtil::readFile(filename));
+    map<string, int> numZones;
+    map<string, set<int>> zoneThreads;
+    for (auto& e : trace["traceEvents"]) {
+        if (e["ph"] != "X")
+            continue;
+        string name = e["name"];
+        numZones[name]++;
+        zoneThreads[name].insert(int(e["tid"]));
+        if (double(e["dur"]) < 0.0)
+            return 1;
+    }
+    if (numZones.count("disabled") || numZones["outer"] != 1 || numZones["inner \"quoted\""] != 1 ||
+        numZones["task"] != 3 || numZones["frame"] != 1)
+        return 1;
+    //each thread and the GPU have their own track
+    int mainTid = *zoneThreads["outer"].begin(), workerTid = *zoneThreads["task"].begin(),
+        gpuTid = *zoneThreads["frame"].begin();
+    if (mainTid == workerTid || mainTid == gpuTid || workerTid == gpuTid)
+        return 1;
+    if (Trace::getNumDroppedZones() != 0 || trace["otherData"]["droppedZones"] != 0)
+        return 1;
+    //each thread keeps its most recent zones, and counts the dropped zones
+    const uint32_t MAX_ZONES = 4, NUM_ZONES = 10;
+    static const char* zoneNames[NUM_ZONES] = { "z0", "z1", "z2", "z3", "z4", "z5", "z6", "z7", "z8", "z9" };
+    Trace::start(MAX_ZONES);
+    for (uint32_t j = 0; j < NUM_ZONES; j++) {
+        NGFX_TRACE_ZONE("test", zoneNames[j]);
+    }
+    //the GPU zone names are copied
+    for (uint32_t j = 0; j < 2; j++) {
+        string name = "gpu" + to_string(j);
+        uint64_t t = Trace::now();
+        Trace::addGPUZone(name, t, t + 1000);
+    }
+    Trace::stop();
+    if (Trace::getNumDroppedZones() != NUM_ZONES - MAX_ZONES || !Trace::writeJSON(filename))
+        return 1;
+    trace = json::parse(FileUtil::readFile(filename));
+    vector<string> names;
+    for (auto& e : trace["traceEvents"]) {
+        if (e["ph"] == "X")
+            names.push_back(e["name"]);
+    }
+    if (names != vector<string>({ "z6", "z7", "z8", "z9", "gpu0", "gpu1" }) ||
+        trace["otherData"]["droppedZones"] != NUM_ZONES - MAX_ZONES)
+        return 1;
+    Trace::clear();
+    Trace::start();
+    Trace::stop();
+    if (Trace::getNumDroppedZones() != 0)
+        return 1;
+#endif
+    return 0;
+}
+
+static int testFrameStats() {
+    //the sliding window only keeps the last 100 frames: 1, 2, ..., 100 ms
+    FrameStats stats(100);
+    for (int j = 0; j < 1000; j++)
+        stats.add(1000.0);
+    for (int j = 1; j <= 100; j++)
+        stats.add(double(j));
+    auto summary = stats.getSummary();
+    if (summary.numSamples != 100 || summary.min != 1.0 || summary.max != 100.0 ||
+        summary.avg != 50.5 || summary.p50 != 50.0 || summary.p95 != 95.0 || summary.p99 != 99.0)
+        return 1;
+    //the histogram keeps all the frames, with a bounded relative error
+    const FrameStats::Histogram& histogram = stats.getHistogram();
+    if (histogram.totalCount != 1100)
+        return 1;
+    double p50 = histogram.getPercentile(50.0), p99 = histogram.getPercentile(99.0);
+    if (fabs(p50 - 1000.0) > 1000.0 * 0.04 || fabs(p99 - 1000.0) > 1000.0 * 0.04)
+        return 1;
+    if (fabs(histogram.getPercentile(5.0) - 55.0) > 55.0 * 0.04)
+        return 1;
+    //the buckets are contiguous, and each value falls in its bucket
+    double lower, upper, prevUpper = 0.0;
+    for (uint32_t j = 0; j < histogram.getNumBuckets(); j++) {
+        histogram.getBucketRange(j, lower, upper);
+        if (lower != prevUpper || upper <= lower || (lower >= 0.032 && (upper - lower) / lower > 0.07))
+            return 1;
+        prevUpper = upper;
+    }
+    for (double v : { 0.0005, 0.0315, 0.0325, 16.667, 33.3, 60000.0 }) {
+        FrameStats::Histogram h;
+        h.add(v);
+        for (uint32_t j = 0; j < h.getNumBuckets(); j++) {
+            h.getBucketRange(j, lower, upper);
+            if (h.getCount(j) && (v < lower - 1e-9 || v >= upper + 1e-9))
+                return 1;
+        }
+    }
+    stats.reset();
+    if (stats.getSummary().numSamples != 0 || stats.getHistogram().totalCount != 0)
+        return 1;
+    //an empty window is rejected
+    for (int j = 0; j < 2; j++) {
+        try {
+            if (j == 0)
+                FrameStats invalidStats(0);
+            else
+                FPSCounter invalidCounter(0);
+            return 1;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    //a window of 1 frame keeps the last frame
+    FrameStats lastFrame(1);
+    lastFrame.add(2.0);
+    lastFrame.add(3.0);
+    summary = lastFrame.getSummary();
+    if (summary.numSamples != 1 || summary.min != 3.0 || summary.max != 3.0)
+        return 1;
+    return 0;
+}
+
+static int testMemoryTracker() {
+    MemoryTracker tracker;
+    int vertexBuffer, texture, stagingBuffer;
+    tracker.onAllocate(&vertexBuffer, MEMORY_CATEGORY_VERTEX, 1024, false, "vertices");
+    tracker.onAllocate(&texture, MEMORY_CATEGORY_TEXTURE, 4096, false);
+    tracker.setName(&texture, "albedo");
+    tracker.addImageViews(&texture, 2);
+    tracker.addDescriptorSets(&texture, 1);
+    tracker.onAllocate(&stagingBuffer, MEMORY_CATEGORY_STAGING, 4096, true);
+    tracker.onFree(&stagingBuffer);
+    //freeing twice, or freeing an unknown resource, is ignored
+    tracker.onFree(&stagingBuffer);
+    auto snapshot = tracker.getSnapshot();
+    if (snapshot.totalBytes != 5120 || snapshot.peakTotalBytes != 9216 ||
+        snapshot.deviceLocalBytes != 5120 || snapshot.hostVisibleBytes != 0 ||
+        snapshot.numAllocations != 2 || snapshot.numImageViews != 2 || snapshot.numDescriptorSets != 1)
+        return 1;
+    auto& staging = snapshot.categories[MEMORY_CATEGORY_STAGING];
+    if (staging.bytes != 0 || staging.count != 0 || staging.peakBytes != 4096 || staging.peakCount != 1)
+        return 1;
+    if (snapshot.allocations.size() != 2 || snapshot.allocations[0].name != "albedo" ||
+        snapshot.allocations[1].name != "vertices")
+        return 1;
+    tracker.resetPeak();
+    if (tracker.getSnapshot(false).peakTotalBytes != 5120 || !tracker.getSnapshot(false).allocations.empty())
+        return 1;
+    //only the live resources are reported as leaks
+    string leakReport = tracker.getLeakReport();
+    if (leakReport.find("albedo") == string::npos || leakReport.find("vertices") == string::npos ||
+        leakReport.find("staging") != string::npos)
+        return 1;
+    tracker.onFree(&vertexBuffer);
+    tracker.onFree(&texture);
+    if (!tracker.getLeakReport().empty() || tracker.getSnapshot().totalBytes != 0)
+        return 1;
+    return 0;
+}
+
+static int testLog() {
+    mutex recordsMutex;
+    vector<Log::Record> records;
+    atomic<bool> blockSink(false);
+    Log::setSink([&](const Log::Record& record) {
+        while (blockSink)
+            this_thread::yield();
+        lock_guard<mutex> lock(recordsMutex);
+        records.push_back(record);
+    });
+    Log::setLevel(LOG_LEVEL_INFO);
+    //the arguments are formatted by the background thread, after the strings went out of scope
+    {
+        string str = "temporary";
+        char deviceName[16] = "device";
+        NGFX_LOG_INFO("%s %s %d %u %.2f %5.1f%% %x %c %lld %-4s|", str, deviceName, -3, 7u, 1.5, 99.0, 255, 'z',
+                 (long long)1 << 40, str.c_str());
+        NGFX_LOG_WARNING("%*d|", 4, 42);
+    }
+    //the arguments of filtered records are not evaluated
+    int numEvaluated = 0;
+    NGFX_LOG_DEBUG("%d", ++numEvaluated);
+    NGFX_LOG_VERBOSE("%d", ++numEvaluated);
+    if (numEvaluated != 0)
+        return 1;
+    Log::flush();
+    {
+        lock_guard<mutex> lock(recordsMutex);
+        if (records.size() != 2 ||
+            records[0].message != "temporary device -3 7 1.50  99.0% ff z 1099511627776 temporary|" ||
+            records[0].level != LOG_LEVEL_INFO || records[0].line == 0 ||
+            records[1].message != "  42|" || records[1].level != LOG_LEVEL_WARNING)
+            return 1;
+        records.clear();
+    }
+    //the records are dropped instead of blocking the producers when the ring buffer is full
+    blockSink = true;
+    const uint32_t numRecords = 5000;
+    for (uint32_t j = 0; j < numRecords; j++)
+        NGFX_LOG_INFO("record %u", j);
+    uint64_t numDropped = Log::getNumDropped();
+    blockSink = false;
+    Log::flush();
+    {
+        lock_guard<mutex> lock(recordsMutex);
+        if (numDropped == 0 || records.size() + numDropped != numRecords ||
+            records[0].message != "record 0")
+            return 1;
+        records.clear();
+    }
+    //synchronous mode, and long strings are truncated
+    Log::setAsync(false);
+    NGFX_LOG_INFO("%s", string(1000, 'x'));
+    Log::setAsync(true);
+    if (records.size() != 1 || records[0].message.size() >= 1000 ||
+        records[0].message.find("[truncated]") == string::npos)
+        return 1;
+    records.clear();
+    //errors are written synchronously, with the full message
+    string errorMessage;
+    try {
+        NGFX_ERR("%s", string(1000, 'y').c_str());
+    } catch (const std::runtime_error& e) {
+        errorMessage = e.what();
+    }
+    if (records.size() != 1 || records[0].level != LOG_LEVEL_ERROR ||
+        errorMessage.size() < 1000 || records[0].message != errorMessage)
+        return 1;
+    records.clear();
+    //the sink can write records, from the calling thread and from the background thread,
+    //and they go to the default output
+    Log::setSink([&](const Log::Record& record) {
+        {
+            lock_guard<mutex> lock(recordsMutex);
+            records.push_back(record);
+        }
+        if (record.message == "outer")
+            NGFX_LOG_ERROR("inner");
+    });
+    NGFX_LOG_ERROR("outer");
+    NGFX_LOG_WARNING("outer");
+    Log::flush();
+    Log::setSink(nullptr);
+    lock_guard<mutex> lock(recordsMutex);
+    return (records.size() == 2 && records[0].message == "outer" &&
+            records[1].message == "outer") ? 0 : 1;
+}
+
+static int testImageCompare() {
+    //use an odd width to cover the remaining pixels of each row
+    const int w = 67, h = 45;
+    ImageData ref(w, h), image(w, h);
+    uint8_t* refData = (uint8_t*)ref.data;
+    for (int j = 0; j < ref.size; j++)
+        refData[j] = uint8_t((j * 7 + (j / (w * 4)) * 3) & 0xFF);
+    memcpy(image.data, ref.data, ref.size);
+    auto result = ImageCompare::compare(image, ref);
+    if (!result.passed || result.numDifferentPixels != 0 || !isinf(result.psnr) ||
+        result.ssim != 1.0 || result.meanDeltaE != 0.0)
+        return 1;
+    //1-LSB differences only pass with a tolerance
+    uint8_t* imageData = (uint8_t*)image.data;
+    for (int j = 0; j < image.size; j++)
+        imageData[j] = refData[j] ^ 1;
+    result = ImageCompare::compare(image, ref);
+    if (result.passed || result.numDifferentPixels != uint64_t(w * h) || result.maxDifference[3] != 1 ||
+        result.mse != 1.0 || fabs(result.psnr - 48.13) > 0.01 || result.ssim < 0.99)
+        return 1;
+    ImageCompare::Options options;
+    options.setTolerance(1);
+    if (!ImageCompare::compare(image, ref, options).passed)
+        return 1;
+    //a single different pixel, highlighted in the heatmap
+    memcpy(image.data, ref.data, ref.size);
+    const int x = 66, y = 20;
+    imageData[(y * w + x) * 4 + 1] += 100;
+    result = ImageCompare::compare(image, ref, options);
+    if (result.passed || result.numDifferentPixels != 1 || result.maxDifference[1] != 100 ||
+        result.maxDifference[0] != 0 || result.maxDeltaE < 10.0)
+        return 1;
+    options.maxDifferentPixels = 1.0 / (w * h);
+    if (!ImageCompare::compare(image, ref, options).passed)
+        return 1;
+    options.maxMeanDeltaE = result.meanDeltaE * 0.5;
+    if (ImageCompare::compare(image, ref, options).passed)
+        return 1;
+    ImageData heatmap;
+    ImageCompare::diffHeatmap(image, ref, heatmap, options);
+    const uint8_t* heatmapData = (const uint8_t*)heatmap.data;
+    auto isGray = [&](int px, int py) {
+        const uint8_t* p = &heatmapData[(py * w + px) * 4];
+        return p[0] == p[1] && p[1] == p[2] && p[3] == 255;
+    };
+    if (heatmap.w != w || heatmap.h != h || isGray(x, y) || !isGray(x - 1, y) || !isGray(0, 0))
+        return 1;
+    //noise lowers the SSIM and PSNR, and 3-channel images use the generic path
+    ImageData ref3(w, h, 3), image3(w, h, 3);
+    uint8_t *ref3Data = (uint8_t*)ref3.data, *image3Data = (uint8_t*)image3.data;
+    for (int j = 0; j < ref3.size; j++)
+        ref3Data[j] = uint8_t(128 + 100 * sin(j * 0.01));
+    auto compareNoise = [&](int amplitude) {
+        uint64_t sumSquares = 0;
+        for (int j = 0; j < ref3.size; j++) {
+            int noise = int((j * 2654435761u) % (2 * amplitude + 1)) - amplitude;
+            image3Data[j] = uint8_t(ref3Data[j] + noise);
+            sumSquares += noise * noise;
+        }
+        auto result = ImageCompare::compare(image3, ref3);
+        return fabs(result.mse - double(sumSquares) / ref3.size) < 1e-9 ? result : ImageCompare::Result();
+    };
+    auto lowNoise = compareNoise(4), highNoise = compareNoise(20);
+    if (lowNoise.ssim >= 1.0 || highNoise.ssim >= lowNoise.ssim || highNoise.ssim <= 0.0 ||
+        highNoise.psnr >= lowNoise.psnr || highNoise.meanDeltaE <= lowNoise.meanDeltaE || lowNoise.mse == 0.0)
+        return 1;
+    //different sizes never match
+    ImageData small(w - 1, h);
+    result = ImageCompare::compare(small, ref);
+    return (result.sizeMismatch && !result.passed) ? 0 : 1;
+}
+
+// Draw a triangle and an indexed quad to the output texture
+class CommandStatsTestOp : public FilterOp {
+public:
+    CommandStatsTestOp(GraphicsContext* ctx, Graphics* graphics, Texture* outputTexture)
+        : FilterOp(ctx, graphics, outputTexture) {
+        using glm::vec2;
+        vector<vec2> pos = { vec2(-1.0f, 1.0f), vec2(0.0f, -1.0f), vec2(1.0f, 1.0f) };
+        op[0] = make_unique<DrawColorOp>(ctx, pos, Color::Red);
+        pos = { vec2(-1.0f, 1.0f), vec2(-1.0f, 0.0f), vec2(0.0f, 1.0f), vec2(0.0f) };
+        op[1] = make_unique<DrawColorOp>(ctx, pos, Color::Green, nullptr, vector<glm::i32>{ 0, 1, 2, 3 });
+    }
+    void draw(CommandBuffer* commandBuffer, Graphics* graphics) override {
+        op[0]->draw(commandBuffer, graphics);
+        op[1]->draw(commandBuffer, graphics);
+    }
+    std::unique_ptr<DrawColorOp> op[2];
+};
+
+static int testCommandStats() {
+    UnitTest test("command_stats", 64, 64);
+    auto ctx = test.ctx.get();
+    auto graphics = test.graphics.get();
+    const uint32_t w = 64, h = 64, size = w * h * 4;
+    SamplerDesc samplerDesc = {
+        FILTER_LINEAR, FILTER_LINEAR, FILTER_LINEAR,
+        CLAMP_TO_EDGE, CLAMP_TO_EDGE, CLAMP_TO_EDGE
+    };
+    unique_ptr<Texture> texture(Texture::create(ctx, graphics, nullptr, PIXELFORMAT_RGBA8_UNORM, size, w, h, 1, 1,
+        ImageUsageFlags(IMAGE_USAGE_SAMPLED_BIT | IMAGE_USAGE_TRANSFER_SRC_BIT | IMAGE_USAGE_TRANSFER_DST_BIT |
+                        IMAGE_USAGE_COLOR_ATTACHMENT_BIT),
+        TEXTURE_TYPE_2D, false, 1, &samplerDesc));
+    auto op = make_unique<CommandStatsTestOp>(ctx, graphics, texture.get());
+    auto copyCommandBuffer = ctx->copyCommandBuffer();
+    vector<uint8_t> data(size, 128);
+    auto isEqual = [](const CommandStats& s0, const CommandStats& s1) {
+        return s0.numDraws == s1.numDraws && s0.numDispatches == s1.numDispatches &&
+            s0.numRenderPasses == s1.numRenderPasses && s0.numPipelineBinds == s1.numPipelineBinds &&
+            s0.numDescriptorSetBinds == s1.numDescriptorSetBinds &&
+            s0.numVertexBufferBinds == s1.numVertexBufferBinds &&
+            s0.numIndexBufferBinds == s1.numIndexBufferBinds &&
+            s0.numBarriers == s1.numBarriers && s0.numCopies == s1.numCopies;
+    };
+    //an upload records a copy between the transitions to and from the transfer layout,
+    //and the copy command buffer is included in the total without going through the graphics interface
+    CommandStats uploadStats;
+    uploadStats.numBarriers = 2;
+    uploadStats.numCopies = 1;
+    graphics->resetStats();
+    texture->upload(data.data(), size);
+    if (!isEqual(graphics->getStats(copyCommandBuffer), uploadStats) || !isEqual(graphics->getStats(), uploadStats))
+        return 1;
+    //the counters restart when the command buffer is recorded again
+    texture->upload(data.data(), size);
+    if (!isEqual(graphics->getStats(copyCommandBuffer), uploadStats) || !isEqual(graphics->getStats(), uploadStats))
+        return 1;
+    graphics->resetStats();
+    if (!isEqual(graphics->getStats(), CommandStats()) || !isEqual(graphics->getStats(copyCommandBuffer), CommandStats()))
+        return 1;
+    //the filter transitions the output texture to the color attachment layout and back,
+    //and each draw binds a pipeline, a vertex buffer and a uniform buffer
+    auto commandBuffer = ctx->drawCommandBuffer();
+    commandBuffer->begin();
+    op->apply(ctx, commandBuffer, graphics);
+    commandBuffer->end();
+    ctx->queue->submit(commandBuffer);
+    ctx->queue->waitIdle();
+    CommandStats drawStats;
+    drawStats.numDraws = 2;
+    drawStats.numRenderPasses = 1;
+    drawStats.numPipelineBinds = 2;
+    drawStats.numDescriptorSetBinds = 2;
+    drawStats.numVertexBufferBinds = 2;
+    drawStats.numIndexBufferBinds = 1;
+    drawStats.numBarriers = 2;
+    auto stats = graphics->getStats(commandBuffer);
+    if (!isEqual(stats, drawStats) || stats.recordingTime < 0.0 || !isEqual(graphics->getStats(), drawStats))
+        return 1;
+    //the download adds a transition to the transfer layout and a copy
+    texture->download(data.data(), size);
+    CommandStats totalStats = drawStats;
+    totalStats.numBarriers += 1;
+    totalStats.numCopies += 1;
+    if (!isEqual(graphics->getStats(), totalStats))
+        return 1;
+    graphics->resetStats();
+    if (!isEqual(graphics->getStats(), CommandStats()) || !isEqual(graphics->getStats(commandBuffer), CommandStats()))
+        return 1;
+    return 0;
+}
+
+// Draw a triangle offscreen
+class BenchmarkTestApp : public BaseApplication {
+public:
+    BenchmarkTestApp() : BaseApplication("benchmark", 128, 128) {}
+    void onInit() override {
+        vector<glm::vec2> pos = { glm::vec2(-0.5f, 0.5f), glm::vec2(0.0f, -0.5f), glm::vec2(0.5f, 0.5f) };
+        op = make_unique<DrawColorOp>(graphicsContext.get(), pos, Color::Red);
+    }
+    void onRecordCommandBuffer(CommandBuffer* commandBuffer) override {
+        graphicsContext->beginOffscreenRenderPass(commandBuffer, graphics.get(), outputFramebuffer.get());
+        op->draw(commandBuffer, graphics.get());
+        graphicsContext->endRenderPass(commandBuffer, graphics.get());
+    }
+    unique_ptr<DrawColorOp> op;
+};
+
+static int testBenchmark() {
+    const uint32_t NUM_FRAMES = 10, NUM_WARMUP_FRAMES = 2;
+    const string filename = "tmp_benchmark.json";
+    for (bool persistentCommandBuffers : { true, false }) {
+        BenchmarkTestApp app;
+        app.persistentCommandBuffers = persistentCommandBuffers;
+        app.enableGPUProfiler = !persistentCommandBuffers;
+        app.benchmarkOptions.enable = true;
+        app.benchmarkOptions.numFrames = NUM_FRAMES;
+        app.benchmarkOptions.numWarmupFrames = NUM_WARMUP_FRAMES;
+        app.benchmarkOptions.w = 64;
+        app.benchmarkOptions.h = 32;
+        app.benchmarkOptions.outputFile = filename;
+        app.run();
+        json report = json::parse(FileUtil::readFile(filename));
+        if (report["app"] != "benchmark" || report["width"] != 64 || report["height"] != 32 ||
+            report["frames"] != NUM_FRAMES || report["warmup_frames"] != NUM_WARMUP_FRAMES ||
+            report["persistent_command_buffers"] != persistentCommandBuffers)
+            return 1;
+        if (report["total_ms"].get<double>() <= 0.0 || report["fps"].get<double>() <= 0.0)
+            return 1;
+        //every measured frame has a frame time, including the first one
+        for (const char* key : { "frame_time", "cpu_time" }) {
+            auto& stats = report[key];
+            if (stats["samples"] != NUM_FRAMES || stats["min_ms"].get<double>() > stats["avg_ms"].get<double>() ||
+                stats["avg_ms"].get<double>() > stats["max_ms"].get<double>())
+                return 1;
+        }
+        //the same commands are submitted every frame
+        auto& commands = report["commands_per_frame"];
+        if (commands["draws"] != 1.0 || commands["render_passes"] != 1.0 ||
+            commands["pipeline_binds"] != 1.0 || commands["dispatches"] != 0.0 ||
+            commands.contains("recording_ms") == persistentCommandBuffers)
+            return 1;
+        auto& memory = report["memory"];
+        if (memory["bytes"].get<uint64_t>() == 0 || memory["peak_bytes"] < memory["bytes"])
+            return 1;
+        //the GPU time is only measured with a GPU profiler, and it is resolved a few frames later
+        if (app.gpuProfiler) {
+            if (!report.contains("gpu_time") || report["gpu_time"]["samples"] > NUM_FRAMES)
+                return 1;
+        }
+        else if (report.contains("gpu_time"))
+            return 1;
+    }
+    FileUtil::remove(filename);
+    return 0;
+}
+
+static int run(ProfileTest profileTest) {
+    switch (profileTest) {
+    case GPU_PROFILER:
+        return testGPUProfiler();
+        break;
+    case PIPELINE_STATISTICS:
+        return testPipelineStatistics();
+        break;
+    case TRACE:
+        return testTrace();
+        break;
+    case FRAME_STATS:
+        return testFrameStats();
+        break;
+    case MEMORY_TRACKER:
+        return testMemoryTracker();
+        break;
+    case LOG:
+        return testLog();
+        break;
+    case IMAGE_COMPARE:
+        return testImageCompare();
+        break;
+    case COMMAND_STATS:
+        return testCommandStats();
+        break;
+    case BENCHMARK:
+        return testBenchmark();
+        break;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        int r = 0;
+        for (auto& p : profileTestMap)
+            r |= run(p.second);
+        return r;
+    }
+    string profileTestStr = argv[1];
+    return run(profileTestMap.at(profileTestStr));
+}
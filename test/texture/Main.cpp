@@ -1,9 +1,19 @@
 #include <iostream>
 #include "ngfx/drawOps/DrawTextureOp.h"
+#include "ngfx/graphics/FormatUtil.h"
+#include "ngfx/graphics/ImageUtil.h"
+#include "ngfx/graphics/TextureStreamer.h"
 #include "ngfx/graphics/TextureUtil.h"
 #include "test/common/UnitTest.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
 using namespace ngfx;
 using namespace std;
+namespace fs = std::filesystem;
 
 class TextureTestOp : public FilterOp {
 public:
@@ -30,8 +40,212 @@ int run() {
     return test.run();
 }
 
+int testTextureStreamer() {
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("texture_streamer", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics(Graphics::create(ctx.get()));
+    //each full resolution texture uses 87380 bytes with its mipmaps: the budget fits two of them
+    const int dim = 128, numTextures = 4;
+    const uint64_t memoryBudget = 200000;
+    vector<string> filenames;
+    for (int j = 0; j < numTextures; j++) {
+        ImageData image(dim, dim);
+        memset(image.data, 64 * j, image.size);
+        filenames.push_back((fs::temp_directory_path() / ("ngfx_streamer_" + to_string(j) + ".png")).string());
+        ImageUtil::storePNG(filenames.back(), image);
+    }
+    TextureStreamer streamer(ctx.get(), graphics.get(), memoryBudget, 16);
+    vector<StreamedTexture*> textures;
+    for (auto& filename : filenames)
+        textures.push_back(streamer.load(filename));
+    //use the given textures every frame, until the condition is met or the timeout expires
+    auto runFrames = [&](vector<int> used, function<bool()> done) {
+        auto t0 = chrono::steady_clock::now();
+        while (chrono::steady_clock::now() - t0 < chrono::seconds(10)) {
+            for (int j : used)
+                textures[j]->get();
+            streamer.update();
+            if (streamer.getMemoryUsage() > memoryBudget)
+                return false;
+            if (done())
+                return true;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return false;
+    };
+    auto isFullResolution = [&](int j) { return textures[j]->isFullResolution(); };
+    if (!runFrames({ 0, 1 }, [&]() { return isFullResolution(0) && isFullResolution(1); }))
+        return 1;
+    if (textures[0]->get()->w != dim || streamer.getStats().numEvicted != 0)
+        return 1;
+    //the least recently used textures are evicted, and fall back to the low resolution version
+    if (!runFrames({ 2, 3 }, [&]() { return isFullResolution(2) && isFullResolution(3); }))
+        return 1;
+    if (isFullResolution(0) || isFullResolution(1) || streamer.getStats().numEvicted != 2)
+        return 1;
+    Texture* lowResTexture = textures[0]->get();
+    if (!lowResTexture || lowResTexture->w != 16)
+        return 1;
+    //when the textures in use don't fit, nothing is evicted and the textures
+    //that didn't fit are not decoded again until the retry delay expires
+    streamer.budgetRetryFrames = 1000;
+    if (!runFrames({ 0, 1, 2, 3 }, [&]() { return streamer.getStats().numOverBudget >= 2; }))
+        return 1;
+    auto stats = streamer.getStats();
+    int numFrames = 0;
+    runFrames({ 0, 1, 2, 3 }, [&]() { return ++numFrames == 100; });
+    if (streamer.getStats().numDecoded != stats.numDecoded || streamer.getStats().numEvicted != 2 ||
+        !isFullResolution(2) || !isFullResolution(3) || isFullResolution(0) || isFullResolution(1))
+        return 1;
+    for (auto& filename : filenames)
+        fs::remove(filename);
+    return 0;
+}
+
+int testFormatSize() {
+    struct TestCase {
+        PixelFormat format;
+        uint32_t w, h, d;
+        uint32_t rowPitch, imageSize;
+    };
+    //partial blocks at the right and bottom edges are padded to a full block
+    const vector<TestCase> testCases = {
+        { PIXELFORMAT_RGBA8_UNORM, 5, 3, 1, 20, 60 },
+        { PIXELFORMAT_RGBA8_UNORM, 4, 4, 2, 16, 128 },
+        { PIXELFORMAT_BC1_RGBA_UNORM, 4, 4, 1, 8, 8 },
+        { PIXELFORMAT_BC1_RGBA_UNORM, 1, 1, 1, 8, 8 },
+        { PIXELFORMAT_BC1_RGBA_UNORM, 10, 6, 1, 24, 48 },
+        { PIXELFORMAT_BC4_UNORM, 8, 8, 1, 16, 32 },
+        { PIXELFORMAT_BC7_UNORM, 4, 4, 1, 16, 16 },
+        { PIXELFORMAT_BC7_UNORM, 13, 9, 2, 64, 384 },
+#ifndef NGFX_GRAPHICS_BACKEND_DIRECT3D12
+        { PIXELFORMAT_ETC2_RGB8_UNORM, 6, 6, 1, 16, 32 },
+        { PIXELFORMAT_ASTC_5x5_UNORM, 11, 11, 1, 48, 144 },
+        { PIXELFORMAT_ASTC_8x8_UNORM, 16, 8, 1, 32, 32 },
+#endif
+    };
+    int result = 0;
+    for (auto& t : testCases) {
+        uint32_t rowPitch = FormatUtil::getRowPitch(t.format, t.w);
+        uint32_t imageSize = FormatUtil::getImageSize(t.format, t.w, t.h, t.d);
+        if (rowPitch != t.rowPitch || imageSize != t.imageSize) {
+            cout << "format: " << t.format << " " << t.w << "x" << t.h << "x" << t.d
+                 << ": rowPitch: " << rowPitch << " expected: " << t.rowPitch
+                 << " imageSize: " << imageSize << " expected: " << t.imageSize << endl;
+            result = 1;
+        }
+    }
+    if (FormatUtil::isCompressed(PIXELFORMAT_RGBA8_UNORM) || !FormatUtil::isCompressed(PIXELFORMAT_BC1_RGBA_UNORM))
+        result = 1;
+    auto blockInfo = FormatUtil::getBlockInfo(PIXELFORMAT_RGBA32_SFLOAT);
+    if (blockInfo.w != 1 || blockInfo.h != 1 || blockInfo.size != 16)
+        result = 1;
+    return result;
+}
+
+struct KTX2File {
+    struct Header {
+        uint8_t identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        uint32_t vkFormat = 37, typeSize = 1, pixelWidth = 4, pixelHeight = 4, pixelDepth = 0,
+            layerCount = 0, faceCount = 1, levelCount = 3, supercompressionScheme = 0;
+        uint32_t dfdByteOffset = 0, dfdByteLength = 0, kvdByteOffset = 0, kvdByteLength = 0;
+        uint64_t sgdByteOffset = 0, sgdByteLength = 0;
+    };
+    struct LevelIndex {
+        uint64_t byteOffset, byteLength, uncompressedByteLength;
+    };
+    //a 4x4 RGBA8 texture with a full mip chain, the level data follows the level index
+    KTX2File() {
+        uint64_t offset = sizeof(Header) + 3 * sizeof(LevelIndex);
+        for (uint32_t size : { 64, 16, 4 }) {
+            levelIndex.push_back({ offset, size, size });
+            offset += size;
+        }
+        levelData.resize(offset - levelIndex[0].byteOffset, 0xFF);
+    }
+    string write(const string& name) {
+        string filename = (fs::temp_directory_path() / ("ngfx_" + name + ".ktx2")).string();
+        vector<uint8_t> contents((uint8_t*)&header, (uint8_t*)&header + sizeof(header));
+        contents.insert(contents.end(), (uint8_t*)levelIndex.data(),
+            (uint8_t*)(levelIndex.data() + levelIndex.size()));
+        contents.insert(contents.end(), levelData.begin(), levelData.end());
+        contents.resize(size_t(contents.size() * truncate));
+        ofstream out(filename, ios::binary);
+        out.write((const char*)contents.data(), contents.size());
+        return filename;
+    }
+    Header header;
+    vector<LevelIndex> levelIndex;
+    vector<uint8_t> levelData;
+    float truncate = 1.0f;
+};
+
+int testKTX2() {
+    unique_ptr<GraphicsContext> ctx(GraphicsContext::create("texture_ktx2", false));
+    ctx->setSurface(nullptr);
+    unique_ptr<Graphics> graphics(Graphics::create(ctx.get()));
+    int result = 0;
+    auto load = [&](const string& name, KTX2File& file) -> unique_ptr<Texture> {
+        string filename = file.write(name);
+        unique_ptr<Texture> texture;
+        try {
+            texture.reset(TextureUtil::loadKTX2(ctx.get(), graphics.get(), filename.c_str()));
+        } catch (std::runtime_error&) {
+        }
+        fs::remove(filename);
+        return texture;
+    };
+    KTX2File validFile;
+    auto texture = load("valid", validFile);
+    if (!texture || texture->w != 4 || texture->h != 4 || texture->mipLevels != 3 ||
+        texture->textureType != TEXTURE_TYPE_2D)
+        result = 1;
+    //each of these files must be rejected without reading past the end of the file
+    const vector<pair<string, function<void(KTX2File&)>>> invalidFiles = {
+        { "truncated_header", [](KTX2File& f) { f.truncate = 0.2f; } },
+        { "identifier", [](KTX2File& f) { f.header.identifier[1] = 'X'; } },
+        { "supercompression", [](KTX2File& f) { f.header.supercompressionScheme = 1; } },
+        { "format", [](KTX2File& f) { f.header.vkFormat = 1; } },
+        { "face_count", [](KTX2File& f) { f.header.faceCount = 0; } },
+        { "width", [](KTX2File& f) { f.header.pixelWidth = 0; } },
+        { "3d_array", [](KTX2File& f) {
+            f.header.pixelDepth = 1;
+            f.header.layerCount = 2;
+        } },
+        { "level_count", [](KTX2File& f) { f.header.levelCount = 4; } },
+        { "level_count_overflow", [](KTX2File& f) { f.header.levelCount = 40; } },
+        { "cube_array", [](KTX2File& f) {
+            f.header.faceCount = 6;
+            f.header.layerCount = 2;
+        } },
+        { "level_index", [](KTX2File& f) {
+            f.header.levelCount = 100;
+            f.levelData.clear();
+        } },
+        { "level_bounds", [](KTX2File& f) { f.levelIndex[2].byteLength = 1000; } },
+        { "level_offset_overflow", [](KTX2File& f) { f.levelIndex[1].byteOffset = ~0ull; } },
+        { "level_size", [](KTX2File& f) { f.levelIndex[0].byteLength = 32; } },
+        { "truncated_level", [](KTX2File& f) { f.truncate = 0.9f; } },
+    };
+    for (auto& invalidFile : invalidFiles) {
+        KTX2File file;
+        invalidFile.second(file);
+        if (load(invalidFile.first, file)) {
+            cout << "invalid KTX2 file loaded: " << invalidFile.first << endl;
+            result = 1;
+        }
+    }
+    return result;
+}
+
 int main(int argc, char** argv) {
     if (argc < 2) {
         return run();
     }
+    if (string(argv[1]) == "streamer")
+        return testTextureStreamer();
+    if (string(argv[1]) == "format_size")
+        return testFormatSize();
+    if (string(argv[1]) == "ktx2")
+        return testKTX2();
 }
\ No newline at end of file